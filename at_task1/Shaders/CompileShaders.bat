@@ -3,4 +3,8 @@ if not exist %1binary mkdir %1binary
 
 :: Compile shaders using glslc
 glslc.exe -fshader-stage=vertex %1VertexShader.glsl -o %1binary\VertexShader.spv
-glslc.exe -fshader-stage=fragment %1FragmentShader.glsl -o %1binary\FragmentShader.spv
\ No newline at end of file
+glslc.exe -fshader-stage=fragment %1FragmentShader.glsl -o %1binary\FragmentShader.spv
+glslc.exe -fshader-stage=vertex %1SpriteVertexShader.glsl -o %1binary\SpriteVertexShader.spv
+glslc.exe -fshader-stage=fragment %1SpriteFragmentShader.glsl -o %1binary\SpriteFragmentShader.spv
+glslc.exe -fshader-stage=vertex %1LightmapVertexShader.glsl -o %1binary\LightmapVertexShader.spv
+glslc.exe -fshader-stage=fragment %1LightmapFragmentShader.glsl -o %1binary\LightmapFragmentShader.spv
\ No newline at end of file
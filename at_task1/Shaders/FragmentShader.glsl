@@ -3,6 +3,18 @@
 // Definitions
 #define SAMPLER_COUNT 1
 #define MAX_TEXTURE_COUNT 32
+#define MAX_POINT_LIGHTS 256
+#define CLUSTER_COUNT (16 * 9 * 24)
+#define MAX_CLUSTER_LIGHT_INDICES (CLUSTER_COUNT * 32)
+#define MAX_VIEW_COUNT 4
+
+// Specialization constants
+#define LIGHTING_MODEL_BLINN_PHONG 0
+#define LIGHTING_MODEL_LAMBERT 1
+#define LIGHTING_MODEL_UNLIT 2
+layout(constant_id = 0) const uint LIGHTING_MODEL = LIGHTING_MODEL_BLINN_PHONG;
+// False when the swapchain format applies gamma
+layout(constant_id = 1) const bool GAMMA_CORRECT = true;
 
 // Input
 layout(location = 0) in vec2 textureCoord;
@@ -13,11 +25,50 @@ layout(location = 4) in vec3 directionalLightColor;
 layout(location = 5) in vec3 directionalLightWorldSpaceDirection;
 layout(location = 6) in vec3 worldSpaceCameraVector;
 layout(location = 7) in vec2 textureScale;
+layout(location = 8) in vec3 worldSpacePosition;
+layout(location = 9) in float viewSpaceDepth;
 
 // Uniforms
 layout(binding = 3) uniform sampler samplers[SAMPLER_COUNT];
 layout(binding = 4) uniform texture2D textures[MAX_TEXTURE_COUNT];
 
+struct PointLight
+{
+	vec4 WorldSpacePositionRadius;
+	vec4 ColorIntensity;
+};
+
+// Clusters of one view's frustum
+struct ClusterGrid
+{
+	// Cluster counts in x, y and z
+	uvec4 ClusterCounts;
+	// Near depth, far depth, depth slice scale and depth slice bias
+	vec4 ClusterDepth;
+	// Tile width and height in pixels followed by the position of the view's viewport
+	vec4 ClusterTileSize;
+	// Offset into light indices and light count for each cluster
+	uvec2 Clusters[CLUSTER_COUNT];
+	uint LightIndices[MAX_CLUSTER_LIGHT_INDICES];
+};
+
+layout(std430, binding = 6) readonly buffer LightGrid
+{
+	// x is the point light count
+	uvec4 LightCount;
+	PointLight Lights[MAX_POINT_LIGHTS];
+	ClusterGrid Views[MAX_VIEW_COUNT];
+};
+
+layout(binding = 2) uniform PerRenderPassUniforms
+{
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+	vec4 CameraWorldSpacePosition;
+	// Selects the view's clusters in the light grid
+	uint ViewIndex;
+};
+
 // Output
 layout(location = 0) out vec4 outColor;
 
@@ -33,27 +84,66 @@ void main()
 	// Sample the texture at inTextureID with the sampler at inSamplerID. Sampled color is in linear space
 	vec4 baseColor = texture(sampler2D(textures[inTextureID], samplers[inSamplerID]), vec2(textureCoord.r, -textureCoord.g) * textureScale);
 
-	// Calculate ambient light contribution
-	const vec3 ambient = vec3(0.05f, 0.05f, 0.05f);
+	// Unlit permutations output the texture color
+	vec3 lighting = vec3(1.0f, 1.0f, 1.0f);
+
+	if (LIGHTING_MODEL != LIGHTING_MODEL_UNLIT)
+	{
+		// Calculate ambient light contribution
+		const vec3 ambient = vec3(0.05f, 0.05f, 0.05f);
+
+		// Calculate diffuse light contribution
+		const float directionalDiffuseLight = clamp(dot(worldSpaceNormal, -directionalLightWorldSpaceDirection), 0.0f, 1.0f);
+		vec3 diffuse = directionalLightColor * directionalDiffuseLight;
+
+		// Calculate specular light contribution. Only Blinn-Phong permutations evaluate specular
+		const bool specularEnabled = LIGHTING_MODEL == LIGHTING_MODEL_BLINN_PHONG;
+		float gloss = 4.0f;
+		const vec3 specularColor = vec3(1.0f, 1.0f, 1.0f);
+		vec3 specular = vec3(0.0f, 0.0f, 0.0f);
+		if (specularEnabled)
+		{
+			vec3 halfAngle = normalize(-directionalLightWorldSpaceDirection + worldSpaceCameraVector);
+			float normalDotHalfAngle = clamp(dot(worldSpaceNormal, halfAngle), 0.0f, 1.0f);
+			float specularPower = pow(normalDotHalfAngle, gloss);
+			specular = specularColor * specularPower;
+		}
+
+		// Find the fragment's cluster in the light grid
+		uvec4 clusterCounts = Views[ViewIndex].ClusterCounts;
+		vec4 clusterDepth = Views[ViewIndex].ClusterDepth;
+		vec4 clusterTileSize = Views[ViewIndex].ClusterTileSize;
+		uvec2 tile = min(uvec2((gl_FragCoord.xy - clusterTileSize.zw) / clusterTileSize.xy), clusterCounts.xy - 1);
+		uint slice = uint(clamp(log(max(viewSpaceDepth, clusterDepth.x)) * clusterDepth.z - clusterDepth.w, 0.0f, float(clusterCounts.z - 1)));
+		uvec2 cluster = Views[ViewIndex].Clusters[tile.x + (tile.y * clusterCounts.x) + (slice * clusterCounts.x * clusterCounts.y)];
+
+		// Calculate the contribution of point lights in the cluster
+		for (uint i = 0; i < cluster.y; ++i)
+		{
+			PointLight light = Lights[Views[ViewIndex].LightIndices[cluster.x + i]];
+			vec3 toLight = light.WorldSpacePositionRadius.xyz - worldSpacePosition;
+			float lightDistance = length(toLight);
+			vec3 lightDirection = toLight / max(lightDistance, 0.0001f);
 
-	// Calculate diffuse light contribution
-	const float directionalDiffuseLight = clamp(dot(worldSpaceNormal, -directionalLightWorldSpaceDirection), 0.0f, 1.0f);
-	vec3 diffuse = directionalLightColor * directionalDiffuseLight;
+			// Attenuate smoothly to zero at the light's radius
+			float falloff = clamp(1.0f - pow(lightDistance / light.WorldSpacePositionRadius.w, 2.0f), 0.0f, 1.0f);
+			vec3 radiance = light.ColorIntensity.rgb * light.ColorIntensity.a * falloff * falloff;
 
-	// Calculate specular light contribution
-	vec3 halfAngle = normalize(-directionalLightWorldSpaceDirection + worldSpaceCameraVector);
-	float normalDotHalfAngle = clamp(dot(worldSpaceNormal, halfAngle), 0.0f, 1.0f);
-	float gloss = 4.0f;
-	const vec3 specularColor = vec3(1.0f, 1.0f, 1.0f);
-	float specularPower = pow(normalDotHalfAngle, gloss);
-	vec3 specular = specularColor * specularPower;
+			diffuse += radiance * clamp(dot(worldSpaceNormal, lightDirection), 0.0f, 1.0f);
+			if (specularEnabled)
+			{
+				vec3 pointHalfAngle = normalize(lightDirection + worldSpaceCameraVector);
+				specular += specularColor * radiance * pow(clamp(dot(worldSpaceNormal, pointHalfAngle), 0.0f, 1.0f), gloss);
+			}
+		}
 
-	// Calculate total lighting contribtion
-	vec3 lighting = ambient + diffuse + specular;
+		// Calculate total lighting contribtion
+		lighting = ambient + diffuse + specular;
+	}
 
 	// Calculate final color with lighting contributions
 	vec4 finalColor = vec4(lighting * baseColor.rgb, baseColor.a);
 
-	// Output final color transformed to gamma space
-	outColor = vec4(GammaCorrect(finalColor.rgb, 2.2f), finalColor.a);
+	// Output final color transformed to gamma space unless the swapchain format applies gamma
+	outColor = GAMMA_CORRECT ? vec4(GammaCorrect(finalColor.rgb, 2.2f), finalColor.a) : finalColor;
 }
\ No newline at end of file
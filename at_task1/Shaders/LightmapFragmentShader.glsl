@@ -0,0 +1,137 @@
+#version 450
+
+// Definitions
+#define SAMPLER_COUNT 2
+#define MAX_TEXTURE_COUNT 32
+#define MAX_POINT_LIGHTS 256
+#define CLUSTER_COUNT (16 * 9 * 24)
+#define MAX_CLUSTER_LIGHT_INDICES (CLUSTER_COUNT * 32)
+#define MAX_VIEW_COUNT 4
+// Lightmaps are sampled with the linear filter sampler
+#define LIGHTMAP_SAMPLER_ID 0
+
+// Specialization constants
+#define LIGHTING_MODEL_BLINN_PHONG 0
+#define LIGHTING_MODEL_LAMBERT 1
+#define LIGHTING_MODEL_UNLIT 2
+layout(constant_id = 0) const uint LIGHTING_MODEL = LIGHTING_MODEL_BLINN_PHONG;
+// False when the swapchain format applies gamma
+layout(constant_id = 1) const bool GAMMA_CORRECT = true;
+
+// Input
+layout(location = 0) in vec2 textureCoord;
+layout(location = 1) flat in int inSamplerID;
+layout(location = 2) flat in int inTextureID;
+layout(location = 3) in vec3 worldSpaceNormal;
+layout(location = 4) in vec3 worldSpaceCameraVector;
+layout(location = 5) in vec2 textureScale;
+layout(location = 6) in vec3 worldSpacePosition;
+layout(location = 7) in float viewSpaceDepth;
+layout(location = 8) in vec2 lightmapCoord;
+layout(location = 9) flat in int inLightmapTextureID;
+
+// Uniforms
+layout(binding = 3) uniform sampler samplers[SAMPLER_COUNT];
+layout(binding = 4) uniform texture2D textures[MAX_TEXTURE_COUNT];
+
+struct PointLight
+{
+	vec4 WorldSpacePositionRadius;
+	vec4 ColorIntensity;
+};
+
+// Clusters of one view's frustum
+struct ClusterGrid
+{
+	// Cluster counts in x, y and z
+	uvec4 ClusterCounts;
+	// Near depth, far depth, depth slice scale and depth slice bias
+	vec4 ClusterDepth;
+	// Tile width and height in pixels followed by the position of the view's viewport
+	vec4 ClusterTileSize;
+	// Offset into light indices and light count for each cluster
+	uvec2 Clusters[CLUSTER_COUNT];
+	uint LightIndices[MAX_CLUSTER_LIGHT_INDICES];
+};
+
+layout(std430, binding = 6) readonly buffer LightGrid
+{
+	// x is the point light count
+	uvec4 LightCount;
+	PointLight Lights[MAX_POINT_LIGHTS];
+	ClusterGrid Views[MAX_VIEW_COUNT];
+};
+
+layout(binding = 2) uniform PerRenderPassUniforms
+{
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+	vec4 CameraWorldSpacePosition;
+	// Selects the view's clusters in the light grid
+	uint ViewIndex;
+};
+
+// Output
+layout(location = 0) out vec4 outColor;
+
+// Applies gamma to the color
+vec3 GammaCorrect(vec3 color, float gamma)
+{
+	float exponent = 1.0f / gamma;
+	return pow(color, vec3(exponent));
+}
+
+void main()
+{
+	// Sample the texture at inTextureID with the sampler at inSamplerID. Sampled color is in linear space
+	vec4 baseColor = texture(sampler2D(textures[inTextureID], samplers[inSamplerID]), vec2(textureCoord.r, -textureCoord.g) * textureScale);
+
+	// Unlit permutations output the texture color
+	vec3 lighting = vec3(1.0f, 1.0f, 1.0f);
+
+	if (LIGHTING_MODEL != LIGHTING_MODEL_UNLIT)
+	{
+		// Read baked ambient, direct and bounced light from the lightmap instead of lighting the fragment
+		vec3 diffuse = texture(sampler2D(textures[inLightmapTextureID], samplers[LIGHTMAP_SAMPLER_ID]), lightmapCoord).rgb;
+		vec3 specular = vec3(0.0f, 0.0f, 0.0f);
+
+		// Find the fragment's cluster in the light grid
+		uvec4 clusterCounts = Views[ViewIndex].ClusterCounts;
+		vec4 clusterDepth = Views[ViewIndex].ClusterDepth;
+		vec4 clusterTileSize = Views[ViewIndex].ClusterTileSize;
+		uvec2 tile = min(uvec2((gl_FragCoord.xy - clusterTileSize.zw) / clusterTileSize.xy), clusterCounts.xy - 1);
+		uint slice = uint(clamp(log(max(viewSpaceDepth, clusterDepth.x)) * clusterDepth.z - clusterDepth.w, 0.0f, float(clusterCounts.z - 1)));
+		uvec2 cluster = Views[ViewIndex].Clusters[tile.x + (tile.y * clusterCounts.x) + (slice * clusterCounts.x * clusterCounts.y)];
+
+		// Dynamic point lights are not baked so their contribution is still calculated per pixel. Only Blinn-Phong permutations
+		// evaluate specular
+		const float gloss = 4.0f;
+		const vec3 specularColor = vec3(1.0f, 1.0f, 1.0f);
+		for (uint i = 0; i < cluster.y; ++i)
+		{
+			PointLight light = Lights[Views[ViewIndex].LightIndices[cluster.x + i]];
+			vec3 toLight = light.WorldSpacePositionRadius.xyz - worldSpacePosition;
+			float lightDistance = length(toLight);
+			vec3 lightDirection = toLight / max(lightDistance, 0.0001f);
+
+			// Attenuate smoothly to zero at the light's radius
+			float falloff = clamp(1.0f - pow(lightDistance / light.WorldSpacePositionRadius.w, 2.0f), 0.0f, 1.0f);
+			vec3 radiance = light.ColorIntensity.rgb * light.ColorIntensity.a * falloff * falloff;
+
+			diffuse += radiance * clamp(dot(worldSpaceNormal, lightDirection), 0.0f, 1.0f);
+			if (LIGHTING_MODEL == LIGHTING_MODEL_BLINN_PHONG)
+			{
+				vec3 pointHalfAngle = normalize(lightDirection + worldSpaceCameraVector);
+				specular += specularColor * radiance * pow(clamp(dot(worldSpaceNormal, pointHalfAngle), 0.0f, 1.0f), gloss);
+			}
+		}
+
+		lighting = diffuse + specular;
+	}
+
+	// Calculate final color with lighting contributions
+	vec4 finalColor = vec4(lighting * baseColor.rgb, baseColor.a);
+
+	// Output final color transformed to gamma space unless the swapchain format applies gamma
+	outColor = GAMMA_CORRECT ? vec4(GammaCorrect(finalColor.rgb, 2.2f), finalColor.a) : finalColor;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#version 450
+
+// Input
+layout(location = 0) in vec3 localSpacePosition;
+layout(location = 1) in vec2 textureCoord;
+layout(location = 2) in vec3 vertexNormal;
+layout(location = 3) in vec2 lightmapCoord;
+
+// Uniforms
+layout(binding = 0) uniform PerObjectUniforms
+{
+	mat4 WorldMatrix;
+	mat4 NormalMatrix;
+	uint MaterialID;
+	uint LightmapTextureID;
+	float FlipbookPhase;
+};
+
+layout(binding = 2) uniform PerRenderPassUniforms
+{
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+	vec4 CameraWorldSpacePosition;
+};
+
+layout(binding = 1) uniform PerFrameUniforms
+{
+	vec4 DirectionalLightColor;
+	vec4 DirectionalLightWorldSpaceDirection;
+	float Time;
+};
+
+struct Material
+{
+	uint SamplerID;
+	uint TextureID;
+	vec2 TextureScale;
+	uint FlipbookFrameCount;
+	uint FlipbookColumnCount;
+	float FlipbookFrameRate;
+};
+
+layout(std430, binding = 5) readonly buffer MaterialTable
+{
+	Material Materials[];
+};
+
+// Output
+layout(location = 0) out vec2 outTextureCoord;
+layout(location = 1) out int outSamplerID;
+layout(location = 2) out int outTextureID;
+layout(location = 3) out vec3 outWorldSpaceNormal;
+layout(location = 4) out vec3 outWorldSpaceCameraVector;
+layout(location = 5) out vec2 outTextureScale;
+layout(location = 6) out vec3 outWorldSpacePosition;
+layout(location = 7) out float outViewSpaceDepth;
+layout(location = 8) out vec2 outLightmapCoord;
+layout(location = 9) out int outLightmapTextureID;
+
+// Maps texture coordinates into the material's current flipbook frame. Frames are laid out in rows from the top left of the sprite
+// sheet. Texture coordinates are flipped in v by the fragment shader so rows are addressed from the bottom
+vec2 FlipbookTextureCoord(vec2 coord, Material material)
+{
+	if (material.FlipbookFrameCount <= 1)
+	{
+		return coord;
+	}
+
+	uint frame = uint(max(floor((Time * material.FlipbookFrameRate) + (FlipbookPhase * float(material.FlipbookFrameCount))), 0.0f)) % material.FlipbookFrameCount;
+	uint columnCount = max(material.FlipbookColumnCount, 1);
+	uint rowCount = (material.FlipbookFrameCount + columnCount - 1) / columnCount;
+	uvec2 cell = uvec2(frame % columnCount, rowCount - 1 - (frame / columnCount));
+
+	return (coord + vec2(cell)) / vec2(columnCount, rowCount);
+}
+
+void main()
+{
+	// Static geometry is merged in world space so the world matrix is the identity
+	vec4 worldSpacePosition = WorldMatrix * vec4(localSpacePosition, 1.0f);
+	vec4 viewSpacePosition = ViewMatrix * worldSpacePosition;
+	gl_Position = ProjectionMatrix * viewSpacePosition;
+
+	// Read the object's material parameters from the material table
+	Material material = Materials[MaterialID];
+	// Write outputs to fragment shader
+	outTextureCoord = FlipbookTextureCoord(textureCoord, material);
+	outSamplerID = int(material.SamplerID);
+	outTextureID = int(material.TextureID);
+	outWorldSpaceNormal = normalize((NormalMatrix * vec4(vertexNormal, 0.0f)).xyz);
+	outWorldSpaceCameraVector = normalize(CameraWorldSpacePosition.xyz - worldSpacePosition.xyz);
+	outTextureScale = material.TextureScale;
+	outWorldSpacePosition = worldSpacePosition.xyz;
+	// View space is left handed so depth increases along z
+	outViewSpaceDepth = viewSpacePosition.z;
+	outLightmapCoord = lightmapCoord;
+	outLightmapTextureID = int(LightmapTextureID);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Definitions
+#define SAMPLER_COUNT 2
+#define MAX_TEXTURE_COUNT 32
+
+// Specialization constants
+// False when the swapchain format applies gamma
+layout(constant_id = 1) const bool GAMMA_CORRECT = true;
+
+// Input
+layout(location = 0) in vec2 textureCoord;
+layout(location = 1) in vec4 color;
+layout(location = 2) flat in uint inSamplerID;
+layout(location = 3) flat in uint inTextureID;
+
+// Uniforms
+layout(binding = 3) uniform sampler samplers[SAMPLER_COUNT];
+layout(binding = 4) uniform texture2D textures[MAX_TEXTURE_COUNT];
+
+// Output
+layout(location = 0) out vec4 outColor;
+
+// Applies gamma to the color
+vec3 GammaCorrect(vec3 color, float gamma)
+{
+	float exponent = 1.0f / gamma;
+	return pow(color, vec3(exponent));
+}
+
+void main()
+{
+	// Sample the texture at inTextureID with the sampler at inSamplerID. IDs can differ between sprites in the same draw
+	vec4 baseColor = texture(sampler2D(textures[nonuniformEXT(inTextureID)], samplers[nonuniformEXT(inSamplerID)]), textureCoord);
+
+	// Sprites are unlit so the final color is the texture color tinted by the sprite color
+	vec4 finalColor = baseColor * color;
+
+	// Output final color transformed to gamma space unless the swapchain format applies gamma
+	outColor = GAMMA_CORRECT ? vec4(GammaCorrect(finalColor.rgb, 2.2f), finalColor.a) : finalColor;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 450
+
+// Input
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 textureCoord;
+layout(location = 2) in vec4 color;
+layout(location = 3) in uint samplerID;
+layout(location = 4) in uint textureID;
+
+// Uniforms
+layout(binding = 2) uniform PerRenderPassUniforms
+{
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+	vec4 CameraWorldSpacePosition;
+};
+
+// Output
+layout(location = 0) out vec2 outTextureCoord;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) flat out uint outSamplerID;
+layout(location = 3) flat out uint outTextureID;
+
+void main()
+{
+	// Sprite positions are already in world space so transform straight to projection space
+	gl_Position = ProjectionMatrix * ViewMatrix * vec4(position, 1.0f);
+
+	// Write outputs to fragment shader
+	outTextureCoord = textureCoord;
+	outColor = color;
+	outSamplerID = samplerID;
+	outTextureID = textureID;
+}
\ No newline at end of file
@@ -10,15 +10,16 @@ layout(binding = 0) uniform PerObjectUniforms
 {
 	mat4 WorldMatrix;
 	mat4 NormalMatrix;
-	vec4 Data1;
-	int SamplerID;
-	int TextureID;
+	uint MaterialID;
+	uint LightmapTextureID;
+	float FlipbookPhase;
 };
 
 layout(binding = 1) uniform PerFrameUniforms
 {
 	vec4 DirectionalLightColor;
 	vec4 DirectionalLightWorldSpaceDirection;
+	float Time;
 };
 
 layout(binding = 2) uniform PerRenderPassUniforms
@@ -28,6 +29,21 @@ layout(binding = 2) uniform PerRenderPassUniforms
 	vec4 CameraWorldSpacePosition;
 };
 
+struct Material
+{
+	uint SamplerID;
+	uint TextureID;
+	vec2 TextureScale;
+	uint FlipbookFrameCount;
+	uint FlipbookColumnCount;
+	float FlipbookFrameRate;
+};
+
+layout(std430, binding = 5) readonly buffer MaterialTable
+{
+	Material Materials[];
+};
+
 // Output
 layout(location = 0) out vec2 outTextureCoord;
 layout(location = 1) out int outSamplerID;
@@ -37,6 +53,25 @@ layout(location = 4) out vec3 outDirectionalLightColor;
 layout(location = 5) out vec3 outDirectionalLightWorldSpaceDirection;
 layout(location = 6) out vec3 outWorldSpaceCameraVector;
 layout(location = 7) out vec2 outTextureScale;
+layout(location = 8) out vec3 outWorldSpacePosition;
+layout(location = 9) out float outViewSpaceDepth;
+
+// Maps texture coordinates into the material's current flipbook frame. Frames are laid out in rows from the top left of the sprite
+// sheet. Texture coordinates are flipped in v by the fragment shader so rows are addressed from the bottom
+vec2 FlipbookTextureCoord(vec2 coord, Material material)
+{
+	if (material.FlipbookFrameCount <= 1)
+	{
+		return coord;
+	}
+
+	uint frame = uint(max(floor((Time * material.FlipbookFrameRate) + (FlipbookPhase * float(material.FlipbookFrameCount))), 0.0f)) % material.FlipbookFrameCount;
+	uint columnCount = max(material.FlipbookColumnCount, 1);
+	uint rowCount = (material.FlipbookFrameCount + columnCount - 1) / columnCount;
+	uvec2 cell = uvec2(frame % columnCount, rowCount - 1 - (frame / columnCount));
+
+	return (coord + vec2(cell)) / vec2(columnCount, rowCount);
+}
 
 void main()
 {
@@ -48,14 +83,19 @@ void main()
 
 	// Transform view space position to projection space and write to gl_Position
 	gl_Position = ProjectionMatrix * viewSpacePosition;
+	// Read the object's material parameters from the material table
+	Material material = Materials[MaterialID];
 	// Write outputs to fragment shader
-	outTextureCoord = textureCoord;
-	outSamplerID = SamplerID;
-	outTextureID = TextureID;
+	outTextureCoord = FlipbookTextureCoord(textureCoord, material);
+	outSamplerID = int(material.SamplerID);
+	outTextureID = int(material.TextureID);
 	// Transform vertex normal to world space normal
 	outWorldSpaceNormal = normalize((NormalMatrix * vec4(vertexNormal, 0.0f)).xyz);
 	outDirectionalLightColor = DirectionalLightColor.rgb;
 	outDirectionalLightWorldSpaceDirection = normalize(DirectionalLightWorldSpaceDirection.xyz);
 	outWorldSpaceCameraVector = normalize(CameraWorldSpacePosition.xyz - worldSpacePosition.xyz);
-	outTextureScale = vec2(Data1.r, Data1.g);
+	outTextureScale = material.TextureScale;
+	outWorldSpacePosition = worldSpacePosition.xyz;
+	// View space is left handed so depth increases along z
+	outViewSpaceDepth = viewSpacePosition.z;
 }
\ No newline at end of file
@@ -0,0 +1,518 @@
+#include "Pch.h"
+#include "CollisionBroadphase.h"
+
+#include "Game/World.h"
+#include "Game/Components/TransformComponent.h"
+#include "Game/Components/RigidBodyComponent.h"
+#include "Game/Components/AABBCollisionComponent.h"
+#include "Game/Components/SphereCollisionComponent.h"
+
+void StaticBVH::Build(std::vector<CollisionDetection::Bounds>&& proxyBounds, std::vector<entt::entity>&& proxyEntities,
+	std::vector<uint32_t>&& proxyLayers, std::vector<uint32_t>&& proxyMasks)
+{
+	assert(proxyBounds.size() == proxyEntities.size() && "Static BVH proxy bounds and entities must match.");
+	assert(proxyBounds.size() == proxyLayers.size() && "Static BVH proxy bounds and layers must match.");
+	assert(proxyBounds.size() == proxyMasks.size() && "Static BVH proxy bounds and masks must match.");
+
+	Clear();
+	if (proxyBounds.empty())
+	{
+		return;
+	}
+
+	ProxyBounds = std::move(proxyBounds);
+	ProxyEntities = std::move(proxyEntities);
+	ProxyLayers = std::move(proxyLayers);
+	ProxyMasks = std::move(proxyMasks);
+
+	// A binary tree with one or more proxies in each leaf has fewer than two nodes per proxy
+	std::vector<uint32_t> proxyOrder(ProxyBounds.size());
+	for (uint32_t i = 0; i < static_cast<uint32_t>(proxyOrder.size()); ++i)
+	{
+		proxyOrder[i] = i;
+	}
+	Nodes.reserve(ProxyBounds.size() * 2);
+	BuildNode(proxyOrder, 0, static_cast<uint32_t>(proxyOrder.size()));
+
+	// Store proxies in the order leaves reference them
+	std::vector<CollisionDetection::Bounds> orderedBounds(ProxyBounds.size());
+	std::vector<entt::entity> orderedEntities(ProxyEntities.size());
+	std::vector<uint32_t> orderedLayers(ProxyLayers.size());
+	std::vector<uint32_t> orderedMasks(ProxyMasks.size());
+	for (size_t i = 0; i < proxyOrder.size(); ++i)
+	{
+		orderedBounds[i] = ProxyBounds[proxyOrder[i]];
+		orderedEntities[i] = ProxyEntities[proxyOrder[i]];
+		orderedLayers[i] = ProxyLayers[proxyOrder[i]];
+		orderedMasks[i] = ProxyMasks[proxyOrder[i]];
+	}
+	ProxyBounds = std::move(orderedBounds);
+	ProxyEntities = std::move(orderedEntities);
+	ProxyLayers = std::move(orderedLayers);
+	ProxyMasks = std::move(orderedMasks);
+}
+
+void StaticBVH::Clear()
+{
+	Nodes.clear();
+	ProxyBounds.clear();
+	ProxyEntities.clear();
+	ProxyLayers.clear();
+	ProxyMasks.clear();
+}
+
+void StaticBVH::SetProxyFilter(const uint32_t proxy, const uint32_t layer, const uint32_t mask)
+{
+	ProxyLayers[proxy] = layer;
+	ProxyMasks[proxy] = mask;
+
+	// Children are stored after their parents so recalculating the nodes in reverse order visits children first. Filters of static
+	// colliders rarely change so the whole hierarchy is recalculated
+	for (auto nodeIndex = static_cast<uint32_t>(Nodes.size()); nodeIndex-- > 0;)
+	{
+		auto& node = Nodes[nodeIndex];
+		if (node.ProxyCount > 0)
+		{
+			node.Layers = 0;
+			for (uint32_t i = node.SecondChildOrFirstProxy; i < node.SecondChildOrFirstProxy + node.ProxyCount; ++i)
+			{
+				node.Layers |= ProxyLayers[i];
+			}
+		}
+		else
+		{
+			node.Layers = Nodes[nodeIndex + 1].Layers | Nodes[node.SecondChildOrFirstProxy].Layers;
+		}
+	}
+}
+
+uint32_t StaticBVH::BuildNode(std::vector<uint32_t>& proxyOrder, const uint32_t firstProxy, const uint32_t proxyCount)
+{
+	const auto nodeIndex = static_cast<uint32_t>(Nodes.size());
+	Nodes.emplace_back();
+
+	// Bound the node's proxies and their centers
+	auto bounds = ProxyBounds[proxyOrder[firstProxy]];
+	const auto firstCenter = (bounds.Min + bounds.Max) * 0.5f;
+	CollisionDetection::Bounds centerBounds{ firstCenter, firstCenter };
+	auto layers = ProxyLayers[proxyOrder[firstProxy]];
+	for (uint32_t i = firstProxy + 1; i < firstProxy + proxyCount; ++i)
+	{
+		const auto& proxy = ProxyBounds[proxyOrder[i]];
+		const auto center = (proxy.Min + proxy.Max) * 0.5f;
+		bounds = CollisionDetection::MergeBounds(bounds, proxy);
+		centerBounds = CollisionDetection::MergeBounds(centerBounds, { center, center });
+		layers |= ProxyLayers[proxyOrder[i]];
+	}
+	Nodes[nodeIndex].Bounds = bounds;
+	Nodes[nodeIndex].Layers = layers;
+
+	if (proxyCount <= MAX_LEAF_PROXY_COUNT)
+	{
+		Nodes[nodeIndex].SecondChildOrFirstProxy = firstProxy;
+		Nodes[nodeIndex].ProxyCount = proxyCount;
+		return nodeIndex;
+	}
+
+	// Split the proxies at the median center along the axis their centers are spread furthest over
+	const auto centerExtent = centerBounds.Max - centerBounds.Min;
+	glm::length_t axis{ 0 };
+	if (centerExtent.y > centerExtent[axis])
+	{
+		axis = 1;
+	}
+	if (centerExtent.z > centerExtent[axis])
+	{
+		axis = 2;
+	}
+
+	const auto firstChildProxyCount = proxyCount / 2;
+	const auto begin = proxyOrder.begin() + firstProxy;
+	std::nth_element(begin, begin + firstChildProxyCount, begin + proxyCount, [this, axis](const uint32_t lhs, const uint32_t rhs)
+		{
+			return (ProxyBounds[lhs].Min[axis] + ProxyBounds[lhs].Max[axis]) < (ProxyBounds[rhs].Min[axis] + ProxyBounds[rhs].Max[axis]);
+		});
+
+	// The first child directly follows its parent
+	BuildNode(proxyOrder, firstProxy, firstChildProxyCount);
+	const auto secondChild = BuildNode(proxyOrder, firstProxy + firstChildProxyCount, proxyCount - firstChildProxyCount);
+	Nodes[nodeIndex].SecondChildOrFirstProxy = secondChild;
+	Nodes[nodeIndex].ProxyCount = 0;
+
+	return nodeIndex;
+}
+
+uint32_t DynamicAABBTree::CreateProxy(const CollisionDetection::Bounds& bounds, const entt::entity entity, const uint32_t layer,
+	const uint32_t mask)
+{
+	const auto proxy = AllocateNode();
+	Nodes[proxy].FatBounds = CalculateFatBounds(bounds, glm::vec3(0.0f));
+	Nodes[proxy].Entity = entity;
+	Nodes[proxy].Layers = layer;
+	Nodes[proxy].Mask = mask;
+	InsertLeaf(proxy);
+
+	return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(const uint32_t proxy)
+{
+	assert(Nodes[proxy].IsLeaf() && "Dynamic AABB tree proxy is not a leaf.");
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+}
+
+void DynamicAABBTree::SetProxyFilter(const uint32_t proxy, const uint32_t layer, const uint32_t mask)
+{
+	assert(Nodes[proxy].IsLeaf() && "Dynamic AABB tree proxy is not a leaf.");
+
+	Nodes[proxy].Layers = layer;
+	Nodes[proxy].Mask = mask;
+
+	for (auto node = Nodes[proxy].Parent; node != NULL_NODE; node = Nodes[node].Parent)
+	{
+		Nodes[node].Layers = Nodes[Nodes[node].Child1].Layers | Nodes[Nodes[node].Child2].Layers;
+	}
+}
+
+bool DynamicAABBTree::MoveProxy(const uint32_t proxy, const CollisionDetection::Bounds& bounds, const glm::vec3& displacement)
+{
+	assert(Nodes[proxy].IsLeaf() && "Dynamic AABB tree proxy is not a leaf.");
+
+	if (CollisionDetection::BoundsContain(Nodes[proxy].FatBounds, bounds))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+	Nodes[proxy].FatBounds = CalculateFatBounds(bounds, displacement);
+	InsertLeaf(proxy);
+
+	return true;
+}
+
+void DynamicAABBTree::Clear()
+{
+	Nodes.clear();
+	Root = NULL_NODE;
+	FreeList = NULL_NODE;
+}
+
+uint32_t DynamicAABBTree::AllocateNode()
+{
+	if (FreeList == NULL_NODE)
+	{
+		Nodes.emplace_back();
+		return static_cast<uint32_t>(Nodes.size() - 1);
+	}
+
+	// Free nodes are linked through their parents
+	const auto node = FreeList;
+	FreeList = Nodes[node].Parent;
+	Nodes[node] = {};
+
+	return node;
+}
+
+void DynamicAABBTree::FreeNode(const uint32_t node)
+{
+	Nodes[node] = {};
+	Nodes[node].Parent = FreeList;
+	Nodes[node].Height = -1;
+	FreeList = node;
+}
+
+void DynamicAABBTree::InsertLeaf(const uint32_t leaf)
+{
+	if (Root == NULL_NODE)
+	{
+		Root = leaf;
+		Nodes[leaf].Parent = NULL_NODE;
+		return;
+	}
+
+	// Descend to the sibling that grows the tree's surface area the least
+	const auto leafBounds = Nodes[leaf].FatBounds;
+	auto sibling = Root;
+	while (!Nodes[sibling].IsLeaf())
+	{
+		const auto& node = Nodes[sibling];
+		const auto cost = CollisionDetection::CalculateBoundsCost(node.FatBounds);
+		const auto combinedCost = CollisionDetection::CalculateBoundsCost(CollisionDetection::MergeBounds(node.FatBounds, leafBounds));
+
+		// Pairing the leaf with this node creates a parent covering both. Descending further grows this node's bounds
+		const auto parentCost = 2.0f * combinedCost;
+		const auto inheritedCost = 2.0f * (combinedCost - cost);
+
+		auto calculateDescentCost = [this, &leafBounds, inheritedCost](const uint32_t child)
+		{
+			const auto& childNode = Nodes[child];
+			const auto mergedCost = CollisionDetection::CalculateBoundsCost(CollisionDetection::MergeBounds(childNode.FatBounds, leafBounds));
+			return childNode.IsLeaf() ?
+				(mergedCost + inheritedCost) :
+				((mergedCost - CollisionDetection::CalculateBoundsCost(childNode.FatBounds)) + inheritedCost);
+		};
+
+		const auto child1Cost = calculateDescentCost(node.Child1);
+		const auto child2Cost = calculateDescentCost(node.Child2);
+		if ((parentCost < child1Cost) && (parentCost < child2Cost))
+		{
+			break;
+		}
+
+		sibling = (child1Cost < child2Cost) ? node.Child1 : node.Child2;
+	}
+
+	// Replace the sibling with a parent of the sibling and the leaf
+	const auto oldParent = Nodes[sibling].Parent;
+	const auto newParent = AllocateNode();
+	Nodes[newParent].Parent = oldParent;
+	Nodes[newParent].FatBounds = CollisionDetection::MergeBounds(leafBounds, Nodes[sibling].FatBounds);
+	Nodes[newParent].Height = Nodes[sibling].Height + 1;
+	Nodes[newParent].Layers = Nodes[sibling].Layers | Nodes[leaf].Layers;
+	Nodes[newParent].Child1 = sibling;
+	Nodes[newParent].Child2 = leaf;
+	Nodes[sibling].Parent = newParent;
+	Nodes[leaf].Parent = newParent;
+
+	if (oldParent == NULL_NODE)
+	{
+		Root = newParent;
+	}
+	else if (Nodes[oldParent].Child1 == sibling)
+	{
+		Nodes[oldParent].Child1 = newParent;
+	}
+	else
+	{
+		Nodes[oldParent].Child2 = newParent;
+	}
+
+	Refit(Nodes[leaf].Parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(const uint32_t leaf)
+{
+	if (leaf == Root)
+	{
+		Root = NULL_NODE;
+		return;
+	}
+
+	// Replace the leaf's parent with the leaf's sibling
+	const auto parent = Nodes[leaf].Parent;
+	const auto grandParent = Nodes[parent].Parent;
+	const auto sibling = (Nodes[parent].Child1 == leaf) ? Nodes[parent].Child2 : Nodes[parent].Child1;
+	Nodes[sibling].Parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NULL_NODE)
+	{
+		Root = sibling;
+		return;
+	}
+
+	if (Nodes[grandParent].Child1 == parent)
+	{
+		Nodes[grandParent].Child1 = sibling;
+	}
+	else
+	{
+		Nodes[grandParent].Child2 = sibling;
+	}
+
+	Refit(grandParent);
+}
+
+uint32_t DynamicAABBTree::Balance(const uint32_t node)
+{
+	auto& a = Nodes[node];
+	if (a.IsLeaf() || (a.Height < 2))
+	{
+		return node;
+	}
+
+	const auto b = a.Child1;
+	const auto c = a.Child2;
+	const auto balance = Nodes[c].Height - Nodes[b].Height;
+	if ((balance >= -1) && (balance <= 1))
+	{
+		return node;
+	}
+
+	// Rotate the taller child up to replace the node. The node keeps the shorter child and the taller child's shorter grandchild
+	const auto raised = (balance > 0) ? c : b;
+	const auto kept = (balance > 0) ? b : c;
+	auto& raisedNode = Nodes[raised];
+	const auto tallerGrandchild = (Nodes[raisedNode.Child1].Height > Nodes[raisedNode.Child2].Height) ? raisedNode.Child1 : raisedNode.Child2;
+	const auto shorterGrandchild = (tallerGrandchild == raisedNode.Child1) ? raisedNode.Child2 : raisedNode.Child1;
+
+	raisedNode.Parent = a.Parent;
+	if (raisedNode.Parent == NULL_NODE)
+	{
+		Root = raised;
+	}
+	else if (Nodes[raisedNode.Parent].Child1 == node)
+	{
+		Nodes[raisedNode.Parent].Child1 = raised;
+	}
+	else
+	{
+		Nodes[raisedNode.Parent].Child2 = raised;
+	}
+
+	a.Parent = raised;
+	a.Child1 = kept;
+	a.Child2 = shorterGrandchild;
+	Nodes[shorterGrandchild].Parent = node;
+	a.FatBounds = CollisionDetection::MergeBounds(Nodes[kept].FatBounds, Nodes[shorterGrandchild].FatBounds);
+	a.Height = 1 + std::max(Nodes[kept].Height, Nodes[shorterGrandchild].Height);
+	a.Layers = Nodes[kept].Layers | Nodes[shorterGrandchild].Layers;
+
+	raisedNode.Child1 = node;
+	raisedNode.Child2 = tallerGrandchild;
+	raisedNode.FatBounds = CollisionDetection::MergeBounds(a.FatBounds, Nodes[tallerGrandchild].FatBounds);
+	raisedNode.Height = 1 + std::max(a.Height, Nodes[tallerGrandchild].Height);
+	raisedNode.Layers = a.Layers | Nodes[tallerGrandchild].Layers;
+
+	return raised;
+}
+
+void DynamicAABBTree::Refit(uint32_t node)
+{
+	while (node != NULL_NODE)
+	{
+		node = Balance(node);
+
+		auto& refitNode = Nodes[node];
+		const auto& child1 = Nodes[refitNode.Child1];
+		const auto& child2 = Nodes[refitNode.Child2];
+		refitNode.Height = 1 + std::max(child1.Height, child2.Height);
+		refitNode.FatBounds = CollisionDetection::MergeBounds(child1.FatBounds, child2.FatBounds);
+		refitNode.Layers = child1.Layers | child2.Layers;
+
+		node = refitNode.Parent;
+	}
+}
+
+CollisionDetection::Bounds DynamicAABBTree::CalculateFatBounds(const CollisionDetection::Bounds& bounds, const glm::vec3& displacement) const
+{
+	// Extend the bounds in the direction the collider is moving
+	auto fatBounds = bounds;
+	fatBounds.Min -= glm::vec3(FAT_BOUNDS_MARGIN);
+	fatBounds.Max += glm::vec3(FAT_BOUNDS_MARGIN);
+	const auto predictedDisplacement = displacement * DISPLACEMENT_MULTIPLIER;
+	fatBounds.Min += glm::min(predictedDisplacement, glm::vec3(0.0f));
+	fatBounds.Max += glm::max(predictedDisplacement, glm::vec3(0.0f));
+
+	return fatBounds;
+}
+
+void CollisionBroadphase::Build(entt::registry& registry)
+{
+	Clear();
+
+	std::vector<CollisionDetection::Bounds> proxyBounds;
+	std::vector<entt::entity> proxyEntities;
+	std::vector<uint32_t> proxyLayers;
+	std::vector<uint32_t> proxyMasks;
+	auto staticView = registry.view<TransformComponent, AABBCollisionComponent>(entt::exclude<RigidBodyComponent>);
+	for (auto [entity, transform, aabb] : staticView.each())
+	{
+		proxyBounds.push_back(CollisionDetection::CalculateBounds(transform.Transform.Position, aabb.Extent));
+		proxyEntities.push_back(entity);
+		proxyLayers.push_back(aabb.CollisionLayer);
+		proxyMasks.push_back(aabb.CollisionMask);
+	}
+
+	StaticTree.Build(std::move(proxyBounds), std::move(proxyEntities), std::move(proxyLayers), std::move(proxyMasks));
+
+	// The hierarchy reorders its proxies when built
+	const auto& staticEntities = StaticTree.GetProxyEntities();
+	for (uint32_t i = 0; i < static_cast<uint32_t>(staticEntities.size()); ++i)
+	{
+		StaticProxies.emplace(staticEntities[i], i);
+	}
+}
+
+void CollisionBroadphase::Update(entt::registry& registry)
+{
+	++UpdateCount;
+
+	auto rigidBodyView = registry.view<TransformComponent, RigidBodyComponent>();
+	for (auto [entity, transform, rigidBody] : rigidBodyView.each())
+	{
+		// Bound the entity's collider
+		CollisionDetection::Bounds bounds{};
+		uint32_t layer{ CollisionFilter::NO_LAYERS };
+		uint32_t mask{ CollisionFilter::NO_LAYERS };
+		if (const auto* pAABB = registry.try_get<AABBCollisionComponent>(entity))
+		{
+			bounds = CollisionDetection::CalculateBounds(transform.Transform.Position, pAABB->Extent);
+			layer = pAABB->CollisionLayer;
+			mask = pAABB->CollisionMask;
+		}
+		else if (const auto* pSphere = registry.try_get<SphereCollisionComponent>(entity))
+		{
+			bounds = CollisionDetection::CalculateBounds(transform.Transform.Position, glm::vec3(pSphere->Radius));
+			layer = pSphere->CollisionLayer;
+			mask = pSphere->CollisionMask;
+		}
+		else
+		{
+			continue;
+		}
+
+		auto [proxyIterator, inserted] = DynamicProxies.try_emplace(entity);
+		auto& proxy = proxyIterator->second;
+		if (inserted)
+		{
+			proxy.ID = DynamicTree.CreateProxy(bounds, entity, layer, mask);
+		}
+		else
+		{
+			const auto& node = DynamicTree.GetNodes()[proxy.ID];
+			if ((node.Layers != layer) || (node.Mask != mask))
+			{
+				DynamicTree.SetProxyFilter(proxy.ID, layer, mask);
+			}
+			// Velocities are per millisecond, so the fat bounds predict the motion of one fixed step
+			DynamicTree.MoveProxy(proxy.ID, bounds, rigidBody.Velocity * World::GetFixedTimestep());
+		}
+		proxy.LastUpdate = UpdateCount;
+	}
+
+	// Destroy proxies of colliders that were removed
+	for (auto proxyIterator = DynamicProxies.begin(); proxyIterator != DynamicProxies.end();)
+	{
+		if (proxyIterator->second.LastUpdate != UpdateCount)
+		{
+			DynamicTree.DestroyProxy(proxyIterator->second.ID);
+			proxyIterator = DynamicProxies.erase(proxyIterator);
+			continue;
+		}
+
+		++proxyIterator;
+	}
+}
+
+void CollisionBroadphase::RefreshFilter(const entt::registry& registry, const entt::entity entity)
+{
+	const auto proxyIterator = StaticProxies.find(entity);
+	const auto* pAABB = registry.try_get<AABBCollisionComponent>(entity);
+	if ((proxyIterator == StaticProxies.end()) || (pAABB == nullptr))
+	{
+		return;
+	}
+
+	StaticTree.SetProxyFilter(proxyIterator->second, pAABB->CollisionLayer, pAABB->CollisionMask);
+}
+
+void CollisionBroadphase::Clear()
+{
+	StaticTree.Clear();
+	DynamicTree.Clear();
+	DynamicProxies.clear();
+	StaticProxies.clear();
+}
@@ -0,0 +1,532 @@
+#pragma once
+
+#include "Game/CollisionDetection.h"
+
+// Bounding volume hierarchy over colliders that never move. Built once when a level finishes loading
+class StaticBVH
+{
+public:
+	struct Node
+	{
+		CollisionDetection::Bounds Bounds{};
+		// Leaves hold a range of proxies. Interior nodes are followed by their first child and store the index of their second child
+		uint32_t SecondChildOrFirstProxy{ 0 };
+		uint32_t ProxyCount{ 0 };
+		// Layers of the proxies under the node
+		uint32_t Layers{ 0 };
+	};
+
+	void Build(std::vector<CollisionDetection::Bounds>&& proxyBounds, std::vector<entt::entity>&& proxyEntities,
+		std::vector<uint32_t>&& proxyLayers, std::vector<uint32_t>&& proxyMasks);
+	void Clear();
+	// Changes the layer and mask of a proxy and the layers of the nodes above it
+	void SetProxyFilter(const uint32_t proxy, const uint32_t layer, const uint32_t mask);
+
+	// Calls the callback with the entity of each proxy passing the filter whose bounds overlap the bounds
+	template<typename Callback>
+	void Query(const CollisionDetection::Bounds& bounds, const CollisionQueryFilter& filter, Callback&& callback) const
+	{
+		if (Nodes.empty())
+		{
+			return;
+		}
+
+		std::array<uint32_t, MAX_DEPTH> stack{};
+		uint32_t stackSize{ 0 };
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			// Skip subtrees without proxies on the filter's layers
+			const auto& node = Nodes[stack[--stackSize]];
+			if (((node.Layers & filter.Layers) == 0) || !CollisionDetection::BoundsOverlap(node.Bounds, bounds))
+			{
+				continue;
+			}
+
+			if (node.ProxyCount > 0)
+			{
+				for (uint32_t i = node.SecondChildOrFirstProxy; i < node.SecondChildOrFirstProxy + node.ProxyCount; ++i)
+				{
+					if (filter.Passes(ProxyLayers[i], ProxyMasks[i]) && CollisionDetection::BoundsOverlap(ProxyBounds[i], bounds))
+					{
+						callback(ProxyEntities[i]);
+					}
+				}
+				continue;
+			}
+
+			stack[stackSize++] = static_cast<uint32_t>(&node - Nodes.data()) + 1;
+			stack[stackSize++] = node.SecondChildOrFirstProxy;
+		}
+	}
+
+	// Calls the callback with the entity of each proxy passing the filter the ray enters, visiting nodes nearest first. The callback is
+	// given the current maximum distance and returns the distance the ray is clipped to, or a negative distance to stop. Returns the
+	// final maximum distance
+	template<typename Callback>
+	float Raycast(const CollisionDetection::Ray& ray, const glm::vec3& inverseDirection, float maxDistance, const CollisionQueryFilter& filter,
+		Callback&& callback) const
+	{
+		float entryDistance{ 0.0f };
+		if (Nodes.empty() || ((Nodes[0].Layers & filter.Layers) == 0) || !CollisionDetection::IntersectRayBounds(ray.Origin, inverseDirection, Nodes[0].Bounds, maxDistance, entryDistance))
+		{
+			return maxDistance;
+		}
+
+		struct StackEntry
+		{
+			uint32_t Node{ 0 };
+			float EntryDistance{ 0.0f };
+		};
+
+		std::array<StackEntry, MAX_DEPTH> stack{};
+		uint32_t stackSize{ 0 };
+		stack[stackSize++] = { 0, entryDistance };
+		while (stackSize > 0)
+		{
+			const auto entry = stack[--stackSize];
+
+			// Nodes entered beyond a hit found since they were pushed are skipped
+			if (entry.EntryDistance > maxDistance)
+			{
+				continue;
+			}
+
+			const auto& node = Nodes[entry.Node];
+			if (node.ProxyCount > 0)
+			{
+				for (uint32_t i = node.SecondChildOrFirstProxy; i < node.SecondChildOrFirstProxy + node.ProxyCount; ++i)
+				{
+					if (filter.Passes(ProxyLayers[i], ProxyMasks[i]) &&
+						CollisionDetection::IntersectRayBounds(ray.Origin, inverseDirection, ProxyBounds[i], maxDistance, entryDistance))
+					{
+						maxDistance = callback(ProxyEntities[i], maxDistance);
+						if (maxDistance < 0.0f)
+						{
+							return maxDistance;
+						}
+					}
+				}
+				continue;
+			}
+
+			// Push the further child first so the nearer child is visited first
+			const StackEntry firstChild{ entry.Node + 1, 0.0f };
+			const StackEntry secondChild{ node.SecondChildOrFirstProxy, 0.0f };
+			std::array<StackEntry, 2> children{ firstChild, secondChild };
+			std::array<bool, 2> childrenHit{};
+			for (size_t i = 0; i < children.size(); ++i)
+			{
+				const auto& child = Nodes[children[i].Node];
+				childrenHit[i] = ((child.Layers & filter.Layers) != 0) &&
+					CollisionDetection::IntersectRayBounds(ray.Origin, inverseDirection, child.Bounds, maxDistance, children[i].EntryDistance);
+			}
+
+			const size_t nearChild = (childrenHit[0] && childrenHit[1] && (children[1].EntryDistance < children[0].EntryDistance)) ? 1 : 0;
+			const auto farChild = 1 - nearChild;
+			if (childrenHit[farChild])
+			{
+				stack[stackSize++] = children[farChild];
+			}
+			if (childrenHit[nearChild])
+			{
+				stack[stackSize++] = children[nearChild];
+			}
+		}
+
+		return maxDistance;
+	}
+
+	// Calls the callback with the entity of each proxy passing the filter and a mask of the packet's rays entering it, visiting nodes
+	// nearest first. The callback can shorten the packet's maximum distances as hits are found so further nodes are skipped
+	template<typename Callback>
+	void RaycastPacket(const CollisionDetection::RayPacket& packet, const uint32_t rayMask, const CollisionQueryFilter& filter,
+		Callback&& callback) const
+	{
+		float entryDistance{ 0.0f };
+		const auto rootRayMask = (Nodes.empty() || ((Nodes[0].Layers & filter.Layers) == 0)) ?
+			0 : CollisionDetection::IntersectRayPacketBounds(packet, rayMask, Nodes[0].Bounds, entryDistance);
+		if (rootRayMask == 0)
+		{
+			return;
+		}
+
+		struct StackEntry
+		{
+			uint32_t Node{ 0 };
+			uint32_t RayMask{ 0 };
+			float EntryDistance{ 0.0f };
+		};
+
+		std::array<StackEntry, MAX_DEPTH> stack{};
+		uint32_t stackSize{ 0 };
+		stack[stackSize++] = { 0, rootRayMask, entryDistance };
+		while (stackSize > 0)
+		{
+			const auto entry = stack[--stackSize];
+
+			// Drop the rays clipped by hits found since the node was pushed
+			const auto nodeRayMask = packet.ClipRayMask(entry.RayMask, entry.EntryDistance);
+			if (nodeRayMask == 0)
+			{
+				continue;
+			}
+
+			const auto& node = Nodes[entry.Node];
+			if (node.ProxyCount > 0)
+			{
+				for (uint32_t i = node.SecondChildOrFirstProxy; i < node.SecondChildOrFirstProxy + node.ProxyCount; ++i)
+				{
+					if (!filter.Passes(ProxyLayers[i], ProxyMasks[i]))
+					{
+						continue;
+					}
+
+					const auto proxyRayMask = CollisionDetection::IntersectRayPacketBounds(packet, nodeRayMask, ProxyBounds[i], entryDistance);
+					if (proxyRayMask != 0)
+					{
+						callback(ProxyEntities[i], proxyRayMask);
+					}
+				}
+				continue;
+			}
+
+			// Push the further child first so the nearer child is visited first
+			std::array<StackEntry, 2> children{ StackEntry{ entry.Node + 1, 0, 0.0f }, StackEntry{ node.SecondChildOrFirstProxy, 0, 0.0f } };
+			for (auto& child : children)
+			{
+				child.RayMask = ((Nodes[child.Node].Layers & filter.Layers) == 0) ?
+					0 : CollisionDetection::IntersectRayPacketBounds(packet, nodeRayMask, Nodes[child.Node].Bounds, child.EntryDistance);
+			}
+
+			const size_t nearChild = ((children[0].RayMask == 0) || ((children[1].RayMask != 0) && (children[1].EntryDistance < children[0].EntryDistance))) ? 1 : 0;
+			const auto farChild = 1 - nearChild;
+			if (children[farChild].RayMask != 0)
+			{
+				stack[stackSize++] = children[farChild];
+			}
+			if (children[nearChild].RayMask != 0)
+			{
+				stack[stackSize++] = children[nearChild];
+			}
+		}
+	}
+
+	const std::vector<Node>& GetNodes() const { return Nodes; }
+	const std::vector<CollisionDetection::Bounds>& GetProxyBounds() const { return ProxyBounds; }
+	const std::vector<entt::entity>& GetProxyEntities() const { return ProxyEntities; }
+
+private:
+	// Leaves hold up to this many proxies
+	static constexpr uint32_t MAX_LEAF_PROXY_COUNT{ 2 };
+	// Splitting at the median keeps the depth logarithmic so traversal fits in a fixed size stack
+	static constexpr uint32_t MAX_DEPTH{ 64 };
+
+	// Builds the node over a range of the proxy order. Returns the node's index
+	uint32_t BuildNode(std::vector<uint32_t>& proxyOrder, const uint32_t firstProxy, const uint32_t proxyCount);
+
+	std::vector<Node> Nodes;
+	std::vector<CollisionDetection::Bounds> ProxyBounds;
+	std::vector<entt::entity> ProxyEntities;
+	std::vector<uint32_t> ProxyLayers;
+	std::vector<uint32_t> ProxyMasks;
+};
+
+// AABB tree over moving colliders. Proxies are stored with fattened bounds so a proxy is only reinserted once its collider leaves them
+class DynamicAABBTree
+{
+public:
+	static constexpr uint32_t NULL_NODE{ std::numeric_limits<uint32_t>::max() };
+
+	struct Node
+	{
+		CollisionDetection::Bounds FatBounds{};
+		uint32_t Parent{ NULL_NODE };
+		uint32_t Child1{ NULL_NODE };
+		uint32_t Child2{ NULL_NODE };
+		// Leaves have a height of zero
+		int32_t Height{ 0 };
+		entt::entity Entity{ entt::null };
+		// Layer of a leaf's proxy, or the layers of the proxies under an interior node
+		uint32_t Layers{ 0 };
+		// Mask of a leaf's proxy
+		uint32_t Mask{ 0 };
+
+		bool IsLeaf() const { return Child1 == NULL_NODE; }
+	};
+
+	// Returns the proxy's ID
+	uint32_t CreateProxy(const CollisionDetection::Bounds& bounds, const entt::entity entity, const uint32_t layer, const uint32_t mask);
+	void DestroyProxy(const uint32_t proxy);
+	// Changes the layer and mask of a proxy and the layers of the nodes above it
+	void SetProxyFilter(const uint32_t proxy, const uint32_t layer, const uint32_t mask);
+	// Reinserts the proxy when the bounds leave its fat bounds. The fat bounds are extended along the displacement the collider is expected
+	// to move by. Returns whether the proxy was reinserted
+	bool MoveProxy(const uint32_t proxy, const CollisionDetection::Bounds& bounds, const glm::vec3& displacement);
+	void Clear();
+
+	// Calls the callback with the entity of each proxy passing the filter whose fat bounds overlap the bounds
+	template<typename Callback>
+	void Query(const CollisionDetection::Bounds& bounds, const CollisionQueryFilter& filter, Callback&& callback) const
+	{
+		if (Root == NULL_NODE)
+		{
+			return;
+		}
+
+		std::array<uint32_t, MAX_QUERY_STACK_SIZE> stack{};
+		uint32_t stackSize{ 0 };
+		stack[stackSize++] = Root;
+		while (stackSize > 0)
+		{
+			// Skip subtrees without proxies on the filter's layers
+			const auto& node = Nodes[stack[--stackSize]];
+			if (((node.Layers & filter.Layers) == 0) || !CollisionDetection::BoundsOverlap(node.FatBounds, bounds))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				if (filter.Passes(node.Layers, node.Mask))
+				{
+					callback(node.Entity);
+				}
+				continue;
+			}
+
+			assert((stackSize + 2) <= MAX_QUERY_STACK_SIZE && "Dynamic AABB tree is too deep to query.");
+			stack[stackSize++] = node.Child1;
+			stack[stackSize++] = node.Child2;
+		}
+	}
+
+	// Calls the callback with the entity of each proxy passing the filter the ray enters, visiting nodes nearest first. The callback is
+	// given the current maximum distance and returns the distance the ray is clipped to, or a negative distance to stop. Returns the
+	// final maximum distance
+	template<typename Callback>
+	float Raycast(const CollisionDetection::Ray& ray, const glm::vec3& inverseDirection, float maxDistance, const CollisionQueryFilter& filter,
+		Callback&& callback) const
+	{
+		float entryDistance{ 0.0f };
+		if ((Root == NULL_NODE) || ((Nodes[Root].Layers & filter.Layers) == 0) || !CollisionDetection::IntersectRayBounds(ray.Origin, inverseDirection, Nodes[Root].FatBounds, maxDistance, entryDistance))
+		{
+			return maxDistance;
+		}
+
+		struct StackEntry
+		{
+			uint32_t Node{ NULL_NODE };
+			float EntryDistance{ 0.0f };
+		};
+
+		std::array<StackEntry, MAX_QUERY_STACK_SIZE> stack{};
+		uint32_t stackSize{ 0 };
+		stack[stackSize++] = { Root, entryDistance };
+		while (stackSize > 0)
+		{
+			const auto entry = stack[--stackSize];
+
+			// Nodes entered beyond a hit found since they were pushed are skipped
+			if (entry.EntryDistance > maxDistance)
+			{
+				continue;
+			}
+
+			const auto& node = Nodes[entry.Node];
+			if (node.IsLeaf())
+			{
+				if (!filter.Passes(node.Layers, node.Mask))
+				{
+					continue;
+				}
+
+				maxDistance = callback(node.Entity, maxDistance);
+				if (maxDistance < 0.0f)
+				{
+					return maxDistance;
+				}
+				continue;
+			}
+
+			// Push the further child first so the nearer child is visited first
+			std::array<StackEntry, 2> children{ StackEntry{ node.Child1, 0.0f }, StackEntry{ node.Child2, 0.0f } };
+			std::array<bool, 2> childrenHit{};
+			for (size_t i = 0; i < children.size(); ++i)
+			{
+				const auto& child = Nodes[children[i].Node];
+				childrenHit[i] = ((child.Layers & filter.Layers) != 0) &&
+					CollisionDetection::IntersectRayBounds(ray.Origin, inverseDirection, child.FatBounds, maxDistance, children[i].EntryDistance);
+			}
+
+			const size_t nearChild = (childrenHit[0] && childrenHit[1] && (children[1].EntryDistance < children[0].EntryDistance)) ? 1 : 0;
+			const auto farChild = 1 - nearChild;
+			assert((stackSize + 2) <= MAX_QUERY_STACK_SIZE && "Dynamic AABB tree is too deep to raycast.");
+			if (childrenHit[farChild])
+			{
+				stack[stackSize++] = children[farChild];
+			}
+			if (childrenHit[nearChild])
+			{
+				stack[stackSize++] = children[nearChild];
+			}
+		}
+
+		return maxDistance;
+	}
+
+	// Calls the callback with the entity of each proxy passing the filter and a mask of the packet's rays entering it, visiting nodes
+	// nearest first. The callback can shorten the packet's maximum distances as hits are found so further nodes are skipped
+	template<typename Callback>
+	void RaycastPacket(const CollisionDetection::RayPacket& packet, const uint32_t rayMask, const CollisionQueryFilter& filter,
+		Callback&& callback) const
+	{
+		float entryDistance{ 0.0f };
+		const auto rootRayMask = ((Root == NULL_NODE) || ((Nodes[Root].Layers & filter.Layers) == 0)) ?
+			0 : CollisionDetection::IntersectRayPacketBounds(packet, rayMask, Nodes[Root].FatBounds, entryDistance);
+		if (rootRayMask == 0)
+		{
+			return;
+		}
+
+		struct StackEntry
+		{
+			uint32_t Node{ NULL_NODE };
+			uint32_t RayMask{ 0 };
+			float EntryDistance{ 0.0f };
+		};
+
+		std::array<StackEntry, MAX_QUERY_STACK_SIZE> stack{};
+		uint32_t stackSize{ 0 };
+		stack[stackSize++] = { Root, rootRayMask, entryDistance };
+		while (stackSize > 0)
+		{
+			const auto entry = stack[--stackSize];
+
+			// Drop the rays clipped by hits found since the node was pushed
+			const auto nodeRayMask = packet.ClipRayMask(entry.RayMask, entry.EntryDistance);
+			if (nodeRayMask == 0)
+			{
+				continue;
+			}
+
+			const auto& node = Nodes[entry.Node];
+			if (node.IsLeaf())
+			{
+				if (filter.Passes(node.Layers, node.Mask))
+				{
+					callback(node.Entity, nodeRayMask);
+				}
+				continue;
+			}
+
+			// Push the further child first so the nearer child is visited first
+			std::array<StackEntry, 2> children{ StackEntry{ node.Child1, 0, 0.0f }, StackEntry{ node.Child2, 0, 0.0f } };
+			for (auto& child : children)
+			{
+				child.RayMask = ((Nodes[child.Node].Layers & filter.Layers) == 0) ?
+					0 : CollisionDetection::IntersectRayPacketBounds(packet, nodeRayMask, Nodes[child.Node].FatBounds, child.EntryDistance);
+			}
+
+			const size_t nearChild = ((children[0].RayMask == 0) || ((children[1].RayMask != 0) && (children[1].EntryDistance < children[0].EntryDistance))) ? 1 : 0;
+			const auto farChild = 1 - nearChild;
+			assert((stackSize + 2) <= MAX_QUERY_STACK_SIZE && "Dynamic AABB tree is too deep to raycast.");
+			if (children[farChild].RayMask != 0)
+			{
+				stack[stackSize++] = children[farChild];
+			}
+			if (children[nearChild].RayMask != 0)
+			{
+				stack[stackSize++] = children[nearChild];
+			}
+		}
+	}
+
+	uint32_t GetRoot() const { return Root; }
+	const std::vector<Node>& GetNodes() const { return Nodes; }
+
+private:
+	// Fattens proxy bounds so colliders moving a small distance do not change the tree
+	static constexpr float FAT_BOUNDS_MARGIN{ 0.1f };
+	// Fat bounds are extended by this many times a collider's displacement
+	static constexpr float DISPLACEMENT_MULTIPLIER{ 2.0f };
+	// The tree is kept balanced so its height grows logarithmically with the proxy count
+	static constexpr uint32_t MAX_QUERY_STACK_SIZE{ 256 };
+
+	uint32_t AllocateNode();
+	void FreeNode(const uint32_t node);
+	void InsertLeaf(const uint32_t leaf);
+	void RemoveLeaf(const uint32_t leaf);
+	// Rotates the subtree at the node when its children's heights differ by more than one. Returns the subtree's new root
+	uint32_t Balance(const uint32_t node);
+	// Rebalances and recalculates the bounds and heights of a node and its ancestors
+	void Refit(uint32_t node);
+	CollisionDetection::Bounds CalculateFatBounds(const CollisionDetection::Bounds& bounds, const glm::vec3& displacement) const;
+
+	std::vector<Node> Nodes;
+	uint32_t Root{ NULL_NODE };
+	uint32_t FreeList{ NULL_NODE };
+};
+
+// Finds colliders that may overlap a volume. Colliders of entities without rigid bodies never move and are stored in a static bounding
+// volume hierarchy built when the level finishes loading. Colliders of entities with rigid bodies are stored in a dynamic AABB tree
+// updated each physics update
+class CollisionBroadphase
+{
+public:
+	// Builds the static hierarchy from the AABB colliders of entities without rigid bodies
+	void Build(entt::registry& registry);
+	// Inserts, moves and removes proxies of colliders with rigid bodies. Proxies take the layer and mask of their collider
+	void Update(entt::registry& registry);
+	// Applies a change to the layer or mask of a static collider's AABB collision
+	void RefreshFilter(const entt::registry& registry, const entt::entity entity);
+	void Clear();
+
+	// Calls the callback with each entity passing the filter whose collider bounds may overlap the bounds
+	template<typename Callback>
+	void Query(const CollisionDetection::Bounds& bounds, const CollisionQueryFilter& filter, Callback&& callback) const
+	{
+		StaticTree.Query(bounds, filter, callback);
+		DynamicTree.Query(bounds, filter, callback);
+	}
+
+	// Calls the callback with each entity passing the filter whose collider bounds the ray enters, nearest first within each tier. The
+	// callback is given the current maximum distance and returns the distance the ray is clipped to, or a negative distance to stop
+	template<typename Callback>
+	void Raycast(const CollisionDetection::Ray& ray, const CollisionQueryFilter& filter, Callback&& callback) const
+	{
+		const auto inverseDirection = CollisionDetection::CalculateInverseDirection(ray.Direction);
+		const auto maxDistance = StaticTree.Raycast(ray, inverseDirection, ray.Length, filter, callback);
+		if (maxDistance >= 0.0f)
+		{
+			DynamicTree.Raycast(ray, inverseDirection, maxDistance, filter, callback);
+		}
+	}
+
+	// Calls the callback with each entity passing the filter whose collider bounds rays of the packet enter and a mask of those rays.
+	// The callback can shorten the packet's maximum distances as hits are found
+	template<typename Callback>
+	void RaycastPacket(const CollisionDetection::RayPacket& packet, const CollisionQueryFilter& filter, Callback&& callback) const
+	{
+		StaticTree.RaycastPacket(packet, packet.GetRayMask(), filter, callback);
+		DynamicTree.RaycastPacket(packet, packet.GetRayMask(), filter, callback);
+	}
+
+	const StaticBVH& GetStaticTree() const { return StaticTree; }
+	const DynamicAABBTree& GetDynamicTree() const { return DynamicTree; }
+
+private:
+	struct DynamicProxy
+	{
+		uint32_t ID{ DynamicAABBTree::NULL_NODE };
+		// Proxies of colliders not seen in an update are destroyed
+		uint64_t LastUpdate{ 0 };
+	};
+
+	StaticBVH StaticTree;
+	DynamicAABBTree DynamicTree;
+	std::unordered_map<entt::entity, DynamicProxy> DynamicProxies;
+	// Index of each static collider's proxy in the static hierarchy
+	std::unordered_map<entt::entity, uint32_t> StaticProxies;
+	uint64_t UpdateCount{ 0 };
+};
\ No newline at end of file
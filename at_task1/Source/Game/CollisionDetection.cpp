@@ -2,6 +2,109 @@
 #include "CollisionDetection.h"
 #include "Game/Components/SphereCollisionComponent.h"
 #include "Game/Components/AABBCollisionComponent.h"
+#include "Game/Components/TransformComponent.h"
+#include "Game/Level.h"
+#include "Console.h"
+
+// The project builds with /arch:AVX2, which defines __AVX__ and selects the 8 wide paths. Other builds use the 4 wide SSE2 paths
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Batches are padded for the widest SIMD path so every path can load whole groups of lanes
+constexpr uint32_t AABB_BATCH_PADDING{ 8 };
+
+// Tests a sphere against one box of a batch
+static bool TestSphereAABBBatchLane(const glm::vec3& spherePosition, const float radiusSquared, const CollisionDetection::AABBBatch& boxes,
+    const uint32_t index, glm::vec3& hitSurfaceNormal)
+{
+    const glm::vec3 center(boxes.CenterX[index], boxes.CenterY[index], boxes.CenterZ[index]);
+    const glm::vec3 extent(boxes.ExtentX[index], boxes.ExtentY[index], boxes.ExtentZ[index]);
+    const auto delta = spherePosition - glm::max(center - extent, glm::min(spherePosition, center + extent));
+    const auto distanceSquared = glm::dot(delta, delta);
+    if (distanceSquared >= radiusSquared)
+    {
+        return false;
+    }
+
+    hitSurfaceNormal = (distanceSquared > 0.0f) ? (delta / std::sqrt(distanceSquared)) : glm::vec3(0.0f);
+    return true;
+}
+
+#if defined(__AVX__) || defined(_M_X64) || defined(__SSE2__)
+#define COLLISION_DETECTION_SIMD
+#if defined(__AVX__)
+constexpr uint32_t SIMD_LANE_COUNT{ 8 };
+#else
+constexpr uint32_t SIMD_LANE_COUNT{ 4 };
+#endif
+
+using SimdLaneNormals = std::array<std::array<float, SIMD_LANE_COUNT>, 3>;
+
+// Tests a sphere against a group of boxes of a batch, one box per SIMD lane. Returns a bit for each lane hit and writes the lanes' normals
+static uint32_t TestSphereAABBBatchLanes(const glm::vec3& spherePosition, const float radiusSquared, const CollisionDetection::AABBBatch& boxes,
+    const uint32_t first, SimdLaneNormals& normals)
+{
+#if defined(__AVX__)
+    // Clamp the sphere's center to each box to find the closest points
+    auto calculateDelta = [first](const float sphere, const std::vector<float>& centers, const std::vector<float>& extents)
+    {
+        const auto center = _mm256_loadu_ps(centers.data() + first);
+        const auto extent = _mm256_loadu_ps(extents.data() + first);
+        const auto sphereLanes = _mm256_set1_ps(sphere);
+        return _mm256_sub_ps(sphereLanes, _mm256_max_ps(_mm256_sub_ps(center, extent), _mm256_min_ps(sphereLanes, _mm256_add_ps(center, extent))));
+    };
+
+    const auto deltaX = calculateDelta(spherePosition.x, boxes.CenterX, boxes.ExtentX);
+    const auto deltaY = calculateDelta(spherePosition.y, boxes.CenterY, boxes.ExtentY);
+    const auto deltaZ = calculateDelta(spherePosition.z, boxes.CenterZ, boxes.ExtentZ);
+    const auto distanceSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(deltaX, deltaX), _mm256_mul_ps(deltaY, deltaY)), _mm256_mul_ps(deltaZ, deltaZ));
+
+    const auto hits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(distanceSquared, _mm256_set1_ps(radiusSquared), _CMP_LT_OQ)));
+    if (hits == 0)
+    {
+        return 0;
+    }
+
+    // Centers inside a box have a zero normal
+    const auto inverseDistance = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(distanceSquared)),
+        _mm256_cmp_ps(distanceSquared, _mm256_setzero_ps(), _CMP_GT_OQ));
+    _mm256_storeu_ps(normals[0].data(), _mm256_mul_ps(deltaX, inverseDistance));
+    _mm256_storeu_ps(normals[1].data(), _mm256_mul_ps(deltaY, inverseDistance));
+    _mm256_storeu_ps(normals[2].data(), _mm256_mul_ps(deltaZ, inverseDistance));
+#else
+    // Clamp the sphere's center to each box to find the closest points
+    auto calculateDelta = [first](const float sphere, const std::vector<float>& centers, const std::vector<float>& extents)
+    {
+        const auto center = _mm_loadu_ps(centers.data() + first);
+        const auto extent = _mm_loadu_ps(extents.data() + first);
+        const auto sphereLanes = _mm_set1_ps(sphere);
+        return _mm_sub_ps(sphereLanes, _mm_max_ps(_mm_sub_ps(center, extent), _mm_min_ps(sphereLanes, _mm_add_ps(center, extent))));
+    };
+
+    const auto deltaX = calculateDelta(spherePosition.x, boxes.CenterX, boxes.ExtentX);
+    const auto deltaY = calculateDelta(spherePosition.y, boxes.CenterY, boxes.ExtentY);
+    const auto deltaZ = calculateDelta(spherePosition.z, boxes.CenterZ, boxes.ExtentZ);
+    const auto distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY)), _mm_mul_ps(deltaZ, deltaZ));
+
+    const auto hits = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(distanceSquared, _mm_set1_ps(radiusSquared))));
+    if (hits == 0)
+    {
+        return 0;
+    }
+
+    // Centers inside a box have a zero normal
+    const auto inverseDistance = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(distanceSquared)), _mm_cmpgt_ps(distanceSquared, _mm_setzero_ps()));
+    _mm_storeu_ps(normals[0].data(), _mm_mul_ps(deltaX, inverseDistance));
+    _mm_storeu_ps(normals[1].data(), _mm_mul_ps(deltaY, inverseDistance));
+    _mm_storeu_ps(normals[2].data(), _mm_mul_ps(deltaZ, inverseDistance));
+#endif
+
+    return hits;
+}
+#endif
 
 bool CollisionDetection::TestSphereAABB(const glm::vec3& spherePosition, const SphereCollisionComponent& sphere,
     const glm::vec3& aabbPosition, const AABBCollisionComponent& aabb, CollisionTestResult& result)
@@ -120,3 +223,645 @@ bool CollisionDetection::TestLineAABB(const glm::vec3& lineStart,
 
     return true;
 }
+
+CollisionDetection::Bounds CollisionDetection::CalculateBounds(const glm::vec3& position, const glm::vec3& extent)
+{
+    return { position - extent, position + extent };
+}
+
+CollisionDetection::Bounds CollisionDetection::MergeBounds(const Bounds& lhs, const Bounds& rhs)
+{
+    return { glm::min(lhs.Min, rhs.Min), glm::max(lhs.Max, rhs.Max) };
+}
+
+bool CollisionDetection::BoundsOverlap(const Bounds& lhs, const Bounds& rhs)
+{
+    return (lhs.Min.x <= rhs.Max.x) && (lhs.Max.x >= rhs.Min.x) &&
+        (lhs.Min.y <= rhs.Max.y) && (lhs.Max.y >= rhs.Min.y) &&
+        (lhs.Min.z <= rhs.Max.z) && (lhs.Max.z >= rhs.Min.z);
+}
+
+bool CollisionDetection::BoundsContain(const Bounds& outer, const Bounds& inner)
+{
+    return (outer.Min.x <= inner.Min.x) && (outer.Min.y <= inner.Min.y) && (outer.Min.z <= inner.Min.z) &&
+        (outer.Max.x >= inner.Max.x) && (outer.Max.y >= inner.Max.y) && (outer.Max.z >= inner.Max.z);
+}
+
+float CollisionDetection::CalculateBoundsCost(const Bounds& bounds)
+{
+    const auto size = bounds.Max - bounds.Min;
+    return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+}
+
+glm::vec3 CollisionDetection::CalculateInverseDirection(const glm::vec3& direction)
+{
+    glm::vec3 inverseDirection{};
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        inverseDirection[axis] = 1.0f / ((direction[axis] == 0.0f) ? 0.000001f : direction[axis]);
+    }
+
+    return inverseDirection;
+}
+
+bool CollisionDetection::IntersectRayBounds(const glm::vec3& origin, const glm::vec3& inverseDirection, const Bounds& bounds,
+    const float maxDistance, float& entryDistance)
+{
+    const auto t0 = (bounds.Min - origin) * inverseDirection;
+    const auto t1 = (bounds.Max - origin) * inverseDirection;
+    const auto tMin = glm::min(t0, t1);
+    const auto tMax = glm::max(t0, t1);
+
+    const auto entry = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+    const auto exit = std::min(std::min(tMax.x, tMax.y), tMax.z);
+    if ((entry > exit) || (entry > maxDistance))
+    {
+        return false;
+    }
+
+    entryDistance = entry;
+    return true;
+}
+
+void CollisionDetection::RayPacket::Add(const Ray& ray)
+{
+    assert(Count < MAX_RAY_COUNT && "Ray packet is full.");
+
+    const auto inverseDirection = CalculateInverseDirection(ray.Direction);
+    OriginX[Count] = ray.Origin.x;
+    OriginY[Count] = ray.Origin.y;
+    OriginZ[Count] = ray.Origin.z;
+    InverseDirectionX[Count] = inverseDirection.x;
+    InverseDirectionY[Count] = inverseDirection.y;
+    InverseDirectionZ[Count] = inverseDirection.z;
+    MaxDistance[Count] = ray.Length;
+    ++Count;
+}
+
+uint32_t CollisionDetection::IntersectRayPacketBounds(const RayPacket& packet, const uint32_t rayMask, const Bounds& bounds,
+    float& nearestEntryDistance)
+{
+    std::array<float, RayPacket::MAX_RAY_COUNT> entryDistances{};
+    uint32_t hitMask{ 0 };
+
+#if defined(COLLISION_DETECTION_SIMD)
+    static_assert((RayPacket::MAX_RAY_COUNT % SIMD_LANE_COUNT) == 0, "Ray packets must hold whole groups of SIMD lanes.");
+    constexpr uint32_t LANE_MASK{ (1u << SIMD_LANE_COUNT) - 1 };
+
+    for (uint32_t first = 0; first < packet.Count; first += SIMD_LANE_COUNT)
+    {
+        // Skip groups of rays that are all inactive
+        if (((rayMask >> first) & LANE_MASK) == 0)
+        {
+            continue;
+        }
+
+#if defined(__AVX__)
+        // Entry and exit distances of each ray through the slab of one axis
+        auto slab = [first](const float boundsMin, const float boundsMax, const std::array<float, RayPacket::MAX_RAY_COUNT>& origins,
+            const std::array<float, RayPacket::MAX_RAY_COUNT>& inverseDirections, __m256& slabEntry, __m256& slabExit)
+        {
+            const auto origin = _mm256_load_ps(origins.data() + first);
+            const auto inverseDirection = _mm256_load_ps(inverseDirections.data() + first);
+            const auto t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boundsMin), origin), inverseDirection);
+            const auto t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boundsMax), origin), inverseDirection);
+            slabEntry = _mm256_min_ps(t0, t1);
+            slabExit = _mm256_max_ps(t0, t1);
+        };
+
+        __m256 entryX, exitX, entryY, exitY, entryZ, exitZ;
+        slab(bounds.Min.x, bounds.Max.x, packet.OriginX, packet.InverseDirectionX, entryX, exitX);
+        slab(bounds.Min.y, bounds.Max.y, packet.OriginY, packet.InverseDirectionY, entryY, exitY);
+        slab(bounds.Min.z, bounds.Max.z, packet.OriginZ, packet.InverseDirectionZ, entryZ, exitZ);
+
+        const auto entry = _mm256_max_ps(_mm256_max_ps(entryX, entryY), _mm256_max_ps(entryZ, _mm256_setzero_ps()));
+        const auto exit = _mm256_min_ps(_mm256_min_ps(exitX, exitY), exitZ);
+        const auto hits = _mm256_and_ps(_mm256_cmp_ps(entry, exit, _CMP_LE_OQ),
+            _mm256_cmp_ps(entry, _mm256_load_ps(packet.MaxDistance.data() + first), _CMP_LE_OQ));
+        hitMask |= static_cast<uint32_t>(_mm256_movemask_ps(hits)) << first;
+        _mm256_storeu_ps(entryDistances.data() + first, entry);
+#else
+        // Entry and exit distances of each ray through the slab of one axis
+        auto slab = [first](const float boundsMin, const float boundsMax, const std::array<float, RayPacket::MAX_RAY_COUNT>& origins,
+            const std::array<float, RayPacket::MAX_RAY_COUNT>& inverseDirections, __m128& slabEntry, __m128& slabExit)
+        {
+            const auto origin = _mm_load_ps(origins.data() + first);
+            const auto inverseDirection = _mm_load_ps(inverseDirections.data() + first);
+            const auto t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boundsMin), origin), inverseDirection);
+            const auto t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boundsMax), origin), inverseDirection);
+            slabEntry = _mm_min_ps(t0, t1);
+            slabExit = _mm_max_ps(t0, t1);
+        };
+
+        __m128 entryX, exitX, entryY, exitY, entryZ, exitZ;
+        slab(bounds.Min.x, bounds.Max.x, packet.OriginX, packet.InverseDirectionX, entryX, exitX);
+        slab(bounds.Min.y, bounds.Max.y, packet.OriginY, packet.InverseDirectionY, entryY, exitY);
+        slab(bounds.Min.z, bounds.Max.z, packet.OriginZ, packet.InverseDirectionZ, entryZ, exitZ);
+
+        const auto entry = _mm_max_ps(_mm_max_ps(entryX, entryY), _mm_max_ps(entryZ, _mm_setzero_ps()));
+        const auto exit = _mm_min_ps(_mm_min_ps(exitX, exitY), exitZ);
+        const auto hits = _mm_and_ps(_mm_cmple_ps(entry, exit), _mm_cmple_ps(entry, _mm_load_ps(packet.MaxDistance.data() + first)));
+        hitMask |= static_cast<uint32_t>(_mm_movemask_ps(hits)) << first;
+        _mm_storeu_ps(entryDistances.data() + first, entry);
+#endif
+    }
+
+    hitMask &= rayMask;
+#else
+    for (uint32_t ray = 0; ray < packet.Count; ++ray)
+    {
+        const glm::vec3 origin(packet.OriginX[ray], packet.OriginY[ray], packet.OriginZ[ray]);
+        const glm::vec3 inverseDirection(packet.InverseDirectionX[ray], packet.InverseDirectionY[ray], packet.InverseDirectionZ[ray]);
+        if (((rayMask >> ray) & 1) && IntersectRayBounds(origin, inverseDirection, bounds, packet.MaxDistance[ray], entryDistances[ray]))
+        {
+            hitMask |= 1u << ray;
+        }
+    }
+#endif
+
+    nearestEntryDistance = std::numeric_limits<float>::max();
+    for (uint32_t ray = 0; ray < packet.Count; ++ray)
+    {
+        if ((hitMask >> ray) & 1)
+        {
+            nearestEntryDistance = std::min(nearestEntryDistance, entryDistances[ray]);
+        }
+    }
+
+    return hitMask;
+}
+
+// Intersects a segment with a sphere the segment starts outside of. Writes the fraction of the segment it enters the sphere at
+static bool IntersectSegmentSphere(const glm::vec3& start, const glm::vec3& segment, const glm::vec3& center, const float radius, float& t)
+{
+    const auto offset = start - center;
+    const auto a = glm::dot(segment, segment);
+    const auto b = glm::dot(offset, segment);
+    const auto c = glm::dot(offset, offset) - (radius * radius);
+    const auto discriminant = (b * b) - (a * c);
+    if ((a == 0.0f) || (discriminant < 0.0f))
+    {
+        return false;
+    }
+
+    t = (-b - std::sqrt(discriminant)) / a;
+    return (t >= 0.0f) && (t <= 1.0f);
+}
+
+// Intersects a segment with a cylinder around an axis aligned box edge. The edge runs along an axis between the box's minimum and
+// maximum on that axis and passes through the corner on the other axes. Writes the fraction of the segment it enters the cylinder at
+static bool IntersectSegmentEdgeCylinder(const glm::vec3& start, const glm::vec3& segment, const glm::vec3& corner, const glm::length_t axis,
+    const float edgeMin, const float edgeMax, const float radius, float& t)
+{
+    // Intersect the segment with the circle around the edge in the plane of the other two axes
+    const auto i = (axis + 1) % 3;
+    const auto j = (axis + 2) % 3;
+    const glm::vec2 offset(start[i] - corner[i], start[j] - corner[j]);
+    const glm::vec2 direction(segment[i], segment[j]);
+    const auto a = glm::dot(direction, direction);
+    const auto b = glm::dot(offset, direction);
+    const auto c = glm::dot(offset, offset) - (radius * radius);
+    const auto discriminant = (b * b) - (a * c);
+    if ((a == 0.0f) || (discriminant < 0.0f))
+    {
+        return false;
+    }
+
+    t = (-b - std::sqrt(discriminant)) / a;
+    if ((t < 0.0f) || (t > 1.0f))
+    {
+        return false;
+    }
+
+    // The cylinder ends at the box's corners
+    const auto position = start[axis] + (segment[axis] * t);
+    return (position >= edgeMin) && (position <= edgeMax);
+}
+
+bool CollisionDetection::SweepSphereAABB(const glm::vec3& spherePosition, const float sphereRadius, const glm::vec3& displacement,
+    const glm::vec3& aabbPosition, const glm::vec3& aabbExtent, float& timeOfImpact, glm::vec3& hitSurfaceNormal)
+{
+    const auto boxMin = aabbPosition - aabbExtent;
+    const auto boxMax = aabbPosition + aabbExtent;
+
+    // Check if the sphere already touches the box
+    const auto startDelta = spherePosition - glm::clamp(spherePosition, boxMin, boxMax);
+    const auto startDistanceSquared = glm::dot(startDelta, startDelta);
+    if (startDistanceSquared < (sphereRadius * sphereRadius))
+    {
+        if (startDistanceSquared > 0.0f)
+        {
+            hitSurfaceNormal = startDelta / std::sqrt(startDistanceSquared);
+        }
+        else
+        {
+            // Push centers inside the box out through the nearest face
+            const auto toMin = spherePosition - boxMin;
+            const auto toMax = boxMax - spherePosition;
+            glm::length_t axis{ 0 };
+            auto penetration = std::min(toMin.x, toMax.x);
+            for (glm::length_t i = 1; i < 3; ++i)
+            {
+                if (std::min(toMin[i], toMax[i]) < penetration)
+                {
+                    penetration = std::min(toMin[i], toMax[i]);
+                    axis = i;
+                }
+            }
+
+            hitSurfaceNormal = glm::vec3(0.0f);
+            hitSurfaceNormal[axis] = (toMin[axis] < toMax[axis]) ? -1.0f : 1.0f;
+        }
+
+        timeOfImpact = 0.0f;
+        return glm::dot(displacement, hitSurfaceNormal) < 0.0f;
+    }
+
+    // The sphere's center hits the box grown by the sphere's radius, with rounded edges and corners. Sweep the center against the
+    // grown box first and only test the rounded parts when the center enters the box's edge or corner regions
+    float entry{ 0.0f };
+    const Bounds grownBounds{ boxMin - sphereRadius, boxMax + sphereRadius };
+    if (!IntersectRayBounds(spherePosition, CalculateInverseDirection(displacement), grownBounds, 1.0f, entry))
+    {
+        return false;
+    }
+
+    const auto entryPosition = spherePosition + (displacement * entry);
+    glm::vec3 corner{};
+    std::array<bool, 3> outside{};
+    uint32_t outsideCount{ 0 };
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        outside[axis] = (entryPosition[axis] < boxMin[axis]) || (entryPosition[axis] > boxMax[axis]);
+        corner[axis] = (entryPosition[axis] < aabbPosition[axis]) ? boxMin[axis] : boxMax[axis];
+        outsideCount += outside[axis] ? 1 : 0;
+    }
+
+    timeOfImpact = entry;
+    if (outsideCount > 1)
+    {
+        // Find the first edge cylinder or corner sphere hit. Edge regions are bounded by the edge and the corners at its ends and
+        // corner regions by the corner and the three edges meeting at it
+        auto hit = false;
+        timeOfImpact = std::numeric_limits<float>::max();
+        auto testCorner = [&](const glm::vec3& cornerPosition)
+        {
+            float t{ 0.0f };
+            if (IntersectSegmentSphere(spherePosition, displacement, cornerPosition, sphereRadius, t) && (t < timeOfImpact))
+            {
+                timeOfImpact = t;
+                hit = true;
+            }
+        };
+
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            float t{ 0.0f };
+            if (((outsideCount == 3) || !outside[axis]) &&
+                IntersectSegmentEdgeCylinder(spherePosition, displacement, corner, axis, boxMin[axis], boxMax[axis], sphereRadius, t) &&
+                (t < timeOfImpact))
+            {
+                timeOfImpact = t;
+                hit = true;
+            }
+
+            if ((outsideCount == 2) && !outside[axis])
+            {
+                auto edgeStart = corner;
+                auto edgeEnd = corner;
+                edgeStart[axis] = boxMin[axis];
+                edgeEnd[axis] = boxMax[axis];
+                testCorner(edgeStart);
+                testCorner(edgeEnd);
+            }
+        }
+
+        if (outsideCount == 3)
+        {
+            testCorner(corner);
+        }
+
+        if (!hit)
+        {
+            return false;
+        }
+    }
+
+    // Push out along the direction from the closest point on the box to the sphere's center where they touch
+    const auto hitPosition = spherePosition + (displacement * timeOfImpact);
+    const auto hitDelta = hitPosition - glm::clamp(hitPosition, boxMin, boxMax);
+    const auto hitDistance = glm::length(hitDelta);
+    hitSurfaceNormal = (hitDistance > 0.0f) ? (hitDelta / hitDistance) : -glm::normalize(displacement);
+
+    return true;
+}
+
+bool CollisionDetection::TestRayAABB(const Ray& ray, const glm::vec3& aabbPosition, const glm::vec3& aabbExtent, RaycastHit& hit)
+{
+    const auto inverseDirection = CalculateInverseDirection(ray.Direction);
+    const auto t0 = ((aabbPosition - aabbExtent) - ray.Origin) * inverseDirection;
+    const auto t1 = ((aabbPosition + aabbExtent) - ray.Origin) * inverseDirection;
+    const auto tMin = glm::min(t0, t1);
+    const auto tMax = glm::max(t0, t1);
+
+    // The ray enters the box through the face of the axis it crosses last
+    glm::length_t entryAxis{ 0 };
+    for (glm::length_t axis = 1; axis < 3; ++axis)
+    {
+        if (tMin[axis] > tMin[entryAxis])
+        {
+            entryAxis = axis;
+        }
+    }
+
+    const auto entry = tMin[entryAxis];
+    const auto exit = std::min(std::min(tMax.x, tMax.y), tMax.z);
+    if ((entry > exit) || (exit < 0.0f) || (entry > ray.Length))
+    {
+        return false;
+    }
+
+    // Rays starting inside the box hit it where they start, facing back along the ray
+    if (entry < 0.0f)
+    {
+        hit.Distance = 0.0f;
+        hit.Position = ray.Origin;
+        hit.SurfaceNormal = -ray.Direction;
+        return true;
+    }
+
+    hit.Distance = entry;
+    hit.Position = ray.Origin + (ray.Direction * entry);
+    hit.SurfaceNormal = glm::vec3(0.0f);
+    hit.SurfaceNormal[entryAxis] = (ray.Direction[entryAxis] > 0.0f) ? -1.0f : 1.0f;
+    return true;
+}
+
+// Returns the AABB collision rays test an entity found by the broadphase against, or null when the filter ignores the entity
+static const AABBCollisionComponent* GetRaycastCollision(const entt::registry& registry, const CollisionDetection::RaycastFilter& filter,
+    const entt::entity entity)
+{
+    if (entity == filter.IgnoredEntity)
+    {
+        return nullptr;
+    }
+
+    // The broadphase has already filtered the entity's layer
+    return registry.try_get<AABBCollisionComponent>(entity);
+}
+
+// Tests the ray against an entity found by the broadphase when the filter does not ignore it
+static bool TestRaycastEntity(const entt::registry& registry, const CollisionDetection::Ray& ray,
+    const CollisionDetection::RaycastFilter& filter, const entt::entity entity, CollisionDetection::RaycastHit& hit)
+{
+    const auto* pAABB = GetRaycastCollision(registry, filter, entity);
+    if ((pAABB == nullptr) ||
+        !CollisionDetection::TestRayAABB(ray, registry.get<TransformComponent>(entity).Transform.Position, pAABB->Extent, hit))
+    {
+        return false;
+    }
+
+    hit.Entity = entity;
+    return true;
+}
+
+bool CollisionDetection::RaycastClosest(const Level& level, const Ray& ray, const RaycastFilter& filter, RaycastHit& hit)
+{
+    const auto& registry = level.GetECSRegistry();
+
+    bool hitFound{ false };
+    level.GetCollisionBroadphase().Raycast(ray, CollisionQueryFilter{ filter.Layers }, [&](const entt::entity entity, const float maxDistance)
+        {
+            RaycastHit entityHit{};
+            if (!TestRaycastEntity(registry, ray, filter, entity, entityHit) || (entityHit.Distance > maxDistance))
+            {
+                return maxDistance;
+            }
+
+            // Clip the ray to the hit so only closer colliders are tested
+            hit = entityHit;
+            hitFound = true;
+            return entityHit.Distance;
+        });
+
+    return hitFound;
+}
+
+bool CollisionDetection::RaycastAny(const Level& level, const Ray& ray, const RaycastFilter& filter, RaycastHit& hit)
+{
+    const auto& registry = level.GetECSRegistry();
+
+    bool hitFound{ false };
+    level.GetCollisionBroadphase().Raycast(ray, CollisionQueryFilter{ filter.Layers }, [&](const entt::entity entity, const float maxDistance)
+        {
+            if (!TestRaycastEntity(registry, ray, filter, entity, hit))
+            {
+                return maxDistance;
+            }
+
+            hitFound = true;
+            return -1.0f;
+        });
+
+    return hitFound;
+}
+
+uint32_t CollisionDetection::RaycastAll(const Level& level, const Ray& ray, const RaycastFilter& filter, std::vector<RaycastHit>& hits)
+{
+    const auto& registry = level.GetECSRegistry();
+
+    hits.clear();
+    level.GetCollisionBroadphase().Raycast(ray, CollisionQueryFilter{ filter.Layers }, [&](const entt::entity entity, const float maxDistance)
+        {
+            RaycastHit entityHit{};
+            if (TestRaycastEntity(registry, ray, filter, entity, entityHit))
+            {
+                hits.push_back(entityHit);
+            }
+
+            return maxDistance;
+        });
+
+    std::sort(hits.begin(), hits.end(), [](const RaycastHit& lhs, const RaycastHit& rhs) { return lhs.Distance < rhs.Distance; });
+
+    return static_cast<uint32_t>(hits.size());
+}
+
+uint32_t CollisionDetection::RaycastClosestPacket(const Level& level, const std::vector<Ray>& rays, const RaycastFilter& filter,
+    std::vector<RaycastHit>& hits)
+{
+    const auto& registry = level.GetECSRegistry();
+
+    hits.assign(rays.size(), RaycastHit{});
+    uint32_t hitCount{ 0 };
+
+    // Cast the rays a packet at a time
+    RayPacket packet{};
+    for (size_t first = 0; first < rays.size(); first += RayPacket::MAX_RAY_COUNT)
+    {
+        packet.Clear();
+        const auto rayCount = std::min(rays.size() - first, static_cast<size_t>(RayPacket::MAX_RAY_COUNT));
+        for (size_t i = 0; i < rayCount; ++i)
+        {
+            packet.Add(rays[first + i]);
+        }
+
+        level.GetCollisionBroadphase().RaycastPacket(packet, CollisionQueryFilter{ filter.Layers }, [&](const entt::entity entity, const uint32_t rayMask)
+            {
+                const auto* pAABB = GetRaycastCollision(registry, filter, entity);
+                if (pAABB == nullptr)
+                {
+                    return;
+                }
+
+                const auto& position = registry.get<TransformComponent>(entity).Transform.Position;
+                for (uint32_t ray = 0; ray < packet.Count; ++ray)
+                {
+                    RaycastHit hit{};
+                    if (((rayMask >> ray) & 1) && TestRayAABB(rays[first + ray], position, pAABB->Extent, hit) &&
+                        (hit.Distance <= packet.MaxDistance[ray]))
+                    {
+                        // Clip the ray to the hit so only closer colliders are tested
+                        hit.Entity = entity;
+                        hits[first + ray] = hit;
+                        packet.MaxDistance[ray] = hit.Distance;
+                    }
+                }
+            });
+    }
+
+    for (const auto& hit : hits)
+    {
+        if (hit.Entity != entt::null)
+        {
+            ++hitCount;
+        }
+    }
+
+    return hitCount;
+}
+
+void CollisionDetection::AABBBatch::Add(const glm::vec3& center, const glm::vec3& extent)
+{
+    if (Count == CenterX.size())
+    {
+        const auto paddedCount = CenterX.size() + AABB_BATCH_PADDING;
+        for (auto* pArray : { &CenterX, &CenterY, &CenterZ, &ExtentX, &ExtentY, &ExtentZ })
+        {
+            pArray->resize(paddedCount, 0.0f);
+        }
+    }
+
+    CenterX[Count] = center.x;
+    CenterY[Count] = center.y;
+    CenterZ[Count] = center.z;
+    ExtentX[Count] = extent.x;
+    ExtentY[Count] = extent.y;
+    ExtentZ[Count] = extent.z;
+    ++Count;
+}
+
+uint32_t CollisionDetection::TestSphereAABBBatch(const glm::vec3& spherePosition, const float sphereRadius, const AABBBatch& boxes,
+    std::vector<uint32_t>& hitMasks, std::vector<glm::vec3>& hitSurfaceNormals)
+{
+    hitMasks.assign((boxes.Count + HIT_MASK_BIT_COUNT - 1) / HIT_MASK_BIT_COUNT, 0);
+    hitSurfaceNormals.resize(boxes.Count);
+
+    const auto radiusSquared = sphereRadius * sphereRadius;
+    uint32_t hitCount{ 0 };
+    uint32_t i{ 0 };
+
+#ifdef COLLISION_DETECTION_SIMD
+    // Lane groups never straddle a hit mask
+    for (; i < boxes.Count; i += SIMD_LANE_COUNT)
+    {
+        SimdLaneNormals normals{};
+        const auto validLaneCount = std::min(boxes.Count - i, SIMD_LANE_COUNT);
+        const auto hits = TestSphereAABBBatchLanes(spherePosition, radiusSquared, boxes, i, normals) & ((1u << validLaneCount) - 1);
+        if (hits == 0)
+        {
+            continue;
+        }
+
+        hitMasks[i / HIT_MASK_BIT_COUNT] |= hits << (i % HIT_MASK_BIT_COUNT);
+        for (uint32_t lane = 0; lane < validLaneCount; ++lane)
+        {
+            if (hits & (1u << lane))
+            {
+                hitSurfaceNormals[i + lane] = { normals[0][lane], normals[1][lane], normals[2][lane] };
+                ++hitCount;
+            }
+        }
+    }
+#endif // COLLISION_DETECTION_SIMD
+
+    // Test the remaining boxes one at a time when SIMD is unavailable
+    for (; i < boxes.Count; ++i)
+    {
+        if (TestSphereAABBBatchLane(spherePosition, radiusSquared, boxes, i, hitSurfaceNormals[i]))
+        {
+            hitMasks[i / HIT_MASK_BIT_COUNT] |= 1u << (i % HIT_MASK_BIT_COUNT);
+            ++hitCount;
+        }
+    }
+
+    return hitCount;
+}
+
+void CollisionDetection::RunSphereAABBBenchmark()
+{
+    constexpr uint32_t boxCount{ 4096 };
+    constexpr uint32_t sphereCount{ 1024 };
+    constexpr float sphereRadius{ 0.5f };
+
+    // Scatter boxes the size of walls and props through a level sized volume
+    std::vector<glm::vec3> boxPositions(boxCount);
+    std::vector<AABBCollisionComponent> boxComponents(boxCount);
+    AABBBatch batch{};
+    for (uint32_t i = 0; i < boxCount; ++i)
+    {
+        boxPositions[i] = glm::linearRand(glm::vec3(-50.0f, -2.0f, -50.0f), glm::vec3(50.0f, 2.0f, 50.0f));
+        boxComponents[i].Extent = glm::linearRand(glm::vec3(0.2f), glm::vec3(4.0f));
+        batch.Add(boxPositions[i], boxComponents[i].Extent);
+    }
+
+    std::vector<glm::vec3> spherePositions(sphereCount);
+    for (auto& spherePosition : spherePositions)
+    {
+        spherePosition = glm::linearRand(glm::vec3(-50.0f, -2.0f, -50.0f), glm::vec3(50.0f, 2.0f, 50.0f));
+    }
+
+    using clock = std::chrono::high_resolution_clock;
+
+    // Test each pair one at a time
+    SphereCollisionComponent sphere{};
+    sphere.Radius = sphereRadius;
+    uint64_t scalarHitCount{ 0 };
+    const auto scalarStartTime = clock::now();
+    for (const auto& spherePosition : spherePositions)
+    {
+        for (uint32_t i = 0; i < boxCount; ++i)
+        {
+            CollisionTestResult result{};
+            scalarHitCount += TestSphereAABB(spherePosition, sphere, boxPositions[i], boxComponents[i], result) ? 1 : 0;
+        }
+    }
+    const std::chrono::duration<float, std::milli> scalarDuration = clock::now() - scalarStartTime;
+
+    // Test each sphere against the batch
+    std::vector<uint32_t> hitMasks;
+    std::vector<glm::vec3> hitSurfaceNormals;
+    uint64_t batchHitCount{ 0 };
+    const auto batchStartTime = clock::now();
+    for (const auto& spherePosition : spherePositions)
+    {
+        batchHitCount += TestSphereAABBBatch(spherePosition, sphereRadius, batch, hitMasks, hitSurfaceNormals);
+    }
+    const std::chrono::duration<float, std::milli> batchDuration = clock::now() - batchStartTime;
+
+    // Printed in every configuration as timings only mean something in release. Printing the hit counts also stops the timed loops
+    // being optimised away
+    std::cout << "Sphere AABB benchmark: " << sphereCount << " spheres against " << boxCount << " boxes\n";
+    std::cout << "  Scalar: " << scalarDuration.count() << "ms, " << scalarHitCount << " hits\n";
+    std::cout << "  Batched: " << batchDuration.count() << "ms, " << batchHitCount << " hits\n";
+}
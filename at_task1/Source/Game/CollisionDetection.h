@@ -1,10 +1,16 @@
 #pragma once
 
+#include "Game/CollisionFilter.h"
+
 struct SphereCollisionComponent;
 struct AABBCollisionComponent;
+class Level;
 
 namespace CollisionDetection
 {
+	// Boxes of a batch whose hits are recorded in each hit mask
+	constexpr uint32_t HIT_MASK_BIT_COUNT{ 32 };
+
 	struct CollisionTestResult
 	{
 		bool Hit{ false };
@@ -12,6 +18,107 @@ namespace CollisionDetection
 		glm::vec3 HitPosition{ 0.0f, 0.0f, 0.0f };
 	};
 
+	// Boxes stored as a structure of arrays so a sphere can be tested against several boxes per instruction. Arrays are padded to a
+	// whole number of the widest SIMD lanes
+	struct AABBBatch
+	{
+		std::vector<float> CenterX;
+		std::vector<float> CenterY;
+		std::vector<float> CenterZ;
+		std::vector<float> ExtentX;
+		std::vector<float> ExtentY;
+		std::vector<float> ExtentZ;
+		uint32_t Count{ 0 };
+
+		void Add(const glm::vec3& center, const glm::vec3& extent);
+		// Keeps the arrays' memory for the next boxes added
+		void Clear() { Count = 0; }
+	};
+
+	struct Ray
+	{
+		glm::vec3 Origin{ 0.0f, 0.0f, 0.0f };
+		// Must be normalized
+		glm::vec3 Direction{ 0.0f, 0.0f, 1.0f };
+		float Length{ std::numeric_limits<float>::max() };
+	};
+
+	struct RaycastHit
+	{
+		entt::entity Entity{ entt::null };
+		// Distance along the ray. Rays starting inside a collider hit it at a distance of zero
+		float Distance{ 0.0f };
+		glm::vec3 Position{ 0.0f, 0.0f, 0.0f };
+		glm::vec3 SurfaceNormal{ 0.0f, 0.0f, 0.0f };
+	};
+
+	// A bundle of rays traversed through the broadphase together, such as the pellets of a spread weapon. Each ray is stored in its own
+	// lane so a node's bounds are tested against every ray at once
+	struct RayPacket
+	{
+		static constexpr uint32_t MAX_RAY_COUNT{ 16 };
+
+		alignas(32) std::array<float, MAX_RAY_COUNT> OriginX{};
+		alignas(32) std::array<float, MAX_RAY_COUNT> OriginY{};
+		alignas(32) std::array<float, MAX_RAY_COUNT> OriginZ{};
+		alignas(32) std::array<float, MAX_RAY_COUNT> InverseDirectionX{};
+		alignas(32) std::array<float, MAX_RAY_COUNT> InverseDirectionY{};
+		alignas(32) std::array<float, MAX_RAY_COUNT> InverseDirectionZ{};
+		// Distance each ray is clipped to. Shortened as closer hits are found
+		alignas(32) std::array<float, MAX_RAY_COUNT> MaxDistance{};
+		uint32_t Count{ 0 };
+
+		void Add(const Ray& ray);
+		void Clear() { Count = 0; }
+		// A bit for each ray in the packet
+		uint32_t GetRayMask() const { return (1u << Count) - 1; }
+		// Removes the rays clipped before a distance from a mask
+		uint32_t ClipRayMask(const uint32_t rayMask, const float distance) const
+		{
+			auto clippedMask = rayMask;
+			for (uint32_t ray = 0; ray < Count; ++ray)
+			{
+				if (MaxDistance[ray] < distance)
+				{
+					clippedMask &= ~(1u << ray);
+				}
+			}
+			return clippedMask;
+		}
+	};
+
+	// Colliders rays hit
+	struct RaycastFilter
+	{
+		// Typically the entity casting the ray
+		entt::entity IgnoredEntity{ entt::null };
+		// Collisions on other layers are ignored
+		uint32_t Layers{ CollisionFilter::ALL_LAYERS };
+	};
+
+	// World space bounds of a collider used by the broadphase
+	struct Bounds
+	{
+		glm::vec3 Min{ 0.0f, 0.0f, 0.0f };
+		glm::vec3 Max{ 0.0f, 0.0f, 0.0f };
+	};
+
+	Bounds CalculateBounds(const glm::vec3& position, const glm::vec3& extent);
+	Bounds MergeBounds(const Bounds& lhs, const Bounds& rhs);
+	bool BoundsOverlap(const Bounds& lhs, const Bounds& rhs);
+	bool BoundsContain(const Bounds& outer, const Bounds& inner);
+	// Half the surface area of the bounds. Used to compare the cost of bounding volume hierarchies
+	float CalculateBoundsCost(const Bounds& bounds);
+	// Reciprocal of each component of a ray's direction. Zero components are nudged so slab tests never divide by zero
+	glm::vec3 CalculateInverseDirection(const glm::vec3& direction);
+	// Slab test of a ray against bounds. The inverse direction is the reciprocal of each component of the ray's direction. Writes the
+	// distance the ray enters the bounds at, which is zero when the ray starts inside them
+	bool IntersectRayBounds(const glm::vec3& origin, const glm::vec3& inverseDirection, const Bounds& bounds, const float maxDistance,
+		float& entryDistance);
+	// Slab test of the rays of a packet in a mask against bounds. Returns a bit for each ray entering the bounds and writes the nearest
+	// distance any of them enters at
+	uint32_t IntersectRayPacketBounds(const RayPacket& packet, const uint32_t rayMask, const Bounds& bounds, float& nearestEntryDistance);
+
 	bool TestSphereAABB(const glm::vec3& spherePosition, const SphereCollisionComponent& sphere, 
 		const glm::vec3& aabbPosition, const AABBCollisionComponent& aabb, CollisionTestResult& result);
 	bool TestLineAABB(const glm::vec3& lineStart,
@@ -19,4 +126,28 @@ namespace CollisionDetection
 		const glm::vec3& aabbPosition,
 		const glm::vec3& aabbExtent,
 		CollisionDetection::CollisionTestResult& result);
+	// Sweeps a sphere along a displacement against an AABB. Writes the fraction of the displacement at which the sphere first touches
+	// the box and the surface normal pushing the sphere out of it. A sphere already touching a box hits it at zero unless moving away
+	bool SweepSphereAABB(const glm::vec3& spherePosition, const float sphereRadius, const glm::vec3& displacement,
+		const glm::vec3& aabbPosition, const glm::vec3& aabbExtent, float& timeOfImpact, glm::vec3& hitSurfaceNormal);
+	// Tests a sphere against every box in a batch. Sets a bit in the hit masks for each box hit, HIT_MASK_BIT_COUNT boxes to a mask,
+	// and writes the surface normal pushing the sphere out of each box hit. Normals are zero when the sphere's center is inside a box.
+	// Returns the number of boxes hit
+	uint32_t TestSphereAABBBatch(const glm::vec3& spherePosition, const float sphereRadius, const AABBBatch& boxes,
+		std::vector<uint32_t>& hitMasks, std::vector<glm::vec3>& hitSurfaceNormals);
+	// Times testing spheres against boxes one pair at a time and in batches, and prints the results to the console
+	void RunSphereAABBBenchmark();
+	bool TestRayAABB(const Ray& ray, const glm::vec3& aabbPosition, const glm::vec3& aabbExtent, RaycastHit& hit);
+
+	// Raycasts test the colliders of a level's broadphase nearest first and stop once no closer collider can be hit
+	// Finds the nearest collider along the ray
+	bool RaycastClosest(const Level& level, const Ray& ray, const RaycastFilter& filter, RaycastHit& hit);
+	// Stops at the first collider found along the ray, which is not necessarily the nearest
+	bool RaycastAny(const Level& level, const Ray& ray, const RaycastFilter& filter, RaycastHit& hit);
+	// Writes every collider along the ray sorted nearest first. Returns the number of hits
+	uint32_t RaycastAll(const Level& level, const Ray& ray, const RaycastFilter& filter, std::vector<RaycastHit>& hits);
+	// Finds the nearest collider along each ray, traversing the broadphase with packets of rays so the rays share the work of
+	// visiting each node. Coherent rays, like the pellets of one shot, share the most. Writes a hit for each ray, with a null entity
+	// for rays that hit nothing. Returns the number of rays that hit
+	uint32_t RaycastClosestPacket(const Level& level, const std::vector<Ray>& rays, const RaycastFilter& filter, std::vector<RaycastHit>& hits);
 }
\ No newline at end of file
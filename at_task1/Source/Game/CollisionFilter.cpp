@@ -0,0 +1,60 @@
+#include "Pch.h"
+#include "CollisionFilter.h"
+
+constexpr size_t LAYER_COUNT{ static_cast<size_t>(ECollisionLayer::COUNT) };
+
+// Layers each layer collides with. Kept symmetric
+static std::array<uint32_t, LAYER_COUNT> gLayerCollisionTable = []()
+{
+	std::array<uint32_t, LAYER_COUNT> table{};
+	auto collide = [&table](const ECollisionLayer lhs, const ECollisionLayer rhs)
+	{
+		table[static_cast<size_t>(lhs)] |= CollisionFilter::ToLayerBit(rhs);
+		table[static_cast<size_t>(rhs)] |= CollisionFilter::ToLayerBit(lhs);
+	};
+
+	collide(ECollisionLayer::WORLD, ECollisionLayer::PLAYER);
+	collide(ECollisionLayer::WORLD, ECollisionLayer::ENEMY);
+	collide(ECollisionLayer::WORLD, ECollisionLayer::PROP);
+	collide(ECollisionLayer::FLOOR, ECollisionLayer::PLAYER);
+	collide(ECollisionLayer::FLOOR, ECollisionLayer::ENEMY);
+	collide(ECollisionLayer::PROP_FLOOR, ECollisionLayer::PROP);
+	collide(ECollisionLayer::PLAYER, ECollisionLayer::PROP);
+	collide(ECollisionLayer::PLAYER, ECollisionLayer::INTERACTABLE);
+	collide(ECollisionLayer::PLAYER, ECollisionLayer::TRIGGER);
+	collide(ECollisionLayer::ENEMY, ECollisionLayer::PROP);
+	collide(ECollisionLayer::PROP, ECollisionLayer::PROP);
+	collide(ECollisionLayer::PROP, ECollisionLayer::INTERACTABLE);
+
+	return table;
+}();
+
+void CollisionFilter::SetLayersCollide(const ECollisionLayer lhs, const ECollisionLayer rhs, const bool collide)
+{
+	auto& lhsLayers = gLayerCollisionTable[static_cast<size_t>(lhs)];
+	auto& rhsLayers = gLayerCollisionTable[static_cast<size_t>(rhs)];
+	if (collide)
+	{
+		lhsLayers |= ToLayerBit(rhs);
+		rhsLayers |= ToLayerBit(lhs);
+	}
+	else
+	{
+		lhsLayers &= ~ToLayerBit(rhs);
+		rhsLayers &= ~ToLayerBit(lhs);
+	}
+}
+
+uint32_t CollisionFilter::GetCollidingLayers(const uint32_t layers)
+{
+	uint32_t collidingLayers{ 0 };
+	for (size_t layer = 0; layer < LAYER_COUNT; ++layer)
+	{
+		if (layers & (1u << layer))
+		{
+			collidingLayers |= gLayerCollisionTable[layer];
+		}
+	}
+
+	return collidingLayers;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Categories of collision. Each collision belongs to one layer
+enum class ECollisionLayer : uint32_t
+{
+	WORLD,
+	// Floor collision the player walks on. It rises above the floor mesh to hold the player's view at eye height, so shots pass
+	// through it
+	FLOOR,
+	// Floor collision at the floor mesh that only props rest on
+	PROP_FLOOR,
+	PLAYER,
+	ENEMY,
+	PROP,
+	// Solid collisions the player interacts with, like the level goal
+	INTERACTABLE,
+	// Volumes that are only overlapped and never block
+	TRIGGER,
+	COUNT
+};
+
+namespace CollisionFilter
+{
+	constexpr uint32_t ToLayerBit(const ECollisionLayer layer) { return 1u << static_cast<uint32_t>(layer); }
+	constexpr uint32_t ALL_LAYERS{ (1u << static_cast<uint32_t>(ECollisionLayer::COUNT)) - 1 };
+	// Collisions on no layer collide with nothing and are never hit by rays
+	constexpr uint32_t NO_LAYERS{ 0 };
+
+	// The pair table decides which layers collide. Changing a pair applies to both of its layers
+	void SetLayersCollide(const ECollisionLayer lhs, const ECollisionLayer rhs, const bool collide);
+	// Returns the layers colliding with any of the layers
+	uint32_t GetCollidingLayers(const uint32_t layers);
+}
+
+// What a broadphase query finds. Proxies pass when their layer is one of the query's layers and their mask contains the query's layer
+struct CollisionQueryFilter
+{
+	uint32_t Layers{ CollisionFilter::ALL_LAYERS };
+	// Queries without a layer of their own, like raycasts, pass every proxy mask
+	uint32_t Layer{ CollisionFilter::ALL_LAYERS };
+
+	// Filter for a collision on a layer with a mask, limited to the layers the pair table lets its layer collide with
+	static CollisionQueryFilter ForCollision(const uint32_t layer, const uint32_t mask)
+	{
+		return { mask & CollisionFilter::GetCollidingLayers(layer), layer };
+	}
+
+	bool Passes(const uint32_t proxyLayer, const uint32_t proxyMask) const
+	{
+		return ((proxyLayer & Layers) != 0) && ((proxyMask & Layer) != 0);
+	}
+};
\ No newline at end of file
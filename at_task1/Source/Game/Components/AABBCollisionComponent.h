@@ -1,8 +1,12 @@
 #pragma once
 
+#include "Game/CollisionFilter.h"
+
 struct AABBCollisionComponent
 {
-	bool CollisionEnabled{ true };
-	bool CanCollideWithSphereCollisions{ true };
+	// Bit of the layer the collision is on. The broadphase must be refreshed after the layer or mask of a loaded collision changes
+	uint32_t CollisionLayer{ CollisionFilter::ToLayerBit(ECollisionLayer::WORLD) };
+	// Layers the collision collides with
+	uint32_t CollisionMask{ CollisionFilter::ALL_LAYERS };
 	glm::vec3 Extent{ 1.0f, 1.0f, 1.0f };
 };
\ No newline at end of file
@@ -5,7 +5,8 @@ struct EnemyAIComponent
 	bool Active{ true };
 	bool FirstAttack{ true };
 	float AttackRadius{ 1.0f };
-	std::chrono::high_resolution_clock::time_point LastAttackTime{};
+	// Milliseconds of simulated time since the enemy last attacked. Counted in fixed steps so attacks replay the same way
+	float TimeSinceLastAttack{ 0.0f };
 	float AttackRateSeconds{ 1.25f };
 	float AttackDamage{ 33.3f };
 };
\ No newline at end of file
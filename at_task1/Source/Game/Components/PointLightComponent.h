@@ -0,0 +1,9 @@
+#pragma once
+
+struct PointLightComponent
+{
+	bool Enabled{ true };
+	glm::vec3 Color{ 1.0f, 1.0f, 1.0f };
+	float Intensity{ 1.0f };
+	float Radius{ 5.0f };
+};
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Maths/Transform.h"
+
+// Transform of an entity before the latest fixed step. Rendering blends from it to the entity's transform
+struct PreviousTransformComponent
+{
+	Maths::Transform Transform{};
+};
\ No newline at end of file
@@ -1,7 +1,32 @@
 #pragma once
 
+// Shapes the inertia of dynamic rigid bodies is calculated from. Cylinders stand along the world up axis
+enum class ERigidBodyShape : uint8_t
+{
+	BOX,
+	CYLINDER,
+	SPHERE
+};
+
 struct RigidBodyComponent
 {
 	bool ApplyGravity{ true };
+	// Units per millisecond
 	glm::vec3 Velocity{ 0.0f, 0.0f, 0.0f };
+
+	// Dynamic bodies are moved by the contact solver. Other rigid bodies move by their velocity and slide along what they hit, pushing
+	// dynamic bodies without being pushed back
+	bool Dynamic{ false };
+	float Mass{ 1.0f };
+	// Fraction of the speed a dynamic body hits something at that it bounces away with
+	float Restitution{ 0.0f };
+	float Friction{ 0.5f };
+	// Radians per millisecond about each world axis. AABB collisions never rotate, so bodies colliding as AABBs only turn about axes
+	// their shape looks the same from as it turns
+	glm::vec3 AngularVelocity{ 0.0f, 0.0f, 0.0f };
+	ERigidBodyShape Shape{ ERigidBodyShape::BOX };
+	// Sleeping bodies are not simulated until a moving body touches them or their island
+	bool Asleep{ false };
+	// Milliseconds the body has moved slower than the sleep speeds
+	float RestingTime{ 0.0f };
 };
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
-#include "Renderer/Material.h"
-
 struct StaticMeshComponent
 {
 	bool Visible{ true };
+	// Static meshes never move after their level loads. The renderer merges them by material and records them once when the level loads
+	bool Static{ false };
 	uint32_t GeometryID{ std::numeric_limits<uint32_t>::max() };
-	Renderer::Material Material{};
+	// ID of a material registered with the renderer
+	uint32_t MaterialID{ std::numeric_limits<uint32_t>::max() };
+	// Offsets the material's flipbook animation by a fraction of its cycle so meshes sharing the material animate out of step
+	float FlipbookPhase{ 0.0f };
 };
\ No newline at end of file
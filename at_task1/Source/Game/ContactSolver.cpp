@@ -0,0 +1,274 @@
+#include "Pch.h"
+#include "ContactSolver.h"
+
+// Times every contact is solved in a step. More iterations let impulses travel further through stacks of bodies
+constexpr uint32_t SOLVER_ITERATION_COUNT{ 10 };
+// Overlap left between bodies so resting contacts stay touching instead of jittering between touching and separated
+constexpr float PENETRATION_SLOP{ 0.005f };
+// Fraction of the overlap beyond the slop removed each step
+constexpr float POSITION_CORRECTION_FACTOR{ 0.2f };
+// Units per millisecond overlapping bodies are pushed apart at most so deep overlaps do not launch bodies
+constexpr float MAX_POSITION_CORRECTION_SPEED{ 0.001f };
+// Bodies approaching slower than this many units per millisecond do not bounce so resting bodies settle
+constexpr float RESTITUTION_VELOCITY_THRESHOLD{ 0.001f };
+
+// A contact point prepared for solving
+struct SolverContact
+{
+	glm::vec3 Offset1{ 0.0f, 0.0f, 0.0f };
+	glm::vec3 Offset2{ 0.0f, 0.0f, 0.0f };
+	float NormalMass{ 0.0f };
+	std::array<float, 2> TangentMasses{};
+	// Normal velocity the contact separates at. Negative when the bodies may close a gap between them
+	float TargetNormalVelocity{ 0.0f };
+	float NormalImpulse{ 0.0f };
+	std::array<float, 2> TangentImpulses{};
+};
+
+// Reused between solves to keep their memory
+static std::vector<SolverContact> gSolverContacts;
+
+static void CalculateTangents(const glm::vec3& normal, glm::vec3& tangent1, glm::vec3& tangent2)
+{
+	// Cross with the world axis least aligned with the normal
+	const auto absoluteNormal = glm::abs(normal);
+	const glm::vec3 axis = (absoluteNormal.x < absoluteNormal.y) ?
+		((absoluteNormal.x < absoluteNormal.z) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f)) :
+		((absoluteNormal.y < absoluteNormal.z) ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f));
+	tangent1 = glm::normalize(glm::cross(normal, axis));
+	tangent2 = glm::cross(normal, tangent1);
+}
+
+// Returns the inverse of the mass a direction of impulse at the offsets moves the bodies with
+static float CalculateEffectiveMass(const ContactSolver::Body* pBody1, const ContactSolver::Body* pBody2, const glm::vec3& offset1,
+	const glm::vec3& offset2, const glm::vec3& direction)
+{
+	float inverseMass{ 0.0f };
+	if (pBody1 != nullptr)
+	{
+		const auto angular = glm::cross(offset1, direction);
+		inverseMass += pBody1->InverseMass + glm::dot(angular, pBody1->InverseInertia * angular);
+	}
+	if (pBody2 != nullptr)
+	{
+		const auto angular = glm::cross(offset2, direction);
+		inverseMass += pBody2->InverseMass + glm::dot(angular, pBody2->InverseInertia * angular);
+	}
+
+	return (inverseMass > 0.0f) ? (1.0f / inverseMass) : 0.0f;
+}
+
+static glm::vec3 CalculateRelativeVelocity(const ContactSolver::Body* pBody1, const ContactSolver::Body* pBody2, const glm::vec3& offset1,
+	const glm::vec3& offset2)
+{
+	glm::vec3 velocity{ 0.0f, 0.0f, 0.0f };
+	if (pBody1 != nullptr)
+	{
+		velocity += pBody1->LinearVelocity + glm::cross(pBody1->AngularVelocity, offset1);
+	}
+	if (pBody2 != nullptr)
+	{
+		velocity -= pBody2->LinearVelocity + glm::cross(pBody2->AngularVelocity, offset2);
+	}
+
+	return velocity;
+}
+
+static void ApplyImpulse(ContactSolver::Body* pBody1, ContactSolver::Body* pBody2, const glm::vec3& offset1, const glm::vec3& offset2,
+	const glm::vec3& impulse)
+{
+	if (pBody1 != nullptr)
+	{
+		pBody1->LinearVelocity += impulse * pBody1->InverseMass;
+		pBody1->AngularVelocity += pBody1->InverseInertia * glm::cross(offset1, impulse);
+	}
+	if (pBody2 != nullptr)
+	{
+		pBody2->LinearVelocity -= impulse * pBody2->InverseMass;
+		pBody2->AngularVelocity -= pBody2->InverseInertia * glm::cross(offset2, impulse);
+	}
+}
+
+bool ContactSolver::CollideAABBs(const glm::vec3& position1, const glm::vec3& extent1, const glm::vec3& position2, const glm::vec3& extent2,
+	const float margin, ContactManifold& manifold)
+{
+	// Overlap along each axis. Negative where the boxes are apart
+	const auto offset = position1 - position2;
+	const auto overlap = (extent1 + extent2) - glm::abs(offset);
+	if ((overlap.x < -margin) || (overlap.y < -margin) || (overlap.z < -margin))
+	{
+		return false;
+	}
+
+	// Push the boxes apart along the axis they overlap least on
+	glm::length_t axis{ 0 };
+	if (overlap.y < overlap[axis])
+	{
+		axis = 1;
+	}
+	if (overlap.z < overlap[axis])
+	{
+		axis = 2;
+	}
+
+	const auto direction = (offset[axis] < 0.0f) ? -1.0f : 1.0f;
+	manifold.Normal = glm::vec3(0.0f);
+	manifold.Normal[axis] = direction;
+
+	// Place a point at each corner of the area the boxes' touching faces share, midway between the faces
+	const auto minimum = glm::max(position1 - extent1, position2 - extent2);
+	const auto maximum = glm::min(position1 + extent1, position2 + extent2);
+	const auto faceCoordinate = ((position1[axis] - (extent1[axis] * direction)) + (position2[axis] + (extent2[axis] * direction))) * 0.5f;
+	const auto tangentAxis1 = (axis + 1) % 3;
+	const auto tangentAxis2 = (axis + 2) % 3;
+	manifold.PointCount = MAX_CONTACT_POINTS;
+	for (uint32_t i = 0; i < MAX_CONTACT_POINTS; ++i)
+	{
+		auto& point = manifold.Points[i];
+		point[axis] = faceCoordinate;
+		point[tangentAxis1] = (i & 1) ? maximum[tangentAxis1] : minimum[tangentAxis1];
+		point[tangentAxis2] = (i & 2) ? maximum[tangentAxis2] : minimum[tangentAxis2];
+		manifold.Separations[i] = -overlap[axis];
+	}
+
+	return true;
+}
+
+bool ContactSolver::CollideSphereAABB(const glm::vec3& spherePosition, const float radius, const glm::vec3& aabbPosition,
+	const glm::vec3& aabbExtent, const float margin, ContactManifold& manifold)
+{
+	const auto closestPoint = glm::clamp(spherePosition, aabbPosition - aabbExtent, aabbPosition + aabbExtent);
+	const auto offset = spherePosition - closestPoint;
+	const auto distance = glm::length(offset);
+	if (distance > (radius + margin))
+	{
+		return false;
+	}
+
+	manifold.PointCount = 1;
+	if (distance > 0.0f)
+	{
+		manifold.Normal = offset / distance;
+		manifold.Points[0] = closestPoint;
+		manifold.Separations[0] = distance - radius;
+		return true;
+	}
+
+	// Spheres centred inside the box are pushed out through the nearest face
+	const auto centerOffset = spherePosition - aabbPosition;
+	const auto faceDistances = aabbExtent - glm::abs(centerOffset);
+	glm::length_t axis{ 0 };
+	if (faceDistances.y < faceDistances[axis])
+	{
+		axis = 1;
+	}
+	if (faceDistances.z < faceDistances[axis])
+	{
+		axis = 2;
+	}
+
+	manifold.Normal = glm::vec3(0.0f);
+	manifold.Normal[axis] = (centerOffset[axis] < 0.0f) ? -1.0f : 1.0f;
+	manifold.Points[0] = spherePosition;
+	manifold.Separations[0] = -(faceDistances[axis] + radius);
+	return true;
+}
+
+bool ContactSolver::CollideSpheres(const glm::vec3& position1, const float radius1, const glm::vec3& position2, const float radius2,
+	const float margin, ContactManifold& manifold)
+{
+	const auto offset = position1 - position2;
+	const auto distance = glm::length(offset);
+	if (distance > (radius1 + radius2 + margin))
+	{
+		return false;
+	}
+
+	// Spheres at the same position are pushed apart along an arbitrary axis
+	manifold.Normal = (distance > 0.0f) ? (offset / distance) : glm::vec3(0.0f, 1.0f, 0.0f);
+	manifold.PointCount = 1;
+	manifold.Points[0] = position2 + (manifold.Normal * (radius2 + ((distance - radius1 - radius2) * 0.5f)));
+	manifold.Separations[0] = distance - radius1 - radius2;
+	return true;
+}
+
+void ContactSolver::Solve(std::vector<Body>& bodies, const std::vector<ContactManifold>& manifolds, const float deltaTime)
+{
+	auto getBody = [&bodies](const uint32_t body) { return (body == STATIC_BODY) ? nullptr : &bodies[body]; };
+
+	// Prepare each contact point. Contacts are stored in manifold order
+	gSolverContacts.clear();
+	for (const auto& manifold : manifolds)
+	{
+		const auto* pBody1 = getBody(manifold.Body1);
+		const auto* pBody2 = getBody(manifold.Body2);
+		glm::vec3 tangent1{}, tangent2{};
+		CalculateTangents(manifold.Normal, tangent1, tangent2);
+
+		for (uint32_t i = 0; i < manifold.PointCount; ++i)
+		{
+			auto& contact = gSolverContacts.emplace_back();
+			contact.Offset1 = (pBody1 != nullptr) ? (manifold.Points[i] - pBody1->Position) : glm::vec3(0.0f);
+			contact.Offset2 = (pBody2 != nullptr) ? (manifold.Points[i] - pBody2->Position) : glm::vec3(0.0f);
+			contact.NormalMass = CalculateEffectiveMass(pBody1, pBody2, contact.Offset1, contact.Offset2, manifold.Normal);
+			contact.TangentMasses[0] = CalculateEffectiveMass(pBody1, pBody2, contact.Offset1, contact.Offset2, tangent1);
+			contact.TangentMasses[1] = CalculateEffectiveMass(pBody1, pBody2, contact.Offset1, contact.Offset2, tangent2);
+
+			// Bodies apart may close the gap over the step. Overlapping bodies are pushed apart by part of their overlap
+			const auto separation = manifold.Separations[i];
+			contact.TargetNormalVelocity = (separation > 0.0f) ?
+				(-separation / deltaTime) :
+				std::min((POSITION_CORRECTION_FACTOR * std::max(-separation - PENETRATION_SLOP, 0.0f)) / deltaTime, MAX_POSITION_CORRECTION_SPEED);
+
+			// Bounce bodies approaching fast enough
+			const auto normalVelocity = glm::dot(CalculateRelativeVelocity(pBody1, pBody2, contact.Offset1, contact.Offset2), manifold.Normal);
+			if (normalVelocity < -RESTITUTION_VELOCITY_THRESHOLD)
+			{
+				contact.TargetNormalVelocity = std::max(contact.TargetNormalVelocity, -manifold.Restitution * normalVelocity);
+			}
+		}
+	}
+
+	for (uint32_t iteration = 0; iteration < SOLVER_ITERATION_COUNT; ++iteration)
+	{
+		size_t contactIndex{ 0 };
+		for (const auto& manifold : manifolds)
+		{
+			auto* pBody1 = getBody(manifold.Body1);
+			auto* pBody2 = getBody(manifold.Body2);
+			glm::vec3 tangent1{}, tangent2{};
+			CalculateTangents(manifold.Normal, tangent1, tangent2);
+			const std::array<glm::vec3, 2> tangents{ tangent1, tangent2 };
+
+			// Friction opposes sliding, limited by how hard the bodies press together. The load is shared evenly between the points, as
+			// bodies that cannot tip can leave all of it on any one point, which then becomes a pivot the body spins around
+			float manifoldNormalImpulse{ 0.0f };
+			for (uint32_t i = 0; i < manifold.PointCount; ++i)
+			{
+				manifoldNormalImpulse += gSolverContacts[contactIndex + i].NormalImpulse;
+			}
+			const auto maxFrictionImpulse = (manifold.Friction * manifoldNormalImpulse) / static_cast<float>(manifold.PointCount);
+
+			for (uint32_t i = 0; i < manifold.PointCount; ++i)
+			{
+				auto& contact = gSolverContacts[contactIndex++];
+
+				for (size_t tangent = 0; tangent < tangents.size(); ++tangent)
+				{
+					const auto tangentVelocity = glm::dot(CalculateRelativeVelocity(pBody1, pBody2, contact.Offset1, contact.Offset2), tangents[tangent]);
+					const auto previousImpulse = contact.TangentImpulses[tangent];
+					contact.TangentImpulses[tangent] = glm::clamp(previousImpulse - (tangentVelocity * contact.TangentMasses[tangent]),
+						-maxFrictionImpulse, maxFrictionImpulse);
+					ApplyImpulse(pBody1, pBody2, contact.Offset1, contact.Offset2,
+						tangents[tangent] * (contact.TangentImpulses[tangent] - previousImpulse));
+				}
+
+				// Contacts only push. The total impulse over the iterations is kept positive
+				const auto normalVelocity = glm::dot(CalculateRelativeVelocity(pBody1, pBody2, contact.Offset1, contact.Offset2), manifold.Normal);
+				const auto previousImpulse = contact.NormalImpulse;
+				contact.NormalImpulse = std::max(previousImpulse + ((contact.TargetNormalVelocity - normalVelocity) * contact.NormalMass), 0.0f);
+				ApplyImpulse(pBody1, pBody2, contact.Offset1, contact.Offset2, manifold.Normal * (contact.NormalImpulse - previousImpulse));
+			}
+		}
+	}
+}
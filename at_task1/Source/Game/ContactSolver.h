@@ -0,0 +1,51 @@
+#pragma once
+
+// Resolves contacts between rigid bodies with sequential impulses. Bodies are referred to by index so the caller decides how entities
+// map to bodies
+namespace ContactSolver
+{
+	constexpr uint32_t MAX_CONTACT_POINTS{ 4 };
+	// Index of a body that never moves, like a static collider
+	constexpr uint32_t STATIC_BODY{ std::numeric_limits<uint32_t>::max() };
+
+	// Velocities and mass of a body during a step. Bodies with zero inverse mass are not moved by contacts, but their velocity still
+	// pushes the bodies they touch
+	struct Body
+	{
+		glm::vec3 Position{ 0.0f, 0.0f, 0.0f };
+		// Units per millisecond
+		glm::vec3 LinearVelocity{ 0.0f, 0.0f, 0.0f };
+		// Radians per millisecond about each world axis
+		glm::vec3 AngularVelocity{ 0.0f, 0.0f, 0.0f };
+		float InverseMass{ 0.0f };
+		// Inverse inertia about each world axis
+		glm::vec3 InverseInertia{ 0.0f, 0.0f, 0.0f };
+	};
+
+	// Points where two bodies touch or are about to touch. The normal points from the second body to the first
+	struct ContactManifold
+	{
+		uint32_t Body1{ STATIC_BODY };
+		uint32_t Body2{ STATIC_BODY };
+		glm::vec3 Normal{ 0.0f, 0.0f, 0.0f };
+		float Friction{ 0.0f };
+		float Restitution{ 0.0f };
+		uint32_t PointCount{ 0 };
+		std::array<glm::vec3, MAX_CONTACT_POINTS> Points{};
+		// Distance between the bodies along the normal at each point. Negative when they overlap
+		std::array<float, MAX_CONTACT_POINTS> Separations{};
+	};
+
+	// Find the contact points of collider pairs separated by no more than the margin. Contacts found before colliders touch stop fast
+	// bodies closing the gap within a step. The normal points from the second collider to the first
+	bool CollideAABBs(const glm::vec3& position1, const glm::vec3& extent1, const glm::vec3& position2, const glm::vec3& extent2,
+		const float margin, ContactManifold& manifold);
+	bool CollideSphereAABB(const glm::vec3& spherePosition, const float radius, const glm::vec3& aabbPosition, const glm::vec3& aabbExtent,
+		const float margin, ContactManifold& manifold);
+	bool CollideSpheres(const glm::vec3& position1, const float radius1, const glm::vec3& position2, const float radius2,
+		const float margin, ContactManifold& manifold);
+
+	// Changes the velocities of the bodies so they do not move into each other over the step, bounce by their restitution and slow by
+	// their friction. Overlapping bodies are pushed apart over several steps
+	void Solve(std::vector<Body>& bodies, const std::vector<ContactManifold>& manifolds, const float deltaTime);
+}
\ No newline at end of file
@@ -10,7 +10,7 @@
 #include "Game/Components/TransformComponent.h"
 #include "Game/Components/EnemyAIComponent.h"
 
-void EnemyAI::Update(Level& level)
+void EnemyAI::Update(Level& level, const float deltaTime)
 {
 	auto attackPlayer = [](const glm::vec3& enemyPosition, const glm::vec3& playerPosition, const EnemyAIComponent& aiComponent) {
 		// Calculate the distance between the possessed entity and the enemy
@@ -57,28 +57,26 @@ void EnemyAI::Update(Level& level)
 			continue;
 		}
 
-		auto timeNow = std::chrono::high_resolution_clock::now();
-
 		if (aiComponent.FirstAttack)
 		{
 			aiComponent.FirstAttack = false;
 
 			attackPlayer(transformComponent.Transform.Position, pPossessedEntity->GetComponent<TransformComponent>().Transform.Position, aiComponent);
 
-			// Update the ai's last attack time
-			aiComponent.LastAttackTime = timeNow;
+			// Reset the time since the ai's last attack
+			aiComponent.TimeSinceLastAttack = 0.0f;
 
 			continue;
 		}
 
 		// Check if enough time has elapsed since the enemy's last attack
-		std::chrono::duration<float, std::milli> elapsed = (timeNow - aiComponent.LastAttackTime);
-		if ((elapsed.count() * 0.001f) >= aiComponent.AttackRateSeconds)
+		aiComponent.TimeSinceLastAttack += deltaTime;
+		if ((aiComponent.TimeSinceLastAttack * 0.001f) >= aiComponent.AttackRateSeconds)
 		{
 			attackPlayer(transformComponent.Transform.Position, pPossessedEntity->GetComponent<TransformComponent>().Transform.Position, aiComponent);
 
-			// Update the ai's last attack time
-			aiComponent.LastAttackTime = timeNow;
+			// Reset the time since the ai's last attack
+			aiComponent.TimeSinceLastAttack = 0.0f;
 		}
 	}
 }
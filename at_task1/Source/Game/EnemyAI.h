@@ -4,5 +4,5 @@ class Level;
 
 namespace EnemyAI
 {
-	void Update(Level& level);
+	void Update(Level& level, const float deltaTime);
 }
\ No newline at end of file
@@ -33,8 +33,9 @@ static void OnEnemyShot(entt::registry& ecsRegistry, const entt::entity enemyEnt
 	// Destroy the enemy entity. Cannot destroy here as other entity components are being used to calculate 3D audio
 	//ecsRegistry.destroy(entity);
 
-	// For now, disable other components on the entity
-	ecsRegistry.get<AABBCollisionComponent>(enemyEntity).CollisionEnabled = false;
+	// For now, disable other components on the entity. Moving the collision to no layer stops it being hit
+	ecsRegistry.get<AABBCollisionComponent>(enemyEntity).CollisionLayer = CollisionFilter::NO_LAYERS;
+	World::GetLoadedLevel().GetCollisionBroadphase().RefreshFilter(ecsRegistry, enemyEntity);
 	ecsRegistry.get<StaticMeshComponent>(enemyEntity).Visible = false;
 	ecsRegistry.get<BillboardComponent>(enemyEntity).Active = false;
 	ecsRegistry.get<EnemyAIComponent>(enemyEntity).Active = false;
@@ -104,89 +105,38 @@ void GameEvents::PlayerFired()
 		// Get the loaded level
 		const auto& loadedLevel = World::GetLoadedLevel();
 
-		// Get possessed transform from level
-		const auto& possessedTransform = loadedLevel.GetPossessedEntity()->GetComponent<TransformComponent>().Transform;
+		// Get the possessed entity from the level
+		const auto* pPossessedEntity = loadedLevel.GetPossessedEntity();
+		const auto& possessedTransform = pPossessedEntity->GetComponent<TransformComponent>().Transform;
 
-		// Get ECS registry from loaded level
-		auto& ecsRegistry = World::GetLoadedLevel().GetECSRegistry();
+		// Raycast from the player forwards into the scene
+		CollisionDetection::Ray ray{};
+		ray.Origin = possessedTransform.Position;
+		ray.Direction = glm::normalize(Maths::RotateVector(possessedTransform.Rotation, World::GetWorldForwardVector()));
 
-		// Create a view of entities with transform, billboard and AABB collision components
-		auto aabbView = ecsRegistry.view<TransformComponent, AABBCollisionComponent>();
+		// Shots pass through the player and the floor collision, which rises above the floor mesh. They hit the world, enemies, props
+		// and solid interactables like the level goal
+		CollisionDetection::RaycastFilter filter{};
+		filter.IgnoredEntity = pPossessedEntity->GetID();
+		filter.Layers = CollisionFilter::ToLayerBit(ECollisionLayer::WORLD) | CollisionFilter::ToLayerBit(ECollisionLayer::ENEMY) |
+			CollisionFilter::ToLayerBit(ECollisionLayer::PROP) | CollisionFilter::ToLayerBit(ECollisionLayer::INTERACTABLE);
 
-		struct HitPositionAndEntity
+		CollisionDetection::RaycastHit hit{};
+		if (!CollisionDetection::RaycastClosest(loadedLevel, ray, filter, hit))
 		{
-			HitPositionAndEntity(const glm::vec3& pos, const entt::entity entity) : Position(pos), Entity(entity) {}
-
-			glm::vec3 Position;
-			entt::entity Entity;
-		};
-
-		// For each entity in the view
-		std::vector<HitPositionAndEntity> hits;
-		hits.reserve(aabbView.size_hint());
-		for (auto [entity, entityTransformComponent, aabb] : aabbView.each())
-		{
-			// Check if the aabb component is enabled
-			if (aabb.CollisionEnabled)
-			{
-				// Test if the player's shot hits an entity by raycasting (a line from the player forwards into the scene) for aabbs
-				CollisionDetection::CollisionTestResult testResult{};
-				if (CollisionDetection::TestLineAABB(possessedTransform.Position,
-					possessedTransform.Position + (glm::normalize(Maths::RotateVector(possessedTransform.Rotation, World::GetWorldForwardVector()))),
-					entityTransformComponent.Transform.Position,
-					aabb.Extent,
-					testResult))
-				{
-					// Store the hit position and entity
-					hits.emplace_back(testResult.HitPosition, entity);
-				}
-			}
+			return;
 		}
 
-		// Sort hits based on their distance from the camera
-		std::sort(hits.begin(), hits.end(), [&cameraPosition = possessedTransform.Position](const auto& lhs, const auto& rhs) {
-			auto lhsDistance = glm::length(cameraPosition - lhs.Position);
-			auto rhsDistance = glm::length(cameraPosition - rhs.Position);
-
-			return lhsDistance < rhsDistance;
-		});
-
-		// Check if the first hit was an enemy
-		const auto& firstHit = hits[0];
-		if (ecsRegistry.all_of<TagComponent>(firstHit.Entity))
+		// Check if the closest hit was an enemy
+		auto& ecsRegistry = World::GetLoadedLevel().GetECSRegistry();
+		if (ecsRegistry.all_of<TagComponent>(hit.Entity) && (ecsRegistry.get<TagComponent>(hit.Entity).Tag == Tags::ENEMY_TAG))
 		{
-			if (ecsRegistry.get<TagComponent>(firstHit.Entity).Tag == Tags::ENEMY_TAG)
-			{
-				OnEnemyShot(ecsRegistry, firstHit.Entity);
-
-				// An enemy was shot and checking hits can stop
-				return;
-			}
+			OnEnemyShot(ecsRegistry, hit.Entity);
+			return;
 		}
 
-		// For each other hit along the ray
-		for (size_t i = 1; i < hits.size(); ++i)
-		{
-			const auto& hit = hits[i];
-
-			// Check if the hit entity was an enemy.
-			if (ecsRegistry.all_of<TagComponent>(hit.Entity))
-			{
-				if (ecsRegistry.get<TagComponent>(hit.Entity).Tag == Tags::ENEMY_TAG)
-				{
-					OnEnemyShot(ecsRegistry, hit.Entity);
-
-					// An enemy was shot and checking hits can stop
-					break;
-				}
-			}
-			else
-			{
-				// Something else was hit and checking hits can stop
-				// Spawn decal, bullet impact particles, impact sound emitter etc... at hit position
-				break;
-			}
-		}
+		// Something else was hit
+		// Spawn decal, bullet impact particles, impact sound emitter etc... at hit position
 	}
 }
 
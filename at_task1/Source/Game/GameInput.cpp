@@ -42,7 +42,7 @@ static void AddMovementInput(Entity* pPossessedEntity, const glm::vec3& directio
 	auto& possessedEntityRigidBodyComponent = pPossessedEntity->GetComponent<RigidBodyComponent>();
 
 	// Add scaled velocity in the direction
-	possessedEntityRigidBodyComponent.Velocity += scale * direction * World::GetWorldDeltaTime();
+	possessedEntityRigidBodyComponent.Velocity += scale * direction;
 }
 
 static void MoveForward(Entity* pPossessedEntity, const float scale)
@@ -231,6 +231,9 @@ void GameInput::PollInputs()
 		return;
 	}
 
+	// Movement input sets the possessed entity's velocity for the fixed steps simulated this frame
+	pPossessedEntity->GetComponent<RigidBodyComponent>().Velocity = { 0.0f, 0.0f, 0.0f };
+
 	if (IsInputPressed(InputCodes::S))
 	{
 		MoveForward(pPossessedEntity, possessedEntitySpeed * -1.0f);
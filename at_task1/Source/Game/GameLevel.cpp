@@ -17,6 +17,7 @@
 #include "Game/Components/TagComponent.h"
 #include "Game/Components/EnemyAIComponent.h"
 #include "Game/Components/LevitateComponent.h"
+#include "Game/Components/PointLightComponent.h"
 
 bool GameLevel::Load()
 {
@@ -108,6 +109,7 @@ bool GameLevel::SetupPlayer(const glm::vec3& startPosition)
 
     auto& playerSphereCollisionComponent = PlayerEntity.AddComponent<SphereCollisionComponent>();
     playerSphereCollisionComponent.Radius = 0.2f;
+    playerSphereCollisionComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::PLAYER);
 
     auto& playerRigidBodyComponent = PlayerEntity.AddComponent<RigidBodyComponent>();
     playerRigidBodyComponent.ApplyGravity = true;
@@ -126,15 +128,31 @@ void GameLevel::AddFloor(const glm::vec2& scale, const glm::vec2& textureScale)
 
     auto& floorStaticMeshComponent = pFloorEntity->AddComponent<StaticMeshComponent>();
     floorStaticMeshComponent.GeometryID = PlaneGeometryID;
-    floorStaticMeshComponent.Material.TextureScale = textureScale;
-    floorStaticMeshComponent.Material.TextureID = FloorTextureID;
-    floorStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-
+    Renderer::Material floorMaterial{};
+    floorMaterial.TextureScale = textureScale;
+    floorMaterial.TextureID = FloorTextureID;
+    floorMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    floorStaticMeshComponent.MaterialID = Renderer::RegisterMaterial(floorMaterial);
+    floorStaticMeshComponent.Static = true;
+
+    // The floor collision rises above the floor mesh to hold the player's view at eye height. Props rest on their own floor
+    // collision on a layer only props collide with
     auto& floorAABBComponent = pFloorEntity->AddComponent<AABBCollisionComponent>();
     floorAABBComponent.Extent = Maths::CalculateAABBExtent({ 0.5f, 1.0f, 0.5f }, floorTransformComponent.Transform);
+    floorAABBComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::FLOOR);
 
     auto& floorTagComponent = pFloorEntity->AddComponent<TagComponent>();
     floorTagComponent.Tag = Tags::FLOOR_TAG;
+
+    // Prop floor
+    auto* pPropFloorEntity = CreateEntity();
+
+    auto& propFloorTransformComponent = pPropFloorEntity->AddComponent<TransformComponent>();
+    propFloorTransformComponent.Transform.Position = { 0.0f, PropFloorYPosition + floorAABBComponent.Extent.y, 0.0f };
+
+    auto& propFloorAABBComponent = pPropFloorEntity->AddComponent<AABBCollisionComponent>();
+    propFloorAABBComponent.Extent = floorAABBComponent.Extent;
+    propFloorAABBComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::PROP_FLOOR);
 }
 
 void GameLevel::AddRoof(const glm::vec2& scale, const glm::vec2& textureScale)
@@ -148,9 +166,12 @@ void GameLevel::AddRoof(const glm::vec2& scale, const glm::vec2& textureScale)
 
     auto& floorStaticMeshComponent = pFloorEntity->AddComponent<StaticMeshComponent>();
     floorStaticMeshComponent.GeometryID = PlaneGeometryID;
-    floorStaticMeshComponent.Material.TextureScale = textureScale;
-    floorStaticMeshComponent.Material.TextureID = FloorTextureID;
-    floorStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    Renderer::Material floorMaterial{};
+    floorMaterial.TextureScale = textureScale;
+    floorMaterial.TextureID = FloorTextureID;
+    floorMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    floorStaticMeshComponent.MaterialID = Renderer::RegisterMaterial(floorMaterial);
+    floorStaticMeshComponent.Static = true;
 }
 
 void GameLevel::AddWall(const Maths::Transform& transform, const glm::vec2& textureScale)
@@ -164,9 +185,12 @@ void GameLevel::AddWall(const Maths::Transform& transform, const glm::vec2& text
 
     auto& wallStaticMeshComponent = pWallEntity->AddComponent<StaticMeshComponent>();
     wallStaticMeshComponent.GeometryID = CubeGeometryID;
-    wallStaticMeshComponent.Material.TextureID = WallTextureID;
-    wallStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    wallStaticMeshComponent.Material.TextureScale = textureScale;
+    Renderer::Material wallMaterial{};
+    wallMaterial.TextureID = WallTextureID;
+    wallMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    wallMaterial.TextureScale = textureScale;
+    wallStaticMeshComponent.MaterialID = Renderer::RegisterMaterial(wallMaterial);
+    wallStaticMeshComponent.Static = true;
 
     auto& wallAABBCollisionComponent = pWallEntity->AddComponent<AABBCollisionComponent>();
     wallAABBCollisionComponent.Extent = Maths::CalculateAABBExtent(glm::vec3(0.5f, 0.5f, 0.5f), WallTransformComponent.Transform);
@@ -183,16 +207,23 @@ void GameLevel::AddEnemy(const glm::vec3& position)
 
     auto& enemyStaticMeshComponent = pEnemyEntity->AddComponent<StaticMeshComponent>();
     enemyStaticMeshComponent.GeometryID = PlaneGeometryID;
-    enemyStaticMeshComponent.Material.TextureID = MonsterTextureID;
-    enemyStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    enemyStaticMeshComponent.Material.AlphaBlended = true;
+    Renderer::Material enemyMaterial{};
+    enemyMaterial.TextureID = MonsterTextureID;
+    enemyMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    enemyMaterial.AlphaBlended = true;
+    enemyMaterial.FlipbookFrameCount = MonsterFlipbookFrameCount;
+    enemyMaterial.FlipbookColumnCount = MonsterFlipbookColumnCount;
+    enemyMaterial.FlipbookFrameRate = MonsterFlipbookFrameRate;
+    enemyStaticMeshComponent.MaterialID = Renderer::RegisterMaterial(enemyMaterial);
+    // Start each enemy at a random point in its animation so they do not animate in lockstep
+    enemyStaticMeshComponent.FlipbookPhase = glm::linearRand(0.0f, 1.0f);
 
     auto& enemyBillboardComponent = pEnemyEntity->AddComponent<BillboardComponent>();
     enemyBillboardComponent.CanLean = false;
 
     auto& enemyAABBComponent = pEnemyEntity->AddComponent<AABBCollisionComponent>();
     enemyAABBComponent.Extent = Maths::CalculateAABBExtent({ 1.0f, 1.0f, 1.0f }, enemyTransformComponent.Transform);
-    enemyAABBComponent.CanCollideWithSphereCollisions = false;
+    enemyAABBComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::ENEMY);
 
     auto& enemySoundEmitter3D = pEnemyEntity->AddComponent<SoundEmitter3DComponent>();
     Audio::CreateSoundSourceVoice(MonsterDeathSoundID, &enemySoundEmitter3D.SoundSourceVoice);
@@ -219,18 +250,22 @@ void GameLevel::AddLevelGoal(const glm::vec3& position)
 
     auto& cylinderMeshComponent = pCylinderEntity->AddComponent<StaticMeshComponent>();
     cylinderMeshComponent.GeometryID = CylinderGeometryID;
-    cylinderMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    cylinderMeshComponent.Material.TextureID = LevelGoalTextureID;
-    cylinderMeshComponent.Material.TextureScale = { 1.0f, 1.0f };
+    Renderer::Material cylinderMaterial{};
+    cylinderMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    cylinderMaterial.TextureID = LevelGoalTextureID;
+    cylinderMaterial.TextureScale = { 1.0f, 1.0f };
+    cylinderMeshComponent.MaterialID = Renderer::RegisterMaterial(cylinderMaterial);
 
     auto& cylinderSphereComponent = pCylinderEntity->AddComponent<SphereCollisionComponent>();
     cylinderSphereComponent.Radius = 4.0f;
+    cylinderSphereComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::TRIGGER);
 
     auto& cylinderTagComponent = pCylinderEntity->AddComponent<TagComponent>();
     cylinderTagComponent.Tag = Tags::LEVEL_GOAL_TAG;
 
     auto& cylinderAABBComponent = pCylinderEntity->AddComponent<AABBCollisionComponent>();
     cylinderAABBComponent.Extent = Maths::CalculateAABBExtent({ 1.0f, 1.0f, 1.0f }, cylinderTransformComponent.Transform);
+    cylinderAABBComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::INTERACTABLE);
 
     // Power cell
     auto* pConeEntity = CreateEntity();
@@ -243,15 +278,22 @@ void GameLevel::AddLevelGoal(const glm::vec3& position)
 
     auto& coneMeshComponent = pConeEntity->AddComponent<StaticMeshComponent>();
     coneMeshComponent.GeometryID = CylinderGeometryID;
-    coneMeshComponent.Material.AlphaBlended = false;
-    coneMeshComponent.Material.TextureID = PowerCellTextureID;
-    coneMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    coneMeshComponent.Material.TextureScale = { 1.0f, 1.0f };
+    Renderer::Material coneMaterial{};
+    coneMaterial.AlphaBlended = false;
+    coneMaterial.TextureID = PowerCellTextureID;
+    coneMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    coneMaterial.TextureScale = { 1.0f, 1.0f };
+    coneMeshComponent.MaterialID = Renderer::RegisterMaterial(coneMaterial);
 
     auto& coneLevitateComponent = pConeEntity->AddComponent<LevitateComponent>();
     coneLevitateComponent.OriginalHeight = coneTransformComponent.Transform.Position.y;
     coneLevitateComponent.MaxHeightDelta = 0.5f;
     coneLevitateComponent.RotationDelta = { 0.004f, 0.01f, 0.006f };
+
+    auto& conePointLightComponent = pConeEntity->AddComponent<PointLightComponent>();
+    conePointLightComponent.Color = { 0.4f, 0.8f, 1.0f };
+    conePointLightComponent.Intensity = 2.0f;
+    conePointLightComponent.Radius = 4.0f;
 }
 
 void GameLevel::AddBarrel(const glm::vec3& position)
@@ -266,10 +308,23 @@ void GameLevel::AddBarrel(const glm::vec3& position)
 
     auto& barrelStaticMesh = pBarrelEntity->AddComponent<StaticMeshComponent>();
     barrelStaticMesh.GeometryID = CylinderGeometryID;
-    barrelStaticMesh.Material.AlphaBlended = false;
-    barrelStaticMesh.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    barrelStaticMesh.Material.TextureID = BarrelTextureID;
+    Renderer::Material barrelMaterial{};
+    barrelMaterial.AlphaBlended = false;
+    barrelMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    barrelMaterial.TextureID = BarrelTextureID;
+    barrelStaticMesh.MaterialID = Renderer::RegisterMaterial(barrelMaterial);
 
     auto& barrelAABBCollision = pBarrelEntity->AddComponent<AABBCollisionComponent>();
-    barrelAABBCollision.Extent = Maths::CalculateAABBExtent({ 2.0f, 2.0f, 2.0f }, barrelTransform.Transform);
+    // Narrow enough that neighbouring barrels do not start overlapping
+    barrelAABBCollision.Extent = Maths::CalculateAABBExtent({ 1.0f, 2.0f, 1.0f }, barrelTransform.Transform);
+    barrelAABBCollision.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::PROP);
+
+    auto& barrelRigidBody = pBarrelEntity->AddComponent<RigidBodyComponent>();
+    barrelRigidBody.Dynamic = true;
+    barrelRigidBody.Mass = BarrelMass;
+    barrelRigidBody.Restitution = 0.1f;
+    barrelRigidBody.Friction = 0.6f;
+    barrelRigidBody.Shape = ERigidBodyShape::CYLINDER;
+    // Barrels start at rest on the prop floor
+    barrelRigidBody.Asleep = true;
 }
@@ -38,10 +38,17 @@ private:
 	static constexpr float WallYScale{ 3.0f };
 	static constexpr float EnemyYPosition{ 0.75f };
 	static constexpr float MonsterDeathSoundVolume{ 15.0f };
+	// The monster texture is a single frame sprite sheet. Frame counts above one animate the enemies
+	static constexpr uint32_t MonsterFlipbookFrameCount{ 1 };
+	static constexpr uint32_t MonsterFlipbookColumnCount{ 1 };
+	static constexpr float MonsterFlipbookFrameRate{ 8.0f };
 	static constexpr float LevelGoalYPosition{ 1.2f };
 	static constexpr float EnemyAttackRadius{ 3.0f };
 	static constexpr float LevelGoalDecorationYPosition{ -1.5f };
 	static constexpr float BarrelYPosition{ 1.05f };
+	static constexpr float BarrelMass{ 20.0f };
+	// Barrel collisions reach down to here from the player's height
+	static constexpr float PropFloorYPosition{ 2.85f };
 
 	Entity PlayerEntity{};
 	uint32_t CubeGeometryID{ std::numeric_limits<uint32_t>::max() };
@@ -1,25 +1,18 @@
 #include "Pch.h"
 #include "HUD.h"
-#include "Renderer/Renderer.h"
 
 bool HUD::Load()
 {
-	// Load plane geometry for HUD images
-	if (!Renderer::LoadPlaneGeometryPrimitive(1.0f, &ImageGeometryID))
-	{
-		return false;
-	}
-
 	return true;
 }
 
 void HUD::UnLoad()
 {
-	// Destroy plane geometry
-	Renderer::DestroyGeometry(ImageGeometryID);
+	Sprites.clear();
 }
 
-Entity* HUD::CreateHUDEntity()
+uint32_t HUD::CreateHUDSprite()
 {
-	return &HUDEntities.emplace_back(ECSRegistry.create(), &ECSRegistry);
+	Sprites.emplace_back();
+	return static_cast<uint32_t>(Sprites.size() - 1);
 }
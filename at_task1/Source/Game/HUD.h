@@ -1,15 +1,14 @@
 #pragma once
 
 #include "Renderer/CameraSettings.h"
-#include "Game/Entity.h"
+#include "Renderer/Sprite.h"
 
 class HUD
 {
 public:
 	using Super = HUD;
 
-	const entt::registry& GetECSRegistry() const { return ECSRegistry; }
-	entt::registry& GetECSRegistry() { return ECSRegistry; }
+	const std::vector<Renderer::Sprite>& GetSprites() const { return Sprites; }
 	const glm::vec3& GetHUDCameraPosition() const { return HUDCameraPosition; }
 	const glm::vec3& GetHUDCameraRotation() const { return HUDCameraRotation; }
 	const Renderer::CameraSettings& GetHUDCameraSettings() const { return HUDCameraSettings; }
@@ -20,14 +19,14 @@ public:
 	virtual void Tick(const float deltaTime) = 0;
 
 protected:
-	Entity* CreateHUDEntity();
+	// Returns the ID of the created sprite. IDs remain valid for the lifetime of the HUD
+	uint32_t CreateHUDSprite();
+	Renderer::Sprite& GetHUDSprite(const uint32_t id) { return Sprites[id]; }
 
 	glm::vec3 HUDCameraPosition{ 0.0f, 0.0f, 0.0f };
 	glm::vec3 HUDCameraRotation{ 0.0f, 0.0f, 0.0f };
 	Renderer::CameraSettings HUDCameraSettings{};
-	uint32_t ImageGeometryID{ std::numeric_limits<uint32_t>::max() };
 
 private:
-	entt::registry ECSRegistry;
-	std::vector<Entity> HUDEntities;
+	std::vector<Renderer::Sprite> Sprites;
 };
\ No newline at end of file
@@ -2,9 +2,6 @@
 #include "FPSHUD.h"
 #include "Renderer/Renderer.h"
 
-#include "Game/Components/TransformComponent.h"
-#include "Game/Components/StaticMeshComponent.h"
-
 #include "Game/GameState.h"
 
 bool FPSHUD::Load()
@@ -61,76 +58,45 @@ bool FPSHUD::Load()
 	HUDCameraSettings.ProjectionMode = Renderer::EProjectionMode::ORTHOGRAPHIC;
 
 	// Crosshair image
-	auto* pCrosshairImageEntity = CreateHUDEntity();
-
-	auto& crosshairTransformComponent = pCrosshairImageEntity->AddComponent<TransformComponent>();
-	crosshairTransformComponent.Transform.Position = { 0.0f, 0.0f, 2.0f };
-	crosshairTransformComponent.Transform.Rotation = { 0.0f, 0.0f, 0.0f };
-	crosshairTransformComponent.Transform.Scale = { 0.3f, 0.3f, 1.0f };
-
-	auto& crosshairStaticMeshComponent = pCrosshairImageEntity->AddComponent<StaticMeshComponent>();
-	crosshairStaticMeshComponent.GeometryID = ImageGeometryID;
-	crosshairStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-	crosshairStaticMeshComponent.Material.AlphaBlended = true;
-	crosshairStaticMeshComponent.Material.TextureID = CrosshairTextureID;
+	auto& crosshairSprite = GetHUDSprite(CreateHUDSprite());
+	crosshairSprite.Position = { 0.0f, 0.0f, 2.0f };
+	crosshairSprite.Size = { 0.3f, 0.3f };
+	crosshairSprite.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+	crosshairSprite.TextureID = CrosshairTextureID;
 
 	// Player arms image
-	auto* pPlayerArmsImageEntity = CreateHUDEntity();
-
-	auto& playerArmsTransformComponent = pPlayerArmsImageEntity->AddComponent<TransformComponent>();
-	playerArmsTransformComponent.Transform.Position = { 4.0f, 5.0f, 1.0f };
-	playerArmsTransformComponent.Transform.Rotation = { 0.0f, 0.0f, 0.0f };
-	playerArmsTransformComponent.Transform.Scale = { 8.0f, 8.0f, 1.0f };
-
-	auto& playerArmsStaticMeshComponent = pPlayerArmsImageEntity->AddComponent<StaticMeshComponent>();
-	playerArmsStaticMeshComponent.GeometryID = ImageGeometryID;
-	playerArmsStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-	playerArmsStaticMeshComponent.Material.AlphaBlended = true;
-	playerArmsStaticMeshComponent.Material.TextureID = PlayerArmsTextureID;
+	auto& playerArmsSprite = GetHUDSprite(CreateHUDSprite());
+	playerArmsSprite.Position = { 4.0f, 5.0f, 1.0f };
+	playerArmsSprite.Size = { 8.0f, 8.0f };
+	playerArmsSprite.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+	playerArmsSprite.TextureID = PlayerArmsTextureID;
 
 	// Interact prompt image
-	auto* pInteractPromptImageEntity = CreateHUDEntity();
-
-	auto& interactPromptTransformComponent = pInteractPromptImageEntity->AddComponent<TransformComponent>();
-	interactPromptTransformComponent.Transform.Position = { 0.0f, 5.0f, 0.0f };
-	interactPromptTransformComponent.Transform.Scale = { 2.0f, 2.0f, 1.0f };
-
-	pInteractPromptStaticMeshComponent = &pInteractPromptImageEntity->AddComponent<StaticMeshComponent>();
-	pInteractPromptStaticMeshComponent->GeometryID = ImageGeometryID;
-	pInteractPromptStaticMeshComponent->Material.AlphaBlended = true;
-	pInteractPromptStaticMeshComponent->Material.SetSamplerID(Renderer::ESampler::LINEAR_FILTER);
-	pInteractPromptStaticMeshComponent->Material.TextureID = PromptTextureID;
-	pInteractPromptStaticMeshComponent->Visible = false;
+	InteractPromptSpriteID = CreateHUDSprite();
+	auto& interactPromptSprite = GetHUDSprite(InteractPromptSpriteID);
+	interactPromptSprite.Position = { 0.0f, 5.0f, 0.0f };
+	interactPromptSprite.Size = { 2.0f, 2.0f };
+	interactPromptSprite.SetSamplerID(Renderer::ESampler::LINEAR_FILTER);
+	interactPromptSprite.TextureID = PromptTextureID;
+	interactPromptSprite.Visible = false;
 
 	// Game complete image
-	auto* pGameCompleteImageEntity = CreateHUDEntity();
-
-	auto& GameCompleteImageTransformComponent = pGameCompleteImageEntity->AddComponent<TransformComponent>();
-	GameCompleteImageTransformComponent.Transform.Position = { 0.0f, -0.2f, 2.0f };
-	GameCompleteImageTransformComponent.Transform.Rotation = { 0.0f, 0.0f, 0.0f };
-	GameCompleteImageTransformComponent.Transform.Scale = { 28.0f, 27.0f, 1.0f };
-
-	pGameCompleteScreenStaticMeshComponent = &pGameCompleteImageEntity->AddComponent<StaticMeshComponent>();
-	pGameCompleteScreenStaticMeshComponent->GeometryID = ImageGeometryID;
-	pGameCompleteScreenStaticMeshComponent->Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-	pGameCompleteScreenStaticMeshComponent->Material.AlphaBlended = true;
-	pGameCompleteScreenStaticMeshComponent->Material.TextureID = GameCompleteScreenTexture;
-	pGameCompleteScreenStaticMeshComponent->Visible = false;
+	GameCompleteScreenSpriteID = CreateHUDSprite();
+	auto& gameCompleteScreenSprite = GetHUDSprite(GameCompleteScreenSpriteID);
+	gameCompleteScreenSprite.Position = { 0.0f, -0.2f, 2.0f };
+	gameCompleteScreenSprite.Size = { 28.0f, 27.0f };
+	gameCompleteScreenSprite.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+	gameCompleteScreenSprite.TextureID = GameCompleteScreenTexture;
+	gameCompleteScreenSprite.Visible = false;
 
 	// Player defeated image
-	auto* pPlayerDefeatedImageEntity = CreateHUDEntity();
-
-	auto& PlayerDefeatedImageTransformComponent = pPlayerDefeatedImageEntity->AddComponent<TransformComponent>();
-	PlayerDefeatedImageTransformComponent.Transform.Position = { 0.0f, -0.2f, 2.0f };
-	PlayerDefeatedImageTransformComponent.Transform.Rotation = { 0.0f, 0.0f, 0.0f };
-	PlayerDefeatedImageTransformComponent.Transform.Scale = { 28.0f, 27.0f, 1.0f };
-
-	pPlayerDefeatedScreenStaticMeshComponent = &pPlayerDefeatedImageEntity->AddComponent<StaticMeshComponent>();
-	pPlayerDefeatedScreenStaticMeshComponent->GeometryID = ImageGeometryID;
-	pPlayerDefeatedScreenStaticMeshComponent->Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-	pPlayerDefeatedScreenStaticMeshComponent->Material.AlphaBlended = true;
-	pPlayerDefeatedScreenStaticMeshComponent->Material.TextureID = PlayerDefeatedScreenTexture;
-	pPlayerDefeatedScreenStaticMeshComponent->Visible = false;
+	PlayerDefeatedScreenSpriteID = CreateHUDSprite();
+	auto& playerDefeatedScreenSprite = GetHUDSprite(PlayerDefeatedScreenSpriteID);
+	playerDefeatedScreenSprite.Position = { 0.0f, -0.2f, 2.0f };
+	playerDefeatedScreenSprite.Size = { 28.0f, 27.0f };
+	playerDefeatedScreenSprite.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+	playerDefeatedScreenSprite.TextureID = PlayerDefeatedScreenTexture;
+	playerDefeatedScreenSprite.Visible = false;
 
     return true;
 }
@@ -156,15 +122,15 @@ void FPSHUD::Tick(const float deltaTime)
 
 void FPSHUD::SetInteractPromptVisible(const bool visible)
 {
-	pInteractPromptStaticMeshComponent->Visible = visible;
+	GetHUDSprite(InteractPromptSpriteID).Visible = visible;
 }
 
 void FPSHUD::ShowGameCompleteScreen()
 {
-	pGameCompleteScreenStaticMeshComponent->Visible = true;
+	GetHUDSprite(GameCompleteScreenSpriteID).Visible = true;
 }
 
 void FPSHUD::ShowPlayerDefeatedScreen()
 {
-	pPlayerDefeatedScreenStaticMeshComponent->Visible = true;
+	GetHUDSprite(PlayerDefeatedScreenSpriteID).Visible = true;
 }
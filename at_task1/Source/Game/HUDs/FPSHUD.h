@@ -2,8 +2,6 @@
 
 #include "Game/HUD.h"
 
-struct StaticMeshComponent;
-
 class FPSHUD : public HUD
 {
 	enum class PromptIcons : uint8_t
@@ -29,7 +27,7 @@ private:
 	uint32_t PromptTextureID{ 0 };
 	uint32_t PlayerDefeatedScreenTexture{ 0 };
 	uint32_t GameCompleteScreenTexture{ 0 };
-	StaticMeshComponent* pInteractPromptStaticMeshComponent{ nullptr };
-	StaticMeshComponent* pGameCompleteScreenStaticMeshComponent{ nullptr };
-	StaticMeshComponent* pPlayerDefeatedScreenStaticMeshComponent{ nullptr };
+	uint32_t InteractPromptSpriteID{ 0 };
+	uint32_t GameCompleteScreenSpriteID{ 0 };
+	uint32_t PlayerDefeatedScreenSpriteID{ 0 };
 };
\ No newline at end of file
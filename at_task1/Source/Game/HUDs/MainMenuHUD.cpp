@@ -2,9 +2,6 @@
 #include "MainMenuHUD.h"
 #include "Renderer/Renderer.h"
 
-#include "Game/Components/TransformComponent.h"
-#include "Game/Components/StaticMeshComponent.h"
-
 bool MainMenuHUD::Load()
 {
 	if (!Super::Load())
@@ -18,19 +15,12 @@ bool MainMenuHUD::Load()
 		return false;
 	}
 
-	// Create image entity
-	auto* pMainMenuImageEntity = CreateHUDEntity();
-
-	auto& mainMenuImageTransformComponent = pMainMenuImageEntity->AddComponent<TransformComponent>();
-	mainMenuImageTransformComponent.Transform.Position = { 0.0f, -0.2f, 2.0f };
-	mainMenuImageTransformComponent.Transform.Rotation = { 0.0f, 0.0f, 0.0f };
-	mainMenuImageTransformComponent.Transform.Scale = { 3.0f, 2.0f, 1.0f };
-
-	auto& mainMenuImageStaticMeshComponent = pMainMenuImageEntity->AddComponent<StaticMeshComponent>();
-	mainMenuImageStaticMeshComponent.GeometryID = ImageGeometryID;
-	mainMenuImageStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-	mainMenuImageStaticMeshComponent.Material.AlphaBlended = true;
-	mainMenuImageStaticMeshComponent.Material.TextureID = MainMenuTexture;
+	// Create main menu image
+	auto& mainMenuSprite = GetHUDSprite(CreateHUDSprite());
+	mainMenuSprite.Position = { 0.0f, -0.2f, 2.0f };
+	mainMenuSprite.Size = { 3.0f, 2.0f };
+	mainMenuSprite.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+	mainMenuSprite.TextureID = MainMenuTexture;
 
     return true;
 }
@@ -0,0 +1,44 @@
+#include "Pch.h"
+#include "Interpolation.h"
+#include "Level.h"
+#include "Maths/Maths.h"
+
+#include "Game/Components/TransformComponent.h"
+#include "Game/Components/PreviousTransformComponent.h"
+#include "Game/Components/RigidBodyComponent.h"
+#include "Game/Components/LevitateComponent.h"
+#include "Game/Components/BillboardComponent.h"
+
+// Saves the transforms of entities with a component of a system that moves them
+template<typename MovingComponent>
+static void SaveMovingTransforms(entt::registry& ecsRegistry)
+{
+	auto entityView = ecsRegistry.view<TransformComponent, MovingComponent>();
+	for (auto entity : entityView)
+	{
+		ecsRegistry.emplace_or_replace<PreviousTransformComponent>(entity, entityView.template get<TransformComponent>(entity).Transform);
+	}
+}
+
+void Interpolation::SaveTransforms(Level& level)
+{
+	// Get level's ecs registry
+	auto& ecsRegistry = level.GetECSRegistry();
+
+	// Only transforms moved by physics, levitation and billboarding change between steps. Static entities are drawn at their transform
+	SaveMovingTransforms<RigidBodyComponent>(ecsRegistry);
+	SaveMovingTransforms<LevitateComponent>(ecsRegistry);
+	SaveMovingTransforms<BillboardComponent>(ecsRegistry);
+}
+
+Maths::Transform Interpolation::CalculateRenderTransform(const entt::registry& registry, const entt::entity entity,
+	const Maths::Transform& transform, const float alpha)
+{
+	const auto* pPreviousTransform = registry.try_get<PreviousTransformComponent>(entity);
+	if (pPreviousTransform == nullptr)
+	{
+		return transform;
+	}
+
+	return Maths::InterpolateTransform(pPreviousTransform->Transform, transform, alpha);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Maths/Transform.h"
+
+class Level;
+
+namespace Interpolation
+{
+	// Saves the transform of each entity the fixed step can move before the step
+	void SaveTransforms(Level& level);
+	// Blends an entity's transform from before the latest fixed step to its current transform. The alpha is the fraction of a fixed
+	// step the frame is rendered past the latest step. Entities created since the last step are not blended
+	Maths::Transform CalculateRenderTransform(const entt::registry& registry, const entt::entity entity, const Maths::Transform& transform,
+		const float alpha);
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Level.h"
 #include "Game/Components/TransformComponent.h"
 #include "Game/Components/CameraComponent.h"
+#include "Renderer/View.h"
 
 void Level::Begin()
 {
@@ -44,3 +45,16 @@ bool Level::PossessEntity(Entity* entity)
 
 	return false;
 }
+
+bool Level::AddSplitScreenEntity(Entity* entity)
+{
+	// Check the entity can be viewed and a view is available alongside the possessed entity's view
+	if (entity->HasAllComponents<TransformComponent, CameraComponent>() &&
+		(SplitScreenEntities.size() + 1) < Renderer::MAX_VIEW_COUNT)
+	{
+		SplitScreenEntities.push_back(*entity);
+		return true;
+	}
+
+	return false;
+}
@@ -3,6 +3,7 @@
 #include "Renderer/DirectionalLight.h"
 #include "Entity.h"
 #include "Game/HUD.h"
+#include "Game/CollisionBroadphase.h"
 
 class Level
 {
@@ -15,7 +16,12 @@ public:
 	const entt::registry& GetECSRegistry() const { return ECSRegistry; }
 	Entity* GetPossessedEntity() { return &PossessedEntity; }
 	const Entity* GetPossessedEntity() const { return &PossessedEntity; }
+	// Entities viewed by additional local players. Their views are rendered in split screen after the possessed entity's view
+	const std::vector<Entity>& GetSplitScreenEntities() const { return SplitScreenEntities; }
 	HUD* GetHUDClassInstance() const { return HUDClassInstance.get(); }
+	const std::string& GetLightmapAssetFilepath() const { return LightmapAssetFilepath; }
+	CollisionBroadphase& GetCollisionBroadphase() { return Broadphase; }
+	const CollisionBroadphase& GetCollisionBroadphase() const { return Broadphase; }
 
 	virtual ~Level() = default;
 
@@ -31,14 +37,22 @@ protected:
 	// Possesses an entity if the entity has a transform and camera component. The camera will be used as the view camera
 	// to view the level. Returns whether the entity was succesfully possessed
 	bool PossessEntity(Entity* entity);
+	// Adds a split screen view of an entity if the entity has a transform and camera component and fewer than the renderer's
+	// maximum number of views would be rendered. Returns whether the view was added
+	bool AddSplitScreenEntity(Entity* entity);
 	//const std::vector<Entity>& GetEntities() const { return Entities; }
 	//std::vector<Entity>& GetEntities() { return Entities; }
 
 	std::unique_ptr<HUD> HUDClassInstance;
+	// File the level's baked lightmap is cached in. Lightmaps are baked every time the level loads when empty
+	std::string LightmapAssetFilepath;
 
 private:
 	entt::registry ECSRegistry;
 	std::vector<Entity> Entities;
 	Renderer::DirectionalLight DirectionalLight{};
 	Entity PossessedEntity{};
+	std::vector<Entity> SplitScreenEntities;
+	// Built once the level finishes loading
+	CollisionBroadphase Broadphase;
 };
\ No newline at end of file
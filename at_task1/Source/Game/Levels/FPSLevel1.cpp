@@ -20,6 +20,9 @@ bool FPSLevel1::Load()
         return false;
     }
 
+    // Cache the level's baked lightmap with its assets
+    LightmapAssetFilepath = "Assets/Game/Lightmaps/FPSLevel1.lightmap";
+
     // Create fps hud class instance
     HUDClassInstance = std::make_unique<FPSHUD>();
     if (!HUDClassInstance->Load())
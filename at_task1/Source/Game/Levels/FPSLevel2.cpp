@@ -11,6 +11,9 @@ bool FPSLevel2::Load()
         return false;
     }
 
+    // Cache the level's baked lightmap with its assets
+    LightmapAssetFilepath = "Assets/Game/Lightmaps/FPSLevel2.lightmap";
+
     // Create fps hud class instance
     HUDClassInstance = std::make_unique<FPSHUD>();
     if (!HUDClassInstance->Load())
@@ -24,6 +24,9 @@
 
 bool Level01::Load()
 {
+    // Cache the level's baked lightmap with its assets
+    LightmapAssetFilepath = "Assets/Game/Lightmaps/Level01.lightmap";
+
     // Create level hud class instance
     HUDClassInstance = std::make_unique<FPSHUD>();
     if (!HUDClassInstance->Load())
@@ -72,6 +75,7 @@ bool Level01::Load()
 
     auto& playerSphereCollisionComponent = PlayerEntity.AddComponent<SphereCollisionComponent>();
     playerSphereCollisionComponent.Radius = 0.2f;
+    playerSphereCollisionComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::PLAYER);
 
     auto& playerRigidBodyComponent = PlayerEntity.AddComponent<RigidBodyComponent>();
     playerRigidBodyComponent.ApplyGravity = true;
@@ -91,12 +95,16 @@ bool Level01::Load()
 
     auto& floorStaticMeshComponent = pFloorEntity->AddComponent<StaticMeshComponent>();
     floorStaticMeshComponent.GeometryID = PlaneGeometryID;
-    floorStaticMeshComponent.Material.TextureScale = { 25.0f, 25.0f };
-    floorStaticMeshComponent.Material.TextureID = FloorTextureID;
-    floorStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    Renderer::Material floorMaterial{};
+    floorMaterial.TextureScale = { 25.0f, 25.0f };
+    floorMaterial.TextureID = FloorTextureID;
+    floorMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    floorStaticMeshComponent.MaterialID = Renderer::RegisterMaterial(floorMaterial);
+    floorStaticMeshComponent.Static = true;
 
     auto& floorAABBComponent = pFloorEntity->AddComponent<AABBCollisionComponent>();
     floorAABBComponent.Extent = Maths::CalculateAABBExtent({ 0.5f, 1.0f, 0.5f }, floorTransformComponent.Transform);
+    floorAABBComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::FLOOR);
 
     auto& floorTagComponent = pFloorEntity->AddComponent<TagComponent>();
     floorTagComponent.Tag = Tags::FLOOR_TAG;
@@ -109,9 +117,12 @@ bool Level01::Load()
 
     auto& wallStaticMeshComponent1 = pWallEntity1->AddComponent<StaticMeshComponent>();
     wallStaticMeshComponent1.GeometryID = CubeGeometryID;
-    wallStaticMeshComponent1.Material.TextureID = WallTextureID;
-    wallStaticMeshComponent1.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    wallStaticMeshComponent1.Material.TextureScale = { 5.0f, 5.0f };
+    Renderer::Material wallMaterial1{};
+    wallMaterial1.TextureID = WallTextureID;
+    wallMaterial1.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    wallMaterial1.TextureScale = { 5.0f, 5.0f };
+    wallStaticMeshComponent1.MaterialID = Renderer::RegisterMaterial(wallMaterial1);
+    wallStaticMeshComponent1.Static = true;
 
     auto& wallAABBCollisionComponent1 = pWallEntity1->AddComponent<AABBCollisionComponent>();
     wallAABBCollisionComponent1.Extent = Maths::CalculateAABBExtent(glm::vec3(0.5f, 0.5f, 0.5f), WallTransformComponent1.Transform);
@@ -126,9 +137,12 @@ bool Level01::Load()
 
     auto& wallStaticMeshComponent2 = pWallEntity2->AddComponent<StaticMeshComponent>();
     wallStaticMeshComponent2.GeometryID = CubeGeometryID;
-    wallStaticMeshComponent2.Material.TextureID = WallTextureID;
-    wallStaticMeshComponent2.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    wallStaticMeshComponent2.Material.TextureScale = { 5.0f, 5.0f };
+    Renderer::Material wallMaterial2{};
+    wallMaterial2.TextureID = WallTextureID;
+    wallMaterial2.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    wallMaterial2.TextureScale = { 5.0f, 5.0f };
+    wallStaticMeshComponent2.MaterialID = Renderer::RegisterMaterial(wallMaterial2);
+    wallStaticMeshComponent2.Static = true;
 
     auto& wallAABBCollisionComponent2 = pWallEntity2->AddComponent<AABBCollisionComponent>();
     wallAABBCollisionComponent2.Extent = Maths::CalculateAABBExtent(glm::vec3(0.5f, 0.5f, 0.5f), wallTransformComponent2.Transform);
@@ -142,16 +156,18 @@ bool Level01::Load()
 
     auto& enemyStaticMeshComponent = pEnemyEntity->AddComponent<StaticMeshComponent>();
     enemyStaticMeshComponent.GeometryID = PlaneGeometryID;
-    enemyStaticMeshComponent.Material.TextureID = MonsterTextureID;
-    enemyStaticMeshComponent.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    enemyStaticMeshComponent.Material.AlphaBlended = true;
+    Renderer::Material enemyMaterial{};
+    enemyMaterial.TextureID = MonsterTextureID;
+    enemyMaterial.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    enemyMaterial.AlphaBlended = true;
+    enemyStaticMeshComponent.MaterialID = Renderer::RegisterMaterial(enemyMaterial);
 
     auto& enemyBillboardComponent = pEnemyEntity->AddComponent<BillboardComponent>();
     enemyBillboardComponent.CanLean = false;
 
     auto& enemyAABBComponent = pEnemyEntity->AddComponent<AABBCollisionComponent>();
     enemyAABBComponent.Extent = Maths::CalculateAABBExtent({ 0.5f, 0.5f, 0.1f }, enemyTransformComponent.Transform);
-    enemyAABBComponent.CanCollideWithSphereCollisions = false;
+    enemyAABBComponent.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::ENEMY);
 
     auto& enemySoundEmitter3D = pEnemyEntity->AddComponent<SoundEmitter3DComponent>();
     Audio::CreateSoundSourceVoice(MonsterDeathSoundID, &enemySoundEmitter3D.SoundSourceVoice);
@@ -170,16 +186,18 @@ bool Level01::Load()
 
     auto& enemyStaticMeshComponent2 = pEnemyEntity2->AddComponent<StaticMeshComponent>();
     enemyStaticMeshComponent2.GeometryID = PlaneGeometryID;
-    enemyStaticMeshComponent2.Material.TextureID = MonsterTextureID;
-    enemyStaticMeshComponent2.Material.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
-    enemyStaticMeshComponent2.Material.AlphaBlended = true;
+    Renderer::Material enemyMaterial2{};
+    enemyMaterial2.TextureID = MonsterTextureID;
+    enemyMaterial2.SetSamplerID(Renderer::ESampler::NEAREST_NEIGHBOUR_FILTER);
+    enemyMaterial2.AlphaBlended = true;
+    enemyStaticMeshComponent2.MaterialID = Renderer::RegisterMaterial(enemyMaterial2);
 
     auto& enemyBillboardComponent2 = pEnemyEntity2->AddComponent<BillboardComponent>();
     enemyBillboardComponent2.CanLean = false;
 
     auto& enemyAABBComponent2 = pEnemyEntity2->AddComponent<AABBCollisionComponent>();
     enemyAABBComponent2.Extent = Maths::CalculateAABBExtent({ 0.5f, 0.5f, 0.1f }, enemyTransformComponent2.Transform);
-    enemyAABBComponent2.CanCollideWithSphereCollisions = false;
+    enemyAABBComponent2.CollisionLayer = CollisionFilter::ToLayerBit(ECollisionLayer::ENEMY);
 
     auto& enemySoundEmitter3D2 = pEnemyEntity2->AddComponent<SoundEmitter3DComponent>();
     Audio::CreateSoundSourceVoice(MonsterDeathSoundID, &enemySoundEmitter3D2.SoundSourceVoice);
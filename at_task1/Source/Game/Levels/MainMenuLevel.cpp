@@ -14,6 +14,9 @@ bool MainMenuLevel::Load()
         return false;
     }
 
+    // Cache the level's baked lightmap with its assets
+    LightmapAssetFilepath = "Assets/Game/Lightmaps/MainMenuLevel.lightmap";
+
     // Create main menu hud instance
     HUDClassInstance = std::make_unique<MainMenuHUD>();
     if (!HUDClassInstance->Load())
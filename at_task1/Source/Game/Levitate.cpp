@@ -9,7 +9,7 @@
 #include "Game/Components/TransformComponent.h"
 #include "Game/Components/LevitateComponent.h"
 
-void Levitate::Update(Level& level)
+void Levitate::Update(Level& level, const float deltaTime)
 {
 	// Get level's ecs registry
 	auto& ecsRegistry = level.GetECSRegistry();
@@ -20,8 +20,6 @@ void Levitate::Update(Level& level)
 	// For each entity in the view
 	for (auto [entity, transform, levitate] : entityView.each())
 	{
-		auto deltaTime = World::GetWorldDeltaTime();
-
 		if (levitate.MovingUp)
 		{
 			transform.Transform.Position.y -= levitate.LevitateRate * deltaTime;
@@ -4,5 +4,5 @@ class Level;
 
 namespace Levitate
 {
-	void Update(Level& level);
+	void Update(Level& level, const float deltaTime);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Physics.h"
 
 #include "Game/CollisionDetection.h"
+#include "Game/ContactSolver.h"
 #include "Game/World.h"
 #include "Game/Level.h"
 #include "Game/Components/RigidBodyComponent.h"
@@ -9,60 +10,534 @@
 #include "Game/Components/SphereCollisionComponent.h"
 #include "Game/Components/AABBCollisionComponent.h"
 
+#include "Maths/Maths.h"
+#include "JobSystem/JobSystem.h"
 #include "Console.h"
 
-void Physics::Update(Level& level)
+#include <bit>
+
+// Times a sphere's motion is redirected along the surfaces it hits in a step. Motion left after the last slide is dropped
+constexpr uint32_t MAX_SLIDE_ITERATIONS{ 4 };
+// Distance spheres stop short of the surfaces they hit so sliding along a surface does not hit it again
+constexpr float COLLISION_SKIN_WIDTH{ 0.001f };
+
+// Distance apart the colliders of dynamic bodies start generating contacts at
+constexpr float CONTACT_MARGIN{ 0.02f };
+// Fraction of their velocity dynamic bodies lose each millisecond so bodies not touching anything come to rest
+constexpr float LINEAR_DAMPING{ 0.0001f };
+constexpr float ANGULAR_DAMPING{ 0.001f };
+// Dynamic bodies moving slower than these speeds in units and radians per millisecond are resting
+constexpr float SLEEP_LINEAR_SPEED{ 0.0002f };
+constexpr float SLEEP_ANGULAR_SPEED{ 0.0005f };
+// Milliseconds every body of an island must rest for before the island sleeps
+constexpr float TIME_TO_SLEEP{ 500.0f };
+// Collider pairs each worker thread takes at a time when finding contacts
+constexpr uint32_t NARROWPHASE_GRAIN_SIZE{ 32 };
+
+// Boxes found by the broadphase for the sphere being moved and their entities. Kept between updates to reuse their memory
+static CollisionDetection::AABBBatch gCandidateAABBs;
+static std::vector<entt::entity> gCandidateEntities;
+// Candidate boxes the sphere enclosing a slide overlaps, as the batch test's hit masks, and the normals of those boxes
+static std::vector<uint32_t> gCandidateHitMasks;
+static std::vector<glm::vec3> gCandidateHitSurfaceNormals;
+
+// Rigid bodies taking part in the dynamics step. Kept between updates to reuse their memory
+static std::vector<entt::entity> gSolverEntities;
+static std::vector<ContactSolver::Body> gSolverBodies;
+static std::unordered_map<entt::entity, uint32_t> gSolverBodyIndices;
+// Pairs of colliders that may touch, stored once each with the lower entity first
+static std::vector<std::pair<entt::entity, entt::entity>> gColliderPairs;
+// Contacts of each collider pair, written by whichever thread tests the pair. Pairs not touching have no contact points
+static std::vector<ContactSolver::ContactManifold> gPairManifolds;
+static std::vector<ContactSolver::ContactManifold> gContactManifolds;
+// Parent of each solver body in the forest joining touching bodies into islands, and the time each island has rested for
+static std::vector<uint32_t> gIslandParents;
+static std::vector<float> gIslandRestingTimes;
+
+// A collider as dynamic bodies see it
+struct Collider
+{
+	glm::vec3 Position{ 0.0f, 0.0f, 0.0f };
+	// Half the size of an AABB, or a sphere's radius along every axis
+	glm::vec3 Extent{ 0.0f, 0.0f, 0.0f };
+	bool Sphere{ false };
+	uint32_t Layer{ CollisionFilter::NO_LAYERS };
+	uint32_t Mask{ CollisionFilter::NO_LAYERS };
+};
+
+// Entities with both collisions collide as their AABB
+static bool GetCollider(const entt::registry& registry, const entt::entity entity, Collider& collider)
+{
+	const auto* pTransform = registry.try_get<TransformComponent>(entity);
+	if (pTransform == nullptr)
+	{
+		return false;
+	}
+
+	collider.Position = pTransform->Transform.Position;
+	if (const auto* pAABB = registry.try_get<AABBCollisionComponent>(entity))
+	{
+		collider.Extent = pAABB->Extent;
+		collider.Sphere = false;
+		collider.Layer = pAABB->CollisionLayer;
+		collider.Mask = pAABB->CollisionMask;
+		return true;
+	}
+
+	if (const auto* pSphere = registry.try_get<SphereCollisionComponent>(entity))
+	{
+		collider.Extent = glm::vec3(pSphere->Radius);
+		collider.Sphere = true;
+		collider.Layer = pSphere->CollisionLayer;
+		collider.Mask = pSphere->CollisionMask;
+		return true;
+	}
+
+	return false;
+}
+
+// Inverse inertia about the world axes of a solid shape of the body's mass filling its collider. AABB collisions cannot turn with the
+// body, so axes the collision would need to turn about are locked with zero inverse inertia. Cylinders standing along the world up
+// axis cover the same AABB as they spin about it so only turn about that axis, and boxes do not turn. Spheres turn about every axis
+static glm::vec3 CalculateInverseInertia(const RigidBodyComponent& rigidBody, const Collider& collider)
+{
+	const auto squaredExtent = collider.Extent * collider.Extent;
+	glm::vec3 inertia{ 0.0f, 0.0f, 0.0f };
+	glm::vec3 freeAxes{ 1.0f, 1.0f, 1.0f };
+	switch (rigidBody.Shape)
+	{
+	case ERigidBodyShape::BOX:
+		inertia = (rigidBody.Mass / 3.0f) *
+			glm::vec3(squaredExtent.y + squaredExtent.z, squaredExtent.x + squaredExtent.z, squaredExtent.x + squaredExtent.y);
+		freeAxes = glm::vec3(0.0f);
+		break;
+
+	case ERigidBodyShape::CYLINDER:
+	{
+		const auto squaredRadius = std::max(squaredExtent.x, squaredExtent.z);
+		const auto acrossInertia = (rigidBody.Mass / 12.0f) * ((3.0f * squaredRadius) + (4.0f * squaredExtent.y));
+		inertia = { acrossInertia, 0.5f * rigidBody.Mass * squaredRadius, acrossInertia };
+		freeAxes = glm::abs(World::GetWorldUpVector());
+		break;
+	}
+
+	case ERigidBodyShape::SPHERE:
+		inertia = glm::vec3(0.4f * rigidBody.Mass * std::max(std::max(squaredExtent.x, squaredExtent.y), squaredExtent.z));
+		break;
+	}
+
+	if (collider.Sphere)
+	{
+		freeAxes = glm::vec3(1.0f);
+	}
+
+	return freeAxes * glm::vec3(
+		(inertia.x > 0.0f) ? (1.0f / inertia.x) : 0.0f,
+		(inertia.y > 0.0f) ? (1.0f / inertia.y) : 0.0f,
+		(inertia.z > 0.0f) ? (1.0f / inertia.z) : 0.0f);
+}
+
+static void WakeRigidBody(RigidBodyComponent& rigidBody)
+{
+	if (rigidBody.Asleep)
+	{
+		rigidBody.Asleep = false;
+		rigidBody.RestingTime = 0.0f;
+	}
+}
+
+static uint32_t FindSolverBody(const entt::entity entity)
+{
+	const auto bodyIterator = gSolverBodyIndices.find(entity);
+	return (bodyIterator == gSolverBodyIndices.end()) ? ContactSolver::STATIC_BODY : bodyIterator->second;
+}
+
+// Adds the entity's rigid body to the step, waking it if it sleeps. Entities without rigid bodies are static
+static uint32_t AddSolverBody(entt::registry& registry, const entt::entity entity, const float deltaTime)
+{
+	const auto existingBody = FindSolverBody(entity);
+	auto* pRigidBody = registry.try_get<RigidBodyComponent>(entity);
+	if ((existingBody != ContactSolver::STATIC_BODY) || (pRigidBody == nullptr))
+	{
+		return existingBody;
+	}
+
+	ContactSolver::Body body{};
+	body.Position = registry.get<TransformComponent>(entity).Transform.Position;
+	body.LinearVelocity = pRigidBody->Velocity;
+	if (pRigidBody->Dynamic)
+	{
+		assert(pRigidBody->Mass > 0.0f && "Dynamic rigid bodies must have a positive mass.");
+
+		WakeRigidBody(*pRigidBody);
+		Collider collider{};
+		GetCollider(registry, entity, collider);
+		body.InverseMass = 1.0f / pRigidBody->Mass;
+		body.InverseInertia = CalculateInverseInertia(*pRigidBody, collider);
+		// Locked axes do not turn
+		body.AngularVelocity = pRigidBody->AngularVelocity * glm::vec3(glm::greaterThan(body.InverseInertia, glm::vec3(0.0f)));
+		if (pRigidBody->ApplyGravity)
+		{
+			body.LinearVelocity += -World::GetWorldUpVector() * (World::GetWorldGravityAcceleration() * deltaTime);
+		}
+	}
+
+	const auto bodyIndex = static_cast<uint32_t>(gSolverBodies.size());
+	gSolverEntities.push_back(entity);
+	gSolverBodies.push_back(body);
+	gSolverBodyIndices.emplace(entity, bodyIndex);
+
+	return bodyIndex;
+}
+
+// Only reads the registry and the solver body indices, so pairs can be tested on any thread
+static bool CollideColliders(const entt::registry& registry, const entt::entity entity1, const entt::entity entity2,
+	ContactSolver::ContactManifold& manifold)
+{
+	Collider collider1{}, collider2{};
+	if (!GetCollider(registry, entity1, collider1) || !GetCollider(registry, entity2, collider2))
+	{
+		return false;
+	}
+
+	// Spheres touching boxes are always the first body
+	auto body1 = entity1;
+	auto body2 = entity2;
+	bool touching{ false };
+	if (!collider1.Sphere && !collider2.Sphere)
+	{
+		touching = ContactSolver::CollideAABBs(collider1.Position, collider1.Extent, collider2.Position, collider2.Extent, CONTACT_MARGIN,
+			manifold);
+	}
+	else if (collider1.Sphere && collider2.Sphere)
+	{
+		touching = ContactSolver::CollideSpheres(collider1.Position, collider1.Extent.x, collider2.Position, collider2.Extent.x,
+			CONTACT_MARGIN, manifold);
+	}
+	else if (collider1.Sphere)
+	{
+		touching = ContactSolver::CollideSphereAABB(collider1.Position, collider1.Extent.x, collider2.Position, collider2.Extent,
+			CONTACT_MARGIN, manifold);
+	}
+	else
+	{
+		touching = ContactSolver::CollideSphereAABB(collider2.Position, collider2.Extent.x, collider1.Position, collider1.Extent,
+			CONTACT_MARGIN, manifold);
+		std::swap(body1, body2);
+	}
+
+	if (!touching)
+	{
+		return false;
+	}
+
+	manifold.Body1 = FindSolverBody(body1);
+	manifold.Body2 = FindSolverBody(body2);
+
+	// Colliders without rigid bodies take the material of the body they touch
+	const auto* pRigidBody1 = registry.try_get<RigidBodyComponent>(body1);
+	const auto* pRigidBody2 = registry.try_get<RigidBodyComponent>(body2);
+	if ((pRigidBody1 != nullptr) && (pRigidBody2 != nullptr))
+	{
+		manifold.Friction = std::sqrt(pRigidBody1->Friction * pRigidBody2->Friction);
+		manifold.Restitution = std::max(pRigidBody1->Restitution, pRigidBody2->Restitution);
+	}
+	else
+	{
+		const auto* pRigidBody = (pRigidBody1 != nullptr) ? pRigidBody1 : pRigidBody2;
+		manifold.Friction = pRigidBody->Friction;
+		manifold.Restitution = pRigidBody->Restitution;
+	}
+
+	return true;
+}
+
+static uint32_t FindIsland(uint32_t body)
+{
+	while (gIslandParents[body] != body)
+	{
+		gIslandParents[body] = gIslandParents[gIslandParents[body]];
+		body = gIslandParents[body];
+	}
+
+	return body;
+}
+
+// Moves awake dynamic bodies by their velocities after solving the contacts between them and the colliders they touch. Islands of
+// touching bodies that have all rested long enough sleep and cost nothing until something touches them
+static void StepDynamicBodies(entt::registry& registry, const CollisionBroadphase& broadphase, const float deltaTime)
+{
+	gSolverEntities.clear();
+	gSolverBodies.clear();
+	gSolverBodyIndices.clear();
+	gColliderPairs.clear();
+	gContactManifolds.clear();
+
+	auto rigidBodyView = registry.view<TransformComponent, RigidBodyComponent>();
+	for (auto [entity, transform, rigidBody] : rigidBodyView.each())
+	{
+		if (rigidBody.Dynamic && !rigidBody.Asleep)
+		{
+			AddSolverBody(registry, entity, deltaTime);
+		}
+	}
+
+	// Find the colliders each dynamic body may touch over the step. Sleeping bodies touching them are added as they are found, so
+	// touching a sleeping island wakes all of it
+	for (uint32_t bodyIndex = 0; bodyIndex < static_cast<uint32_t>(gSolverBodies.size()); ++bodyIndex)
+	{
+		const auto entity = gSolverEntities[bodyIndex];
+		Collider collider{};
+		if ((gSolverBodies[bodyIndex].InverseMass <= 0.0f) || !GetCollider(registry, entity, collider))
+		{
+			continue;
+		}
+
+		const auto bounds = CollisionDetection::CalculateBounds(collider.Position, collider.Extent + glm::vec3(CONTACT_MARGIN));
+		const auto reach = glm::abs(gSolverBodies[bodyIndex].LinearVelocity * deltaTime);
+		const CollisionDetection::Bounds queryBounds{ bounds.Min - reach, bounds.Max + reach };
+		broadphase.Query(queryBounds, CollisionQueryFilter::ForCollision(collider.Layer, collider.Mask), [&](const entt::entity otherEntity)
+			{
+				Collider otherCollider{};
+				if ((otherEntity == entity) || !GetCollider(registry, otherEntity, otherCollider))
+				{
+					return;
+				}
+
+				// Only sleeping bodies already touching are woken
+				const auto* pOtherRigidBody = registry.try_get<RigidBodyComponent>(otherEntity);
+				if ((pOtherRigidBody != nullptr) && pOtherRigidBody->Dynamic && pOtherRigidBody->Asleep &&
+					!CollisionDetection::BoundsOverlap(bounds, CollisionDetection::CalculateBounds(otherCollider.Position, otherCollider.Extent)))
+				{
+					return;
+				}
+
+				AddSolverBody(registry, otherEntity, deltaTime);
+				gColliderPairs.emplace_back(std::min(entity, otherEntity), std::max(entity, otherEntity));
+			});
+	}
+
+	// Pairs of dynamic bodies are found by both bodies
+	std::sort(gColliderPairs.begin(), gColliderPairs.end());
+	gColliderPairs.erase(std::unique(gColliderPairs.begin(), gColliderPairs.end()), gColliderPairs.end());
+
+	// Pairs are tested across the worker threads, each writing only its pair's slot. Reading the slots back in pair order keeps the
+	// manifolds in the same order whatever the thread count, so the solver gives the same result
+	const auto pairCount = static_cast<uint32_t>(gColliderPairs.size());
+	gPairManifolds.resize(pairCount);
+	JobSystem::ParallelFor(pairCount, NARROWPHASE_GRAIN_SIZE, [&registry](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t pairIndex = begin; pairIndex < end; ++pairIndex)
+			{
+				auto& manifold = gPairManifolds[pairIndex];
+				manifold = {};
+				if (!CollideColliders(registry, gColliderPairs[pairIndex].first, gColliderPairs[pairIndex].second, manifold))
+				{
+					manifold.PointCount = 0;
+				}
+			}
+		});
+
+	for (uint32_t pairIndex = 0; pairIndex < pairCount; ++pairIndex)
+	{
+		if (gPairManifolds[pairIndex].PointCount > 0)
+		{
+			gContactManifolds.push_back(gPairManifolds[pairIndex]);
+		}
+	}
+
+	ContactSolver::Solve(gSolverBodies, gContactManifolds, deltaTime);
+
+	// Join dynamic bodies touching each other into islands. Static and kinematic bodies do not join islands together
+	const auto bodyCount = static_cast<uint32_t>(gSolverBodies.size());
+	gIslandParents.resize(bodyCount);
+	for (uint32_t bodyIndex = 0; bodyIndex < bodyCount; ++bodyIndex)
+	{
+		gIslandParents[bodyIndex] = bodyIndex;
+	}
+	for (const auto& manifold : gContactManifolds)
+	{
+		if ((manifold.Body1 != ContactSolver::STATIC_BODY) && (manifold.Body2 != ContactSolver::STATIC_BODY) &&
+			(gSolverBodies[manifold.Body1].InverseMass > 0.0f) && (gSolverBodies[manifold.Body2].InverseMass > 0.0f))
+		{
+			gIslandParents[FindIsland(manifold.Body1)] = FindIsland(manifold.Body2);
+		}
+	}
+
+	// Move the dynamic bodies and find how long each island has rested for
+	gIslandRestingTimes.assign(bodyCount, TIME_TO_SLEEP);
+	for (uint32_t bodyIndex = 0; bodyIndex < bodyCount; ++bodyIndex)
+	{
+		const auto& body = gSolverBodies[bodyIndex];
+		if (body.InverseMass <= 0.0f)
+		{
+			continue;
+		}
+
+		const auto entity = gSolverEntities[bodyIndex];
+		auto& rigidBody = registry.get<RigidBodyComponent>(entity);
+		rigidBody.Velocity = body.LinearVelocity / (1.0f + (LINEAR_DAMPING * deltaTime));
+		rigidBody.AngularVelocity = body.AngularVelocity / (1.0f + (ANGULAR_DAMPING * deltaTime));
+
+		// Bodies only turn about axes that leave their collision the same
+		auto& transform = registry.get<TransformComponent>(entity).Transform;
+		transform.Position += rigidBody.Velocity * deltaTime;
+		transform.Rotation = Maths::RotateEuler(transform.Rotation, rigidBody.AngularVelocity * deltaTime);
+
+		const auto resting = (glm::length(rigidBody.Velocity) < SLEEP_LINEAR_SPEED) && (glm::length(rigidBody.AngularVelocity) < SLEEP_ANGULAR_SPEED);
+		rigidBody.RestingTime = resting ? (rigidBody.RestingTime + deltaTime) : 0.0f;
+
+		auto& islandRestingTime = gIslandRestingTimes[FindIsland(bodyIndex)];
+		islandRestingTime = std::min(islandRestingTime, rigidBody.RestingTime);
+	}
+
+	// Put islands that have rested long enough to sleep
+	for (uint32_t bodyIndex = 0; bodyIndex < bodyCount; ++bodyIndex)
+	{
+		if ((gSolverBodies[bodyIndex].InverseMass <= 0.0f) || (gIslandRestingTimes[FindIsland(bodyIndex)] < TIME_TO_SLEEP))
+		{
+			continue;
+		}
+
+		auto& rigidBody = registry.get<RigidBodyComponent>(gSolverEntities[bodyIndex]);
+		rigidBody.Asleep = true;
+		rigidBody.Velocity = glm::vec3(0.0f);
+		rigidBody.AngularVelocity = glm::vec3(0.0f);
+	}
+}
+
+void Physics::Update(Level& level, const float deltaTime)
 {
 	// Get level ECS registry
 	auto& ecsRegistry = level.GetECSRegistry();
 
+	// Update the broadphase with the colliders of moving entities
+	auto& broadphase = level.GetCollisionBroadphase();
+	broadphase.Update(ecsRegistry);
+
 	// Create a view of entities with rigidbody and transform components
 	auto rigidBodyView = ecsRegistry.view<TransformComponent, RigidBodyComponent>();
 
-	// Create a view of entities with AABBCollisionComponents and transform components
-	auto aabbView = ecsRegistry.view<TransformComponent, AABBCollisionComponent>();
-
 	// For each entity with a rigidbody
 	for (auto [rigidBodyEntity, rigidBodyEntityTransform, rigidBody] : rigidBodyView.each())
 	{
+		// Dynamic bodies are moved by the contact solver
+		if (rigidBody.Dynamic)
+		{
+			continue;
+		}
+
 		// Check if gravity should be applied to the rigidbody
+		auto velocity = rigidBody.Velocity;
 		if (rigidBody.ApplyGravity)
 		{
 			// Add gravity to rigidbody velocity
-			rigidBody.Velocity += -World::GetWorldUpVector() * World::GetWorldGravityScale();
+			velocity += -World::GetWorldUpVector() * World::GetWorldGravityScale();
 		}
 
-		// Compute next position of the entity
-		auto nextPosition = rigidBodyEntityTransform.Transform.Position + rigidBody.Velocity;
+		// Compute the displacement of the entity over the step
+		auto displacement = velocity * deltaTime;
 
 		// Check if the entity has a sphere collision component
-		if (ecsRegistry.any_of<SphereCollisionComponent>(rigidBodyEntity))
+		const auto* pSphere = ecsRegistry.try_get<SphereCollisionComponent>(rigidBodyEntity);
+		if (pSphere == nullptr)
+		{
+			// Apply displacement to transform. Velocity is kept for every step until it is changed
+			rigidBodyEntityTransform.Transform.Position += displacement;
+			continue;
+		}
+
+		// Gather the AABB collisions the broadphase finds within reach of the sphere's motion. Slides never move the sphere further
+		// than the displacement
+		gCandidateAABBs.Clear();
+		gCandidateEntities.clear();
+		const auto reach = pSphere->Radius + glm::length(displacement) + COLLISION_SKIN_WIDTH;
+		broadphase.Query(CollisionDetection::CalculateBounds(rigidBodyEntityTransform.Transform.Position, glm::vec3(reach)),
+			CollisionQueryFilter::ForCollision(pSphere->CollisionLayer, pSphere->CollisionMask),
+			[&](const entt::entity aabbEntity)
+			{
+				// Prevent collisions with self
+				if (aabbEntity == rigidBodyEntity)
+				{
+					return;
+				}
+
+				// Check the entity has an aabb. The broadphase only finds entities on layers colliding with the sphere
+				const auto* pAABB = ecsRegistry.try_get<AABBCollisionComponent>(aabbEntity);
+				if (pAABB == nullptr)
+				{
+					return;
+				}
+
+				gCandidateAABBs.Add(ecsRegistry.get<TransformComponent>(aabbEntity).Transform.Position, pAABB->Extent);
+				gCandidateEntities.push_back(aabbEntity);
+			});
+
+		// Sweep the sphere along the displacement, stopping at the first box hit and sliding the remaining displacement along it
+		auto& position = rigidBodyEntityTransform.Transform.Position;
+		for (uint32_t iteration = 0; iteration < MAX_SLIDE_ITERATIONS; ++iteration)
 		{
-			// Test sphere collision against all AABB collisions in the level
-			for (auto [aabbEntity, aabbEntityTransform, aabb] : aabbView.each())
+			const auto distance = glm::length(displacement);
+			if (distance <= 0.0f)
 			{
-				// Check if the aabb can collide with sphere collisions and collisions are enabled
-				if (aabb.CanCollideWithSphereCollisions && aabb.CollisionEnabled)
+				break;
+			}
+
+			// Only boxes overlapping a sphere enclosing the whole slide can be hit by it. The batch test rejects the rest of the
+			// candidates before the more costly sweeps
+			if (CollisionDetection::TestSphereAABBBatch(position + (displacement * 0.5f), pSphere->Radius + (distance * 0.5f) + COLLISION_SKIN_WIDTH,
+				gCandidateAABBs, gCandidateHitMasks, gCandidateHitSurfaceNormals) == 0)
+			{
+				position += displacement;
+				break;
+			}
+
+			// Find the earliest hit along the displacement
+			auto timeOfImpact = 1.0f;
+			glm::vec3 hitSurfaceNormal{ 0.0f, 0.0f, 0.0f };
+			auto hit = false;
+			uint32_t hitCandidate{ 0 };
+			for (uint32_t maskIndex = 0; maskIndex < static_cast<uint32_t>(gCandidateHitMasks.size()); ++maskIndex)
+			{
+				for (auto hitMask = gCandidateHitMasks[maskIndex]; hitMask != 0; hitMask &= hitMask - 1)
 				{
-					// Prevent collisions with self
-					if (aabbEntity != rigidBodyEntity)
+					const auto i = (maskIndex * CollisionDetection::HIT_MASK_BIT_COUNT) + static_cast<uint32_t>(std::countr_zero(hitMask));
+					const glm::vec3 aabbPosition(gCandidateAABBs.CenterX[i], gCandidateAABBs.CenterY[i], gCandidateAABBs.CenterZ[i]);
+					const glm::vec3 aabbExtent(gCandidateAABBs.ExtentX[i], gCandidateAABBs.ExtentY[i], gCandidateAABBs.ExtentZ[i]);
+					float aabbTimeOfImpact{ 0.0f };
+					glm::vec3 aabbHitSurfaceNormal{};
+					if (CollisionDetection::SweepSphereAABB(position, pSphere->Radius, displacement, aabbPosition, aabbExtent, aabbTimeOfImpact,
+						aabbHitSurfaceNormal) && (aabbTimeOfImpact < timeOfImpact))
 					{
-						CollisionDetection::CollisionTestResult testResult;
-						if (CollisionDetection::TestSphereAABB(nextPosition, ecsRegistry.get<SphereCollisionComponent>(rigidBodyEntity),
-							aabbEntityTransform.Transform.Position, aabb, testResult))
-						{
-							// Remove collision normal from rigidbody velocity
-							rigidBody.Velocity -= testResult.HitSurfaceNormal * glm::dot(rigidBody.Velocity, testResult.HitSurfaceNormal);
-						}
+						timeOfImpact = aabbTimeOfImpact;
+						hitSurfaceNormal = aabbHitSurfaceNormal;
+						hit = true;
+						hitCandidate = i;
 					}
 				}
 			}
-		}
 
-		// Apply velocity to transform
-		rigidBodyEntityTransform.Transform.Position += rigidBody.Velocity;
+			if (!hit)
+			{
+				position += displacement;
+				break;
+			}
+
+			// Wake sleeping dynamic bodies the sphere runs into so the contact solver can push them
+			if (auto* pHitRigidBody = ecsRegistry.try_get<RigidBodyComponent>(gCandidateEntities[hitCandidate]))
+			{
+				WakeRigidBody(*pHitRigidBody);
+			}
+
+			// Move up to the hit, stopping short by the skin width
+			const auto travelled = std::max((distance * timeOfImpact) - COLLISION_SKIN_WIDTH, 0.0f);
+			position += displacement * (travelled / distance);
 
-		// Zero velocity
-		rigidBody.Velocity = { 0.0f, 0.0f, 0.0f };
+			// Remove collision normal from the remaining displacement
+			displacement *= 1.0f - timeOfImpact;
+			displacement -= hitSurfaceNormal * glm::dot(displacement, hitSurfaceNormal);
+		}
 	}
+
+	StepDynamicBodies(ecsRegistry, broadphase, deltaTime);
 }
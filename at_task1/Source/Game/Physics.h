@@ -4,6 +4,6 @@ class Level;
 
 namespace Physics
 {
-	// Update physics for a level
-	void Update(Level& level);
+	// Steps physics for a level by a fixed timestep in milliseconds
+	void Update(Level& level, const float deltaTime);
 }
\ No newline at end of file
@@ -10,7 +10,12 @@ static std::unique_ptr<Level> gLoadedLevel{};
 static std::unique_ptr<Level> gScheduledLevel{};
 
 static float gWorldDeltaTime{ 0.0f };
-static float gWorldGravityScale{ 0.05f };
+static float gFixedTimestep{ 1000.0f / 60.0f };
+static uint32_t gMaxFixedStepsPerFrame{ 5 };
+// Speed in units per millisecond gravity moves rigid bodies at
+static float gWorldGravityScale{ 0.003125f };
+// Units per millisecond squared. Earth's gravity when a unit is a metre
+static float gWorldGravityAcceleration{ 0.00000981f };
 
 const glm::vec3& World::GetWorldForwardVector()
 {
@@ -42,6 +47,27 @@ void World::SetWorldDeltaTime(const float deltaTime)
 	gWorldDeltaTime = deltaTime;
 }
 
+float World::GetFixedTimestep()
+{
+	return gFixedTimestep;
+}
+
+void World::SetFixedTickRate(const float ticksPerSecond)
+{
+	assert(ticksPerSecond > 0.0f && "Fixed tick rate must be positive.");
+	gFixedTimestep = 1000.0f / ticksPerSecond;
+}
+
+uint32_t World::GetMaxFixedStepsPerFrame()
+{
+	return gMaxFixedStepsPerFrame;
+}
+
+void World::SetMaxFixedStepsPerFrame(const uint32_t stepCount)
+{
+	gMaxFixedStepsPerFrame = std::max(stepCount, 1u);
+}
+
 float World::GetWorldGravityScale()
 {
 	return gWorldGravityScale;
@@ -52,6 +78,16 @@ void World::SetWorldGravityScale(float scale)
 	gWorldGravityScale = scale;
 }
 
+float World::GetWorldGravityAcceleration()
+{
+	return gWorldGravityAcceleration;
+}
+
+void World::SetWorldGravityAcceleration(const float acceleration)
+{
+	gWorldGravityAcceleration = acceleration;
+}
+
 bool World::LoadLevel(std::unique_ptr<Level>&& level, const bool force)
 {
 	gScheduledLevel = std::move(level);
@@ -81,15 +117,38 @@ bool World::LoadScheduledLevel()
 		gLoadedLevel->UnLoad();
 	}
 
+	// Materials are registered again by the level being loaded
+	Renderer::ClearMaterials();
+
 	gLoadedLevel = std::move(gScheduledLevel);
 	gScheduledLevel = nullptr;
 
+	// Upload the level's geometry and textures together
+	Renderer::BeginUploadBatch();
+
+	// Close the batch when loading fails so the next level load can open one
 	if (!gLoadedLevel->Load())
 	{
+		Renderer::AbortUploadBatch();
+		return false;
+	}
+
+	// Record the level's static geometry
+	if (!Renderer::RecordStaticGeometry(*gLoadedLevel))
+	{
+		Renderer::AbortUploadBatch();
 		return false;
 	}
 
-	// Update renderer descriptors with loaded textures
+	if (!Renderer::EndUploadBatch())
+	{
+		return false;
+	}
+
+	// Build the broadphase over the loaded level's colliders
+	gLoadedLevel->GetCollisionBroadphase().Build(gLoadedLevel->GetECSRegistry());
+
+	// Update renderer descriptors with loaded textures and the level's lightmap
 	Renderer::UpdateDescriptorSets();
 
 	// Begin the loaded level
@@ -12,8 +12,18 @@ namespace World
 	float GetWorldDeltaTime();
 	void SetWorldDeltaTime(const float deltaTime);
 
+	// Physics and gameplay are simulated in fixed steps of this many milliseconds
+	float GetFixedTimestep();
+	void SetFixedTickRate(const float ticksPerSecond);
+	// Time a frame falls behind the simulation beyond this many steps is dropped so slow frames do not take longer to simulate
+	uint32_t GetMaxFixedStepsPerFrame();
+	void SetMaxFixedStepsPerFrame(const uint32_t stepCount);
+
 	float GetWorldGravityScale();
 	void SetWorldGravityScale(float scale);
+	// Units per millisecond squared dynamic rigid bodies accelerate at while falling
+	float GetWorldGravityAcceleration();
+	void SetWorldGravityAcceleration(const float acceleration);
 
 	bool LoadLevel(std::unique_ptr<Level>&& level, const bool force);
 	bool IslevelScheduled();
@@ -0,0 +1,135 @@
+#include "Pch.h"
+#include "JobSystem.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+static std::vector<std::thread> gWorkers;
+static std::mutex gMutex;
+static std::condition_variable gJobAvailable;
+static std::condition_variable gJobComplete;
+static bool gQuit{ false };
+static uint32_t gActiveWorkerCount{ 0 };
+
+// The parallel for being run. Only changed while no workers are active
+static const JobSystem::RangeFunction* gpFunction{ nullptr };
+static uint32_t gCount{ 0 };
+static uint32_t gGrainSize{ 1 };
+static uint32_t gRangeCount{ 0 };
+static uint64_t gJobGeneration{ 0 };
+static std::atomic<uint32_t> gNextRange{ 0 };
+static std::atomic<uint32_t> gCompletedRangeCount{ 0 };
+
+// Runs ranges of the current parallel for until none are left
+static void RunRanges()
+{
+	for (auto range = gNextRange.fetch_add(1); range < gRangeCount; range = gNextRange.fetch_add(1))
+	{
+		const auto begin = range * gGrainSize;
+		(*gpFunction)(begin, std::min(begin + gGrainSize, gCount));
+		gCompletedRangeCount.fetch_add(1);
+	}
+}
+
+static void WorkerMain()
+{
+	uint64_t runGeneration{ 0 };
+
+	std::unique_lock<std::mutex> lock(gMutex);
+	while (true)
+	{
+		// Wait for a new parallel for
+		gJobAvailable.wait(lock, [&runGeneration]() { return gQuit || gJobGeneration != runGeneration; });
+		if (gQuit)
+		{
+			return;
+		}
+
+		runGeneration = gJobGeneration;
+		++gActiveWorkerCount;
+		lock.unlock();
+
+		RunRanges();
+
+		lock.lock();
+		--gActiveWorkerCount;
+		gJobComplete.notify_all();
+	}
+}
+
+bool JobSystem::Init()
+{
+	// Use a worker for each hardware thread other than the main thread
+	const auto hardwareThreadCount = std::thread::hardware_concurrency();
+	const auto workerCount = (hardwareThreadCount > 1) ? hardwareThreadCount - 1 : 0;
+
+	gQuit = false;
+	gWorkers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		gWorkers.emplace_back(WorkerMain);
+	}
+
+	return true;
+}
+
+void JobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(gMutex);
+		gQuit = true;
+	}
+	gJobAvailable.notify_all();
+
+	for (auto& worker : gWorkers)
+	{
+		worker.join();
+	}
+	gWorkers.clear();
+}
+
+uint32_t JobSystem::GetWorkerCount()
+{
+	return static_cast<uint32_t>(gWorkers.size());
+}
+
+void JobSystem::ParallelFor(const uint32_t count, const uint32_t grainSize, const RangeFunction& function)
+{
+	assert(grainSize > 0 && "Parallel for grain size must be greater than 0.");
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Run on the calling thread when there is a single range or no workers
+	if (gWorkers.empty() || count <= grainSize)
+	{
+		function(0, count);
+		return;
+	}
+
+	// Publish the parallel for once workers have left the previous one
+	{
+		std::unique_lock<std::mutex> lock(gMutex);
+		gJobComplete.wait(lock, []() { return gActiveWorkerCount == 0; });
+
+		gpFunction = &function;
+		gCount = count;
+		gGrainSize = grainSize;
+		gRangeCount = (count + grainSize - 1) / grainSize;
+		gNextRange = 0;
+		gCompletedRangeCount = 0;
+		++gJobGeneration;
+	}
+	gJobAvailable.notify_all();
+
+	// The calling thread runs ranges alongside the workers
+	RunRanges();
+
+	// Wait for ranges still running on workers
+	std::unique_lock<std::mutex> lock(gMutex);
+	gJobComplete.wait(lock, []() { return gCompletedRangeCount == gRangeCount && gActiveWorkerCount == 0; });
+}
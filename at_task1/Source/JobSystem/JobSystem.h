@@ -0,0 +1,14 @@
+#pragma once
+
+namespace JobSystem
+{
+	// Runs a contiguous range [begin, end) of a parallel for
+	using RangeFunction = std::function<void(const uint32_t begin, const uint32_t end)>;
+
+	bool Init();
+	void Shutdown();
+	uint32_t GetWorkerCount();
+	// Splits [0, count) into ranges of grainSize and runs them on the worker threads and the calling thread. Returns once every
+	// range has run. Must only be called from the main thread
+	void ParallelFor(const uint32_t count, const uint32_t grainSize, const RangeFunction& function);
+}
\ No newline at end of file
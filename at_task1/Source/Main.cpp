@@ -6,15 +6,18 @@
 #include "Renderer/Renderer.h"
 #include "Audio/Audio.h"
 #include "Maths/Maths.h"
+#include "JobSystem/JobSystem.h"
 
 #include "Game/World.h"
 #include "Game/GameInput.h"
 #include "Game/GameState.h"
 #include "Game/Physics.h"
+#include "Game/CollisionDetection.h"
 #include "Game/Billboard.h"
 #include "Game/LevelGoal.h"
 #include "Game/EnemyAI.h"
 #include "Game/Levitate.h"
+#include "Game/Interpolation.h"
 
 #include "Game/Components/TransformComponent.h"
 #include "Game/Components/CameraComponent.h"
@@ -93,22 +96,78 @@ int WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPS
 			{
 				pMainWindow->Close();
 			}
+
+			// Write the software renderer's last frame to a bitmap if F12 is pressed
+			if (event.Input == InputCodes::F12 && event.Data == 1.0f && !Renderer::WriteFramebuffer("Screenshot.bmp"))
+			{
+				LOG("Failed to write the framebuffer. Framebuffers can only be written by the software renderer.");
+			}
 		});
 
 	// Subscribe handler for input events for the application
 	EventSystem::SubscribeToEvent<InputEvent>(GameInput::HandleInputEvent);
 
+	// Initialise worker threads
+	if (!JobSystem::Init())
+	{
+		return 1;
+	}
+
+	const std::string commandLine(lpCmdLine);
+
+	// Print the cost of batched sphere AABB tests against testing pairs one at a time when -collisionbenchmark is passed on the command
+	// line. Release builds have no console until one is created for the results
+	if (commandLine.find("-collisionbenchmark") != std::string::npos)
+	{
+		Console::CreateConsole(4096);
+		CollisionDetection::RunSphereAABBBenchmark();
+	}
+
+	// Use the null renderer backend when -nullrenderer is passed on the command line. No GPU work is done so the CPU cost
+	// of rendering can be profiled on machines without a GPU. -softwarerenderer rasterizes frames on the CPU instead
+	auto rendererBackend = Renderer::EBackend::VULKAN;
+	if (commandLine.find("-nullrenderer") != std::string::npos)
+	{
+		rendererBackend = Renderer::EBackend::NULL_BACKEND;
+	}
+	else if (commandLine.find("-softwarerenderer") != std::string::npos)
+	{
+		rendererBackend = Renderer::EBackend::SOFTWARE;
+	}
+
 	// Initialise the renderer
 	RECT windowClientAreaRect;
 	mainWindow->GetClientAreaRect(windowClientAreaRect);
 	if (!Renderer::Init(
 		{windowClientAreaRect.right - windowClientAreaRect.left, windowClientAreaRect.bottom - windowClientAreaRect.top}, 
-		mainWindow->GetHandle()))
+		mainWindow->GetHandle(),
+		rendererBackend))
 	{
 		return 1;
 	}
 	Renderer::SetVulkanDebugReportLevel(Renderer::EVulkanDebugReportLevel::ERR);
 
+	// Set the streamed texture memory budget in megabytes from -texturebudget=<megabytes> on the command line
+	const std::string textureBudgetArgument("-texturebudget=");
+	const auto textureBudgetArgumentPosition = commandLine.find(textureBudgetArgument);
+	if (textureBudgetArgumentPosition != std::string::npos)
+	{
+		const auto megabytes = std::strtoull(commandLine.c_str() + textureBudgetArgumentPosition + textureBudgetArgument.size(), nullptr, 10);
+		Renderer::SetTextureMemoryBudget(megabytes * 1024 * 1024);
+	}
+
+	// Set the rate physics and gameplay are simulated at in steps per second from -tickrate=<rate> on the command line
+	const std::string tickRateArgument("-tickrate=");
+	const auto tickRateArgumentPosition = commandLine.find(tickRateArgument);
+	if (tickRateArgumentPosition != std::string::npos)
+	{
+		const auto tickRate = std::strtof(commandLine.c_str() + tickRateArgumentPosition + tickRateArgument.size(), nullptr);
+		if (tickRate > 0.0f)
+		{
+			World::SetFixedTickRate(tickRate);
+		}
+	}
+
 	// Initialise audio
 	if (!Audio::Init())
 	{
@@ -140,7 +199,6 @@ int WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPS
 	// Enter main loop
 	using namespace std::chrono_literals;
 	using clock = std::chrono::high_resolution_clock;
-	constexpr std::chrono::nanoseconds fixedTimestep( 16ms );
 	std::chrono::nanoseconds lag(0ns);
 	auto currentTime = clock::now();
 	while (!gQuit)
@@ -171,36 +229,54 @@ int WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPS
 			break;
 		}
 
-		// Generate gamepad events for frame
-		GamepadManager::RefreshGamepadPorts();
-
 		// Poll game inputs
 		GameInput::PollInputs();
 
+		// Generate gamepad events for frame. Sent after polling as polling resets the movement input
+		GamepadManager::RefreshGamepadPorts();
+
 		// Tick the game state
 		GameState::Tick(fDeltaTime);
 
 		// Tick the loaded level
 		loadedLevel.Tick(fDeltaTime);
 
-		while (lag >= fixedTimestep)
+		// Simulate the game in fixed steps so the simulation does not depend on the frame rate. Frames faster than the step rate
+		// simulate nothing and are interpolated between steps
+		const auto fixedTimestep = World::GetFixedTimestep();
+		const auto fixedTimestepDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<float, std::milli>(fixedTimestep));
+		uint32_t fixedStepCount{ 0 };
+		while ((lag >= fixedTimestepDuration) && (fixedStepCount < World::GetMaxFixedStepsPerFrame()))
 		{
-			lag -= fixedTimestep;
+			lag -= fixedTimestepDuration;
+			++fixedStepCount;
+
+			// Save the transforms rendering interpolates from
+			Interpolation::SaveTransforms(loadedLevel);
 
 			// Fixed tick the loaded level
 			loadedLevel.TickFixed();
+
+			// Update game systems
+			Levitate::Update(loadedLevel, fixedTimestep);
+			if (GameState::GetCurrentState() == GameState::EState::IN_GAME)
+			{
+				Billboard::Update(loadedLevel);
+				Physics::Update(loadedLevel, fixedTimestep);
+				LevelGoal::Update(loadedLevel);
+				EnemyAI::Update(loadedLevel, fixedTimestep);
+			}
 		}
 
-		// Update game systems
-		Levitate::Update(loadedLevel);
-		if (GameState::GetCurrentState() == GameState::EState::IN_GAME)
+		// Drop the whole steps the simulation could not catch up on
+		if (lag >= fixedTimestepDuration)
 		{
-			Billboard::Update(loadedLevel);
-			Physics::Update(loadedLevel);
-			LevelGoal::Update(loadedLevel);
-			EnemyAI::Update(loadedLevel);
+			lag %= fixedTimestepDuration;
 		}
 
+		// Fraction of a step the frame is past the latest step
+		const auto interpolation = std::chrono::duration<float>(lag) / std::chrono::duration<float>(fixedTimestepDuration);
+
 		// Update audio
 		Maths::Transform possessedEntityTransform{};
 		glm::vec3 possessedEntityVelocity{};
@@ -227,23 +303,37 @@ int WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPS
 				assert(false && "Renderer failed to begin a frame.");
 			}
 
-			// Get the possessed transform and camera component
-			TransformComponent possessedTransformComponent{};
-			CameraComponent possessedCameraComponent{};
+			// View the level from the possessed entity's camera followed by the camera of each split screen entity
+			std::array<Renderer::View, Renderer::MAX_VIEW_COUNT> views{};
+			uint32_t viewCount{ 1 };
 
 			if (possessedEntityValid)
 			{
-				possessedTransformComponent = loadedLevel.GetPossessedEntity()->GetComponent<TransformComponent>();
-				possessedCameraComponent = loadedLevel.GetPossessedEntity()->GetComponent<CameraComponent>();
+				// Look from the interpolated position. Rotation is applied by input every frame so is not interpolated
+				const auto& possessedTransformComponent = loadedLevel.GetPossessedEntity()->GetComponent<TransformComponent>();
+				views[0].Position = Interpolation::CalculateRenderTransform(loadedLevel.GetECSRegistry(), possessedEntity->GetID(),
+					possessedTransformComponent.Transform, interpolation).Position;
+				views[0].Rotation = possessedTransformComponent.Transform.Rotation;
+				views[0].CameraSettings = loadedLevel.GetPossessedEntity()->GetComponent<CameraComponent>().CameraSettings;
 			}
 
-			// Begin render pass with the main scene camera
-			Renderer::BeginRenderPass(possessedTransformComponent.Transform.Position,
-				possessedTransformComponent.Transform.Rotation,
-				possessedCameraComponent.CameraSettings);
+			for (const auto& splitScreenEntity : loadedLevel.GetSplitScreenEntities())
+			{
+				if (!splitScreenEntity.Valid() || viewCount == Renderer::MAX_VIEW_COUNT)
+				{
+					continue;
+				}
+
+				auto& view = views[viewCount++];
+				const auto& splitScreenTransformComponent = splitScreenEntity.GetComponent<TransformComponent>();
+				view.Position = Interpolation::CalculateRenderTransform(loadedLevel.GetECSRegistry(), splitScreenEntity.GetID(),
+					splitScreenTransformComponent.Transform, interpolation).Position;
+				view.Rotation = splitScreenTransformComponent.Transform.Rotation;
+				view.CameraSettings = splitScreenEntity.GetComponent<CameraComponent>().CameraSettings;
+			}
 
 			// Submit the level
-			if (!Renderer::SubmitLevel(loadedLevel))
+			if (!Renderer::SubmitLevel(loadedLevel, views.data(), viewCount, interpolation))
 			{
 				assert(false && "Renderer failed to render submitted level.");
 			}
@@ -294,9 +384,11 @@ int WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPS
 	// Shutdown audio
 	Audio::Shutdown();
 
-#ifdef _DEBUG
+	// Shutdown worker threads
+	JobSystem::Shutdown();
+
+	// Releases the console if the debug build or the collision benchmark created one
 	Console::ReleaseConsole();
-#endif // _DEBUG
 
 	return 0;
 }
\ No newline at end of file
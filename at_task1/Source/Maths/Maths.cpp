@@ -91,7 +91,70 @@ glm::vec3 Maths::RotateVector(const glm::vec3& rotation, const glm::vec3& vector
 	return rotationMatrix * vector;
 }
 
+glm::vec3 Maths::RotateEuler(const glm::vec3& rotation, const glm::vec3& rotationVector)
+{
+	const auto angle = glm::length(rotationVector);
+	if (angle <= 0.0f)
+	{
+		return rotation;
+	}
+
+	const auto rotationQuaternion = glm::angleAxis(angle, rotationVector / angle) * glm::quat(glm::radians(rotation));
+	const auto rotated = glm::degrees(glm::eulerAngles(rotationQuaternion));
+
+	// Unwrap each angle to the turn nearest the original
+	return rotated + (360.0f * glm::round((rotation - rotated) / 360.0f));
+}
+
 float Maths::Lerp(float a, float b, float alpha)
 {
 	return a * (1.0f - alpha) + b * alpha;
 }
+
+Maths::Transform Maths::InterpolateTransform(const Transform& a, const Transform& b, const float alpha)
+{
+	// Euler angles of the same rotation can differ by half a turn on several axes, so rotations are blended as quaternions
+	const auto rotation = glm::slerp(glm::quat(glm::radians(a.Rotation)), glm::quat(glm::radians(b.Rotation)), alpha);
+
+	return { glm::mix(a.Position, b.Position, alpha), glm::degrees(glm::eulerAngles(rotation)), glm::mix(a.Scale, b.Scale, alpha) };
+}
+
+std::array<glm::vec4, 6> Maths::CalculateFrustumPlanes(const glm::mat4& viewProjectionMatrix)
+{
+	// Get the rows of the matrix as the columns of its transpose. Clip space depth is in the range zero to one
+	const auto rows = glm::transpose(viewProjectionMatrix);
+	const auto& row0 = rows[0];
+	const auto& row1 = rows[1];
+	const auto& row2 = rows[2];
+	const auto& row3 = rows[3];
+
+	std::array<glm::vec4, 6> planes{
+		row3 + row0,
+		row3 - row0,
+		row3 + row1,
+		row3 - row1,
+		row2,
+		row3 - row2
+	};
+
+	for (auto& plane : planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return planes;
+}
+
+bool Maths::SphereIntersectsFrustum(const glm::vec3& center, const float radius, const std::array<glm::vec4, 6>& frustumPlanes)
+{
+	for (const auto& plane : frustumPlanes)
+	{
+		// Check if the sphere is entirely behind the plane
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -14,5 +14,14 @@ namespace Maths
 	// Returns an euler rotation expressed in degrees
 	glm::vec3 RotationMatrix4ToEuler(const glm::mat4& matrix);
 	glm::vec3 RotateVector(const glm::vec3& rotation, const glm::vec3& vector);
+	// Turns an euler rotation expressed in degrees about the world axes by a rotation vector in radians. Each angle stays within half a
+	// turn of the original so the rotations interpolate smoothly
+	glm::vec3 RotateEuler(const glm::vec3& rotation, const glm::vec3& rotationVector);
 	float Lerp(float a, float b, float alpha);
+	// Blends each component of the transforms. Rotations are blended along the shortest arc between them
+	Transform InterpolateTransform(const Transform& a, const Transform& b, const float alpha);
+	// Returns the left, right, bottom, top, near and far planes of a view projection's frustum. Plane normals point into the frustum
+	// and are normalized so the plane equations give distances
+	std::array<glm::vec4, 6> CalculateFrustumPlanes(const glm::mat4& viewProjectionMatrix);
+	bool SphereIntersectsFrustum(const glm::vec3& center, const float radius, const std::array<glm::vec4, 6>& frustumPlanes);
 }
\ No newline at end of file
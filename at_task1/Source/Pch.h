@@ -20,6 +20,7 @@
 #include <filesystem>
 #include <fstream>
 #include <queue>
+#include <unordered_map>
 
 // GLM maths library
 #define GLM_FORCE_RADIANS
@@ -0,0 +1,87 @@
+#include "Pch.h"
+#include "CommandList.h"
+
+void Renderer::CommandList::BindPipeline(const PipelineState& state)
+{
+	if (BoundPipeline == state)
+	{
+		return;
+	}
+
+	Commands.push_back({ ECommandType::BIND_PIPELINE, state.Pack(), 0 });
+	BoundPipeline = state;
+}
+
+void Renderer::CommandList::BindBuffers(const EBufferSource source, const uint32_t geometryID)
+{
+	const auto buffers = std::make_pair(source, geometryID);
+	if (BoundBuffers == buffers)
+	{
+		return;
+	}
+
+	Commands.push_back({ ECommandType::BIND_BUFFERS, static_cast<uint32_t>(source), geometryID });
+	BoundBuffers = buffers;
+}
+
+void Renderer::CommandList::SetDrawData(const uint32_t perObjectUniformOffset, const uint32_t perRenderPassUniformOffset)
+{
+	Commands.push_back({ ECommandType::SET_DRAW_DATA, perObjectUniformOffset, perRenderPassUniformOffset });
+}
+
+void Renderer::CommandList::DrawIndexed(const uint32_t indexCount, const uint32_t firstIndex)
+{
+	Commands.push_back({ ECommandType::DRAW_INDEXED, indexCount, firstIndex });
+}
+
+void Renderer::CommandList::SetViewport(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height)
+{
+	assert(x <= 0xFFFF && y <= 0xFFFF && width <= 0xFFFF && height <= 0xFFFF && "Viewport is too large to pack into a command.");
+
+	const auto viewport = std::make_pair(x | (y << 16), width | (height << 16));
+	if (BoundViewport == viewport)
+	{
+		return;
+	}
+
+	Commands.push_back({ ECommandType::SET_VIEWPORT, viewport.first, viewport.second });
+	BoundViewport = viewport;
+}
+
+void Renderer::CommandList::Reset()
+{
+	Commands.clear();
+	BoundPipeline.reset();
+	BoundBuffers.reset();
+	BoundViewport.reset();
+}
+
+void Renderer::CommandList::CountCommands(CommandStatistics& statistics) const
+{
+	for (const auto& command : Commands)
+	{
+		switch (command.Type)
+		{
+		case ECommandType::BIND_PIPELINE:
+			++statistics.PipelineBinds;
+			break;
+
+		case ECommandType::BIND_BUFFERS:
+			++statistics.BufferBinds;
+			break;
+
+		case ECommandType::SET_DRAW_DATA:
+			++statistics.DrawDataUpdates;
+			break;
+
+		case ECommandType::DRAW_INDEXED:
+			++statistics.Draws;
+			statistics.Indices += command.Arg0;
+			break;
+
+		case ECommandType::SET_VIEWPORT:
+			++statistics.ViewportChanges;
+			break;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PipelineState.h"
+
+namespace Renderer
+{
+	// Buffers a command list can bind. Geometry buffers are identified by the geometry ID
+	enum class EBufferSource : uint8_t
+	{
+		GEOMETRY = 0,
+		SPRITE_BATCH
+	};
+
+	enum class ECommandType : uint8_t
+	{
+		BIND_PIPELINE = 0,
+		BIND_BUFFERS,
+		SET_DRAW_DATA,
+		DRAW_INDEXED,
+		SET_VIEWPORT
+	};
+
+	// A backend agnostic draw command. Arguments by type:
+	// BIND_PIPELINE: Arg0 packed pipeline state
+	// BIND_BUFFERS: Arg0 buffer source, Arg1 geometry ID
+	// SET_DRAW_DATA: Arg0 per object uniform offset, Arg1 per render pass uniform offset
+	// DRAW_INDEXED: Arg0 index count, Arg1 first index
+	// SET_VIEWPORT: Arg0 x in the low 16 bits and y in the high 16 bits, Arg1 width in the low 16 bits and height in the high 16 bits
+	struct Command
+	{
+		ECommandType Type{ ECommandType::DRAW_INDEXED };
+		uint32_t Arg0{ 0 };
+		uint32_t Arg1{ 0 };
+	};
+
+	// Number of each type of command recorded in a frame
+	struct CommandStatistics
+	{
+		uint32_t PipelineBinds{ 0 };
+		uint32_t BufferBinds{ 0 };
+		uint32_t DrawDataUpdates{ 0 };
+		uint32_t Draws{ 0 };
+		uint32_t Indices{ 0 };
+		uint32_t ViewportChanges{ 0 };
+	};
+
+	// Records draw commands to be translated by a renderer backend. Binds of state that is already bound are skipped. Command lists
+	// begin with a viewport covering the whole surface
+	class CommandList
+	{
+	public:
+		void BindPipeline(const PipelineState& state);
+		void BindBuffers(const EBufferSource source, const uint32_t geometryID = 0);
+		void SetDrawData(const uint32_t perObjectUniformOffset, const uint32_t perRenderPassUniformOffset);
+		void DrawIndexed(const uint32_t indexCount, const uint32_t firstIndex);
+		// Sets the viewport and scissor rectangle in pixels
+		void SetViewport(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height);
+		void Reset();
+
+		void CountCommands(CommandStatistics& statistics) const;
+
+		const std::vector<Command>& GetCommands() const { return Commands; }
+
+	private:
+		std::vector<Command> Commands;
+
+		// Currently bound state used to skip redundant binds
+		std::optional<PipelineState> BoundPipeline;
+		std::optional<std::pair<EBufferSource, uint32_t>> BoundBuffers;
+		std::optional<std::pair<uint32_t, uint32_t>> BoundViewport;
+	};
+}
\ No newline at end of file
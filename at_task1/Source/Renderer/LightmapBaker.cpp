@@ -0,0 +1,455 @@
+#include "Pch.h"
+#include "LightmapBaker.h"
+#include "Vertex1Pos2UV1Norm.h"
+#include "DirectionalLight.h"
+#include "BinarySystem/Binary.h"
+#include "JobSystem/JobSystem.h"
+
+// Charts
+constexpr float TEXELS_PER_UNIT{ 4.0f };
+// Charts are scaled down to fit their longest side in the max chart size so large surfaces do not fill the atlas
+constexpr float MAX_CHART_SIZE{ 128.0f };
+constexpr uint32_t CHART_PADDING{ 1 };
+constexpr uint32_t MIN_ATLAS_WIDTH{ 64 };
+constexpr uint32_t MAX_ATLAS_SIZE{ 4096 };
+
+// Lighting
+// Matches the ambient light of the mesh fragment shader
+constexpr glm::vec3 AMBIENT_LIGHT{ 0.05f, 0.05f, 0.05f };
+// Surface textures are only on the GPU so bounced light assumes a grey albedo
+constexpr float SURFACE_ALBEDO{ 0.5f };
+constexpr uint32_t BOUNCE_SAMPLE_COUNT{ 16 };
+// Ambient light is occluded by surfaces closer than the ambient occlusion distance
+constexpr float AMBIENT_OCCLUSION_DISTANCE{ 1.5f };
+constexpr float RAY_BIAS{ 0.01f };
+
+// Cached lightmap files
+constexpr uint32_t LIGHTMAP_FILE_MAGIC{ 0x50414D4C }; // "LMAP"
+constexpr uint32_t LIGHTMAP_FILE_VERSION{ 1 };
+
+struct LightmapFileHeader
+{
+	uint32_t Magic{ LIGHTMAP_FILE_MAGIC };
+	uint32_t Version{ LIGHTMAP_FILE_VERSION };
+	uint64_t Key{ 0 };
+	uint32_t Width{ 0 };
+	uint32_t Height{ 0 };
+};
+
+// A triangle's region of the lightmap atlas
+struct Chart
+{
+	uint32_t Triangle{ 0 };
+	uint32_t X{ 0 };
+	uint32_t Y{ 0 };
+	uint32_t Width{ 0 };
+	uint32_t Height{ 0 };
+	// Position of the triangle's vertices in the chart in texels
+	std::array<glm::vec2, 3> Corners{};
+};
+
+// Triangle data used to trace rays while baking
+struct BakeTriangle
+{
+	glm::vec3 Position{ 0.0f };
+	glm::vec3 Edge1{ 0.0f };
+	glm::vec3 Edge2{ 0.0f };
+	glm::vec3 Normal{ 0.0f };
+	// Unshadowed irradiance from the directional light. Reflected as the triangle's bounced light
+	glm::vec3 DirectIrradiance{ 0.0f };
+};
+
+static uint64_t HashBytes(const void* pData, const size_t size, uint64_t hash)
+{
+	// FNV-1a
+	const auto* pBytes = static_cast<const uint8_t*>(pData);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= pBytes[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+static uint32_t NextPowerOfTwo(const uint32_t value)
+{
+	uint32_t powerOfTwo{ 1 };
+	while (powerOfTwo < value)
+	{
+		powerOfTwo <<= 1;
+	}
+
+	return powerOfTwo;
+}
+
+// Maps a triangle into a chart. The triangle's longest edge lies along the chart's x axis and the opposite vertex above it
+static Chart MapTriangle(const uint32_t triangle, const Renderer::Vertex1Pos2UV1Norm* pVertices)
+{
+	Chart chart{};
+	chart.Triangle = triangle;
+
+	// Find the longest edge
+	uint32_t longestEdge{ 0 };
+	float longestEdgeLength{ 0.0f };
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const auto length = glm::length(pVertices[(i + 1) % 3].Pos - pVertices[i].Pos);
+		if (length > longestEdgeLength)
+		{
+			longestEdge = i;
+			longestEdgeLength = length;
+		}
+	}
+
+	const auto a = longestEdge;
+	const auto b = (longestEdge + 1) % 3;
+	const auto c = (longestEdge + 2) % 3;
+
+	// Place the vertices in chart space
+	float chartWidth{ 0.0f };
+	float chartHeight{ 0.0f };
+	if (longestEdgeLength > std::numeric_limits<float>::epsilon())
+	{
+		const auto scale = std::min(TEXELS_PER_UNIT, MAX_CHART_SIZE / longestEdgeLength);
+		const auto axis = (pVertices[b].Pos - pVertices[a].Pos) / longestEdgeLength;
+		const auto toOpposite = pVertices[c].Pos - pVertices[a].Pos;
+		const auto alongAxis = glm::dot(toOpposite, axis);
+		const auto height = glm::length(toOpposite - (axis * alongAxis));
+
+		chartWidth = longestEdgeLength * scale;
+		chartHeight = height * scale;
+		chart.Corners[a] = { 0.0f, 0.0f };
+		chart.Corners[b] = { chartWidth, 0.0f };
+		chart.Corners[c] = { alongAxis * scale, chartHeight };
+	}
+
+	// Pad the chart so bilinear filtering does not read texels of neighbouring charts
+	const auto padding = static_cast<float>(CHART_PADDING);
+	for (auto& corner : chart.Corners)
+	{
+		corner += glm::vec2(padding, padding);
+	}
+
+	chart.Width = static_cast<uint32_t>(std::ceil(chartWidth)) + (CHART_PADDING * 2) + 1;
+	chart.Height = static_cast<uint32_t>(std::ceil(chartHeight)) + (CHART_PADDING * 2) + 1;
+
+	return chart;
+}
+
+void Renderer::GenerateLightmapUVs(std::vector<Vertex1Pos2UV1Norm>& vertices, const DirectionalLight& directionalLight, Lightmap& lightmap)
+{
+	assert(vertices.size() % 3 == 0 && "Lightmapped vertices must be an unindexed triangle list.");
+
+	// Map each triangle into its own chart
+	const auto triangleCount = static_cast<uint32_t>(vertices.size() / 3);
+	std::vector<Chart> charts;
+	charts.reserve(triangleCount);
+
+	uint64_t chartArea{ 0 };
+	uint32_t widestChart{ 0 };
+	for (uint32_t i = 0; i < triangleCount; ++i)
+	{
+		charts.push_back(MapTriangle(i, &vertices[static_cast<size_t>(i) * 3]));
+		chartArea += static_cast<uint64_t>(charts.back().Width) * charts.back().Height;
+		widestChart = std::max(widestChart, charts.back().Width);
+	}
+
+	// Pack the charts into shelves from tallest to shortest in an atlas roughly as wide as it is tall
+	std::sort(charts.begin(), charts.end(), [](const Chart& a, const Chart& b) { return a.Height > b.Height; });
+
+	const auto squareAtlasWidth = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(chartArea))));
+	lightmap.Width = std::min(NextPowerOfTwo(std::max({ squareAtlasWidth, widestChart, MIN_ATLAS_WIDTH })), MAX_ATLAS_SIZE);
+
+	uint32_t shelfX{ 0 };
+	uint32_t shelfY{ 0 };
+	uint32_t shelfHeight{ 0 };
+	for (auto& chart : charts)
+	{
+		if (shelfX + chart.Width > lightmap.Width)
+		{
+			shelfX = 0;
+			shelfY += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		chart.X = shelfX;
+		chart.Y = shelfY;
+		shelfX += chart.Width;
+		shelfHeight = std::max(shelfHeight, chart.Height);
+	}
+
+	lightmap.Height = std::max(shelfY + shelfHeight, 1u);
+	assert(lightmap.Height <= MAX_ATLAS_SIZE && "Static geometry does not fit in the lightmap atlas.");
+
+	// Write the lightmap texture coordinates
+	const glm::vec2 atlasSize{ static_cast<float>(lightmap.Width), static_cast<float>(lightmap.Height) };
+	for (const auto& chart : charts)
+	{
+		for (size_t i = 0; i < 3; ++i)
+		{
+			const glm::vec2 chartPosition{ static_cast<float>(chart.X), static_cast<float>(chart.Y) };
+			vertices[(static_cast<size_t>(chart.Triangle) * 3) + i].LightmapUV = (chartPosition + chart.Corners[i]) / atlasSize;
+		}
+	}
+
+	// Key the lightmap to the geometry and lighting it is baked from
+	auto key = HashBytes(vertices.data(), vertices.size() * sizeof(Vertex1Pos2UV1Norm), 0xCBF29CE484222325ull);
+	key = HashBytes(&directionalLight.GetColor(), sizeof(glm::vec3), key);
+	key = HashBytes(&directionalLight.GetDirection(), sizeof(glm::vec3), key);
+	const auto intensity = directionalLight.GetIntensity();
+	lightmap.Key = HashBytes(&intensity, sizeof(intensity), key);
+}
+
+// Returns the distance to the closest triangle hit by the ray and the hit triangle's index. Returns a negative distance on a miss
+static float TraceRay(const glm::vec3& origin, const glm::vec3& direction, const std::vector<BakeTriangle>& triangles, uint32_t& hitTriangle)
+{
+	float closestDistance{ std::numeric_limits<float>::max() };
+
+	// Moller-Trumbore ray triangle intersection
+	for (uint32_t i = 0; i < static_cast<uint32_t>(triangles.size()); ++i)
+	{
+		const auto& triangle = triangles[i];
+		const auto p = glm::cross(direction, triangle.Edge2);
+		const auto determinant = glm::dot(triangle.Edge1, p);
+		if (std::abs(determinant) < 1e-8f)
+		{
+			continue;
+		}
+
+		const auto inverseDeterminant = 1.0f / determinant;
+		const auto toOrigin = origin - triangle.Position;
+		const auto u = glm::dot(toOrigin, p) * inverseDeterminant;
+		if (u < 0.0f || u > 1.0f)
+		{
+			continue;
+		}
+
+		const auto q = glm::cross(toOrigin, triangle.Edge1);
+		const auto v = glm::dot(direction, q) * inverseDeterminant;
+		if (v < 0.0f || u + v > 1.0f)
+		{
+			continue;
+		}
+
+		const auto distance = glm::dot(triangle.Edge2, q) * inverseDeterminant;
+		if (distance > 0.0f && distance < closestDistance)
+		{
+			closestDistance = distance;
+			hitTriangle = i;
+		}
+	}
+
+	return (closestDistance == std::numeric_limits<float>::max()) ? -1.0f : closestDistance;
+}
+
+static float RadicalInverse(uint32_t bits)
+{
+	bits = (bits << 16u) | (bits >> 16u);
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+	return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+static uint8_t EncodeSRGB(const float linear)
+{
+	const auto clamped = std::clamp(linear, 0.0f, 1.0f);
+	const auto encoded = (clamped <= 0.0031308f) ? (clamped * 12.92f) : ((1.055f * std::pow(clamped, 1.0f / 2.4f)) - 0.055f);
+	return static_cast<uint8_t>((encoded * 255.0f) + 0.5f);
+}
+
+// Calculates the irradiance at a point on a static surface
+static glm::vec3 CalculateIrradiance(const glm::vec3& position, const glm::vec3& normal, const glm::vec3& faceNormal,
+	const glm::vec3& directionalLightRadiance, const glm::vec3& toDirectionalLight, const float sampleRotation,
+	const std::vector<BakeTriangle>& triangles)
+{
+	// Direct light. The directional light is not shadowed as the levels are enclosed by roofs that would occlude it entirely
+	const auto direct = directionalLightRadiance * std::max(glm::dot(normal, toDirectionalLight), 0.0f);
+
+	// Build a basis around the normal to orient hemisphere samples
+	const auto tangent = glm::normalize(std::abs(normal.y) < 0.99f ? glm::cross(normal, glm::vec3(0.0f, 1.0f, 0.0f)) : glm::cross(normal, glm::vec3(1.0f, 0.0f, 0.0f)));
+	const auto bitangent = glm::cross(normal, tangent);
+	const auto origin = position + (faceNormal * RAY_BIAS);
+
+	// Gather bounced light and ambient occlusion with cosine weighted hemisphere samples
+	glm::vec3 bounce{ 0.0f };
+	uint32_t occludedSampleCount{ 0 };
+	for (uint32_t i = 0; i < BOUNCE_SAMPLE_COUNT; ++i)
+	{
+		const auto u1 = (static_cast<float>(i) + 0.5f) / static_cast<float>(BOUNCE_SAMPLE_COUNT);
+		const auto phi = glm::two_pi<float>() * (RadicalInverse(i) + sampleRotation);
+		const auto radius = std::sqrt(u1);
+		const auto direction = (tangent * (radius * std::cos(phi))) + (bitangent * (radius * std::sin(phi))) + (normal * std::sqrt(1.0f - u1));
+
+		uint32_t hitTriangle{ 0 };
+		const auto distance = TraceRay(origin, direction, triangles, hitTriangle);
+		if (distance < 0.0f)
+		{
+			continue;
+		}
+
+		if (distance < AMBIENT_OCCLUSION_DISTANCE)
+		{
+			++occludedSampleCount;
+		}
+
+		// Back faces reflect no light
+		if (glm::dot(triangles[hitTriangle].Normal, direction) < 0.0f)
+		{
+			bounce += triangles[hitTriangle].DirectIrradiance;
+		}
+	}
+
+	const auto sampleCount = static_cast<float>(BOUNCE_SAMPLE_COUNT);
+	const auto ambient = AMBIENT_LIGHT * (1.0f - (static_cast<float>(occludedSampleCount) / sampleCount));
+
+	return ambient + direct + (bounce * (SURFACE_ALBEDO / sampleCount));
+}
+
+void Renderer::BakeLightmap(const std::vector<Vertex1Pos2UV1Norm>& vertices, const DirectionalLight& directionalLight, Lightmap& lightmap)
+{
+	const auto directionalLightRadiance = directionalLight.GetColor() * directionalLight.GetIntensity();
+	const auto toDirectionalLight = -glm::normalize(directionalLight.GetDirection());
+
+	// Build the triangles rays are traced against
+	const auto triangleCount = static_cast<uint32_t>(vertices.size() / 3);
+	std::vector<BakeTriangle> triangles(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; ++i)
+	{
+		const auto* pVertices = &vertices[static_cast<size_t>(i) * 3];
+		auto& triangle = triangles[i];
+		triangle.Position = pVertices[0].Pos;
+		triangle.Edge1 = pVertices[1].Pos - pVertices[0].Pos;
+		triangle.Edge2 = pVertices[2].Pos - pVertices[0].Pos;
+
+		// Orient the face normal with the vertex normals
+		const auto cross = glm::cross(triangle.Edge1, triangle.Edge2);
+		const auto crossLength = glm::length(cross);
+		triangle.Normal = (crossLength > 0.0f) ? cross / crossLength : pVertices[0].Norm;
+		if (glm::dot(triangle.Normal, pVertices[0].Norm + pVertices[1].Norm + pVertices[2].Norm) < 0.0f)
+		{
+			triangle.Normal = -triangle.Normal;
+		}
+
+		triangle.DirectIrradiance = directionalLightRadiance * std::max(glm::dot(triangle.Normal, toDirectionalLight), 0.0f);
+	}
+
+	lightmap.Pixels.assign(static_cast<size_t>(lightmap.Width) * lightmap.Height * 4, 0);
+	const glm::vec2 atlasSize{ static_cast<float>(lightmap.Width), static_cast<float>(lightmap.Height) };
+
+	// Bake each triangle's chart as a job. Charts do not overlap so jobs write to separate texels
+	JobSystem::ParallelFor(triangleCount, 1, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				const auto* pVertices = &vertices[static_cast<size_t>(i) * 3];
+				const auto corner0 = pVertices[0].LightmapUV * atlasSize;
+				const auto corner1 = pVertices[1].LightmapUV * atlasSize;
+				const auto corner2 = pVertices[2].LightmapUV * atlasSize;
+
+				// Bake every texel of the chart, including its padding, so bilinear filtering at chart edges reads lit texels
+				const auto minCorner = glm::min(glm::min(corner0, corner1), corner2);
+				const auto maxCorner = glm::max(glm::max(corner0, corner1), corner2);
+				const auto minX = static_cast<uint32_t>(std::max(std::floor(minCorner.x) - static_cast<float>(CHART_PADDING), 0.0f));
+				const auto minY = static_cast<uint32_t>(std::max(std::floor(minCorner.y) - static_cast<float>(CHART_PADDING), 0.0f));
+				const auto maxX = std::min(static_cast<uint32_t>(std::ceil(maxCorner.x)) + CHART_PADDING, lightmap.Width);
+				const auto maxY = std::min(static_cast<uint32_t>(std::ceil(maxCorner.y)) + CHART_PADDING, lightmap.Height);
+
+				const auto edge1 = corner1 - corner0;
+				const auto edge2 = corner2 - corner0;
+				const auto area = (edge1.x * edge2.y) - (edge2.x * edge1.y);
+
+				for (uint32_t y = minY; y < maxY; ++y)
+				{
+					for (uint32_t x = minX; x < maxX; ++x)
+					{
+						// Find the texel's barycentric coordinates, clamped to the triangle for texels outside it
+						glm::vec3 barycentric{ 1.0f, 0.0f, 0.0f };
+						if (std::abs(area) > std::numeric_limits<float>::epsilon())
+						{
+							const auto toTexel = glm::vec2(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f) - corner0;
+							barycentric.y = std::max(((toTexel.x * edge2.y) - (edge2.x * toTexel.y)) / area, 0.0f);
+							barycentric.z = std::max(((edge1.x * toTexel.y) - (toTexel.x * edge1.y)) / area, 0.0f);
+							barycentric.x = std::max(1.0f - barycentric.y - barycentric.z, 0.0f);
+							barycentric /= (barycentric.x + barycentric.y + barycentric.z);
+						}
+
+						const auto position = (pVertices[0].Pos * barycentric.x) + (pVertices[1].Pos * barycentric.y) + (pVertices[2].Pos * barycentric.z);
+						auto normal = (pVertices[0].Norm * barycentric.x) + (pVertices[1].Norm * barycentric.y) + (pVertices[2].Norm * barycentric.z);
+						normal = (glm::length(normal) > 0.0f) ? glm::normalize(normal) : triangles[i].Normal;
+
+						// Rotate the hemisphere samples per texel to trade banding for noise
+						const auto sampleRotation = RadicalInverse((y * lightmap.Width) + x + 1);
+
+						const auto irradiance = CalculateIrradiance(position, normal, triangles[i].Normal, directionalLightRadiance, toDirectionalLight,
+							sampleRotation, triangles);
+
+						auto* pTexel = &lightmap.Pixels[((static_cast<size_t>(y) * lightmap.Width) + x) * 4];
+						pTexel[0] = EncodeSRGB(irradiance.r);
+						pTexel[1] = EncodeSRGB(irradiance.g);
+						pTexel[2] = EncodeSRGB(irradiance.b);
+						pTexel[3] = 255;
+					}
+				}
+			}
+		});
+}
+
+bool Renderer::ReadLightmap(const std::string& filepath, const uint64_t key, Lightmap& lightmap)
+{
+	BinaryBuffer buffer{};
+	if (!Binary::ReadBinaryIntoBuffer(filepath, buffer) || buffer.GetBufferLength() < sizeof(LightmapFileHeader))
+	{
+		return false;
+	}
+
+	LightmapFileHeader header{};
+	memcpy(&header, buffer.GetBufferPointer(), sizeof(header));
+	if (header.Magic != LIGHTMAP_FILE_MAGIC || header.Version != LIGHTMAP_FILE_VERSION || header.Key != key ||
+		header.Width != lightmap.Width || header.Height != lightmap.Height)
+	{
+		return false;
+	}
+
+	const auto pixelsSize = static_cast<size_t>(header.Width) * header.Height * 4;
+	if (buffer.GetBufferLength() != sizeof(header) + pixelsSize)
+	{
+		return false;
+	}
+
+	lightmap.Pixels.assign(buffer.GetBufferPointer() + sizeof(header), buffer.GetBufferPointer() + sizeof(header) + pixelsSize);
+
+	return true;
+}
+
+bool Renderer::WriteLightmap(const std::string& filepath, const Lightmap& lightmap)
+{
+	// Create the lightmap's directory
+	const std::filesystem::path path(filepath);
+	std::error_code error;
+	if (path.has_parent_path())
+	{
+		std::filesystem::create_directories(path.parent_path(), error);
+	}
+
+	std::ofstream fs;
+	fs.open(filepath.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+	if (!fs.good())
+	{
+		return false;
+	}
+
+	LightmapFileHeader header{};
+	header.Key = lightmap.Key;
+	header.Width = lightmap.Width;
+	header.Height = lightmap.Height;
+
+	fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fs.write(reinterpret_cast<const char*>(lightmap.Pixels.data()), static_cast<std::streamsize>(lightmap.Pixels.size()));
+	fs.close();
+
+	return !fs.fail();
+}
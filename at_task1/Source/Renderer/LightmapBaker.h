@@ -0,0 +1,27 @@
+#pragma once
+
+namespace Renderer
+{
+	class DirectionalLight;
+	struct Vertex1Pos2UV1Norm;
+
+	// Baked lighting for static geometry. Texels are stored as RGBA8 in sRGB
+	struct Lightmap
+	{
+		uint32_t Width{ 0 };
+		uint32_t Height{ 0 };
+		// Hash of the geometry and lighting the lightmap is baked from. Cached lightmaps are rebaked when it changes
+		uint64_t Key{ 0 };
+		std::vector<uint8_t> Pixels;
+	};
+
+	// Gives each triangle of an unindexed triangle list its own chart in a lightmap atlas and writes the vertices' lightmap texture
+	// coordinates. Sets the lightmap's size and key
+	void GenerateLightmapUVs(std::vector<Vertex1Pos2UV1Norm>& vertices, const DirectionalLight& directionalLight, Lightmap& lightmap);
+	// Bakes direct lighting and a single diffuse bounce into the lightmap on the job system. Vertices must have lightmap texture
+	// coordinates generated for the lightmap
+	void BakeLightmap(const std::vector<Vertex1Pos2UV1Norm>& vertices, const DirectionalLight& directionalLight, Lightmap& lightmap);
+	// Reads a lightmap baked with the key. Fails if the file is missing or was baked from different geometry or lighting
+	bool ReadLightmap(const std::string& filepath, const uint64_t key, Lightmap& lightmap);
+	bool WriteLightmap(const std::string& filepath, const Lightmap& lightmap);
+}
\ No newline at end of file
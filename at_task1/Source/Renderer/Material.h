@@ -1,16 +1,28 @@
 #pragma once
 
+#include "PipelineState.h"
+
 namespace Renderer
 {
 	enum class ESampler : uint8_t;
 
+	// Materials are registered with the renderer, which interns identical materials to a single material ID
 	struct Material
 	{
+		bool operator==(const Material& other) const = default;
+
 		void SetSamplerID(const Renderer::ESampler id) { SamplerID = static_cast<uint32_t>(id); }
 
 		bool AlphaBlended{ false };
 		uint32_t SamplerID{ 0 };
 		uint32_t TextureID{ 0 };
 		glm::vec2 TextureScale{ 1.0f, 1.0f };
+		// Selects the pipeline permutation meshes with the material are drawn with
+		ELightingModel LightingModel{ ELightingModel::BLINN_PHONG };
+		// Flipbook animation. The texture is a sprite sheet of frames laid out in rows from its top left. The frame is selected by the
+		// vertex shader from the frame time and the mesh's flipbook phase. Flipbook materials expect a texture scale of one
+		uint32_t FlipbookFrameCount{ 1 };
+		uint32_t FlipbookColumnCount{ 1 };
+		float FlipbookFrameRate{ 0.0f };
 	};
 }
\ No newline at end of file
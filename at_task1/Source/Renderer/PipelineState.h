@@ -0,0 +1,61 @@
+#pragma once
+
+namespace Renderer
+{
+	// Shader programs a command list can bind. Each program is built into pipeline permutations for the states it is drawn with
+	enum class EPipeline : uint8_t
+	{
+		MESH = 0,
+		SPRITE,
+		// Draws static geometry lit by the level's lightmap
+		LIGHTMAPPED
+	};
+
+	enum class EBlendMode : uint8_t
+	{
+		// Opaque geometry is not blended
+		NONE = 0,
+		ALPHA
+	};
+
+	// Lighting evaluated by a pipeline's fragment shader. Selected with a specialization constant so unused lighting is compiled out
+	enum class ELightingModel : uint8_t
+	{
+		BLINN_PHONG = 0,
+		// Diffuse lighting without specular highlights
+		LAMBERT,
+		UNLIT
+	};
+
+	// Identifies a pipeline permutation. Permutations of a shader program share shaders and vertex layout but differ by blend, depth
+	// and specialization state
+	struct PipelineState
+	{
+		bool operator==(const PipelineState& other) const = default;
+
+		// Packs the state into a single value used as a command argument and pipeline cache key
+		uint32_t Pack() const
+		{
+			return static_cast<uint32_t>(Pipeline) |
+				(static_cast<uint32_t>(BlendMode) << 8) |
+				(static_cast<uint32_t>(DepthWrite) << 10) |
+				(static_cast<uint32_t>(LightingModel) << 12);
+		}
+
+		static PipelineState Unpack(const uint32_t packed)
+		{
+			PipelineState state{};
+			state.Pipeline = static_cast<EPipeline>(packed & 0xFF);
+			state.BlendMode = static_cast<EBlendMode>((packed >> 8) & 0x3);
+			state.DepthWrite = ((packed >> 10) & 0x1) != 0;
+			state.LightingModel = static_cast<ELightingModel>((packed >> 12) & 0xF);
+			return state;
+		}
+
+		EPipeline Pipeline{ EPipeline::MESH };
+		EBlendMode BlendMode{ EBlendMode::NONE };
+		// Opaque geometry writes depth so later fragments behind it are rejected before shading
+		bool DepthWrite{ true };
+		ELightingModel LightingModel{ ELightingModel::BLINN_PHONG };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace Renderer
+{
+	struct PointLight
+	{
+		glm::vec3 Position{ 0.0f, 0.0f, 0.0f };
+		glm::vec3 Color{ 1.0f, 1.0f, 1.0f };
+		float Intensity{ 1.0f };
+		// Distance at which the light no longer contributes
+		float Radius{ 5.0f };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,818 @@
+#include "Pch.h"
+#include "RenderGraph.h"
+#include "Console.h"
+
+// Layout, stages and accesses implied by a resource usage
+struct UsageInfo
+{
+	VkImageLayout Layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+	VkPipelineStageFlags Stages{ 0 };
+	VkAccessFlags ReadAccess{ 0 };
+	VkAccessFlags WriteAccess{ 0 };
+	VkImageUsageFlags ImageUsage{ 0 };
+};
+
+static UsageInfo GetUsageInfo(const Renderer::ERenderGraphUsage usage, const bool write)
+{
+	UsageInfo info{};
+
+	switch (usage)
+	{
+	case Renderer::ERenderGraphUsage::COLOR_ATTACHMENT:
+		info.Layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		info.Stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		info.ReadAccess = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+		info.WriteAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		info.ImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::DEPTH_STENCIL_ATTACHMENT:
+		info.Layout = write ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+		info.Stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		info.ReadAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		info.WriteAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		info.ImageUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::SAMPLED_TEXTURE:
+		info.Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		info.Stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		info.ReadAccess = VK_ACCESS_SHADER_READ_BIT;
+		info.ImageUsage = VK_IMAGE_USAGE_SAMPLED_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::UNIFORM_BUFFER:
+		info.Stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		info.ReadAccess = VK_ACCESS_UNIFORM_READ_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::VERTEX_BUFFER:
+		info.Stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+		info.ReadAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::INDEX_BUFFER:
+		info.Stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+		info.ReadAccess = VK_ACCESS_INDEX_READ_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::STORAGE_BUFFER:
+		info.Stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		info.ReadAccess = VK_ACCESS_SHADER_READ_BIT;
+		info.WriteAccess = VK_ACCESS_SHADER_WRITE_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::TRANSFER_SOURCE:
+		info.Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		info.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		info.ReadAccess = VK_ACCESS_TRANSFER_READ_BIT;
+		info.ImageUsage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		break;
+
+	case Renderer::ERenderGraphUsage::TRANSFER_DESTINATION:
+		info.Layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		info.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		info.WriteAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+		info.ImageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		break;
+	}
+
+	// Reads do not make anything available so only writes carry a write access
+	if (!write)
+	{
+		info.WriteAccess = 0;
+	}
+
+	return info;
+}
+
+static bool IsAttachmentUsage(const Renderer::ERenderGraphUsage usage)
+{
+	return usage == Renderer::ERenderGraphUsage::COLOR_ATTACHMENT || usage == Renderer::ERenderGraphUsage::DEPTH_STENCIL_ATTACHMENT;
+}
+
+static bool HasStencilComponent(const VkFormat format)
+{
+	return format == VK_FORMAT_D32_SFLOAT_S8_UINT ||
+		format == VK_FORMAT_D24_UNORM_S8_UINT ||
+		format == VK_FORMAT_D16_UNORM_S8_UINT ||
+		format == VK_FORMAT_S8_UINT;
+}
+
+static VkImageAspectFlags GetImageAspectMask(const VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_D32_SFLOAT:
+	case VK_FORMAT_D16_UNORM:
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+
+	case VK_FORMAT_D32_SFLOAT_S8_UINT:
+	case VK_FORMAT_D24_UNORM_S8_UINT:
+	case VK_FORMAT_D16_UNORM_S8_UINT:
+		return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+	case VK_FORMAT_S8_UINT:
+		return VK_IMAGE_ASPECT_STENCIL_BIT;
+
+	default:
+		return VK_IMAGE_ASPECT_COLOR_BIT;
+	}
+}
+
+static uint32_t FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memoryProperties, const uint32_t memoryTypeBits,
+	const VkMemoryPropertyFlags properties)
+{
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+	{
+		if ((memoryTypeBits & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return i;
+		}
+	}
+
+	return UINT32_MAX;
+}
+
+Renderer::RenderGraphResource Renderer::RenderGraph::ImportImage(const std::string& name, const std::vector<VkImage>& images,
+	const std::vector<VkImageView>& views, const VkFormat format, const VkImageLayout initialLayout, const VkImageLayout finalLayout)
+{
+	assert(!images.empty() && images.size() == views.size() && "Imported render graph images must each have a view.");
+
+	auto& resource = Resources.emplace_back();
+	resource.Name = name;
+	resource.Image = true;
+	resource.Imported = true;
+	resource.Format = format;
+	resource.InitialLayout = initialLayout;
+	resource.FinalLayout = finalLayout;
+	resource.Images = images;
+	resource.Views = views;
+
+	return static_cast<RenderGraphResource>(Resources.size() - 1);
+}
+
+Renderer::RenderGraphResource Renderer::RenderGraph::ImportBuffer(const std::string& name, const std::vector<VkBuffer>& buffers)
+{
+	assert(!buffers.empty() && "Imported render graph buffers must contain at least one buffer.");
+
+	auto& resource = Resources.emplace_back();
+	resource.Name = name;
+	resource.Imported = true;
+	resource.Buffers = buffers;
+
+	return static_cast<RenderGraphResource>(Resources.size() - 1);
+}
+
+Renderer::RenderGraphResource Renderer::RenderGraph::CreateTransientImage(const std::string& name, const RenderGraphImageDesc& desc)
+{
+	auto& resource = Resources.emplace_back();
+	resource.Name = name;
+	resource.Image = true;
+	resource.Format = desc.Format;
+	resource.SurfaceScale = desc.SurfaceScale;
+
+	return static_cast<RenderGraphResource>(Resources.size() - 1);
+}
+
+Renderer::RenderGraphPass Renderer::RenderGraph::AddPass(const std::string& name, const RenderGraphExecuteFunction& execute)
+{
+	auto& pass = Passes.emplace_back();
+	pass.Name = name;
+	pass.Execute = execute;
+
+	return static_cast<RenderGraphPass>(Passes.size() - 1);
+}
+
+void Renderer::RenderGraph::Read(const RenderGraphPass pass, const RenderGraphResource resource, const ERenderGraphUsage usage)
+{
+	assert(pass < Passes.size() && resource < Resources.size() && "Invalid render graph pass or resource.");
+	Passes[pass].Uses.push_back({ resource, usage, false });
+}
+
+void Renderer::RenderGraph::Write(const RenderGraphPass pass, const RenderGraphResource resource, const ERenderGraphUsage usage)
+{
+	assert(pass < Passes.size() && resource < Resources.size() && "Invalid render graph pass or resource.");
+	assert(usage != ERenderGraphUsage::SAMPLED_TEXTURE && usage != ERenderGraphUsage::UNIFORM_BUFFER && usage != ERenderGraphUsage::VERTEX_BUFFER &&
+		usage != ERenderGraphUsage::INDEX_BUFFER && usage != ERenderGraphUsage::TRANSFER_SOURCE && "Render graph usage is read only.");
+	Passes[pass].Uses.push_back({ resource, usage, true });
+}
+
+void Renderer::RenderGraph::SetClearValue(const RenderGraphPass pass, const RenderGraphResource resource, const VkClearValue& clearValue)
+{
+	assert(pass < Passes.size() && resource < Resources.size() && "Invalid render graph pass or resource.");
+	Passes[pass].ClearValues.emplace_back(resource, clearValue);
+}
+
+void Renderer::RenderGraph::SetSecondaryCommandBufferContents(const RenderGraphPass pass)
+{
+	assert(pass < Passes.size() && "Invalid render graph pass.");
+	Passes[pass].Contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+}
+
+bool Renderer::RenderGraph::Compile(const RenderGraphContext& context)
+{
+	Context = context;
+
+	// Remove passes whose results are never used
+	CullPasses();
+
+	// Find the lifetime of each resource and the usages it is created with
+	for (uint32_t i = 0; i < static_cast<uint32_t>(Passes.size()); ++i)
+	{
+		if (Passes[i].Culled)
+		{
+			continue;
+		}
+
+		for (const auto& use : Passes[i].Uses)
+		{
+			auto& resource = Resources[use.Resource];
+			resource.FirstPass = std::min(resource.FirstPass, i);
+			resource.LastPass = std::max(resource.LastPass, i);
+			resource.ImageUsage |= GetUsageInfo(use.Usage, use.Write).ImageUsage;
+		}
+	}
+
+	// Create transient images, sharing memory between images whose lifetimes do not overlap
+	if (!CreateTransientImages())
+	{
+		return false;
+	}
+
+	// Build the barriers and layout transitions between passes
+	BuildBarriers();
+
+	// Create render passes and framebuffers for passes that draw to attachments
+	for (uint32_t i = 0; i < static_cast<uint32_t>(Passes.size()); ++i)
+	{
+		if (Passes[i].Culled)
+		{
+			continue;
+		}
+
+		if (!CreateRenderPass(Passes[i]))
+		{
+			LOG("Failed to create render pass for render graph pass " << Passes[i].Name << ".");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Renderer::RenderGraph::Execute(VkCommandBuffer commandBuffer, const uint32_t imageIndex, const uint32_t frameIndex)
+{
+	for (const auto& pass : Passes)
+	{
+		if (pass.Culled)
+		{
+			continue;
+		}
+
+		// Wait on previous passes and transition the resources used by this pass
+		RecordBarriers(commandBuffer, pass.Barriers, imageIndex, frameIndex);
+
+		if (pass.RenderPass != VK_NULL_HANDLE)
+		{
+			// Describe render pass begin info
+			VkRenderPassBeginInfo renderPassBeginInfo{};
+			renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassBeginInfo.renderPass = pass.RenderPass;
+			renderPassBeginInfo.framebuffer = pass.Framebuffers[pass.Framebuffers.size() > 1 ? imageIndex : 0];
+			renderPassBeginInfo.renderArea.offset = { 0, 0 };
+			renderPassBeginInfo.renderArea.extent = pass.Extent;
+			renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(pass.AttachmentClearValues.size());
+			renderPassBeginInfo.pClearValues = pass.AttachmentClearValues.data();
+
+			vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, pass.Contents);
+		}
+
+		// Record the pass's commands
+		if (pass.Execute)
+		{
+			pass.Execute(commandBuffer);
+		}
+
+		if (pass.RenderPass != VK_NULL_HANDLE)
+		{
+			vkCmdEndRenderPass(commandBuffer);
+		}
+	}
+
+	// Transition imported images to their final layouts
+	RecordBarriers(commandBuffer, FinalBarriers, imageIndex, frameIndex);
+}
+
+void Renderer::RenderGraph::Destroy()
+{
+	// Destroy render passes and framebuffers
+	for (auto& pass : Passes)
+	{
+		for (auto framebuffer : pass.Framebuffers)
+		{
+			vkDestroyFramebuffer(Context.Device, framebuffer, nullptr);
+		}
+
+		vkDestroyRenderPass(Context.Device, pass.RenderPass, nullptr);
+	}
+
+	// Destroy transient images
+	for (auto& resource : Resources)
+	{
+		if (!resource.Image || resource.Imported)
+		{
+			continue;
+		}
+
+		for (auto view : resource.Views)
+		{
+			vkDestroyImageView(Context.Device, view, nullptr);
+		}
+
+		for (auto image : resource.Images)
+		{
+			vkDestroyImage(Context.Device, image, nullptr);
+		}
+	}
+
+	// Free transient image memory
+	for (auto& block : MemoryBlocks)
+	{
+		vkFreeMemory(Context.Device, block.Memory, nullptr);
+	}
+
+	Passes.clear();
+	Resources.clear();
+	MemoryBlocks.clear();
+	FinalBarriers = {};
+}
+
+VkRenderPass Renderer::RenderGraph::GetRenderPass(const RenderGraphPass pass) const
+{
+	assert(pass < Passes.size() && "Invalid render graph pass.");
+	return Passes[pass].RenderPass;
+}
+
+VkImageView Renderer::RenderGraph::GetImageView(const RenderGraphResource resource, const uint32_t imageIndex) const
+{
+	assert(resource < Resources.size() && Resources[resource].Image && "Invalid render graph image.");
+	const auto& views = Resources[resource].Views;
+	return views.empty() ? VK_NULL_HANDLE : views[views.size() > 1 ? imageIndex : 0];
+}
+
+void Renderer::RenderGraph::CullPasses()
+{
+	// Graph outputs are imported images with a final layout and imported buffers
+	std::vector<bool> needed(Resources.size(), false);
+	for (size_t i = 0; i < Resources.size(); ++i)
+	{
+		const auto& resource = Resources[i];
+		needed[i] = resource.Imported && (!resource.Image || resource.FinalLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+	}
+
+	// Walk passes backwards keeping passes that write a resource needed by a later pass or an output
+	for (auto pass = Passes.rbegin(); pass != Passes.rend(); ++pass)
+	{
+		pass->Culled = true;
+		for (const auto& use : pass->Uses)
+		{
+			if (use.Write && needed[use.Resource])
+			{
+				pass->Culled = false;
+				break;
+			}
+		}
+
+		if (pass->Culled)
+		{
+			LOG("Render graph pass " << pass->Name << " culled.");
+			continue;
+		}
+
+		for (const auto& use : pass->Uses)
+		{
+			// A cleared write does not depend on earlier contents so earlier writers are only needed if something else reads them
+			const bool cleared = std::find_if(pass->ClearValues.begin(), pass->ClearValues.end(),
+				[&use](const auto& clearValue) { return clearValue.first == use.Resource; }) != pass->ClearValues.end();
+
+			needed[use.Resource] = !(use.Write && cleared);
+		}
+	}
+}
+
+bool Renderer::RenderGraph::CreateTransientImages()
+{
+	// Gather transient images used by the compiled passes ordered by their first use
+	std::vector<RenderGraphResource> transientImages;
+	for (uint32_t i = 0; i < static_cast<uint32_t>(Resources.size()); ++i)
+	{
+		if (Resources[i].Image && !Resources[i].Imported && Resources[i].FirstPass != UINT32_MAX)
+		{
+			transientImages.push_back(i);
+		}
+	}
+
+	std::stable_sort(transientImages.begin(), transientImages.end(), [this](const auto lhs, const auto rhs)
+		{
+			return Resources[lhs].FirstPass < Resources[rhs].FirstPass;
+		});
+
+	for (const auto id : transientImages)
+	{
+		auto& resource = Resources[id];
+
+		// Describe the image create info
+		VkImageCreateInfo imageCreateInfo{};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = resource.Format;
+		imageCreateInfo.extent.width = std::max(1u, static_cast<uint32_t>(Context.SurfaceWidth * resource.SurfaceScale));
+		imageCreateInfo.extent.height = std::max(1u, static_cast<uint32_t>(Context.SurfaceHeight * resource.SurfaceScale));
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage = resource.ImageUsage;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// Create the image
+		auto& image = resource.Images.emplace_back(VK_NULL_HANDLE);
+		if (vkCreateImage(Context.Device, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
+		{
+			return false;
+		}
+
+		// Get the image memory requirements
+		VkMemoryRequirements memoryRequirements;
+		vkGetImageMemoryRequirements(Context.Device, image, &memoryRequirements);
+
+		// Reuse the memory of a block whose images are no longer used by the time this image is first used
+		uint32_t blockIndex = UINT32_MAX;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(MemoryBlocks.size()); ++i)
+		{
+			const auto& block = MemoryBlocks[i];
+			if (block.LastPass < resource.FirstPass && (block.MemoryTypeBits & memoryRequirements.memoryTypeBits))
+			{
+				blockIndex = i;
+				break;
+			}
+		}
+
+		if (blockIndex == UINT32_MAX)
+		{
+			MemoryBlocks.emplace_back();
+			blockIndex = static_cast<uint32_t>(MemoryBlocks.size() - 1);
+		}
+		else
+		{
+			LOG("Render graph image " << resource.Name << " aliases transient memory block " << blockIndex << ".");
+		}
+
+		// Every image in a block is bound at offset 0 so the block only has to be as large as its largest image
+		auto& block = MemoryBlocks[blockIndex];
+		block.Size = std::max(block.Size, memoryRequirements.size);
+		block.MemoryTypeBits &= memoryRequirements.memoryTypeBits;
+		block.LastPass = resource.LastPass;
+		resource.MemoryBlock = blockIndex;
+
+		// Accumulate every stage and write access the image is used with so the next user of the memory can wait on them
+		for (const auto& pass : Passes)
+		{
+			if (pass.Culled)
+			{
+				continue;
+			}
+
+			for (const auto& use : pass.Uses)
+			{
+				if (use.Resource == id)
+				{
+					const auto info = GetUsageInfo(use.Usage, use.Write);
+					block.FinalStages |= info.Stages;
+					block.FinalAccess |= info.WriteAccess;
+				}
+			}
+		}
+	}
+
+	// Allocate memory blocks
+	for (auto& block : MemoryBlocks)
+	{
+		const uint32_t memoryTypeIndex = FindMemoryTypeIndex(Context.MemoryProperties, block.MemoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		if (memoryTypeIndex == UINT32_MAX)
+		{
+			return false;
+		}
+
+		// Describe memory allocation
+		VkMemoryAllocateInfo memoryAllocInfo{};
+		memoryAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memoryAllocInfo.allocationSize = block.Size;
+		memoryAllocInfo.memoryTypeIndex = memoryTypeIndex;
+
+		if (vkAllocateMemory(Context.Device, &memoryAllocInfo, nullptr, &block.Memory) != VK_SUCCESS)
+		{
+			return false;
+		}
+	}
+
+	// Bind images to their memory blocks and create their views
+	for (const auto id : transientImages)
+	{
+		auto& resource = Resources[id];
+
+		if (vkBindImageMemory(Context.Device, resource.Images[0], MemoryBlocks[resource.MemoryBlock].Memory, 0) != VK_SUCCESS)
+		{
+			return false;
+		}
+
+		// Describe the image view create info
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.image = resource.Images[0];
+		imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = resource.Format;
+		imageViewCreateInfo.subresourceRange.aspectMask = GetImageAspectMask(resource.Format);
+		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.levelCount = 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+		auto& view = resource.Views.emplace_back(VK_NULL_HANDLE);
+		if (vkCreateImageView(Context.Device, &imageViewCreateInfo, nullptr, &view) != VK_SUCCESS)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Renderer::RenderGraph::BuildBarriers()
+{
+	// Tracked state of each resource as the compiled passes are walked in order
+	struct ResourceState
+	{
+		bool Used{ false };
+		VkImageLayout Layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+		VkPipelineStageFlags Stages{ 0 };
+		VkAccessFlags WriteAccess{ 0 };
+	};
+
+	std::vector<ResourceState> states(Resources.size());
+
+	for (auto& pass : Passes)
+	{
+		pass.Barriers = {};
+		if (pass.Culled)
+		{
+			continue;
+		}
+
+		for (const auto& use : pass.Uses)
+		{
+			const auto& resource = Resources[use.Resource];
+			auto& state = states[use.Resource];
+			const auto info = GetUsageInfo(use.Usage, use.Write);
+			const VkImageLayout layout = resource.Image ? info.Layout : VK_IMAGE_LAYOUT_UNDEFINED;
+
+			if (!state.Used)
+			{
+				if (resource.Image && !resource.Imported)
+				{
+					// Transient images discard their contents on first use and wait on the previous users of their memory,
+					// including the previous frame's use of the same image
+					const auto& block = MemoryBlocks[resource.MemoryBlock];
+					pass.Barriers.Barriers.push_back({ use.Resource, VK_IMAGE_LAYOUT_UNDEFINED, layout, block.FinalAccess, info.ReadAccess | info.WriteAccess });
+					pass.Barriers.SrcStages |= block.FinalStages;
+					pass.Barriers.DstStages |= info.Stages;
+				}
+				else if (resource.Image && resource.InitialLayout != layout)
+				{
+					// Imported images are made available outside the graph. The transition waits on the stage it is used in which
+					// chains with a semaphore wait at the same stage, such as a swapchain image acquire
+					pass.Barriers.Barriers.push_back({ use.Resource, resource.InitialLayout, layout, 0, info.ReadAccess | info.WriteAccess });
+					pass.Barriers.SrcStages |= info.Stages;
+					pass.Barriers.DstStages |= info.Stages;
+				}
+
+				state = { true, layout, info.Stages, info.WriteAccess };
+				continue;
+			}
+
+			// Synchronise with the previous use on layout changes, read after write, write after read and write after write
+			if (state.Layout != layout || state.WriteAccess != 0 || use.Write)
+			{
+				pass.Barriers.Barriers.push_back({ use.Resource, state.Layout, layout, state.WriteAccess, info.ReadAccess | info.WriteAccess });
+				pass.Barriers.SrcStages |= state.Stages;
+				pass.Barriers.DstStages |= info.Stages;
+
+				state = { true, layout, info.Stages, info.WriteAccess };
+			}
+			else
+			{
+				// Consecutive reads in the same layout need no barrier. Later writes wait on every reader
+				state.Stages |= info.Stages;
+			}
+		}
+	}
+
+	// Transition imported images to their final layouts
+	FinalBarriers = {};
+	for (uint32_t i = 0; i < static_cast<uint32_t>(Resources.size()); ++i)
+	{
+		const auto& resource = Resources[i];
+		const auto& state = states[i];
+
+		if (resource.Image && resource.Imported && state.Used && resource.FinalLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			FinalBarriers.Barriers.push_back({ i, state.Layout, resource.FinalLayout, state.WriteAccess, 0 });
+			FinalBarriers.SrcStages |= state.Stages;
+			FinalBarriers.DstStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		}
+	}
+}
+
+bool Renderer::RenderGraph::CreateRenderPass(Pass& pass)
+{
+	const auto passIndex = static_cast<uint32_t>(&pass - Passes.data());
+
+	std::vector<VkAttachmentDescription> attachments;
+	std::vector<VkAttachmentReference> colorAttachmentReferences;
+	VkAttachmentReference depthStencilAttachmentReference{};
+	bool hasDepthStencilAttachment{ false };
+	std::vector<RenderGraphResource> attachmentResources;
+
+	for (const auto& use : pass.Uses)
+	{
+		if (!IsAttachmentUsage(use.Usage))
+		{
+			continue;
+		}
+
+		const auto& resource = Resources[use.Resource];
+		const auto info = GetUsageInfo(use.Usage, use.Write);
+
+		const auto clearValue = std::find_if(pass.ClearValues.begin(), pass.ClearValues.end(),
+			[&use](const auto& value) { return value.first == use.Resource; });
+		const bool cleared = clearValue != pass.ClearValues.end();
+
+		// Contents are loaded when an earlier pass used the attachment or it is imported with defined contents and stored when
+		// a later pass uses it or it leaves the graph
+		const bool loaded = passIndex > resource.FirstPass || (resource.Imported && resource.InitialLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+		const bool stored = passIndex < resource.LastPass || resource.Imported;
+
+		VkAttachmentDescription attachment{};
+		attachment.format = resource.Format;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = cleared ? VK_ATTACHMENT_LOAD_OP_CLEAR : (loaded ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE);
+		attachment.storeOp = stored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.stencilLoadOp = HasStencilComponent(resource.Format) ? attachment.loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = HasStencilComponent(resource.Format) ? attachment.storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		// Layout transitions are done by the graph's barriers so the layout does not change inside the render pass
+		attachment.initialLayout = info.Layout;
+		attachment.finalLayout = info.Layout;
+
+		const VkAttachmentReference reference{ static_cast<uint32_t>(attachments.size()), info.Layout };
+		if (use.Usage == ERenderGraphUsage::COLOR_ATTACHMENT)
+		{
+			colorAttachmentReferences.push_back(reference);
+		}
+		else
+		{
+			assert(!hasDepthStencilAttachment && "Only one depth stencil attachment is allowed per render graph pass.");
+			depthStencilAttachmentReference = reference;
+			hasDepthStencilAttachment = true;
+		}
+
+		attachments.push_back(attachment);
+		attachmentResources.push_back(use.Resource);
+		pass.AttachmentClearValues.push_back(cleared ? clearValue->second : VkClearValue{});
+	}
+
+	// Passes without attachments are recorded outside of a render pass
+	if (attachments.empty())
+	{
+		return true;
+	}
+
+	// Describe the subpass
+	VkSubpassDescription subpass{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = static_cast<uint32_t>(colorAttachmentReferences.size());
+	subpass.pColorAttachments = colorAttachmentReferences.data();
+	subpass.pDepthStencilAttachment = hasDepthStencilAttachment ? &depthStencilAttachmentReference : nullptr;
+
+	// Describe create info
+	VkRenderPassCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+	createInfo.pAttachments = attachments.data();
+	createInfo.subpassCount = 1;
+	createInfo.pSubpasses = &subpass;
+
+	// Create the render pass
+	if (vkCreateRenderPass(Context.Device, &createInfo, nullptr, &pass.RenderPass) != VK_SUCCESS)
+	{
+		return false;
+	}
+
+	// Attachments in a pass share the size of the first attachment
+	const float surfaceScale = Resources[attachmentResources[0]].SurfaceScale;
+	pass.Extent.width = std::max(1u, static_cast<uint32_t>(Context.SurfaceWidth * surfaceScale));
+	pass.Extent.height = std::max(1u, static_cast<uint32_t>(Context.SurfaceHeight * surfaceScale));
+
+	// Create a framebuffer for each image of attachments imported with one image per swapchain image
+	size_t framebufferCount = 1;
+	for (const auto id : attachmentResources)
+	{
+		framebufferCount = std::max(framebufferCount, Resources[id].Views.size());
+	}
+
+	pass.Framebuffers.resize(framebufferCount, VK_NULL_HANDLE);
+	for (size_t i = 0; i < framebufferCount; ++i)
+	{
+		std::vector<VkImageView> views;
+		for (const auto id : attachmentResources)
+		{
+			const auto& resourceViews = Resources[id].Views;
+			views.push_back(resourceViews[resourceViews.size() > 1 ? i : 0]);
+		}
+
+		// Describe framebuffer create info
+		VkFramebufferCreateInfo framebufferCreateInfo{};
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.renderPass = pass.RenderPass;
+		framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(views.size());
+		framebufferCreateInfo.pAttachments = views.data();
+		framebufferCreateInfo.width = pass.Extent.width;
+		framebufferCreateInfo.height = pass.Extent.height;
+		framebufferCreateInfo.layers = 1;
+
+		if (vkCreateFramebuffer(Context.Device, &framebufferCreateInfo, nullptr, &pass.Framebuffers[i]) != VK_SUCCESS)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Renderer::RenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, const BarrierBatch& batch, const uint32_t imageIndex, const uint32_t frameIndex)
+{
+	if (batch.Barriers.empty())
+	{
+		return;
+	}
+
+	ImageBarriers.clear();
+	BufferBarriers.clear();
+
+	for (const auto& barrier : batch.Barriers)
+	{
+		const auto& resource = Resources[barrier.Resource];
+
+		if (resource.Image)
+		{
+			VkImageMemoryBarrier imageBarrier{};
+			imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageBarrier.srcAccessMask = barrier.SrcAccess;
+			imageBarrier.dstAccessMask = barrier.DstAccess;
+			imageBarrier.oldLayout = barrier.OldLayout;
+			imageBarrier.newLayout = barrier.NewLayout;
+			imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.image = resource.Images[resource.Images.size() > 1 ? imageIndex : 0];
+			imageBarrier.subresourceRange.aspectMask = GetImageAspectMask(resource.Format);
+			imageBarrier.subresourceRange.baseMipLevel = 0;
+			imageBarrier.subresourceRange.levelCount = 1;
+			imageBarrier.subresourceRange.baseArrayLayer = 0;
+			imageBarrier.subresourceRange.layerCount = 1;
+			ImageBarriers.push_back(imageBarrier);
+		}
+		else
+		{
+			VkBufferMemoryBarrier bufferBarrier{};
+			bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			bufferBarrier.srcAccessMask = barrier.SrcAccess;
+			bufferBarrier.dstAccessMask = barrier.DstAccess;
+			bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferBarrier.buffer = resource.Buffers[resource.Buffers.size() > 1 ? frameIndex : 0];
+			bufferBarrier.offset = 0;
+			bufferBarrier.size = VK_WHOLE_SIZE;
+			BufferBarriers.push_back(bufferBarrier);
+		}
+	}
+
+	vkCmdPipelineBarrier(commandBuffer,
+		batch.SrcStages != 0 ? batch.SrcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		batch.DstStages != 0 ? batch.DstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		0,
+		0, nullptr,
+		static_cast<uint32_t>(BufferBarriers.size()), BufferBarriers.data(),
+		static_cast<uint32_t>(ImageBarriers.size()), ImageBarriers.data());
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+namespace Renderer
+{
+	// Handle to a resource declared in a render graph
+	using RenderGraphResource = uint32_t;
+
+	// Handle to a pass added to a render graph
+	using RenderGraphPass = uint32_t;
+
+	// How a pass uses a resource. Image layouts, pipeline stages and access masks are derived from the usage
+	enum class ERenderGraphUsage : uint8_t
+	{
+		COLOR_ATTACHMENT = 0,
+		DEPTH_STENCIL_ATTACHMENT,
+		SAMPLED_TEXTURE,
+		UNIFORM_BUFFER,
+		VERTEX_BUFFER,
+		INDEX_BUFFER,
+		STORAGE_BUFFER,
+		TRANSFER_SOURCE,
+		TRANSFER_DESTINATION
+	};
+
+	// Describes an image owned by the render graph. Transient images only live for the passes that use them and
+	// may share memory with other transient images whose lifetimes do not overlap
+	struct RenderGraphImageDesc
+	{
+		VkFormat Format{ VK_FORMAT_UNDEFINED };
+		// Size of the image relative to the surface size
+		float SurfaceScale{ 1.0f };
+	};
+
+	// Device state the render graph needs to create its resources
+	struct RenderGraphContext
+	{
+		VkDevice Device{ VK_NULL_HANDLE };
+		VkPhysicalDeviceMemoryProperties MemoryProperties{};
+		uint32_t SurfaceWidth{ 0 };
+		uint32_t SurfaceHeight{ 0 };
+	};
+
+	// Records a pass's commands into the frame's command buffer. Render passes have already begun when this is called
+	using RenderGraphExecuteFunction = std::function<void(VkCommandBuffer)>;
+
+	class RenderGraph
+	{
+	public:
+		// Imports images that are owned outside the graph. One image and view can be given for each swapchain image. The imported
+		// images are transitioned to finalLayout at the end of the graph. Images with a final layout are graph outputs
+		RenderGraphResource ImportImage(const std::string& name, const std::vector<VkImage>& images, const std::vector<VkImageView>& views,
+			const VkFormat format, const VkImageLayout initialLayout, const VkImageLayout finalLayout);
+
+		// Imports buffers that are owned outside the graph. One buffer can be given for each frame in flight
+		RenderGraphResource ImportBuffer(const std::string& name, const std::vector<VkBuffer>& buffers);
+
+		RenderGraphResource CreateTransientImage(const std::string& name, const RenderGraphImageDesc& desc);
+
+		// Passes execute in the order they are added. Passes that do not contribute to a graph output are culled when compiled
+		RenderGraphPass AddPass(const std::string& name, const RenderGraphExecuteFunction& execute);
+		void Read(const RenderGraphPass pass, const RenderGraphResource resource, const ERenderGraphUsage usage);
+		void Write(const RenderGraphPass pass, const RenderGraphResource resource, const ERenderGraphUsage usage);
+		// Clears an attachment written by the pass when its render pass begins
+		void SetClearValue(const RenderGraphPass pass, const RenderGraphResource resource, const VkClearValue& clearValue);
+		// Begins the pass's render pass for secondary command buffers. The pass's execute function may then only record vkCmdExecuteCommands
+		void SetSecondaryCommandBufferContents(const RenderGraphPass pass);
+
+		// Culls unused passes, creates transient images, render passes and framebuffers and builds the barriers between passes
+		bool Compile(const RenderGraphContext& context);
+
+		// Records every compiled pass into the command buffer
+		void Execute(VkCommandBuffer commandBuffer, const uint32_t imageIndex, const uint32_t frameIndex);
+
+		void Destroy();
+
+		VkRenderPass GetRenderPass(const RenderGraphPass pass) const;
+		VkImageView GetImageView(const RenderGraphResource resource, const uint32_t imageIndex) const;
+
+	private:
+		struct ResourceUse
+		{
+			RenderGraphResource Resource{ 0 };
+			ERenderGraphUsage Usage{ ERenderGraphUsage::COLOR_ATTACHMENT };
+			bool Write{ false };
+		};
+
+		struct Barrier
+		{
+			RenderGraphResource Resource{ 0 };
+			VkImageLayout OldLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			VkImageLayout NewLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			VkAccessFlags SrcAccess{ 0 };
+			VkAccessFlags DstAccess{ 0 };
+		};
+
+		struct BarrierBatch
+		{
+			std::vector<Barrier> Barriers;
+			VkPipelineStageFlags SrcStages{ 0 };
+			VkPipelineStageFlags DstStages{ 0 };
+		};
+
+		struct Pass
+		{
+			std::string Name;
+			RenderGraphExecuteFunction Execute;
+			std::vector<ResourceUse> Uses;
+			std::vector<std::pair<RenderGraphResource, VkClearValue>> ClearValues;
+			VkSubpassContents Contents{ VK_SUBPASS_CONTENTS_INLINE };
+
+			// Compiled state
+			bool Culled{ false };
+			BarrierBatch Barriers;
+			VkRenderPass RenderPass{ VK_NULL_HANDLE };
+			std::vector<VkFramebuffer> Framebuffers;
+			std::vector<VkClearValue> AttachmentClearValues;
+			VkExtent2D Extent{ 0, 0 };
+		};
+
+		struct Resource
+		{
+			std::string Name;
+			bool Image{ false };
+			bool Imported{ false };
+			VkFormat Format{ VK_FORMAT_UNDEFINED };
+			float SurfaceScale{ 1.0f };
+			VkImageLayout InitialLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			VkImageLayout FinalLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			std::vector<VkImage> Images;
+			std::vector<VkImageView> Views;
+			std::vector<VkBuffer> Buffers;
+
+			// Compiled state
+			VkImageUsageFlags ImageUsage{ 0 };
+			uint32_t FirstPass{ UINT32_MAX };
+			uint32_t LastPass{ 0 };
+			uint32_t MemoryBlock{ UINT32_MAX };
+		};
+
+		struct MemoryBlock
+		{
+			VkDeviceMemory Memory{ VK_NULL_HANDLE };
+			VkDeviceSize Size{ 0 };
+			uint32_t MemoryTypeBits{ UINT32_MAX };
+			uint32_t LastPass{ 0 };
+			// Union of the final stages and accesses of every image placed in the block. The first use of an image in the block waits on them
+			VkPipelineStageFlags FinalStages{ 0 };
+			VkAccessFlags FinalAccess{ 0 };
+		};
+
+		void CullPasses();
+		bool CreateTransientImages();
+		void BuildBarriers();
+		bool CreateRenderPass(Pass& pass);
+		void RecordBarriers(VkCommandBuffer commandBuffer, const BarrierBatch& batch, const uint32_t imageIndex, const uint32_t frameIndex);
+
+		RenderGraphContext Context{};
+		std::vector<Pass> Passes;
+		std::vector<Resource> Resources;
+		std::vector<MemoryBlock> MemoryBlocks;
+		BarrierBatch FinalBarriers;
+
+		// Scratch barrier storage reused every frame
+		std::vector<VkImageMemoryBarrier> ImageBarriers;
+		std::vector<VkBufferMemoryBarrier> BufferBarriers;
+	};
+}
\ No newline at end of file
@@ -1,12 +1,22 @@
 #include "Pch.h"
 #include "Renderer.h"
+#include "RenderGraph.h"
+#include "CommandList.h"
+#include "LightmapBaker.h"
+#include "SoftwareRasterizer.h"
+#include "TextureStreamer.h"
+#include "Vertex1Pos2UV1Norm.h"
 #include "Console.h"
 #include "BinarySystem/Binary.h"
 #include "Maths/Maths.h"
+#include "JobSystem/JobSystem.h"
 
 #include "Game/Level.h"
+#include "Game/HUD.h"
+#include "Game/Interpolation.h"
 #include "Game/Components/StaticMeshComponent.h"
 #include "Game/Components/TransformComponent.h"
+#include "Game/Components/PointLightComponent.h"
 
 // Remove windows CreateSemaphore definition
 #ifdef CreateSemaphore
@@ -41,10 +51,20 @@ public:
     VkBuffer& GetIndexBuffer() { return IndexBuffer; }
     VkDeviceMemory& GetIndexBufferMemory() { return IndexBufferMemory; }
     void SetIndexCount(const uint32_t count) { IndexCount = count; }
+    void SetBoundingSphere(const glm::vec4& sphere) { BoundingSphere = sphere; }
+    void SetTextureCoordExtent(const float extent) { TextureCoordExtent = extent; }
+    std::vector<Renderer::Vertex1Pos1UV1Norm>& GetVertices() { return Vertices; }
+    std::vector<uint32_t>& GetIndices() { return Indices; }
+    std::vector<Renderer::Vertex1Pos2UV1Norm>& GetLightmappedVertices() { return LightmappedVertices; }
 
     const VkBuffer& GetVertexBuffer() const { return VertexBuffer; }
     const VkBuffer& GetIndexBuffer() const { return IndexBuffer; }
     const uint32_t GetIndexCount() const { return IndexCount; }
+    const glm::vec4& GetBoundingSphere() const { return BoundingSphere; }
+    const float GetTextureCoordExtent() const { return TextureCoordExtent; }
+    const std::vector<Renderer::Vertex1Pos1UV1Norm>& GetVertices() const { return Vertices; }
+    const std::vector<uint32_t>& GetIndices() const { return Indices; }
+    const std::vector<Renderer::Vertex1Pos2UV1Norm>& GetLightmappedVertices() const { return LightmappedVertices; }
 
     void Reset()
     {
@@ -53,6 +73,11 @@ public:
         IndexBuffer = VK_NULL_HANDLE;
         IndexBufferMemory = VK_NULL_HANDLE;
         IndexCount = 0;
+        BoundingSphere = { 0.0f, 0.0f, 0.0f, 0.0f };
+        TextureCoordExtent = 0.0f;
+        Vertices.clear();
+        Indices.clear();
+        LightmappedVertices.clear();
     }
 
 private:
@@ -61,6 +86,15 @@ private:
     VkBuffer IndexBuffer{ VK_NULL_HANDLE };
     VkDeviceMemory IndexBufferMemory{ VK_NULL_HANDLE };
     uint32_t IndexCount{ 0 };
+    // Local space center and radius of a sphere bounding the geometry's vertices. Draw items are culled against each view with it
+    glm::vec4 BoundingSphere{ 0.0f, 0.0f, 0.0f, 0.0f };
+    // Largest span of the geometry's texture coordinates. Streamed textures are requested at the mip the span needs on screen
+    float TextureCoordExtent{ 0.0f };
+    // Host copies of the geometry's vertices and indices. Static meshes are merged from them when a level loads
+    std::vector<Renderer::Vertex1Pos1UV1Norm> Vertices;
+    std::vector<uint32_t> Indices;
+    // Host copy of lightmapped geometry's unindexed vertices drawn by the software backend
+    std::vector<Renderer::Vertex1Pos2UV1Norm> LightmappedVertices;
 };
 
 class Texture
@@ -69,22 +103,37 @@ public:
     VkImage& GetImage() { return Image; }
     VkDeviceMemory& GetImageMemory() { return ImageMemory; }
     VkImageView& GetImageView() { return ImageView; }
+    Renderer::SoftwareTexture& GetSoftwareTexture() { return SoftwareTexture; }
+    std::vector<Renderer::TextureMip>& GetMips() { return Mips; }
+    void SetResidentMip(const uint32_t mip) { ResidentMip = mip; }
 
     const VkImage& GetImage() const { return Image; }
     const VkDeviceMemory& GetImageMemory() const { return ImageMemory; }
     const VkImageView& GetImageView() const { return ImageView; }
+    const Renderer::SoftwareTexture& GetSoftwareTexture() const { return SoftwareTexture; }
+    const std::vector<Renderer::TextureMip>& GetMips() const { return Mips; }
+    uint32_t GetResidentMip() const { return ResidentMip; }
 
     void Reset()
     {
         Image = VK_NULL_HANDLE;
         ImageMemory = VK_NULL_HANDLE;
         ImageView = VK_NULL_HANDLE;
+        SoftwareTexture = {};
+        Mips.clear();
+        ResidentMip = 0;
     }
 
 private:
     VkImage Image{ VK_NULL_HANDLE };
     VkDeviceMemory ImageMemory{ VK_NULL_HANDLE };
     VkImageView ImageView{ VK_NULL_HANDLE };
+    // Host copy of the texture's texels sampled by the software backend
+    Renderer::SoftwareTexture SoftwareTexture;
+    // Host copy of a streamed texture's mip chain. Mips are uploaded from it as they are streamed in
+    std::vector<Renderer::TextureMip> Mips;
+    // Mip of the chain held by the image's first level
+    uint32_t ResidentMip{ 0 };
 };
 
 // Settings
@@ -92,6 +141,7 @@ constexpr auto MAX_SYNCHRONIZATION_TIMEOUT_DURATION{ std::chrono::nanoseconds::m
 constexpr glm::vec4 CLEAR_COLOR{ 1.0f, 0.0f, 1.0f, 1.0f };
 constexpr size_t MAX_FRAMES_IN_FLIGHT{ 3 };
 constexpr uint32_t MAX_DRAW_ITEMS_PER_FRAME{ 64 };
+constexpr uint32_t MAX_SPRITES_PER_FRAME{ 256 };
 constexpr size_t WORLD_MATRIX_SIZE_BYTES{ sizeof(glm::mat4) };
 
 static uint32_t gSwapchainImageCount{ 3 }; // Triple buffering
@@ -100,21 +150,27 @@ static bool gStencilAvailable{ false };
 
 const std::string gVertexShaderPath{ "Shaders/binary/VertexShader.spv" };
 const std::string gFragmentShaderPath{ "Shaders/binary/FragmentShader.spv" };
+const std::string gSpriteVertexShaderPath{ "Shaders/binary/SpriteVertexShader.spv" };
+const std::string gSpriteFragmentShaderPath{ "Shaders/binary/SpriteFragmentShader.spv" };
+const std::string gLightmapVertexShaderPath{ "Shaders/binary/LightmapVertexShader.spv" };
+const std::string gLightmapFragmentShaderPath{ "Shaders/binary/LightmapFragmentShader.spv" };
 
 // Uniform buffers
 struct PerObjectUniforms
 {
     glm::mat4 WorldMatrix{ glm::identity<glm::mat4>() };
     glm::mat4 NormalMatrix{ glm::identity<glm::mat4>() };
-    glm::vec4 Data1{ 0.0f, 0.0f, 0.0f, 0.0f };
-    uint32_t SamplerID{ 0 };
-    uint32_t TextureID{ 0 };
+    uint32_t MaterialID{ 0 };
+    uint32_t LightmapTextureID{ 0 };
+    float FlipbookPhase{ 0.0f };
 };
 
 struct PerFrameUniforms
 {
     glm::vec4 DirectionalLightColor;
     glm::vec4 DirectionalLightWorldSpaceDirection;
+    // Seconds since the renderer was initialised. Drives flipbook animation
+    float Time{ 0.0f };
 };
 
 struct PerRenderPassUniforms
@@ -122,6 +178,8 @@ struct PerRenderPassUniforms
     glm::mat4 ViewMatrix{ glm::identity<glm::mat4>() };
     glm::mat4 ProjectionMatrix{ glm::identity<glm::mat4>() };
     glm::vec4 CameraWorldSpacePosition{ 0.0f, 0.0f, 0.0f, 1.0f };
+    // Selects the view's clusters in the light grid
+    uint32_t ViewIndex{ 0 };
 };
 
 constexpr uint32_t UNIFORM_BUFFER_COUNT{ 3 };
@@ -130,6 +188,91 @@ std::vector<void*> gMappedPerObjectUniformBuffers;
 std::vector<void*> gMappedPerFrameUniformBuffers;
 std::vector<void*> gMappedPerRenderPassUniformBuffers;
 
+// Material table. Material parameters are stored once in a storage buffer indexed by material ID
+struct MaterialData
+{
+    uint32_t SamplerID{ 0 };
+    uint32_t TextureID{ 0 };
+    glm::vec2 TextureScale{ 1.0f, 1.0f };
+    uint32_t FlipbookFrameCount{ 1 };
+    uint32_t FlipbookColumnCount{ 1 };
+    float FlipbookFrameRate{ 0.0f };
+    // Pads the material to its std430 array stride
+    uint32_t Padding{ 0 };
+};
+
+constexpr uint32_t MAX_MATERIAL_COUNT{ 256 };
+constexpr VkDeviceSize MATERIAL_BUFFER_SIZE{ sizeof(MaterialData) * MAX_MATERIAL_COUNT };
+
+static std::vector<Renderer::Material> gMaterials;
+static VkBuffer gMaterialBuffer{ VK_NULL_HANDLE };
+static VkDeviceMemory gMaterialBufferMemory{ VK_NULL_HANDLE };
+static void* gMappedMaterialBuffer{ nullptr };
+
+// Clustered point lights. The view frustum is split into clusters with exponentially spaced depth slices and each cluster
+// stores a list of the point lights that overlap it
+constexpr uint32_t CLUSTER_COUNT_X{ 16 };
+constexpr uint32_t CLUSTER_COUNT_Y{ 9 };
+constexpr uint32_t CLUSTER_COUNT_Z{ 24 };
+constexpr uint32_t CLUSTER_COUNT{ CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z };
+constexpr uint32_t MAX_POINT_LIGHTS_PER_FRAME{ 256 };
+constexpr uint32_t MAX_CLUSTER_LIGHT_INDICES{ CLUSTER_COUNT * 32 };
+constexpr float MIN_CLUSTER_DEPTH{ 0.1f };
+
+struct PointLightData
+{
+    glm::vec4 WorldSpacePositionRadius{ 0.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec4 ColorIntensity{ 0.0f, 0.0f, 0.0f, 0.0f };
+};
+
+// Clusters of one view's frustum
+struct ClusterGrid
+{
+    // Cluster counts in x, y and z
+    glm::uvec4 ClusterCounts{ CLUSTER_COUNT_X, CLUSTER_COUNT_Y, CLUSTER_COUNT_Z, 0 };
+    // Near depth, far depth, depth slice scale and depth slice bias
+    glm::vec4 ClusterDepth{ 0.0f, 0.0f, 0.0f, 0.0f };
+    // Tile width and height in pixels followed by the position of the view's viewport
+    glm::vec4 ClusterTileSize{ 0.0f, 0.0f, 0.0f, 0.0f };
+    // Offset into light indices and light count for each cluster
+    std::array<glm::uvec2, CLUSTER_COUNT> Clusters;
+    std::array<uint32_t, MAX_CLUSTER_LIGHT_INDICES> LightIndices;
+};
+
+// Matches the std430 layout of the light grid storage buffer read by the fragment shader. Point lights are shared by every view
+// and each view bins them into its own clusters
+struct LightGrid
+{
+    // x is the point light count
+    glm::uvec4 LightCount{ 0, 0, 0, 0 };
+    std::array<PointLightData, MAX_POINT_LIGHTS_PER_FRAME> Lights;
+    std::array<ClusterGrid, Renderer::MAX_VIEW_COUNT> Views;
+};
+
+static std::vector<VkBuffer> gLightGridBuffers;
+static std::vector<VkDeviceMemory> gLightGridBuffersMemory;
+static std::vector<void*> gMappedLightGridBuffers;
+static bool gLightGridBuilt{ false };
+// Light indices binned into each depth slice. Kept between frames to reuse their memory
+static std::array<std::vector<uint32_t>, CLUSTER_COUNT_Z> gSliceLightIndices;
+static std::array<uint32_t, CLUSTER_COUNT> gClusterLightCounts{};
+
+// Sprite batching
+struct SpriteVertex
+{
+    glm::vec3 Pos{ 0.0f, 0.0f, 0.0f };
+    glm::vec2 UV{ 0.0f, 0.0f };
+    glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+    uint32_t SamplerID{ 0 };
+    uint32_t TextureID{ 0 };
+};
+
+constexpr uint32_t SPRITE_VERTEX_COUNT{ 4 };
+constexpr uint32_t SPRITE_INDEX_COUNT{ 6 };
+constexpr std::array<uint32_t, SPRITE_INDEX_COUNT> SPRITE_QUAD_INDICES{ 0, 1, 2, 2, 3, 0 };
+
+std::vector<void*> gMappedSpriteVertexBuffers;
+
 // Vulkan object handles
 static VkInstance gInstance{ VK_NULL_HANDLE };
 static VkPhysicalDevice gPhysicalDevice{ VK_NULL_HANDLE };
@@ -140,14 +283,12 @@ static VkDevice gDevice{ VK_NULL_HANDLE };
 static QueueFamilyIndices gQueueFamilyIndices{};
 static VkQueue gGraphicsQueue{ VK_NULL_HANDLE };
 static VkQueue gTransferQueue{ VK_NULL_HANDLE };
-static VkRenderPass gRenderPass{ VK_NULL_HANDLE };
 static std::vector<VkSemaphore> gImageAvailableSemaphores;
 static std::vector<VkSemaphore> gRenderFinishedSemaphores;
 static std::vector<VkFence> gInFlightFences;
 static std::vector<VkFence> gImagesInFlight;
 static VkDescriptorSetLayout gDescriptorSetLayout{ VK_NULL_HANDLE };
 static VkPipelineLayout gGraphicsPipelineLayout{ VK_NULL_HANDLE };
-static VkPipeline gGraphicsPipeline{ VK_NULL_HANDLE };
 static VkCommandPool gGraphicsCommandPool{ VK_NULL_HANDLE };
 static std::vector<VkCommandBuffer> gGraphicsCommandBuffers;
 static VkCommandPool gTransferTemporaryCommandPool{ VK_NULL_HANDLE };
@@ -162,14 +303,15 @@ static std::vector<VkBuffer> gPerRenderPassUniformBuffers;
 static std::vector<VkDeviceMemory> gPerRenderPassUniformBuffersMemory;
 static VkDeviceSize gMinUniformBufferOffsetAlignment{ 0 };
 
+static std::vector<VkBuffer> gSpriteVertexBuffers;
+static std::vector<VkDeviceMemory> gSpriteVertexBuffersMemory;
+static VkBuffer gSpriteIndexBuffer{ VK_NULL_HANDLE };
+static VkDeviceMemory gSpriteIndexBufferMemory{ VK_NULL_HANDLE };
+
 static VkSurfaceKHR gSurface{ VK_NULL_HANDLE };
 static VkSwapchainKHR gSwapchain{ VK_NULL_HANDLE };
 static std::vector<VkImage> gSwapchainImages;
-static std::vector<VkFramebuffer> gFramebuffers;
 static std::vector<VkImageView> gSwapchainImageViews;
-static VkImage gDepthStencilImage{ VK_NULL_HANDLE };
-static VkImageView gDepthStencilImageView{ VK_NULL_HANDLE };
-static VkDeviceMemory gDepthStencilImageMemory{ VK_NULL_HANDLE };
 static VkSurfaceCapabilitiesKHR gSurfaceCapabilities{};
 static VkSurfaceFormatKHR gSurfaceFormat{};
 uint32_t gSurfaceWidth{ 0 };
@@ -198,6 +340,80 @@ static std::array<Texture, MAX_LOADED_TEXTURE_COUNT> gLoadedTextures{};
 static std::queue<uint32_t> gAvailableTextureIDs;
 static std::vector<uint32_t> gUsedTextureIDs;
 
+// Texture streaming
+static Renderer::TextureStreamer gTextureStreamer;
+// Frames whose descriptor sets point at texture images replaced by streaming
+static std::vector<bool> gStaleTextureDescriptorSets;
+
+// Deferred destruction
+// Device resources released by the application. Destroyed once every frame that could use them has finished
+struct DeferredDestruction
+{
+    VkBuffer Buffer{ VK_NULL_HANDLE };
+    VkImage Image{ VK_NULL_HANDLE };
+    VkImageView ImageView{ VK_NULL_HANDLE };
+    VkDeviceMemory Memory{ VK_NULL_HANDLE };
+    // Frame being recorded when destruction was requested
+    uint64_t Frame{ 0 };
+};
+
+// Ordered by frame
+static std::deque<DeferredDestruction> gDeferredDestructions;
+
+// Uploads
+// Staging memory is sub-allocated from a persistently mapped ring buffer
+constexpr VkDeviceSize STAGING_RING_SIZE{ 32 * 1024 * 1024 };
+// Satisfies the texel size and optimal buffer copy offset alignment of supported devices
+constexpr VkDeviceSize STAGING_ALIGNMENT{ 256 };
+
+// Staging memory an upload writes its data into
+struct StagingAllocation
+{
+    VkBuffer Buffer{ VK_NULL_HANDLE };
+    VkDeviceSize Offset{ 0 };
+    uint8_t* pData{ nullptr };
+};
+
+// Staging memory in use by an upload. Memory read by a frame's command buffer is released once the frame has finished and memory read
+// by uploads submitted outside of frames is released when the upload fence signals. Uploads that do not fit in the ring are given a
+// dedicated buffer
+struct StagingRegion
+{
+    VkDeviceSize Begin{ 0 };
+    VkDeviceSize End{ 0 };
+    VkBuffer DedicatedBuffer{ VK_NULL_HANDLE };
+    VkDeviceMemory DedicatedBufferMemory{ VK_NULL_HANDLE };
+    bool FrameUpload{ false };
+    uint64_t Frame{ 0 };
+    bool Released{ false };
+};
+
+static VkBuffer gStagingRingBuffer{ VK_NULL_HANDLE };
+static VkDeviceMemory gStagingRingBufferMemory{ VK_NULL_HANDLE };
+static uint8_t* gMappedStagingRingBuffer{ nullptr };
+static VkDeviceSize gStagingRingHead{ 0 };
+// Regions are released in the order they were allocated
+static std::deque<StagingRegion> gStagingRingRegions;
+static std::vector<StagingRegion> gDedicatedStagingRegions;
+static VkFence gUploadFence{ VK_NULL_HANDLE };
+
+// Uploads recorded for a queue while an upload batch is open. They are submitted together when the batch ends
+struct UploadBatch
+{
+    VkCommandPool CommandPool{ VK_NULL_HANDLE };
+    VkQueue Queue{ VK_NULL_HANDLE };
+    VkFence Fence{ VK_NULL_HANDLE };
+    // Begun by the batch's first upload
+    VkCommandBuffer CommandBuffer{ VK_NULL_HANDLE };
+};
+
+// Geometry is uploaded on the transfer queue and textures on the graphics queue
+constexpr size_t TRANSFER_UPLOAD_BATCH{ 0 };
+constexpr size_t GRAPHICS_UPLOAD_BATCH{ 1 };
+
+static bool gUploadBatchOpen{ false };
+static std::array<UploadBatch, 2> gUploadBatches{};
+
 // Samplers
 constexpr uint32_t SAMPLER_COUNT{ 2 };
 
@@ -208,15 +424,93 @@ constexpr uint32_t DYNAMIC_OFFSET_COUNT{ 2 };
 constexpr size_t PER_OBJECT_UNIFORMS_DYNAMIC_OFFSET_INDEX{ 0 };
 constexpr size_t PER_RENDER_PASS_UNIFORMS_DYNAMIC_OFFSET_INDEX{ 1 };
 
-// Rendering
-constexpr uint32_t MAX_RENDER_PASS_COUNT{ 2 };
+// Rendering. Each view is rendered in its own render pass followed by the HUD's render pass
+constexpr uint32_t MAX_RENDER_PASS_COUNT{ Renderer::MAX_VIEW_COUNT + 1 };
+// Views are laid out by the number of views rendered in a frame. Every view of every layout has a slot so that static geometry can be
+// recorded once for each of them
+constexpr uint32_t VIEW_LAYOUT_SLOT_COUNT{ (Renderer::MAX_VIEW_COUNT * (Renderer::MAX_VIEW_COUNT + 1)) / 2 };
 
 static size_t gCurrentFrame{ 0 };
+static uint64_t gFrameNumber{ 0 };
+// Frames numbered below the finished frame count have finished executing on the device
+static uint64_t gFinishedFrameCount{ 0 };
 static uint32_t gImageIndex{ 0 };
 static VkCommandBuffer gCurrentFrameCommandBuffer{ VK_NULL_HANDLE };
 static uint32_t gDrawItemSubmitCount{ 0 };
 static uint32_t gRenderPassCount{ 0 };
+static uint32_t gSpriteSubmitCount{ 0 };
 static std::array<uint32_t, DYNAMIC_OFFSET_COUNT> gDynamicOffsets{};
+// View of the current render pass. Point lights are clustered in this view
+static glm::mat4 gRenderPassViewMatrix{ glm::identity<glm::mat4>() };
+static glm::mat4 gRenderPassProjectionMatrix{ glm::identity<glm::mat4>() };
+static float gRenderPassNearClipPlane{ 0.0f };
+static float gRenderPassFarClipPlane{ 0.0f };
+static VkRect2D gRenderPassViewport{};
+static uint32_t gRenderPassViewIndex{ 0 };
+// Number of views of the level rendered this frame
+static uint32_t gViewCount{ 0 };
+
+// Render graph
+static Renderer::RenderGraph gRenderGraph;
+static Renderer::RenderGraphPass gStaticScenePass{ 0 };
+static Renderer::RenderGraphPass gScenePass{ 0 };
+static Renderer::RenderGraphPass gHUDPass{ 0 };
+
+// Backend selected at initialisation
+static Renderer::EBackend gBackend{ Renderer::EBackend::VULKAN };
+static std::chrono::steady_clock::time_point gInitTime{};
+
+// Pipelines. Shader modules are kept for the renderer's lifetime so pipeline permutations can be built when first bound
+struct ShaderProgram
+{
+    VkShaderModule VertexShaderModule{ VK_NULL_HANDLE };
+    VkShaderModule FragmentShaderModule{ VK_NULL_HANDLE };
+};
+
+constexpr size_t SHADER_PROGRAM_COUNT{ 3 };
+// Fragment shader specialization constant IDs
+constexpr uint32_t LIGHTING_MODEL_CONSTANT_ID{ 0 };
+constexpr uint32_t GAMMA_CORRECT_CONSTANT_ID{ 1 };
+
+static std::array<ShaderProgram, SHADER_PROGRAM_COUNT> gShaderPrograms{};
+// Pipeline permutations keyed by packed pipeline state
+static std::unordered_map<uint32_t, VkPipeline> gPipelineCache;
+
+// Command lists recorded during the frame and translated by the backend into the render graph's passes when the frame ends
+static Renderer::CommandList gSceneCommandList;
+static Renderer::CommandList gHUDCommandList;
+static Renderer::CommandStatistics gCommandStatistics{};
+
+// Static geometry recorded once when a level loads. Static per object uniforms live in a persistent buffer bound through
+// a second set of descriptor sets and the static draws are replayed each frame from secondary command buffers. The static draws
+// are recorded for each view layout slot so each view replays them with its own viewport and per render pass uniforms
+static std::array<Renderer::CommandList, VIEW_LAYOUT_SLOT_COUNT> gStaticCommandLists;
+static std::vector<VkCommandBuffer> gStaticCommandBuffers;
+static std::vector<VkDescriptorSet> gStaticDescriptorSets;
+static VkBuffer gStaticUniformBuffer{ VK_NULL_HANDLE };
+static VkDeviceMemory gStaticUniformBufferMemory{ VK_NULL_HANDLE };
+static bool gStaticCommandBuffersRecorded{ false };
+// Geometry that static meshes were merged into. It is owned by the renderer and destroyed when the next level's static geometry is recorded
+static std::vector<uint32_t> gMergedGeometryIDs;
+// Draw items of the merged geometry. Their textures are requested from the texture streamer for each view
+static std::vector<Renderer::DrawItem> gStaticDrawItems;
+// Lighting for static geometry is baked into the lightmap texture when a level loads
+static uint32_t gLightmapTextureID{ 0 };
+static bool gLightmapLoaded{ false };
+
+// Host memory standing in for the persistently mapped buffers when the null or software backend is used
+static std::vector<std::vector<uint8_t>> gNullBackendBufferStorage;
+// Host memory standing in for the static per object uniform buffer
+static std::vector<uint8_t> gHostStaticUniformBuffer;
+
+// Software backend. The frame's command lists are rasterized on the CPU and the framebuffer is presented to the window
+static Renderer::SoftwareRasterizer gSoftwareRasterizer;
+static HWND gSoftwareWindowHandle{ nullptr };
+static std::vector<Renderer::SoftwareVertex> gSoftwareVertices;
+static std::vector<Renderer::SoftwareVertex> gSoftwareTransformedVertices;
+// Match the lighting of the mesh fragment shader
+constexpr glm::vec3 SOFTWARE_AMBIENT_LIGHT{ 0.05f, 0.05f, 0.05f };
+constexpr float SOFTWARE_SPECULAR_GLOSS{ 4.0f };
 
 // Debug
 static VkDebugReportCallbackEXT gDebugReport{ VK_NULL_HANDLE };
@@ -394,6 +688,22 @@ static bool CreateInstance()
     return vkCreateInstance(&instanceCreateInfo, nullptr, &gInstance) == VK_SUCCESS;
 }
 
+// Checks the physical device supports the descriptor indexing features CreateLogicalDevice enables. Partially bound descriptors
+// are used by every descriptor set and non uniform indexing by batched sprites
+static bool SupportsDescriptorIndexing(VkPhysicalDevice device)
+{
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures{};
+    deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures.pNext = &descriptorIndexingFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &deviceFeatures);
+
+    return (descriptorIndexingFeatures.descriptorBindingPartiallyBound == VK_TRUE) &&
+        (descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE);
+}
+
 static VkPhysicalDevice GetPhysicalDevice(VkDeviceSize& minUniformBufferOffsetAlignment, 
     VkPhysicalDeviceProperties& physicalDeviceProperties, VkPhysicalDeviceMemoryProperties& phyiscalDeviceMemoryProperties, VkPhysicalDeviceFeatures& physicalDeviceFeatures)
 {
@@ -438,9 +748,11 @@ static VkPhysicalDevice GetPhysicalDevice(VkDeviceSize& minUniformBufferOffsetAl
         VkPhysicalDeviceFeatures deviceFeatures;
         vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
 
-        // If the physical device is not a dedicated GPU or does not have a memory heap, skip to the next physical device
+        // If the physical device is not a dedicated GPU, does not have a memory heap or cannot index descriptors as the renderer
+        // needs, skip to the next physical device
         if (deviceProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ||
-            deviceMemoryProperties.memoryHeapCount == 0)
+            deviceMemoryProperties.memoryHeapCount == 0 ||
+            !SupportsDescriptorIndexing(device))
         {
             continue;
         }
@@ -586,12 +898,15 @@ static bool CreateLogicalDevice(VkPhysicalDevice physicalDevice, const VkPhysica
     robustnessFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT;
     robustnessFeatures.nullDescriptor = VK_TRUE;
 
-    // Enable binding partially bound descriptors
+    // Enable binding partially bound descriptors. Physical devices without the descriptor indexing features used are not selected
     VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
     descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
     descriptorIndexingFeatures.pNext = &robustnessFeatures;
     descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
 
+    // Enable indexing texture and sampler arrays with values that vary within a draw. Used by batched sprites
+    descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
     // Describe device create info
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -814,26 +1129,7 @@ static bool GetSwapchainImagesAndCreateViews(
     return true;
 }
 
-static uint32_t FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties, const VkMemoryRequirements& memoryRequirements,
-    const VkMemoryPropertyFlags memoryProperties)
-{
-    auto requiredProperties{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
-    for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; ++i)
-    {
-        if (memoryRequirements.memoryTypeBits & (1 << i))
-        {
-            if ((physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & memoryProperties) == memoryProperties)
-            {
-                return i;
-            }
-        }
-    }
-
-    return UINT32_MAX;
-}
-
-static bool CreateDepthStencilImageAndView(VkDevice device, VkPhysicalDevice physicalDevice,const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties,
-    uint32_t width, uint32_t height, VkImage* pImage, VkImageView* pImageView, VkDeviceMemory* pMemory)
+static bool FindDepthStencilFormat(VkPhysicalDevice physicalDevice)
 {
     // Find supported depth stencil format
     std::array<VkFormat, 5> tryFormats{
@@ -878,84 +1174,6 @@ static bool CreateDepthStencilImageAndView(VkDevice device, VkPhysicalDevice phy
         gStencilAvailable = false;
     }
 
-    // Describe the image create info
-    VkImageCreateInfo imageCreateInfo{};
-    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageCreateInfo.flags = 0;
-    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageCreateInfo.format = gDepthStencilFormat;
-    imageCreateInfo.extent.width = width;
-    imageCreateInfo.extent.height = height;
-    imageCreateInfo.extent.depth = 1;
-    imageCreateInfo.mipLevels = 1;
-    imageCreateInfo.arrayLayers = 1;
-    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageCreateInfo.queueFamilyIndexCount = 0; // Ignored when sharing mode is VK_SHARING_MODE_EXCLUSIVE
-    imageCreateInfo.pQueueFamilyIndices = nullptr; // Ignored when sharing mode is VK_SHARING_MODE_EXCLUSIVE
-    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-    // Create the image
-    if (vkCreateImage(device, &imageCreateInfo, nullptr, pImage) != VK_SUCCESS)
-    {
-        return false;
-    }
-
-    // Get the depth stencil image memory requirements
-    VkMemoryRequirements imageMemoryRequirements;
-    vkGetImageMemoryRequirements(device, *pImage, &imageMemoryRequirements);
-
-    // Get the memory type index
-    uint32_t memoryIndex = FindMemoryTypeIndex(physicalDeviceMemoryProperties, imageMemoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    // Check a memory index was found
-    if (memoryIndex == UINT32_MAX)
-    {
-        return false;
-    }
-
-    // Describe image memory allocation
-    VkMemoryAllocateInfo memoryAllocInfo{};
-    memoryAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    memoryAllocInfo.allocationSize = imageMemoryRequirements.size;
-    memoryAllocInfo.memoryTypeIndex = memoryIndex;
-
-    // Allocate memory for the image
-    if (vkAllocateMemory(device, &memoryAllocInfo, nullptr, pMemory) != VK_SUCCESS)
-    {
-        return false;
-    }
-
-    // Bind image memory
-    if (vkBindImageMemory(device, *pImage, *pMemory, 0) != VK_SUCCESS)
-    {
-        return false;
-    }
-
-    // Descrive the image view create info
-    VkImageViewCreateInfo imageViewCreateInfo{};
-    imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    imageViewCreateInfo.image = *pImage;
-    imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    imageViewCreateInfo.format = gDepthStencilFormat;
-    imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-    imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | (gStencilAvailable ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
-    imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-    imageViewCreateInfo.subresourceRange.levelCount = 1;
-    imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
-    imageViewCreateInfo.subresourceRange.layerCount = 1;
-
-    // Create the image view
-    if (vkCreateImageView(device, &imageViewCreateInfo, nullptr, pImageView) != VK_SUCCESS)
-    {
-        return false;
-    }
-
     return true;
 }
 
@@ -984,114 +1202,6 @@ static bool AllocateCommandBuffers(VkDevice device, VkCommandPool commandPool, u
     return vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, pCommandBuffers) == VK_SUCCESS;
 }
 
-static bool CreateRenderPass(VkDevice device, const VkFormat& surfaceFormat, const VkFormat& depthStencilFormat, VkRenderPass* pRenderPass)
-{
-    // Create an array of attachments for the render pass. Only 1 currently as the render pass 
-    // will only use a color attachment. This will need to be increased when a depth stencil attachment is created
-    std::array<VkAttachmentDescription, 2> attachments{};
-    auto& colorAttachment = attachments[0];
-    colorAttachment.flags = 0;
-    colorAttachment.format = surfaceFormat;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    // Create an array of attachment references. This color attachment will be referenced in the fragment shader at layout location = 0
-    std::array<VkAttachmentReference, 1> subpass0ColorAttachments{};
-    subpass0ColorAttachments[0].attachment = 0;
-    subpass0ColorAttachments[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    // Create depth stencil attachment reference. Only 1 depth stencil attachment is allowed per subpass
-    auto& depthStencilAttachment = attachments[1];
-    depthStencilAttachment.format = depthStencilFormat;
-    depthStencilAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    depthStencilAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthStencilAttachment.stencilLoadOp = gStencilAvailable ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    depthStencilAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthStencilAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthStencilAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    VkAttachmentReference subpass0DepthStencilAttachment{};
-    subpass0DepthStencilAttachment.attachment = 1;
-    subpass0DepthStencilAttachment.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    // Create an array of subpasses
-    std::array<VkSubpassDescription, 1> subpasses{};
-    auto& subpass0 = subpasses[0];
-    subpass0.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass0.inputAttachmentCount = 0;
-    subpass0.pInputAttachments = nullptr;
-    subpass0.colorAttachmentCount = static_cast<uint32_t>(subpass0ColorAttachments.size());
-    subpass0.pColorAttachments = subpass0ColorAttachments.data();
-    subpass0.pDepthStencilAttachment = &subpass0DepthStencilAttachment;
-
-    // Describe dependency 
-    VkSubpassDependency dependency{};
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-    // Describe create info
-    VkRenderPassCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-    createInfo.pAttachments = attachments.data();
-    createInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
-    createInfo.pSubpasses = subpasses.data();
-    createInfo.dependencyCount = 1;
-    createInfo.pDependencies = &dependency;
-
-    // Create the render pass
-    return vkCreateRenderPass(device, &createInfo, nullptr, pRenderPass) == VK_SUCCESS;
-}
-
-static bool CreateFramebuffers(
-    VkDevice device,
-    const uint32_t swapchainImageCount, 
-    VkRenderPass renderPass, 
-    const uint32_t surfaceWidth, 
-    const uint32_t surfaceHeight, 
-    const std::vector<VkImageView>& swapchainImageViews,
-    VkImageView depthStencilImageView,
-    std::vector<VkFramebuffer>& framebuffers)
-{
-    // Resize the framebuffers vector to create a framebuffer for each image in the swapchain
-    framebuffers.resize(swapchainImageCount);
-
-    // Create a framebuffer for each image in the swapchain
-    for (uint32_t i = 0; i < swapchainImageCount; ++i)
-    {
-        // Create image views to the render pass attachments. The color attachment is the swapchain image this framebuffer
-        // refers to and the depth stencil attachment is the depth stencil attachment
-        std::array<VkImageView, 2> attachments{
-            swapchainImageViews[i],
-            depthStencilImageView
-        };
-
-        // Describe framebuffer create info
-        VkFramebufferCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        createInfo.renderPass = renderPass;
-        createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        createInfo.pAttachments = attachments.data();
-        createInfo.width = surfaceWidth;
-        createInfo.height = surfaceHeight;
-        createInfo.layers = 1;
-
-        // Create a framebuffer
-        if (vkCreateFramebuffer(device, &createInfo, nullptr, &framebuffers[i]) != VK_SUCCESS)
-        {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 static bool CreateFence(VkDevice device, VkFence* pFence)
 {
     // Describe fence create info
@@ -1173,7 +1283,7 @@ static bool BeginSingleSubmitCommandBuffer(VkDevice device, VkCommandPool comman
     return true;
 }
 
-static bool EndAndSubmitSingleSubmitCommandBuffer(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkCommandBuffer commandBuffer)
+static bool EndAndSubmitSingleSubmitCommandBuffer(VkDevice device, VkCommandPool commandPool, VkQueue queue, VkFence fence, VkCommandBuffer commandBuffer)
 {
     // Stop recoding commands
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
@@ -1187,13 +1297,13 @@ static bool EndAndSubmitSingleSubmitCommandBuffer(VkDevice device, VkCommandPool
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    if (vkResetFences(device, 1, &fence) != VK_SUCCESS || vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS)
     {
         return false;
     }
 
     // Wait for the command buffer to finish executing
-    if (vkQueueWaitIdle(queue) != VK_SUCCESS)
+    if (vkWaitForFences(device, 1, &fence, VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION) != VK_SUCCESS)
     {
         return false;
     }
@@ -1273,137 +1383,455 @@ static void DestroyBuffer(VkBuffer buffer, VkDeviceMemory bufferMemory)
     vkFreeMemory(gDevice, bufferMemory, nullptr);
 }
 
-static bool CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkImage* pImage, VkDeviceMemory* pImageMemory)
+static VkDeviceSize AlignStagingOffset(const VkDeviceSize offset)
 {
-    // Describe image create info
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = mipLevels;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.queueFamilyIndexCount = 0;
-    imageInfo.pQueueFamilyIndices = nullptr;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.flags = 0;
-
-    // Create the image
-    if (vkCreateImage(gDevice, &imageInfo, nullptr, pImage) != VK_SUCCESS)
-    {
-        return false;
-    }
-
-    // Get image memory requirements
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(gDevice, *pImage, &memRequirements);
+    return (offset + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+}
 
-    // Describe memory allocation info
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, gPhysicalDevice);
+static bool IsStagingRegionReleased(const StagingRegion& region)
+{
+    return region.Released || (region.FrameUpload && (region.Frame < gFinishedFrameCount));
+}
 
-    // Allocate image memory for the texture
-    if (vkAllocateMemory(gDevice, &allocInfo, nullptr, pImageMemory) != VK_SUCCESS)
+// Recycles staging memory whose uploads have finished
+static void RecycleStagingMemory()
+{
+    while (!gStagingRingRegions.empty() && IsStagingRegionReleased(gStagingRingRegions.front()))
     {
-        return false;
+        gStagingRingRegions.pop_front();
     }
 
-    // Bind image memory to the texture image
-    if (vkBindImageMemory(gDevice, *pImage, *pImageMemory, 0) != VK_SUCCESS)
+    for (const auto& region : gDedicatedStagingRegions)
     {
-        return false;
+        if (IsStagingRegionReleased(region))
+        {
+            DestroyBuffer(region.DedicatedBuffer, region.DedicatedBufferMemory);
+        }
     }
-
-    return true;
+    gDedicatedStagingRegions.erase(std::remove_if(gDedicatedStagingRegions.begin(), gDedicatedStagingRegions.end(), IsStagingRegionReleased),
+        gDedicatedStagingRegions.end());
 }
 
-static void DestroyImage(VkImage image, VkDeviceMemory imageMemory)
+// Releases staging memory read by uploads submitted outside of frames. Called once the upload fence has signalled
+static void ReleaseUploadStagingMemory()
 {
-    vkDestroyImage(gDevice, image, nullptr);
-    vkFreeMemory(gDevice, imageMemory, nullptr);
-}
+    for (auto& region : gStagingRingRegions)
+    {
+        region.Released = region.Released || !region.FrameUpload;
+    }
 
-static bool CreateSampler(VkDevice device, VkFilter filter, VkSampler* pSampler)
-{
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = filter;
-    samplerInfo.minFilter = filter;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.anisotropyEnable = VK_TRUE;
-    samplerInfo.maxAnisotropy = gPhysicalDeviceProperties.limits.maxSamplerAnisotropy;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
-    samplerInfo.mipLodBias = 0.0f;
-    samplerInfo.minLod = 0.0f;
+    for (auto& region : gDedicatedStagingRegions)
+    {
+        region.Released = region.Released || !region.FrameUpload;
+    }
 
-    return vkCreateSampler(device, &samplerInfo, nullptr, pSampler) == VK_SUCCESS;
+    RecycleStagingMemory();
 }
 
-static void CopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+// Submits the uploads recorded by the open upload batch, waits for them to finish and recycles their staging memory. The batch stays open
+static bool FlushUploadBatch()
 {
-    // Copy the source buffer to the destination buffer
-    VkBufferCopy copyRegion{};
-    copyRegion.srcOffset = 0;
-    copyRegion.dstOffset = 0;
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-}
+    std::array<VkFence, 2> submittedFences{};
+    uint32_t submittedFenceCount{ 0 };
+    for (auto& batch : gUploadBatches)
+    {
+        if (batch.CommandBuffer == VK_NULL_HANDLE)
+        {
+            continue;
+        }
 
-static void TransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, const uint32_t mipLevels,
-    VkImageLayout oldLayout, VkImageLayout newLayout)
-{
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = mipLevels;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+        if (vkEndCommandBuffer(batch.CommandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
 
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.CommandBuffer;
 
-    // If transitioning to transfer destination, writes to the image must wait until after the transition
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+        if ((vkResetFences(gDevice, 1, &batch.Fence) != VK_SUCCESS) || (vkQueueSubmit(batch.Queue, 1, &submitInfo, batch.Fence) != VK_SUCCESS))
+        {
+            return false;
+        }
+        submittedFences[submittedFenceCount++] = batch.Fence;
+    }
+
+    if (submittedFenceCount == 0)
     {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        return true;
+    }
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    // Wait once for every queue's uploads
+    if (vkWaitForFences(gDevice, submittedFenceCount, submittedFences.data(), VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION) != VK_SUCCESS)
+    {
+        return false;
     }
-    // Else if transitioning to shader read only, shader read operations must wait until after the transition
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+
+    for (auto& batch : gUploadBatches)
     {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        if (batch.CommandBuffer != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(gDevice, batch.CommandPool, 1, &batch.CommandBuffer);
+            batch.CommandBuffer = VK_NULL_HANDLE;
+        }
+    }
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    ReleaseUploadStagingMemory();
+
+    return true;
+}
+
+// Waits for the frame reading the oldest staging ring region to finish. Uploads in the open upload batch are flushed when they hold the
+// oldest region. Fails when the region is read by a command buffer that cannot be submitted
+static bool WaitForOldestStagingRegion()
+{
+    const auto& region = gStagingRingRegions.front();
+    if (!region.FrameUpload)
+    {
+        return gUploadBatchOpen && FlushUploadBatch();
     }
-    else
+
+    if (region.Frame >= gFrameNumber)
     {
-        assert(false && "Unsupported image layout transition.");
+        return false;
+    }
+
+    // The frame's in flight fence signals when the frame, or a later frame using the same fence, finishes
+    if (vkWaitForFences(gDevice, 1, &gInFlightFences[region.Frame % gSwapchainImageCount], VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION) != VK_SUCCESS)
+    {
+        return false;
+    }
+    gFinishedFrameCount = std::max(gFinishedFrameCount, region.Frame + 1);
+
+    RecycleStagingMemory();
+
+    return true;
+}
+
+// Sub-allocates staging memory from the staging ring. When the ring is full, waits for earlier frames reading the ring to finish. Uploads
+// that still do not fit are given a dedicated buffer
+static bool AllocateStagingMemory(const VkDeviceSize size, const bool frameUpload, StagingAllocation& allocation)
+{
+    assert(size > 0 && "Staging memory must not be empty.");
+
+    RecycleStagingMemory();
+
+    StagingRegion region{};
+    region.FrameUpload = frameUpload;
+    region.Frame = gFrameNumber;
+
+    while (size <= STAGING_RING_SIZE)
+    {
+        if (gStagingRingRegions.empty())
+        {
+            gStagingRingHead = 0;
+        }
+
+        // Find free memory after the head, wrapping to the start of the ring when the allocation does not fit before the end of the ring
+        auto offset = AlignStagingOffset(gStagingRingHead);
+        auto wrapped = false;
+        auto fits = gStagingRingRegions.empty();
+        if (!fits)
+        {
+            const auto tail = gStagingRingRegions.front().Begin;
+
+            // Used memory wraps around the end of the ring when the newest region ends before the oldest region begins
+            if (gStagingRingRegions.back().End <= tail)
+            {
+                fits = (offset + size) <= tail;
+            }
+            else if ((offset + size) <= STAGING_RING_SIZE)
+            {
+                fits = true;
+            }
+            else
+            {
+                wrapped = true;
+                fits = size <= tail;
+            }
+        }
+
+        if (fits)
+        {
+            // The end of the ring skipped by a wrapped allocation is released with the allocation
+            if (wrapped)
+            {
+                auto padding = region;
+                padding.Begin = gStagingRingHead;
+                padding.End = STAGING_RING_SIZE;
+                gStagingRingRegions.push_back(padding);
+                offset = 0;
+            }
+
+            region.Begin = offset;
+            region.End = offset + size;
+            gStagingRingRegions.push_back(region);
+            gStagingRingHead = region.End;
+
+            allocation.Buffer = gStagingRingBuffer;
+            allocation.Offset = offset;
+            allocation.pData = gMappedStagingRingBuffer + offset;
+            return true;
+        }
+
+        // Apply back pressure until the oldest region is released
+        if (!WaitForOldestStagingRegion())
+        {
+            break;
+        }
+    }
+
+    // Create a dedicated staging buffer. It stays mapped until it is destroyed
+    if (!CreateBuffer(
+        gDevice,
+        gPhysicalDevice,
+        size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
+        nullptr,
+        &region.DedicatedBuffer,
+        &region.DedicatedBufferMemory))
+    {
+        return false;
+    }
+
+    void* pData;
+    if (vkMapMemory(gDevice, region.DedicatedBufferMemory, 0, size, 0, &pData) != VK_SUCCESS)
+    {
+        return false;
+    }
+    gDedicatedStagingRegions.push_back(region);
+
+    allocation.Buffer = region.DedicatedBuffer;
+    allocation.Offset = 0;
+    allocation.pData = static_cast<uint8_t*>(pData);
+    return true;
+}
+
+// Submits a single submit command buffer of uploads and waits for the upload fence before recycling the uploads' staging memory
+static bool SubmitUploadCommandBuffer(VkCommandPool commandPool, VkQueue queue, VkCommandBuffer commandBuffer)
+{
+    if (!EndAndSubmitSingleSubmitCommandBuffer(gDevice, commandPool, queue, gUploadFence, commandBuffer))
+    {
+        return false;
+    }
+
+    ReleaseUploadStagingMemory();
+
+    return true;
+}
+
+// Begins recording uploads for a queue. Uploads are recorded into the upload batch's command buffer while a batch is open and into a
+// single submit command buffer otherwise
+static bool BeginUploadCommandBuffer(const size_t batchIndex, VkCommandBuffer* pCommandBuffer)
+{
+    auto& batch = gUploadBatches[batchIndex];
+    if (!gUploadBatchOpen)
+    {
+        return BeginSingleSubmitCommandBuffer(gDevice, batch.CommandPool, pCommandBuffer);
+    }
+
+    if ((batch.CommandBuffer == VK_NULL_HANDLE) && !BeginSingleSubmitCommandBuffer(gDevice, batch.CommandPool, &batch.CommandBuffer))
+    {
+        return false;
+    }
+
+    *pCommandBuffer = batch.CommandBuffer;
+    return true;
+}
+
+// Submits uploads recorded outside of an upload batch and waits for them to finish. Batched uploads are submitted when the batch ends
+static bool EndUploadCommandBuffer(const size_t batchIndex, VkCommandBuffer commandBuffer)
+{
+    if (gUploadBatchOpen)
+    {
+        return true;
+    }
+
+    const auto& batch = gUploadBatches[batchIndex];
+    return SubmitUploadCommandBuffer(batch.CommandPool, batch.Queue, commandBuffer);
+}
+
+static bool CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkImage* pImage, VkDeviceMemory* pImageMemory)
+{
+    // Describe image create info
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.queueFamilyIndexCount = 0;
+    imageInfo.pQueueFamilyIndices = nullptr;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.flags = 0;
+
+    // Create the image
+    if (vkCreateImage(gDevice, &imageInfo, nullptr, pImage) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Get image memory requirements
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(gDevice, *pImage, &memRequirements);
+
+    // Describe memory allocation info
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, gPhysicalDevice);
+
+    // Allocate image memory for the texture
+    if (vkAllocateMemory(gDevice, &allocInfo, nullptr, pImageMemory) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Bind image memory to the texture image
+    if (vkBindImageMemory(gDevice, *pImage, *pImageMemory, 0) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static void DestroyImage(VkImage image, VkDeviceMemory imageMemory)
+{
+    vkDestroyImage(gDevice, image, nullptr);
+    vkFreeMemory(gDevice, imageMemory, nullptr);
+}
+
+static void DeferBufferDestruction(VkBuffer buffer, VkDeviceMemory bufferMemory)
+{
+    auto& destruction = gDeferredDestructions.emplace_back();
+    destruction.Buffer = buffer;
+    destruction.Memory = bufferMemory;
+    destruction.Frame = gFrameNumber;
+}
+
+static void DeferImageDestruction(VkImage image, VkDeviceMemory imageMemory, VkImageView imageView)
+{
+    auto& destruction = gDeferredDestructions.emplace_back();
+    destruction.Image = image;
+    destruction.ImageView = imageView;
+    destruction.Memory = imageMemory;
+    destruction.Frame = gFrameNumber;
+}
+
+static void DestroyDeferredResource(const DeferredDestruction& destruction)
+{
+    // Null handles are ignored
+    vkDestroyImageView(gDevice, destruction.ImageView, nullptr);
+    vkDestroyImage(gDevice, destruction.Image, nullptr);
+    vkDestroyBuffer(gDevice, destruction.Buffer, nullptr);
+    vkFreeMemory(gDevice, destruction.Memory, nullptr);
+}
+
+// Destroys deferred resources whose frames have finished executing on the device
+static void ReleaseDeferredDestructions()
+{
+    while (!gDeferredDestructions.empty() && (gDeferredDestructions.front().Frame < gFinishedFrameCount))
+    {
+        DestroyDeferredResource(gDeferredDestructions.front());
+        gDeferredDestructions.pop_front();
+    }
+}
+
+// Destroys every deferred resource regardless of its frame. The device must be idle
+static void FlushDeferredDestructions()
+{
+    for (const auto& destruction : gDeferredDestructions)
+    {
+        DestroyDeferredResource(destruction);
+    }
+    gDeferredDestructions.clear();
+}
+
+static bool CreateSampler(VkDevice device, VkFilter filter, VkSampler* pSampler)
+{
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = filter;
+    samplerInfo.minFilter = filter;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.anisotropyEnable = VK_TRUE;
+    samplerInfo.maxAnisotropy = gPhysicalDeviceProperties.limits.maxSamplerAnisotropy;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    samplerInfo.mipLodBias = 0.0f;
+    samplerInfo.minLod = 0.0f;
+
+    return vkCreateSampler(device, &samplerInfo, nullptr, pSampler) == VK_SUCCESS;
+}
+
+static void CopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkBuffer dstBuffer, VkDeviceSize size)
+{
+    // Copy the source buffer to the destination buffer
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = 0;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+}
+
+static void TransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, const uint32_t mipLevels,
+    VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = mipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkPipelineStageFlags sourceStage;
+    VkPipelineStageFlags destinationStage;
+
+    // If transitioning to transfer destination, writes to the image must wait until after the transition
+    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+    {
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+    // Else if transitioning to shader read only, shader read operations must wait until after the transition
+    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+    {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    }
+    else
+    {
+        assert(false && "Unsupported image layout transition.");
     }
 
     vkCmdPipelineBarrier(
@@ -1420,113 +1848,1225 @@ static void TransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image,
     );
 }
 
-static void CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
-{
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { width, height, 1 };
+// Copies mips packed one after another in the buffer into the image's mip levels
+static void CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize bufferOffset, VkImage image, const Renderer::TextureMip* mips,
+    const uint32_t mipCount)
+{
+    std::vector<VkBufferImageCopy> regions(mipCount);
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        auto& region = regions[i];
+        region.bufferOffset = bufferOffset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { mips[i].Width, mips[i].Height, 1 };
+
+        bufferOffset += mips[i].Pixels.size();
+    }
+
+    vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipCount, regions.data());
+}
+
+// Returns the center and radius of a sphere bounding the vertices. The sphere is centered on the vertices' bounding box
+static glm::vec4 CalculateBoundingSphere(const Renderer::Vertex1Pos1UV1Norm* vertices, const uint32_t vertexCount)
+{
+    if (vertexCount == 0)
+    {
+        return { 0.0f, 0.0f, 0.0f, 0.0f };
+    }
+
+    glm::vec3 min{ vertices[0].Pos };
+    glm::vec3 max{ vertices[0].Pos };
+    for (uint32_t i = 1; i < vertexCount; ++i)
+    {
+        min = glm::min(min, vertices[i].Pos);
+        max = glm::max(max, vertices[i].Pos);
+    }
+
+    const auto center = (min + max) * 0.5f;
+    float radiusSquared{ 0.0f };
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        const auto offset = vertices[i].Pos - center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+
+    return glm::vec4(center, std::sqrt(radiusSquared));
+}
+
+// Returns the largest span of the vertices' texture coordinates along either axis
+static float CalculateTextureCoordExtent(const Renderer::Vertex1Pos1UV1Norm* vertices, const uint32_t vertexCount)
+{
+    if (vertexCount == 0)
+    {
+        return 0.0f;
+    }
+
+    glm::vec2 min{ vertices[0].UV };
+    glm::vec2 max{ vertices[0].UV };
+    for (uint32_t i = 1; i < vertexCount; ++i)
+    {
+        min = glm::min(min, vertices[i].UV);
+        max = glm::max(max, vertices[i].UV);
+    }
+
+    const auto extent = max - min;
+    return std::max(extent.x, extent.y);
+}
+
+// Uploads vertex and index data into GPU only buffers for the geometry
+static bool CreateGeometryBuffers(Geometry& geometry, const void* vertices, const VkDeviceSize vertexBufferSize, const uint32_t* indices,
+    const uint32_t indexCount)
+{
+    // Get the queue family indices that will share access to buffer resources
+    const uint32_t sharedAccessQueueFamilyIndices[] = { gQueueFamilyIndices.GetGraphicsFamilyIndex(), gQueueFamilyIndices.GetTransferFamilyIndex() };
+
+    // Calculate index buffer size
+    const auto indexBufferSize = sizeof(uint32_t) * indexCount;
+
+    // Copy the vertices and indices into staging memory. The indices follow the vertices
+    const auto indexStagingOffset = AlignStagingOffset(vertexBufferSize);
+    StagingAllocation staging{};
+    if (!AllocateStagingMemory(indexStagingOffset + indexBufferSize, false, staging))
+    {
+        return false;
+    }
+
+    memcpy(staging.pData, vertices, static_cast<size_t>(vertexBufferSize));
+    memcpy(staging.pData + indexStagingOffset, indices, indexBufferSize);
+
+    // Create GPU only vertex buffer
+    if (!CreateBuffer(
+        gDevice,
+        gPhysicalDevice,
+        vertexBufferSize,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        VK_SHARING_MODE_CONCURRENT,
+        _countof(sharedAccessQueueFamilyIndices),
+        sharedAccessQueueFamilyIndices,
+        &geometry.GetVertexBuffer(),
+        &geometry.GetVertexBufferMemory()))
+    {
+        return false;
+    }
+
+    // Create GPU only index buffer
+    if (!CreateBuffer(
+        gDevice,
+        gPhysicalDevice,
+        indexBufferSize,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        VK_SHARING_MODE_CONCURRENT,
+        _countof(sharedAccessQueueFamilyIndices),
+        sharedAccessQueueFamilyIndices,
+        &geometry.GetIndexBuffer(),
+        &geometry.GetIndexBufferMemory()))
+    {
+        return false;
+    }
+
+    // Set index count
+    geometry.SetIndexCount(indexCount);
+
+    // Begin recording transfer queue uploads
+    VkCommandBuffer commandBuffer;
+    if (!BeginUploadCommandBuffer(TRANSFER_UPLOAD_BATCH, &commandBuffer))
+    {
+        return false;
+    }
+
+    // Copy the staged vertices and indices to the vertex and index buffers
+    CopyBuffer(commandBuffer, staging.Buffer, staging.Offset, geometry.GetVertexBuffer(), vertexBufferSize);
+    CopyBuffer(commandBuffer, staging.Buffer, staging.Offset + indexStagingOffset, geometry.GetIndexBuffer(), indexBufferSize);
+
+    // Submit the copies. Their staging memory is recycled once they finish
+    return EndUploadCommandBuffer(TRANSFER_UPLOAD_BATCH, commandBuffer);
+}
+
+// Creates a texture's image and image view from mips of its mip chain and uploads the mips from staging memory. Frame uploads are
+// recorded into the current frame's command buffer and other uploads are recorded for the graphics queue
+static bool CreateTextureImage(Texture& texture, const Renderer::TextureMip* mips, const uint32_t mipCount, const bool frameUpload)
+{
+    // Calculate the size of the mips
+    VkDeviceSize stagingSize{ 0 };
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        stagingSize += mips[i].Pixels.size();
+    }
+
+    // Copy the mips into staging memory one after another
+    StagingAllocation staging{};
+    if (!AllocateStagingMemory(stagingSize, frameUpload, staging))
+    {
+        return false;
+    }
+
+    auto* pMipData = staging.pData;
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        memcpy(pMipData, mips[i].Pixels.data(), mips[i].Pixels.size());
+        pMipData += mips[i].Pixels.size();
+    }
+
+    // Create image and memory for the texture
+    if (!CreateImage(mips[0].Width, mips[0].Height, mipCount, &texture.GetImage(), &texture.GetImageMemory()))
+    {
+        return false;
+    }
+
+    // Staging memory is allocated before the upload command buffer is begun as allocating can flush the upload batch
+    auto commandBuffer = gCurrentFrameCommandBuffer;
+    if (!frameUpload && !BeginUploadCommandBuffer(GRAPHICS_UPLOAD_BATCH, &commandBuffer))
+    {
+        return false;
+    }
+
+    // Copy the mips into the image and transition it to shader read only
+    TransitionImageLayout(commandBuffer, texture.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, mipCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    CopyBufferToImage(commandBuffer, staging.Buffer, staging.Offset, texture.GetImage(), mips, mipCount);
+    TransitionImageLayout(commandBuffer, texture.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, mipCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Create texture image view
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = texture.GetImage();
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = mipCount;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+    viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+    if (vkCreateImageView(gDevice, &viewInfo, nullptr, &texture.GetImageView()) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Submit the upload. Its staging memory is recycled once it finishes
+    return frameUpload || EndUploadCommandBuffer(GRAPHICS_UPLOAD_BATCH, commandBuffer);
+}
+
+// Creates a texture from RGBA8 sRGB pixels
+static bool CreateTexture(const uint8_t* pixels, const int32_t textureWidth, const int32_t textureHeight, const bool generateMipmaps, uint32_t* pID)
+{
+    // The null backend only tracks the texture's ID
+    if (gBackend == Renderer::EBackend::NULL_BACKEND)
+    {
+        assert(!gAvailableTextureIDs.empty() && "Max loaded texture count reached.");
+        *pID = gAvailableTextureIDs.front();
+        gAvailableTextureIDs.pop();
+        gUsedTextureIDs.push_back(*pID);
+        return true;
+    }
+
+    // The software backend samples a host copy of the texture's base level
+    if (gBackend == Renderer::EBackend::SOFTWARE)
+    {
+        assert(!gAvailableTextureIDs.empty() && "Max loaded texture count reached.");
+        *pID = gAvailableTextureIDs.front();
+        gAvailableTextureIDs.pop();
+        gUsedTextureIDs.push_back(*pID);
+
+        auto& softwareTexture = gLoadedTextures[*pID].GetSoftwareTexture();
+        softwareTexture.Width = static_cast<uint32_t>(textureWidth);
+        softwareTexture.Height = static_cast<uint32_t>(textureHeight);
+        softwareTexture.Texels.resize(static_cast<size_t>(textureWidth) * static_cast<size_t>(textureHeight));
+        memcpy(softwareTexture.Texels.data(), pixels, softwareTexture.Texels.size() * sizeof(uint32_t));
+        return true;
+    }
+
+    // Assert max loaded texture count has not been reached
+    assert(!gAvailableTextureIDs.empty() && "Max loaded texture count reached.");
+
+    // Get an available texture instance
+    *pID = gAvailableTextureIDs.front();
+    gAvailableTextureIDs.pop();
+    auto& texture = gLoadedTextures[*pID];
+    gUsedTextureIDs.push_back(*pID);
+
+    // Mipmapped textures are streamed. A host copy of the mip chain is kept and only its smallest mips are uploaded until more detail is
+    // needed on screen
+    Renderer::TextureMip baseMip{};
+    const Renderer::TextureMip* pUploadedMips{ &baseMip };
+    uint32_t uploadedMipCount{ 1 };
+    if (generateMipmaps)
+    {
+        auto& mips = texture.GetMips();
+        mips = Renderer::GenerateMipChain(pixels, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+
+        const auto residentMip = gTextureStreamer.Register(*pID, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight),
+            static_cast<uint32_t>(mips.size()));
+        texture.SetResidentMip(residentMip);
+        pUploadedMips = mips.data() + residentMip;
+        uploadedMipCount = static_cast<uint32_t>(mips.size()) - residentMip;
+    }
+    else
+    {
+        baseMip.Width = static_cast<uint32_t>(textureWidth);
+        baseMip.Height = static_cast<uint32_t>(textureHeight);
+        baseMip.Pixels.assign(pixels, pixels + (static_cast<size_t>(textureWidth) * static_cast<size_t>(textureHeight) * 4));
+    }
+
+    return CreateTextureImage(texture, pUploadedMips, uploadedMipCount, false);
+}
+
+// Writes a draw item's per object uniforms into mapped uniform buffer memory
+static void WritePerObjectUniforms(const Renderer::DrawItem& drawItem, void* pDestination, const uint32_t lightmapTextureID = 0)
+{
+    assert(drawItem.GetMaterialID() < gMaterials.size() && "Draw item material ID is invalid.");
+
+    PerObjectUniforms perObjectUniforms{};
+    perObjectUniforms.WorldMatrix = drawItem.GetWorldMatrix();
+
+    glm::mat3 worldMatrix3x3 = drawItem.GetWorldMatrix();
+    perObjectUniforms.NormalMatrix = glm::inverse(glm::transpose(worldMatrix3x3));
+
+    perObjectUniforms.MaterialID = drawItem.GetMaterialID();
+    perObjectUniforms.LightmapTextureID = lightmapTextureID;
+    perObjectUniforms.FlipbookPhase = drawItem.GetFlipbookPhase();
+
+    memcpy(pDestination, &perObjectUniforms, sizeof(perObjectUniforms));
+}
+
+static bool IsSRGBFormat(const VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// Reads a shader program's shader binaries and creates its shader modules
+static bool CreateShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath, ShaderProgram& program)
+{
+    // Read in shader binary
+    BinaryBuffer vertexShaderBinary{};
+    if (!Binary::ReadBinaryIntoBuffer(vertexShaderPath, vertexShaderBinary))
+    {
+        LOG("Failed to read vertex shader binary " + vertexShaderPath + ".");
+        return false;
+    }
+
+    BinaryBuffer fragmentShaderBinary{};
+    if (!Binary::ReadBinaryIntoBuffer(fragmentShaderPath, fragmentShaderBinary))
+    {
+        LOG("Failed to read fragment shader binary " + fragmentShaderPath + ".");
+        return false;
+    }
+
+    // Create shader modules
+    return CreateShaderModule(gDevice, vertexShaderBinary, &program.VertexShaderModule) &&
+        CreateShaderModule(gDevice, fragmentShaderBinary, &program.FragmentShaderModule);
+}
+
+// Creates a pipeline permutation. The shader program decides the shaders, vertex layout and render pass. Blend mode and depth writes
+// set fixed function state and the lighting model and gamma handling are specialization constants of the fragment shader
+static bool CreatePipeline(const Renderer::PipelineState& state, VkPipeline* pPipeline)
+{
+    const auto& program = gShaderPrograms[static_cast<size_t>(state.Pipeline)];
+
+    // Describe specialization constants. Gamma is only applied by shaders when the swapchain format does not apply it
+    struct SpecializationData
+    {
+        uint32_t LightingModel{ 0 };
+        VkBool32 GammaCorrect{ VK_TRUE };
+    };
+
+    SpecializationData specializationData{};
+    specializationData.LightingModel = static_cast<uint32_t>(state.LightingModel);
+    specializationData.GammaCorrect = IsSRGBFormat(gSurfaceFormat.format) ? VK_FALSE : VK_TRUE;
+
+    const std::array<VkSpecializationMapEntry, 2> specializationEntries{ {
+        { LIGHTING_MODEL_CONSTANT_ID, offsetof(SpecializationData, LightingModel), sizeof(uint32_t) },
+        { GAMMA_CORRECT_CONSTANT_ID, offsetof(SpecializationData, GammaCorrect), sizeof(VkBool32) }
+    } };
+
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+    specializationInfo.pMapEntries = specializationEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = &specializationData;
+
+    // Describe shader stages
+    VkPipelineShaderStageCreateInfo vertexShaderStageInfo{};
+    vertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertexShaderStageInfo.module = program.VertexShaderModule;
+    vertexShaderStageInfo.pName = "main";
+
+    VkPipelineShaderStageCreateInfo fragmentShaderStageInfo{};
+    fragmentShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragmentShaderStageInfo.module = program.FragmentShaderModule;
+    fragmentShaderStageInfo.pName = "main";
+    fragmentShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+    const VkPipelineShaderStageCreateInfo shaderStages[] = { vertexShaderStageInfo, fragmentShaderStageInfo };
+
+    // Describe the shader program's input binding and attributes
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+    VkRenderPass renderPass{ VK_NULL_HANDLE };
+
+    switch (state.Pipeline)
+    {
+    case Renderer::EPipeline::MESH:
+        bindingDescription.stride = sizeof(Renderer::Vertex1Pos1UV1Norm);
+        attributeDescriptions = {
+            { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Renderer::Vertex1Pos1UV1Norm, Pos) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Renderer::Vertex1Pos1UV1Norm, UV) },
+            { 2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Renderer::Vertex1Pos1UV1Norm, Norm) }
+        };
+        renderPass = gRenderGraph.GetRenderPass(gScenePass);
+        break;
+
+    case Renderer::EPipeline::SPRITE:
+        bindingDescription.stride = sizeof(SpriteVertex);
+        attributeDescriptions = {
+            { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(SpriteVertex, Pos) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteVertex, UV) },
+            { 2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(SpriteVertex, Color) },
+            { 3, 0, VK_FORMAT_R32_UINT, offsetof(SpriteVertex, SamplerID) },
+            { 4, 0, VK_FORMAT_R32_UINT, offsetof(SpriteVertex, TextureID) }
+        };
+        renderPass = gRenderGraph.GetRenderPass(gHUDPass);
+        break;
+
+    case Renderer::EPipeline::LIGHTMAPPED:
+        bindingDescription.stride = sizeof(Renderer::Vertex1Pos2UV1Norm);
+        attributeDescriptions = {
+            { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Renderer::Vertex1Pos2UV1Norm, Pos) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Renderer::Vertex1Pos2UV1Norm, UV) },
+            { 2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Renderer::Vertex1Pos2UV1Norm, Norm) },
+            { 3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Renderer::Vertex1Pos2UV1Norm, LightmapUV) }
+        };
+        renderPass = gRenderGraph.GetRenderPass(gStaticScenePass);
+        break;
+    }
+
+    // Describe vertex input
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    // Describe input assembly
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Describe viewport state
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.pViewports = &gViewport;
+    viewportState.scissorCount = 1;
+    viewportState.pScissors = &gScissor;
+
+    // The viewport and scissor are set by command lists so split screen views share pipelines
+    const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = _countof(dynamicStates);
+    dynamicState.pDynamicStates = dynamicStates;
+
+    // Describe rasterization state. Sprites are not culled
+    const bool sprite = state.Pipeline == Renderer::EPipeline::SPRITE;
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.cullMode = sprite ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
+    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+    rasterizer.lineWidth = 1.0f;
+
+    // Describe multisampling state
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    // Describe depth stencil state. Sprites are sorted on the CPU so depth is neither tested nor written. Fragment shaders do not
+    // write depth or discard so fragments are depth tested before shading
+    VkPipelineDepthStencilStateCreateInfo depthStencilState{};
+    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencilState.depthTestEnable = sprite ? VK_FALSE : VK_TRUE;
+    depthStencilState.depthWriteEnable = (!sprite && state.DepthWrite) ? VK_TRUE : VK_FALSE;
+    depthStencilState.depthCompareOp = sprite ? VK_COMPARE_OP_ALWAYS : VK_COMPARE_OP_LESS;
+    depthStencilState.depthBoundsTestEnable = VK_FALSE;
+    depthStencilState.minDepthBounds = 0.0f;
+    depthStencilState.maxDepthBounds = 1.0f;
+    depthStencilState.stencilTestEnable = VK_FALSE;
+
+    // Describe color blending state
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+        VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = (state.BlendMode == Renderer::EBlendMode::ALPHA) ? VK_TRUE : VK_FALSE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    // Describe graphics pipeline. Every permutation shares the graphics pipeline layout
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = _countof(shaderStages);
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencilState;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = gGraphicsPipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+
+    return vkCreateGraphicsPipelines(gDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, pPipeline) == VK_SUCCESS;
+}
+
+// Returns the pipeline permutation for the packed pipeline state, creating it the first time it is bound
+static VkPipeline GetPipeline(const uint32_t packedState)
+{
+    const auto cachedPipeline = gPipelineCache.find(packedState);
+    if (cachedPipeline != gPipelineCache.end())
+    {
+        return cachedPipeline->second;
+    }
+
+    VkPipeline pipeline{ VK_NULL_HANDLE };
+    if (!CreatePipeline(Renderer::PipelineState::Unpack(packedState), &pipeline))
+    {
+        LOG("Failed to create pipeline permutation.");
+    }
+
+    gPipelineCache.emplace(packedState, pipeline);
+    return pipeline;
+}
+
+// Returns the pipeline state a material's meshes are drawn with. Alpha blended meshes are drawn after opaque meshes and do not write depth
+static Renderer::PipelineState GetMaterialPipelineState(const Renderer::EPipeline pipeline, const Renderer::Material& material)
+{
+    Renderer::PipelineState state{};
+    state.Pipeline = pipeline;
+    state.BlendMode = material.AlphaBlended ? Renderer::EBlendMode::ALPHA : Renderer::EBlendMode::NONE;
+    state.DepthWrite = !material.AlphaBlended;
+    state.LightingModel = material.LightingModel;
+    return state;
+}
+
+// Returns the pipeline state sprites are drawn with. Sprites are unlit
+static Renderer::PipelineState GetSpritePipelineState()
+{
+    Renderer::PipelineState state{};
+    state.Pipeline = Renderer::EPipeline::SPRITE;
+    state.BlendMode = Renderer::EBlendMode::ALPHA;
+    state.DepthWrite = false;
+    state.LightingModel = Renderer::ELightingModel::UNLIT;
+    return state;
+}
+
+// Returns the slot of a view among the views of every layout. The views of a layout occupy contiguous slots
+static uint32_t GetViewLayoutSlot(const uint32_t viewIndex, const uint32_t viewCount)
+{
+    assert(viewCount > 0 && viewCount <= Renderer::MAX_VIEW_COUNT && viewIndex < viewCount && "View is outside the supported layouts.");
+
+    return (((viewCount - 1) * viewCount) / 2) + viewIndex;
+}
+
+// Returns the region of the surface a view is rendered to. Two views split the surface into top and bottom halves and three or
+// four views split it into quarters
+static VkRect2D CalculateViewViewport(const uint32_t viewIndex, const uint32_t viewCount)
+{
+    VkRect2D viewport{};
+    viewport.extent = { gSurfaceWidth, gSurfaceHeight };
+
+    if (viewCount == 2)
+    {
+        viewport.extent.height = gSurfaceHeight / 2;
+        viewport.offset.y = static_cast<int32_t>(viewIndex * viewport.extent.height);
+    }
+    else if (viewCount > 2)
+    {
+        viewport.extent = { gSurfaceWidth / 2, gSurfaceHeight / 2 };
+        viewport.offset.x = static_cast<int32_t>((viewIndex % 2) * viewport.extent.width);
+        viewport.offset.y = static_cast<int32_t>((viewIndex / 2) * viewport.extent.height);
+    }
+
+    return viewport;
+}
+
+// Translates a command list into Vulkan commands recorded into the command buffer. Draw data is bound through the descriptor set
+static void RecordCommandList(VkCommandBuffer commandBuffer, const Renderer::CommandList& commandList, VkDescriptorSet descriptorSet, const size_t frameIndex)
+{
+    std::array<uint32_t, DYNAMIC_OFFSET_COUNT> dynamicOffsets{};
+
+    // Command lists begin with a viewport covering the whole surface
+    vkCmdSetViewport(commandBuffer, 0, 1, &gViewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &gScissor);
+
+    for (const auto& command : commandList.GetCommands())
+    {
+        switch (command.Type)
+        {
+        case Renderer::ECommandType::BIND_PIPELINE:
+        {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, GetPipeline(command.Arg0));
+            break;
+        }
+
+        case Renderer::ECommandType::BIND_BUFFERS:
+        {
+            // Get the vertex and index buffers from the buffer source
+            VkBuffer vertexBuffer{ gSpriteVertexBuffers[frameIndex] };
+            VkBuffer indexBuffer{ gSpriteIndexBuffer };
+            if (static_cast<Renderer::EBufferSource>(command.Arg0) == Renderer::EBufferSource::GEOMETRY)
+            {
+                const auto& geometry = gLoadedGeometry[command.Arg1];
+                vertexBuffer = geometry.GetVertexBuffer();
+                indexBuffer = geometry.GetIndexBuffer();
+            }
+
+            // Bind vertex buffers
+            const VkBuffer vertexBuffers[] = { vertexBuffer };
+            const VkDeviceSize offsets[] = { 0 };
+            vkCmdBindVertexBuffers(commandBuffer, 0, _countof(vertexBuffers), vertexBuffers, offsets);
+
+            // Bind index buffer
+            vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            break;
+        }
+
+        case Renderer::ECommandType::SET_DRAW_DATA:
+        {
+            dynamicOffsets[PER_OBJECT_UNIFORMS_DYNAMIC_OFFSET_INDEX] = command.Arg0;
+            dynamicOffsets[PER_RENDER_PASS_UNIFORMS_DYNAMIC_OFFSET_INDEX] = command.Arg1;
+
+            // Bind descriptor set with the draw's dynamic offsets
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, gGraphicsPipelineLayout,
+                0, 1, &descriptorSet,
+                static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+            break;
+        }
+
+        case Renderer::ECommandType::DRAW_INDEXED:
+        {
+            vkCmdDrawIndexed(commandBuffer, command.Arg0, 1, command.Arg1, 0, 0);
+            break;
+        }
+
+        case Renderer::ECommandType::SET_VIEWPORT:
+        {
+            VkRect2D scissor{};
+            scissor.offset = { static_cast<int32_t>(command.Arg0 & 0xFFFF), static_cast<int32_t>(command.Arg0 >> 16) };
+            scissor.extent = { command.Arg1 & 0xFFFF, command.Arg1 >> 16 };
+
+            VkViewport viewport{};
+            viewport.x = static_cast<float>(scissor.offset.x);
+            viewport.y = static_cast<float>(scissor.offset.y);
+            viewport.width = static_cast<float>(scissor.extent.width);
+            viewport.height = static_cast<float>(scissor.extent.height);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+
+            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+            break;
+        }
+        }
+    }
+}
+
+// Maps texture coordinates into the material's current flipbook frame as the vertex shaders do
+static glm::vec2 CalculateFlipbookTextureCoord(const glm::vec2& textureCoord, const Renderer::Material& material, const float phase,
+    const float time)
+{
+    if (material.FlipbookFrameCount <= 1)
+    {
+        return textureCoord;
+    }
+
+    // Texture coordinates are flipped in v when sampled so rows are addressed from the bottom of the sprite sheet
+    const auto frameCount = static_cast<float>(material.FlipbookFrameCount);
+    const auto frame = static_cast<uint32_t>(std::max(std::floor((time * material.FlipbookFrameRate) + (phase * frameCount)), 0.0f)) %
+        material.FlipbookFrameCount;
+    const auto columnCount = std::max(material.FlipbookColumnCount, 1u);
+    const auto rowCount = (material.FlipbookFrameCount + columnCount - 1) / columnCount;
+    const glm::vec2 cell{ frame % columnCount, rowCount - 1 - (frame / columnCount) };
+
+    return (textureCoord + cell) / glm::vec2(columnCount, rowCount);
+}
+
+// Returns the host copy of a texture sampled by the software backend. Returns nullptr if the texture has no texels
+static const Renderer::SoftwareTexture* GetSoftwareTexture(const uint32_t id)
+{
+    if (id >= MAX_LOADED_TEXTURE_COUNT || gLoadedTextures[id].GetSoftwareTexture().Texels.empty())
+    {
+        return nullptr;
+    }
+
+    return &gLoadedTextures[id].GetSoftwareTexture();
+}
+
+// Lights a vertex for the software backend. Lighting is evaluated per vertex and interpolated across triangles. Ambient and
+// directional light of lightmapped vertices is read from the lightmap by the rasterizer
+static glm::vec3 CalculateSoftwareVertexLighting(const glm::vec3& worldSpacePosition, const glm::vec3& worldSpaceNormal,
+    const glm::vec3& cameraWorldSpacePosition, const Renderer::ELightingModel lightingModel, const bool lightmapped)
+{
+    if (lightingModel == Renderer::ELightingModel::UNLIT)
+    {
+        return glm::vec3(1.0f, 1.0f, 1.0f);
+    }
+
+    const auto& perFrameUniforms = *static_cast<const PerFrameUniforms*>(gMappedPerFrameUniformBuffers[gCurrentFrame]);
+    const auto& lightGrid = *static_cast<const LightGrid*>(gMappedLightGridBuffers[gCurrentFrame]);
+    const auto specularEnabled = lightingModel == Renderer::ELightingModel::BLINN_PHONG;
+    const auto cameraVector = glm::normalize(cameraWorldSpacePosition - worldSpacePosition);
+
+    glm::vec3 lighting{ 0.0f, 0.0f, 0.0f };
+    if (!lightmapped)
+    {
+        const auto lightDirection = -glm::normalize(glm::vec3(perFrameUniforms.DirectionalLightWorldSpaceDirection));
+        lighting += SOFTWARE_AMBIENT_LIGHT;
+        lighting += glm::vec3(perFrameUniforms.DirectionalLightColor) * glm::clamp(glm::dot(worldSpaceNormal, lightDirection), 0.0f, 1.0f);
+        if (specularEnabled)
+        {
+            const auto halfAngle = glm::normalize(lightDirection + cameraVector);
+            lighting += glm::vec3(std::pow(glm::clamp(glm::dot(worldSpaceNormal, halfAngle), 0.0f, 1.0f), SOFTWARE_SPECULAR_GLOSS));
+        }
+    }
+
+    // Point lights are not binned into clusters as every light is evaluated once per vertex
+    for (uint32_t i = 0; i < lightGrid.LightCount.x; ++i)
+    {
+        const auto& light = lightGrid.Lights[i];
+        const auto toLight = glm::vec3(light.WorldSpacePositionRadius) - worldSpacePosition;
+        const auto lightDistance = glm::length(toLight);
+        if (lightDistance >= light.WorldSpacePositionRadius.w)
+        {
+            continue;
+        }
+
+        // Attenuate smoothly to zero at the light's radius
+        const auto lightDirection = toLight / std::max(lightDistance, 0.0001f);
+        const auto falloff = 1.0f - std::pow(lightDistance / light.WorldSpacePositionRadius.w, 2.0f);
+        const auto radiance = glm::vec3(light.ColorIntensity) * light.ColorIntensity.a * falloff * falloff;
+
+        lighting += radiance * glm::clamp(glm::dot(worldSpaceNormal, lightDirection), 0.0f, 1.0f);
+        if (specularEnabled)
+        {
+            const auto halfAngle = glm::normalize(lightDirection + cameraVector);
+            lighting += radiance * std::pow(glm::clamp(glm::dot(worldSpaceNormal, halfAngle), 0.0f, 1.0f), SOFTWARE_SPECULAR_GLOSS);
+        }
+    }
+
+    return lighting;
+}
+
+// Translates a command list into triangles drawn by the software rasterizer. Vertices are transformed and lit on the CPU with
+// the same uniforms the shaders read
+static void RasterizeCommandList(const Renderer::CommandList& commandList, const uint8_t* pPerObjectUniformBuffer)
+{
+    Renderer::PipelineState pipelineState{};
+    auto bufferSource{ Renderer::EBufferSource::GEOMETRY };
+    uint32_t geometryID{ 0 };
+    const PerObjectUniforms* pPerObjectUniforms{ nullptr };
+    const PerRenderPassUniforms* pPerRenderPassUniforms{ nullptr };
+
+    // Command lists begin with a viewport covering the whole surface
+    gSoftwareRasterizer.SetViewport(0, 0, gSoftwareRasterizer.GetWidth(), gSoftwareRasterizer.GetHeight());
+
+    for (const auto& command : commandList.GetCommands())
+    {
+        switch (command.Type)
+        {
+        case Renderer::ECommandType::BIND_PIPELINE:
+        {
+            pipelineState = Renderer::PipelineState::Unpack(command.Arg0);
+            break;
+        }
+
+        case Renderer::ECommandType::SET_VIEWPORT:
+        {
+            gSoftwareRasterizer.SetViewport(command.Arg0 & 0xFFFF, command.Arg0 >> 16, command.Arg1 & 0xFFFF, command.Arg1 >> 16);
+            break;
+        }
+
+        case Renderer::ECommandType::BIND_BUFFERS:
+        {
+            bufferSource = static_cast<Renderer::EBufferSource>(command.Arg0);
+            geometryID = command.Arg1;
+            break;
+        }
+
+        case Renderer::ECommandType::SET_DRAW_DATA:
+        {
+            pPerObjectUniforms = reinterpret_cast<const PerObjectUniforms*>(pPerObjectUniformBuffer + command.Arg0);
+            pPerRenderPassUniforms = reinterpret_cast<const PerRenderPassUniforms*>(
+                static_cast<const uint8_t*>(gMappedPerRenderPassUniformBuffers[gCurrentFrame]) + command.Arg1);
+            break;
+        }
+
+        case Renderer::ECommandType::DRAW_INDEXED:
+        {
+            assert(pPerRenderPassUniforms != nullptr && "Draw recorded before its draw data was set.");
+
+            const auto viewProjectionMatrix = pPerRenderPassUniforms->ProjectionMatrix * pPerRenderPassUniforms->ViewMatrix;
+            const auto cameraWorldSpacePosition = glm::vec3(pPerRenderPassUniforms->CameraWorldSpacePosition);
+
+            Renderer::SoftwareDrawState drawState{};
+            drawState.AlphaBlend = pipelineState.BlendMode == Renderer::EBlendMode::ALPHA;
+            drawState.DepthWrite = pipelineState.DepthWrite;
+
+            // Sprites are not culled or depth tested. Each sprite may sample a different texture so sprites are drawn one at a time
+            if (bufferSource == Renderer::EBufferSource::SPRITE_BATCH)
+            {
+                drawState.CullBackFaces = false;
+                drawState.DepthTest = false;
+                drawState.DepthWrite = false;
+
+                const auto* pSpriteVertices = static_cast<const SpriteVertex*>(gMappedSpriteVertexBuffers[gCurrentFrame]);
+                std::array<Renderer::SoftwareVertex, SPRITE_INDEX_COUNT> quad{};
+                for (uint32_t index = command.Arg1; index < command.Arg1 + command.Arg0; index += SPRITE_INDEX_COUNT)
+                {
+                    const auto* pQuadVertices = pSpriteVertices + ((index / SPRITE_INDEX_COUNT) * SPRITE_VERTEX_COUNT);
+                    for (uint32_t i = 0; i < SPRITE_INDEX_COUNT; ++i)
+                    {
+                        const auto& spriteVertex = pQuadVertices[SPRITE_QUAD_INDICES[i]];
+                        quad[i].ClipPosition = viewProjectionMatrix * glm::vec4(spriteVertex.Pos, 1.0f);
+                        quad[i].TextureCoord = spriteVertex.UV;
+                        quad[i].Color = spriteVertex.Color;
+                    }
+
+                    drawState.pTexture = GetSoftwareTexture(pQuadVertices[0].TextureID);
+                    gSoftwareRasterizer.DrawTriangles(quad.data(), SPRITE_INDEX_COUNT, drawState);
+                }
+                break;
+            }
+
+            assert(pPerObjectUniforms != nullptr && "Draw recorded before its draw data was set.");
+
+            const auto& geometry = gLoadedGeometry[geometryID];
+            const auto& material = gMaterials[pPerObjectUniforms->MaterialID];
+            const auto clipMatrix = viewProjectionMatrix * pPerObjectUniforms->WorldMatrix;
+            const auto time = static_cast<const PerFrameUniforms*>(gMappedPerFrameUniformBuffers[gCurrentFrame])->Time;
+            drawState.pTexture = GetSoftwareTexture(material.TextureID);
+
+            // Mesh texture coordinates are flipped in v and scaled as they are by the fragment shaders
+            const auto transformVertex = [&](const glm::vec3& position, const glm::vec2& textureCoord, const glm::vec3& normal,
+                const bool lightmapped)
+                {
+                    Renderer::SoftwareVertex vertex{};
+                    const auto worldSpacePosition = glm::vec3(pPerObjectUniforms->WorldMatrix * glm::vec4(position, 1.0f));
+                    const auto worldSpaceNormal = glm::normalize(glm::vec3(pPerObjectUniforms->NormalMatrix * glm::vec4(normal, 0.0f)));
+                    const auto flipbookTextureCoord = CalculateFlipbookTextureCoord(textureCoord, material, pPerObjectUniforms->FlipbookPhase, time);
+                    vertex.ClipPosition = clipMatrix * glm::vec4(position, 1.0f);
+                    vertex.TextureCoord = glm::vec2(flipbookTextureCoord.x, -flipbookTextureCoord.y) * material.TextureScale;
+                    vertex.Color = glm::vec4(CalculateSoftwareVertexLighting(worldSpacePosition, worldSpaceNormal, cameraWorldSpacePosition,
+                        pipelineState.LightingModel, lightmapped), 1.0f);
+                    return vertex;
+                };
+
+            gSoftwareVertices.resize(command.Arg0);
+            if (pipelineState.Pipeline == Renderer::EPipeline::LIGHTMAPPED)
+            {
+                // Lightmapped geometry is unindexed. Unlit permutations ignore the lightmap
+                if (pipelineState.LightingModel != Renderer::ELightingModel::UNLIT)
+                {
+                    drawState.pLightmap = GetSoftwareTexture(pPerObjectUniforms->LightmapTextureID);
+                }
+
+                const auto& vertices = geometry.GetLightmappedVertices();
+                for (uint32_t i = 0; i < command.Arg0; ++i)
+                {
+                    const auto& vertex = vertices[command.Arg1 + i];
+                    gSoftwareVertices[i] = transformVertex(vertex.Pos, vertex.UV, vertex.Norm, true);
+                    gSoftwareVertices[i].LightmapCoord = vertex.LightmapUV;
+                }
+            }
+            else
+            {
+                // Transform each vertex once and gather them by index
+                const auto& vertices = geometry.GetVertices();
+                gSoftwareTransformedVertices.resize(vertices.size());
+                for (size_t i = 0; i < vertices.size(); ++i)
+                {
+                    gSoftwareTransformedVertices[i] = transformVertex(vertices[i].Pos, vertices[i].UV, vertices[i].Norm, false);
+                }
+
+                const auto& indices = geometry.GetIndices();
+                for (uint32_t i = 0; i < command.Arg0; ++i)
+                {
+                    gSoftwareVertices[i] = gSoftwareTransformedVertices[indices[command.Arg1 + i]];
+                }
+            }
+
+            gSoftwareRasterizer.DrawTriangles(gSoftwareVertices.data(), command.Arg0, drawState);
+            break;
+        }
+        }
+    }
+}
+
+// Rasterizes the frame's command lists in the order of the render graph's passes and presents the framebuffer to the window
+static void RasterizeAndPresentSoftwareFrame()
+{
+    gSoftwareRasterizer.Clear(CLEAR_COLOR);
+    if (!gHostStaticUniformBuffer.empty())
+    {
+        for (uint32_t i = 0; i < gViewCount; ++i)
+        {
+            RasterizeCommandList(gStaticCommandLists[GetViewLayoutSlot(i, gViewCount)], gHostStaticUniformBuffer.data());
+        }
+    }
+    RasterizeCommandList(gSceneCommandList, static_cast<const uint8_t*>(gMappedPerObjectUniformBuffers[gCurrentFrame]));
+    RasterizeCommandList(gHUDCommandList, static_cast<const uint8_t*>(gMappedPerObjectUniformBuffers[gCurrentFrame]));
+    gSoftwareRasterizer.Flush();
+
+    if (gSoftwareWindowHandle == nullptr)
+    {
+        return;
+    }
+
+    // Describe the framebuffer as a top down device independent bitmap
+    BITMAPINFO bitmapInfo{};
+    bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bitmapInfo.bmiHeader.biWidth = static_cast<LONG>(gSoftwareRasterizer.GetStride());
+    bitmapInfo.bmiHeader.biHeight = -static_cast<LONG>(gSoftwareRasterizer.GetHeight());
+    bitmapInfo.bmiHeader.biPlanes = 1;
+    bitmapInfo.bmiHeader.biBitCount = 32;
+    bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+    // Stretch the framebuffer over the window's client area
+    RECT clientRect{};
+    GetClientRect(gSoftwareWindowHandle, &clientRect);
+    const auto deviceContext = GetDC(gSoftwareWindowHandle);
+    StretchDIBits(deviceContext,
+        0, 0, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top,
+        0, 0, static_cast<int>(gSoftwareRasterizer.GetWidth()), static_cast<int>(gSoftwareRasterizer.GetHeight()),
+        gSoftwareRasterizer.GetColorBuffer().data(), &bitmapInfo, DIB_RGB_COLORS, SRCCOPY);
+    ReleaseDC(gSoftwareWindowHandle, deviceContext);
+}
+
+// Declares the frame's passes and the resources they use. The render graph derives barriers, layout transitions and
+// render passes from the declarations
+static bool BuildRenderGraph()
+{
+    // Import the swapchain images. They are transitioned for presentation after the last pass
+    const auto backbuffer = gRenderGraph.ImportImage("Backbuffer", gSwapchainImages, gSwapchainImageViews, gSurfaceFormat.format,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+    // Import per frame buffers read by the passes
+    const auto perObjectUniforms = gRenderGraph.ImportBuffer("PerObjectUniforms", gPerObjectUniformBuffers);
+    const auto perFrameUniforms = gRenderGraph.ImportBuffer("PerFrameUniforms", gPerFrameUniformBuffers);
+    const auto perRenderPassUniforms = gRenderGraph.ImportBuffer("PerRenderPassUniforms", gPerRenderPassUniformBuffers);
+    const auto spriteVertices = gRenderGraph.ImportBuffer("SpriteVertices", gSpriteVertexBuffers);
+    const auto lightGrid = gRenderGraph.ImportBuffer("LightGrid", gLightGridBuffers);
+
+    // The depth stencil buffer is only used by the scene pass so it is owned by the graph
+    Renderer::RenderGraphImageDesc depthStencilDesc{};
+    depthStencilDesc.Format = gDepthStencilFormat;
+    const auto depthStencil = gRenderGraph.CreateTransientImage("DepthStencil", depthStencilDesc);
+
+    // Describe attachment clear values
+    VkClearValue colorClearValue{};
+    colorClearValue.color.float32[0] = CLEAR_COLOR.r;
+    colorClearValue.color.float32[1] = CLEAR_COLOR.g;
+    colorClearValue.color.float32[2] = CLEAR_COLOR.b;
+    colorClearValue.color.float32[3] = CLEAR_COLOR.a;
+
+    VkClearValue depthStencilClearValue{};
+    depthStencilClearValue.depthStencil = { 1.0f, 0 };
+
+    // Static scene pass replays the static geometry recorded when the level loaded. Its attachments are declared in the same
+    // order as the scene pass so that the mesh pipeline is compatible with both render passes
+    gStaticScenePass = gRenderGraph.AddPass("StaticScene", [](VkCommandBuffer commandBuffer)
+        {
+            // The slots of a layout's views are contiguous so the views' static draws are executed together
+            if (gStaticCommandBuffersRecorded && gViewCount > 0)
+            {
+                vkCmdExecuteCommands(commandBuffer, gViewCount,
+                    &gStaticCommandBuffers[(gCurrentFrame * VIEW_LAYOUT_SLOT_COUNT) + GetViewLayoutSlot(0, gViewCount)]);
+            }
+        });
+    gRenderGraph.Write(gStaticScenePass, backbuffer, Renderer::ERenderGraphUsage::COLOR_ATTACHMENT);
+    gRenderGraph.Write(gStaticScenePass, depthStencil, Renderer::ERenderGraphUsage::DEPTH_STENCIL_ATTACHMENT);
+    gRenderGraph.Read(gStaticScenePass, perFrameUniforms, Renderer::ERenderGraphUsage::UNIFORM_BUFFER);
+    gRenderGraph.Read(gStaticScenePass, perRenderPassUniforms, Renderer::ERenderGraphUsage::UNIFORM_BUFFER);
+    gRenderGraph.Read(gStaticScenePass, lightGrid, Renderer::ERenderGraphUsage::STORAGE_BUFFER);
+    gRenderGraph.SetClearValue(gStaticScenePass, backbuffer, colorClearValue);
+    gRenderGraph.SetClearValue(gStaticScenePass, depthStencil, depthStencilClearValue);
+    gRenderGraph.SetSecondaryCommandBufferContents(gStaticScenePass);
+
+    // Scene pass draws draw items submitted this frame over the static geometry
+    gScenePass = gRenderGraph.AddPass("Scene", [](VkCommandBuffer commandBuffer)
+        {
+            RecordCommandList(commandBuffer, gSceneCommandList, gDescriptorSets[gCurrentFrame], gCurrentFrame);
+        });
+    gRenderGraph.Write(gScenePass, backbuffer, Renderer::ERenderGraphUsage::COLOR_ATTACHMENT);
+    gRenderGraph.Write(gScenePass, depthStencil, Renderer::ERenderGraphUsage::DEPTH_STENCIL_ATTACHMENT);
+    gRenderGraph.Read(gScenePass, perObjectUniforms, Renderer::ERenderGraphUsage::UNIFORM_BUFFER);
+    gRenderGraph.Read(gScenePass, perFrameUniforms, Renderer::ERenderGraphUsage::UNIFORM_BUFFER);
+    gRenderGraph.Read(gScenePass, perRenderPassUniforms, Renderer::ERenderGraphUsage::UNIFORM_BUFFER);
+    gRenderGraph.Read(gScenePass, lightGrid, Renderer::ERenderGraphUsage::STORAGE_BUFFER);
+
+    // HUD pass draws batched sprites over the scene
+    gHUDPass = gRenderGraph.AddPass("HUD", [](VkCommandBuffer commandBuffer)
+        {
+            RecordCommandList(commandBuffer, gHUDCommandList, gDescriptorSets[gCurrentFrame], gCurrentFrame);
+        });
+    gRenderGraph.Write(gHUDPass, backbuffer, Renderer::ERenderGraphUsage::COLOR_ATTACHMENT);
+    gRenderGraph.Read(gHUDPass, perRenderPassUniforms, Renderer::ERenderGraphUsage::UNIFORM_BUFFER);
+    gRenderGraph.Read(gHUDPass, spriteVertices, Renderer::ERenderGraphUsage::VERTEX_BUFFER);
+
+    // Compile the graph
+    Renderer::RenderGraphContext context{};
+    context.Device = gDevice;
+    context.MemoryProperties = gPhysicalDeviceMemoryProperties;
+    context.SurfaceWidth = gSurfaceWidth;
+    context.SurfaceHeight = gSurfaceHeight;
+
+    return gRenderGraph.Compile(context);
+}
+
+// Waits for the current frame's previous submission, acquires the next swapchain image and begins the frame's command buffer
+static bool AcquireNextFrame()
+{
+    // Wait for the previous frame to finish executing on the GPU
+    if (vkWaitForFences(gDevice, 1, &gInFlightFences[gCurrentFrame], VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // The fence was last signalled by the frame submitted a swapchain image count of frames ago
+    if (gFrameNumber >= gSwapchainImageCount)
+    {
+        gFinishedFrameCount = std::max(gFinishedFrameCount, gFrameNumber - gSwapchainImageCount + 1);
+    }
+
+    // Destroy resources released while the finished frames were in flight
+    ReleaseDeferredDestructions();
+
+    // Get the next available swapchain image
+    if (vkAcquireNextImageKHR(gDevice,
+        gSwapchain,
+        std::chrono::nanoseconds::max().count(),
+        gImageAvailableSemaphores[gCurrentFrame],
+        VK_NULL_HANDLE,
+        &gImageIndex) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Check if a previous frame is using the current image
+    if (gImagesInFlight[gImageIndex] != VK_NULL_HANDLE)
+    {
+        // Wait for the GPU to signal the fence it is finished writing to the image
+        vkWaitForFences(gDevice, 1, &gImagesInFlight[gImageIndex], VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION);
+    }
+    // Set the image as in use by the current frame
+    gImagesInFlight[gImageIndex] = gInFlightFences[gCurrentFrame];
+
+    // Describe command buffer begin info 
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    // Begin recording command buffer
+    gCurrentFrameCommandBuffer = gGraphicsCommandBuffers[gCurrentFrame];
+    if (vkBeginCommandBuffer(gCurrentFrameCommandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        return false;
+    }
 
-    vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    return true;
 }
 
-// Generates a full mipmap chain for the image, leaving it in a state suitable for reading from the fragment shader
-static void GenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, int32_t textureWidth, int32_t textureHeight, uint32_t mipLevels)
+// Translates the frame's command lists through the render graph, submits the command buffer and presents the swapchain image
+static bool SubmitAndPresentFrame()
 {
-    // Check if image format supports linear blitting
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(gPhysicalDevice, format, &formatProperties);
+    // Record the render graph's passes with the commands submitted this frame
+    gRenderGraph.Execute(gCurrentFrameCommandBuffer, gImageIndex, static_cast<uint32_t>(gCurrentFrame));
 
-    if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+    // End recording command buffer
+    if (vkEndCommandBuffer(gCurrentFrameCommandBuffer) != VK_SUCCESS)
     {
-        assert(false && "Image format does not support linear blitting.");
+        return false;
     }
 
-    // Describe common properties of image barrier among every transition to be made
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.image = image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = 1;
+    // Get the current in flight frame's wait and signal semaphores
+    VkSemaphore waitSemaphores[] = { gImageAvailableSemaphores[gCurrentFrame] };
+    VkSemaphore signalSemaphores[] = { gRenderFinishedSemaphores[gCurrentFrame] };
+    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+
+    // Describe submit info
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = _countof(waitSemaphores);
+    submitInfo.pWaitSemaphores = waitSemaphores;
+    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &gCurrentFrameCommandBuffer;
+    submitInfo.signalSemaphoreCount = _countof(signalSemaphores);
+    submitInfo.pSignalSemaphores = signalSemaphores;
+
+    // Reset the current frame's fence
+    if (vkResetFences(gDevice, 1, &gInFlightFences[gCurrentFrame]) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Submit command buffer signalling the current frame's fence
+    if (vkQueueSubmit(gGraphicsQueue, 1, &submitInfo, gInFlightFences[gCurrentFrame]) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Describe present info
+    VkResult presentResult = VkResult::VK_RESULT_MAX_ENUM;
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = _countof(signalSemaphores);
+    presentInfo.pWaitSemaphores = signalSemaphores;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &gSwapchain;
+    presentInfo.pImageIndices = &gImageIndex;
+    presentInfo.pResults = &presentResult;
 
-    // Record blit commands
-    int32_t mipWidth = textureWidth;
-    int32_t mipHeight = textureHeight;
+    // Queue the current frame's image for presentation
+    if (vkQueuePresentKHR(gGraphicsQueue, &presentInfo) != VK_SUCCESS)
+    {
+        return false;
+    }
 
-    for (uint32_t i = 1; i < mipLevels; ++i)
+    // Check the present result for errors
+    if (presentResult != VK_SUCCESS)
     {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        
-        // Transition mipmap level to transfer source layout
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-            0, nullptr, 0, nullptr, 1, &barrier);
-
-        // Describe blit region to take from the above mip level and blit it's data to a region half the size on the below mip level
-        VkImageBlit blit{};
-        blit.srcOffsets[0] = { 0, 0, 0 };
-        blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-        blit.dstOffsets[0] = { 0, 0, 0 };
-        blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-
-        // Blit the mip level
-        vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
-
-        // Transition the current mip level to shader read only
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        return false;
+    }
 
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-            0, nullptr, 0, nullptr, 1, &barrier);
+    return true;
+}
 
-        // Halve the dimensions of the mipmap ensuring that each dimension is at least 1
-        if (mipWidth > 1)
-        {
-            mipWidth /= 2;
-        }
+// Initialises the null and software backends. No device is created. Host memory stands in for the persistently mapped buffers so
+// submissions write the same data they would with a device
+static bool InitHostBackend(const glm::vec2& windowClientAreaResolution)
+{
+    gSurfaceWidth = static_cast<uint32_t>(windowClientAreaResolution.x);
+    gSurfaceHeight = static_cast<uint32_t>(windowClientAreaResolution.y);
+    gViewport.width = static_cast<float>(gSurfaceWidth);
+    gViewport.height = static_cast<float>(gSurfaceHeight);
+    gScissor.extent = { gSurfaceWidth, gSurfaceHeight };
+
+    // Use the uniform buffer offset alignment of the GPU the renderer targets (Nvidia GTX 1080)
+    gMinUniformBufferOffsetAlignment = 256;
+
+    // Allocate host memory for each frame's mapped buffers
+    const std::array<size_t, 5> bufferSizes{
+        MAX_DRAW_ITEMS_PER_FRAME * gMinUniformBufferOffsetAlignment,
+        sizeof(PerFrameUniforms),
+        MAX_RENDER_PASS_COUNT * gMinUniformBufferOffsetAlignment,
+        sizeof(SpriteVertex) * SPRITE_VERTEX_COUNT * MAX_SPRITES_PER_FRAME,
+        sizeof(LightGrid)
+    };
+    const std::array<std::vector<void*>*, 5> mappedBuffers{
+        &gMappedPerObjectUniformBuffers,
+        &gMappedPerFrameUniformBuffers,
+        &gMappedPerRenderPassUniformBuffers,
+        &gMappedSpriteVertexBuffers,
+        &gMappedLightGridBuffers
+    };
 
-        if (mipHeight > 1)
+    gNullBackendBufferStorage.resize(bufferSizes.size() * gSwapchainImageCount);
+    for (size_t i = 0; i < mappedBuffers.size(); ++i)
+    {
+        mappedBuffers[i]->resize(static_cast<size_t>(gSwapchainImageCount));
+        for (uint32_t j = 0; j < gSwapchainImageCount; ++j)
         {
-            mipHeight /= 2;
+            auto& storage = gNullBackendBufferStorage[(i * gSwapchainImageCount) + j];
+            storage.resize(bufferSizes[i]);
+            (*mappedBuffers[i])[j] = storage.data();
         }
     }
 
-    // Transition the last mip level to shader read only as the last mip level is not blitted from in the loop
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    // Allocate host memory for the material table
+    gMappedMaterialBuffer = gNullBackendBufferStorage.emplace_back(MATERIAL_BUFFER_SIZE).data();
+
+    // Add available geometry IDs to queue
+    for (uint32_t i = 0; i < MAX_LOADED_GEOMETRY_COUNT; ++i)
+    {
+        gAvailableGeometryIDs.push(i);
+    }
+
+    // Add available texture IDs to queue
+    for (uint32_t i = 0; i < MAX_LOADED_TEXTURE_COUNT; ++i)
+    {
+        gAvailableTextureIDs.push(i);
+    }
 
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-        0, nullptr, 0, nullptr, 1, &barrier);
+    return true;
 }
 
-bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHandle)
+bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHandle, const EBackend backend)
 {
+    gBackend = backend;
+    gInitTime = std::chrono::steady_clock::now();
+
+    // The null and software backends create no device
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        if (!InitHostBackend(windowClientAreaResolution))
+        {
+            return false;
+        }
+
+        // The software backend presents its framebuffer to the window
+        if (gBackend == Renderer::EBackend::SOFTWARE)
+        {
+            gSoftwareWindowHandle = windowHandle;
+            gSoftwareRasterizer.Resize(gSurfaceWidth, gSurfaceHeight);
+        }
+
+        return true;
+    }
+
     // Enable debug layers and extensions if being compiled in debug
 #ifdef _DEBUG
     gDebugEnabled = EnableDebugLayersAndExtensions();
@@ -1648,28 +3188,8 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
         return false;
     }
 
-    // Create depth stencil image and image view
-    if (!CreateDepthStencilImageAndView(gDevice, gPhysicalDevice, gPhysicalDeviceMemoryProperties,
-        gSurfaceWidth, gSurfaceHeight, &gDepthStencilImage, &gDepthStencilImageView, &gDepthStencilImageMemory))
-    {
-        return false;
-    }
-
-    // Create the render pass
-    if (!CreateRenderPass(gDevice, gSurfaceFormat.format, gDepthStencilFormat, &gRenderPass))
-    {
-        return false;
-    }
-
-    // Create framebuffers
-    if (!CreateFramebuffers(gDevice,
-        gSwapchainImageCount,
-        gRenderPass,
-        gSurfaceWidth,
-        gSurfaceHeight,
-        gSwapchainImageViews,
-        gDepthStencilImageView,
-        gFramebuffers))
+    // Find a supported depth stencil format. The depth stencil image is created by the render graph
+    if (!FindDepthStencilFormat(gPhysicalDevice))
     {
         return false;
     }
@@ -1693,6 +3213,19 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
         return false;
     }
 
+    // Allocate secondary command buffers that static geometry is recorded into
+    VkCommandBufferAllocateInfo staticCommandBufferAllocateInfo{};
+    staticCommandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    staticCommandBufferAllocateInfo.commandPool = gGraphicsCommandPool;
+    staticCommandBufferAllocateInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT * VIEW_LAYOUT_SLOT_COUNT;
+    staticCommandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+    gStaticCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT * VIEW_LAYOUT_SLOT_COUNT);
+    if (vkAllocateCommandBuffers(gDevice, &staticCommandBufferAllocateInfo, gStaticCommandBuffers.data()) != VK_SUCCESS)
+    {
+        return false;
+    }
+
     // Create a transfer command pool for temporary transfer command buffers
     if (!CreateCommandPool(
         gDevice, 
@@ -1703,6 +3236,47 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
         return false;
     }
 
+    // Create the fence signalled by uploads submitted outside of frames
+    if (!CreateFence(gDevice, &gUploadFence))
+    {
+        return false;
+    }
+
+    // Upload batches record geometry for the transfer queue and textures for the graphics queue
+    gUploadBatches[TRANSFER_UPLOAD_BATCH].CommandPool = gTransferTemporaryCommandPool;
+    gUploadBatches[TRANSFER_UPLOAD_BATCH].Queue = gTransferQueue;
+    gUploadBatches[GRAPHICS_UPLOAD_BATCH].CommandPool = gGraphicsCommandPool;
+    gUploadBatches[GRAPHICS_UPLOAD_BATCH].Queue = gGraphicsQueue;
+    for (auto& batch : gUploadBatches)
+    {
+        if (!CreateFence(gDevice, &batch.Fence))
+        {
+            return false;
+        }
+    }
+
+    // Create the persistently mapped staging ring that uploads are staged in
+    if (!CreateBuffer(gDevice,
+        gPhysicalDevice,
+        STAGING_RING_SIZE,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
+        nullptr,
+        &gStagingRingBuffer,
+        &gStagingRingBufferMemory))
+    {
+        return false;
+    }
+
+    void* pMappedStagingRingBuffer{ nullptr };
+    if (vkMapMemory(gDevice, gStagingRingBufferMemory, 0, STAGING_RING_SIZE, 0, &pMappedStagingRingBuffer) != VK_SUCCESS)
+    {
+        return false;
+    }
+    gMappedStagingRingBuffer = static_cast<uint8_t*>(pMappedStagingRingBuffer);
+
     // Create fences
     gInFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
     for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
@@ -1827,29 +3401,158 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
     gMappedPerRenderPassUniformBuffers.resize(static_cast<size_t>(gSwapchainImageCount));
     for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
     {
-        if (vkMapMemory(gDevice, gPerRenderPassUniformBuffersMemory[i], 0,
-            MAX_RENDER_PASS_COUNT * gMinUniformBufferOffsetAlignment, 0, &gMappedPerRenderPassUniformBuffers[i]) != VK_SUCCESS)
+        if (vkMapMemory(gDevice, gPerRenderPassUniformBuffersMemory[i], 0,
+            MAX_RENDER_PASS_COUNT * gMinUniformBufferOffsetAlignment, 0, &gMappedPerRenderPassUniformBuffers[i]) != VK_SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    // Create light grid buffers for each frame. Point lights are binned directly into these buffers
+    gLightGridBuffers.resize(static_cast<size_t>(gSwapchainImageCount));
+    gLightGridBuffersMemory.resize(static_cast<size_t>(gSwapchainImageCount));
+    gMappedLightGridBuffers.resize(static_cast<size_t>(gSwapchainImageCount));
+
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        if (!CreateBuffer(
+            gDevice,
+            gPhysicalDevice,
+            sizeof(LightGrid),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            0,
+            nullptr,
+            &gLightGridBuffers[i],
+            &gLightGridBuffersMemory[i]))
+        {
+            return false;
+        }
+
+        if (vkMapMemory(gDevice, gLightGridBuffersMemory[i], 0, sizeof(LightGrid), 0, &gMappedLightGridBuffers[i]) != VK_SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    // Create the material table. Materials are only registered while a level loads so a single buffer is shared by every frame
+    if (!CreateBuffer(
+        gDevice,
+        gPhysicalDevice,
+        MATERIAL_BUFFER_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
+        nullptr,
+        &gMaterialBuffer,
+        &gMaterialBufferMemory))
+    {
+        return false;
+    }
+
+    // Map the material table
+    if (vkMapMemory(gDevice, gMaterialBufferMemory, 0, MATERIAL_BUFFER_SIZE, 0, &gMappedMaterialBuffer) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    // Create sprite vertex buffers for each frame. Sprites are written directly into these buffers as they are submitted
+    const VkDeviceSize spriteVertexBufferSize{ sizeof(SpriteVertex) * SPRITE_VERTEX_COUNT * MAX_SPRITES_PER_FRAME };
+    gSpriteVertexBuffers.resize(static_cast<size_t>(gSwapchainImageCount));
+    gSpriteVertexBuffersMemory.resize(static_cast<size_t>(gSwapchainImageCount));
+
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        if (!CreateBuffer(
+            gDevice,
+            gPhysicalDevice,
+            spriteVertexBufferSize,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            0,
+            nullptr,
+            &gSpriteVertexBuffers[i],
+            &gSpriteVertexBuffersMemory[i]))
+        {
+            return false;
+        }
+    }
+
+    // Map sprite vertex buffers
+    gMappedSpriteVertexBuffers.resize(static_cast<size_t>(gSwapchainImageCount));
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        if (vkMapMemory(gDevice, gSpriteVertexBuffersMemory[i], 0,
+            spriteVertexBufferSize, 0, &gMappedSpriteVertexBuffers[i]) != VK_SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    // Create the sprite index buffer. Every sprite is a quad so the indices never change and are shared by all frames
+    const VkDeviceSize spriteIndexBufferSize{ sizeof(uint32_t) * SPRITE_INDEX_COUNT * MAX_SPRITES_PER_FRAME };
+    if (!CreateBuffer(
+        gDevice,
+        gPhysicalDevice,
+        spriteIndexBufferSize,
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
+        nullptr,
+        &gSpriteIndexBuffer,
+        &gSpriteIndexBufferMemory))
+    {
+        return false;
+    }
+
+    // Write the sprite quad indices
+    void* pSpriteIndexData;
+    if (vkMapMemory(gDevice, gSpriteIndexBufferMemory, 0, spriteIndexBufferSize, 0, &pSpriteIndexData) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    auto* pSpriteIndices = static_cast<uint32_t*>(pSpriteIndexData);
+    for (uint32_t i = 0; i < MAX_SPRITES_PER_FRAME; ++i)
+    {
+        const uint32_t firstVertex = i * SPRITE_VERTEX_COUNT;
+        for (uint32_t j = 0; j < SPRITE_INDEX_COUNT; ++j)
         {
-            return false;
+            pSpriteIndices[(static_cast<size_t>(i) * SPRITE_INDEX_COUNT) + j] = firstVertex + SPRITE_QUAD_INDICES[j];
         }
     }
 
+    vkUnmapMemory(gDevice, gSpriteIndexBufferMemory);
+
+    // Build and compile the render graph
+    if (!BuildRenderGraph())
+    {
+        return false;
+    }
+
     // Shader binding ////////////////////////////////////////////////
     // Describe descriptor pool sizes
-    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    std::array<VkDescriptorPoolSize, 4> poolSizes{};
     poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = gSwapchainImageCount * UNIFORM_BUFFER_COUNT;
+    // Each swapchain image has a descriptor set for dynamic draws and a descriptor set for static draws
+    poolSizes[0].descriptorCount = gSwapchainImageCount * UNIFORM_BUFFER_COUNT * 2;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-    poolSizes[1].descriptorCount = SAMPLER_COUNT;
+    poolSizes[1].descriptorCount = SAMPLER_COUNT * 2;
     poolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-    poolSizes[2].descriptorCount = MAX_LOADED_TEXTURE_COUNT;
+    poolSizes[2].descriptorCount = MAX_LOADED_TEXTURE_COUNT * 2;
+    poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[3].descriptorCount = gSwapchainImageCount * 2 * 2;
 
     // Describe uniform buffer descriptor pool create info
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = gSwapchainImageCount;
+    poolInfo.maxSets = gSwapchainImageCount * 2;
 
     // Create descriptor pool
     if (vkCreateDescriptorPool(gDevice, &poolInfo, nullptr, &gDescriptorPool) != VK_SUCCESS)
@@ -1857,7 +3560,7 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
         return false;
     }
 
-    std::array<VkDescriptorSetLayoutBinding, 5> layoutBindings{};
+    std::array<VkDescriptorSetLayoutBinding, 7> layoutBindings{};
     // Describe binding 0 - vertex shader per object uniform buffer
     layoutBindings[0].descriptorCount = 1;
     layoutBindings[0].binding = 0;
@@ -1870,11 +3573,11 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
     layoutBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     layoutBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
-    // Describe binding 2 - vertex shader per render pass uniform buffer
+    // Describe binding 2 - vertex and fragment shader per render pass uniform buffer
     layoutBindings[2].descriptorCount = 1;
     layoutBindings[2].binding = 2;
     layoutBindings[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-    layoutBindings[2].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    layoutBindings[2].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
     // Describe binding 3 - fragment shader samplers
     layoutBindings[3].descriptorCount = SAMPLER_COUNT;
@@ -1888,6 +3591,18 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
     layoutBindings[4].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
     layoutBindings[4].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
+    // Describe binding 5 - vertex shader material table
+    layoutBindings[5].descriptorCount = 1;
+    layoutBindings[5].binding = 5;
+    layoutBindings[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    layoutBindings[5].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // Describe binding 6 - fragment shader light grid
+    layoutBindings[6].descriptorCount = 1;
+    layoutBindings[6].binding = 6;
+    layoutBindings[6].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    layoutBindings[6].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
     // Describe binding flags
     VkDescriptorBindingFlags bindingFlag{};
     bindingFlag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
@@ -1929,91 +3644,30 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
         return false;
     }
 
-    // Graphics pipeline ////////////////////////////////////////////////
-    // Read in shader binary
-    BinaryBuffer vertexShaderBinary{};
-    if (!Binary::ReadBinaryIntoBuffer(gVertexShaderPath, vertexShaderBinary))
-    {
-        LOG("Failed to read vertex shader binary.");
-        return false;
-    }
-
-    BinaryBuffer fragmentShaderBinary{};
-    if (!Binary::ReadBinaryIntoBuffer(gFragmentShaderPath, fragmentShaderBinary))
+    // Allocate descriptor sets for static draws
+    gStaticDescriptorSets.resize(static_cast<size_t>(gSwapchainImageCount));
+    if (vkAllocateDescriptorSets(gDevice, &allocInfo, gStaticDescriptorSets.data()) != VK_SUCCESS)
     {
-        LOG("Failed to read fragment shader binary.");
         return false;
     }
+    gStaleTextureDescriptorSets.assign(static_cast<size_t>(gSwapchainImageCount), false);
 
-    // Create shader modules
-    VkShaderModule vertexShaderModule;
-    if (!CreateShaderModule(gDevice, vertexShaderBinary, &vertexShaderModule))
-    {
-        return false;
-    }
+    // Graphics pipelines ////////////////////////////////////////////////
+    // Create the shader programs pipeline permutations are built from
+    const std::array<std::pair<const std::string*, const std::string*>, SHADER_PROGRAM_COUNT> shaderProgramPaths{ {
+        { &gVertexShaderPath, &gFragmentShaderPath },
+        { &gSpriteVertexShaderPath, &gSpriteFragmentShaderPath },
+        { &gLightmapVertexShaderPath, &gLightmapFragmentShaderPath }
+    } };
 
-    VkShaderModule fragmentShaderModule;
-    if (!CreateShaderModule(gDevice, fragmentShaderBinary, &fragmentShaderModule))
+    for (size_t i = 0; i < SHADER_PROGRAM_COUNT; ++i)
     {
-        return false;
+        if (!CreateShaderProgram(*shaderProgramPaths[i].first, *shaderProgramPaths[i].second, gShaderPrograms[i]))
+        {
+            return false;
+        }
     }
 
-    // Describe vertex shader stage create info
-    VkPipelineShaderStageCreateInfo vertexShaderStageInfo{};
-    vertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertexShaderStageInfo.module = vertexShaderModule;
-    vertexShaderStageInfo.pName = "main";
-
-    // Describe fragment shader stage create info
-    VkPipelineShaderStageCreateInfo fragmentShaderStageInfo{};
-    fragmentShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragmentShaderStageInfo.module = fragmentShaderModule;
-    fragmentShaderStageInfo.pName = "main";
-
-    const VkPipelineShaderStageCreateInfo shaderStages[] = { vertexShaderStageInfo, fragmentShaderStageInfo };
-
-    // Describe input binding
-    VkVertexInputBindingDescription bindingDescription{};
-    bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(Vertex1Pos1UV1Norm);
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    // Describe attributes
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-    // Position attribute
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[0].offset = 0;
-
-    // UV attribute
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[1].offset = sizeof(glm::vec3);
-
-    // Vertex normal attribute
-    attributeDescriptions[2].binding = 0;
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[2].offset = sizeof(glm::vec3) + sizeof(glm::vec2);
-
-    // Describe vertex input
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-    // Describe input assembly
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
     // Describe the viewport
     gViewport.x = 0.0f;
     gViewport.y = 0.0f;
@@ -2026,70 +3680,6 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
     gScissor.offset = { 0, 0 };
     gScissor.extent = { gSurfaceWidth, gSurfaceHeight };
 
-    // Describe viewport state
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &gViewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &gScissor;
-
-    // Describe rasterization state
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-    rasterizer.lineWidth = 1.0f;
-
-    // Describe multisampling state
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    // Describe depth stencil state
-    VkPipelineDepthStencilStateCreateInfo depthStencilState{};
-    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencilState.depthTestEnable = VK_TRUE;
-    depthStencilState.depthWriteEnable = VK_TRUE;
-    depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS;
-    depthStencilState.depthBoundsTestEnable = VK_FALSE;
-    depthStencilState.minDepthBounds = 0.0f;
-    depthStencilState.maxDepthBounds = 1.0f;
-    depthStencilState.stencilTestEnable = gStencilAvailable ? VK_FALSE : VK_FALSE; // depthStencilState.front and depthStencilState.back need to be configured before using the stencil buffer
-    depthStencilState.front = {};
-    depthStencilState.back = {};
-
-    // Describe color blending state
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
-        VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_SUBTRACT;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    // Describe dynamic states
-    //const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-
-    //VkPipelineDynamicStateCreateInfo dynamicState{};
-    //dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    //dynamicState.dynamicStateCount = _countof(dynamicStates);
-    //dynamicState.pDynamicStates = dynamicStates;
-
     // Describe pipeline layout
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -2102,33 +3692,26 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
         return false;
     }
 
-    // Describe graphics pipeline
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = _countof(shaderStages);
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = &depthStencilState;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = gGraphicsPipelineLayout;
-    pipelineInfo.renderPass = gRenderPass;
-    pipelineInfo.subpass = 0;
+    // Create the permutations every level draws with up front. Other permutations are created when first bound
+    Renderer::Material defaultMaterial{};
+    Renderer::Material alphaBlendedMaterial{};
+    alphaBlendedMaterial.AlphaBlended = true;
+
+    const std::array<Renderer::PipelineState, 4> initialStates{
+        GetMaterialPipelineState(Renderer::EPipeline::MESH, defaultMaterial),
+        GetMaterialPipelineState(Renderer::EPipeline::MESH, alphaBlendedMaterial),
+        GetMaterialPipelineState(Renderer::EPipeline::LIGHTMAPPED, defaultMaterial),
+        GetSpritePipelineState()
+    };
 
-    // Create graphics pipeline
-    if (vkCreateGraphicsPipelines(gDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &gGraphicsPipeline) != VK_SUCCESS)
+    for (const auto& state : initialStates)
     {
-        return false;
+        if (GetPipeline(state.Pack()) == VK_NULL_HANDLE)
+        {
+            return false;
+        }
     }
 
-    // Destroy shader modules
-    vkDestroyShaderModule(gDevice, vertexShaderModule, nullptr);
-    vkDestroyShaderModule(gDevice, fragmentShaderModule, nullptr);
-
     // Add available geometry IDs to queue
     for (uint32_t i = 0; i < MAX_LOADED_GEOMETRY_COUNT; ++i)
     {
@@ -2157,7 +3740,8 @@ bool Renderer::Init(const glm::vec2& windowClientAreaResolution, HWND windowHand
     return true;
 }
 
-void Renderer::UpdateDescriptorSets()
+// Writes descriptors into one descriptor set for each frame in flight. Per object uniforms are read from the given buffers
+static void WriteDescriptorSets(const std::vector<VkDescriptorSet>& descriptorSets, const std::vector<VkBuffer>& perObjectUniformBuffers)
 {
     // Populate descriptor sets with descriptor info
     // Descriptor count in set = buffer version count * buffers in descriptor set
@@ -2166,30 +3750,35 @@ void Renderer::UpdateDescriptorSets()
     std::vector<VkDescriptorBufferInfo> bufferInfos(static_cast<size_t>(gSwapchainImageCount) * UNIFORM_BUFFER_COUNT);
     // Sampler descriptors are the same across descriptor sets as the samplers are static and will not change during a frame
     std::vector<VkDescriptorImageInfo> samplerInfos(SAMPLER_COUNT);
-    // Image descriptors are the same across descriptor sets as the textures are static and will not change during a frame
+    // Image descriptors are the same across descriptor sets. Each frame's texture descriptors are written again when streaming replaces a
+    // texture's image
     std::vector<VkDescriptorImageInfo> imageInfos(MAX_LOADED_TEXTURE_COUNT);
 
     auto uniformBufferDescriptorWriteCount = static_cast<size_t>(gSwapchainImageCount) * UNIFORM_BUFFER_COUNT;
     auto samplerDescriptorWriteCount = static_cast<size_t>(gSwapchainImageCount);
     auto textureDescriptorWriteCount = static_cast<size_t>(gSwapchainImageCount);
+    auto materialDescriptorWriteCount = static_cast<size_t>(gSwapchainImageCount);
+    auto lightGridDescriptorWriteCount = static_cast<size_t>(gSwapchainImageCount);
 
     std::vector<VkWriteDescriptorSet> descriptorWrites(
         uniformBufferDescriptorWriteCount +
         samplerDescriptorWriteCount +
-        textureDescriptorWriteCount
+        textureDescriptorWriteCount +
+        materialDescriptorWriteCount +
+        lightGridDescriptorWriteCount
     );
 
     // Populate per object uniform buffer descriptors in each descriptor set
     for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
     {
         auto& bufferInfo = bufferInfos[i];
-        bufferInfo.buffer = gPerObjectUniformBuffers[i];
+        bufferInfo.buffer = perObjectUniformBuffers[i];
         bufferInfo.offset = 0;
         bufferInfo.range = gMinUniformBufferOffsetAlignment;
 
         auto& descriptorWrite = descriptorWrites[i];
         descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = gDescriptorSets[i];
+        descriptorWrite.dstSet = descriptorSets[i];
         descriptorWrite.dstBinding = 0;
         descriptorWrite.dstArrayElement = 0;
         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -2207,7 +3796,7 @@ void Renderer::UpdateDescriptorSets()
 
         auto& descriptorWrite = descriptorWrites[static_cast<size_t>(i) + gSwapchainImageCount];
         descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = gDescriptorSets[i];
+        descriptorWrite.dstSet = descriptorSets[i];
         descriptorWrite.dstBinding = 1;
         descriptorWrite.dstArrayElement = 0;
         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -2225,7 +3814,7 @@ void Renderer::UpdateDescriptorSets()
 
         auto& descriptorWrite = descriptorWrites[static_cast<size_t>(i) + (static_cast<size_t>(gSwapchainImageCount) * 2)];
         descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = gDescriptorSets[i];
+        descriptorWrite.dstSet = descriptorSets[i];
         descriptorWrite.dstBinding = 2;
         descriptorWrite.dstArrayElement = 0;
         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -2245,7 +3834,7 @@ void Renderer::UpdateDescriptorSets()
     {
         auto& descriptorWrite = descriptorWrites[static_cast<size_t>(i) + uniformBufferDescriptorWriteCount];
         descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = gDescriptorSets[i];
+        descriptorWrite.dstSet = descriptorSets[i];
         descriptorWrite.dstBinding = 3;
         descriptorWrite.dstArrayElement = 0;
         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
@@ -2267,7 +3856,7 @@ void Renderer::UpdateDescriptorSets()
     {
         auto& descriptorWrite = descriptorWrites[static_cast<size_t>(i) + uniformBufferDescriptorWriteCount + samplerDescriptorWriteCount];
         descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = gDescriptorSets[i];
+        descriptorWrite.dstSet = descriptorSets[i];
         descriptorWrite.dstBinding = 4;
         descriptorWrite.dstArrayElement = 0;
         descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
@@ -2275,13 +3864,95 @@ void Renderer::UpdateDescriptorSets()
         descriptorWrite.pImageInfo = imageInfos.data();
     }
 
+    // Describe the material table descriptor. The material table is the same across descriptor sets
+    VkDescriptorBufferInfo materialBufferInfo{};
+    materialBufferInfo.buffer = gMaterialBuffer;
+    materialBufferInfo.offset = 0;
+    materialBufferInfo.range = MATERIAL_BUFFER_SIZE;
+
+    // Populate material table descriptors in each descriptor set
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        auto& descriptorWrite = descriptorWrites[static_cast<size_t>(i) + uniformBufferDescriptorWriteCount + samplerDescriptorWriteCount + textureDescriptorWriteCount];
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = descriptorSets[i];
+        descriptorWrite.dstBinding = 5;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &materialBufferInfo;
+    }
+
+    // Populate light grid descriptors in each descriptor set
+    std::vector<VkDescriptorBufferInfo> lightGridBufferInfos(static_cast<size_t>(gSwapchainImageCount));
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        auto& bufferInfo = lightGridBufferInfos[i];
+        bufferInfo.buffer = gLightGridBuffers[i];
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(LightGrid);
+
+        auto& descriptorWrite = descriptorWrites[static_cast<size_t>(i) + uniformBufferDescriptorWriteCount + samplerDescriptorWriteCount +
+            textureDescriptorWriteCount + materialDescriptorWriteCount];
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = descriptorSets[i];
+        descriptorWrite.dstBinding = 6;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+    }
+
     vkUpdateDescriptorSets(gDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 }
 
+// Points a descriptor set's texture descriptors at the loaded textures' image views
+static void WriteTextureDescriptors(VkDescriptorSet descriptorSet)
+{
+    std::vector<VkDescriptorImageInfo> imageInfos(MAX_LOADED_TEXTURE_COUNT);
+    for (uint32_t i = 0; i < MAX_LOADED_TEXTURE_COUNT; ++i)
+    {
+        auto& imageInfo = imageInfos[i];
+        imageInfo.sampler = nullptr;
+        imageInfo.imageView = gLoadedTextures[i].GetImageView();
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = descriptorSet;
+    descriptorWrite.dstBinding = 4;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    descriptorWrite.descriptorCount = MAX_LOADED_TEXTURE_COUNT;
+    descriptorWrite.pImageInfo = imageInfos.data();
+
+    vkUpdateDescriptorSets(gDevice, 1, &descriptorWrite, 0, nullptr);
+}
+
+void Renderer::UpdateDescriptorSets()
+{
+    // The null and software backends have no descriptor sets
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        return;
+    }
+
+    WriteDescriptorSets(gDescriptorSets, gPerObjectUniformBuffers);
+}
+
 bool Renderer::Shutdown()
 {
+    // The null and software backends only own host memory
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        gNullBackendBufferStorage.clear();
+        gHostStaticUniformBuffer.clear();
+        return true;
+    }
+
     // Wait for all queues to finish work
-    if (vkQueueWaitIdle(gGraphicsQueue) != VK_SUCCESS && vkQueueWaitIdle(gTransferQueue) != VK_SUCCESS)
+    if ((vkQueueWaitIdle(gGraphicsQueue) != VK_SUCCESS) || (vkQueueWaitIdle(gTransferQueue) != VK_SUCCESS))
     {
         return false;
     }
@@ -2300,6 +3971,21 @@ bool Renderer::Shutdown()
         vkUnmapMemory(gDevice, gPerFrameUniformBuffersMemory[i]);
     }
 
+    // Unmap light grid buffers
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        vkUnmapMemory(gDevice, gLightGridBuffersMemory[i]);
+    }
+
+    // Unmap the material table
+    vkUnmapMemory(gDevice, gMaterialBufferMemory);
+
+    // Unmap sprite vertex buffers
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        vkUnmapMemory(gDevice, gSpriteVertexBuffersMemory[i]);
+    }
+
     // Destroy remaining loaded geometry
     for(const auto& id : gUsedGeometryIDs)
     {
@@ -2322,6 +4008,26 @@ bool Renderer::Shutdown()
         vkDestroyImageView(gDevice, texture.GetImageView(), nullptr);
     }
 
+    // Destroy resources released by destroyed geometry, textures and streaming
+    FlushDeferredDestructions();
+
+    // Destroy the staging ring and remaining dedicated staging buffers
+    for (const auto& region : gDedicatedStagingRegions)
+    {
+        DestroyBuffer(region.DedicatedBuffer, region.DedicatedBufferMemory);
+    }
+    gDedicatedStagingRegions.clear();
+    gStagingRingRegions.clear();
+
+    vkUnmapMemory(gDevice, gStagingRingBufferMemory);
+    DestroyBuffer(gStagingRingBuffer, gStagingRingBufferMemory);
+    vkDestroyFence(gDevice, gUploadFence, nullptr);
+    for (auto& batch : gUploadBatches)
+    {
+        vkDestroyFence(gDevice, batch.Fence, nullptr);
+        batch = {};
+    }
+
     // Destroy samplers
     for (uint32_t i = 0; i < SAMPLER_COUNT; ++i)
     {
@@ -2331,8 +4037,19 @@ bool Renderer::Shutdown()
     // Destroy descriptor set layout
     vkDestroyDescriptorSetLayout(gDevice, gDescriptorSetLayout, nullptr);
 
-    // Destroy pipeline
-    vkDestroyPipeline(gDevice, gGraphicsPipeline, nullptr);
+    // Destroy pipelines
+    for (const auto& [packedState, pipeline] : gPipelineCache)
+    {
+        vkDestroyPipeline(gDevice, pipeline, nullptr);
+    }
+    gPipelineCache.clear();
+
+    // Destroy shader programs
+    for (auto& program : gShaderPrograms)
+    {
+        vkDestroyShaderModule(gDevice, program.VertexShaderModule, nullptr);
+        vkDestroyShaderModule(gDevice, program.FragmentShaderModule, nullptr);
+    }
 
     // Destroy pipeline layout
     vkDestroyPipelineLayout(gDevice, gGraphicsPipelineLayout, nullptr);
@@ -2354,21 +4071,8 @@ bool Renderer::Shutdown()
         vkDestroyFence(gDevice, gInFlightFences[i], nullptr);
     }
 
-    // Destroy framebuffers
-    for (auto& framebuffer : gFramebuffers)
-    {
-        vkDestroyFramebuffer(gDevice, framebuffer, nullptr);
-        framebuffer = VK_NULL_HANDLE;
-    }
-
-    // Destroy render pass
-    vkDestroyRenderPass(gDevice, gRenderPass, nullptr);
-    gRenderPass = VK_NULL_HANDLE;
-
-    // Destroy depth stencil image, image view and free memory
-    vkDestroyImageView(gDevice, gDepthStencilImageView, nullptr);
-    vkFreeMemory(gDevice, gDepthStencilImageMemory, nullptr);
-    vkDestroyImage(gDevice, gDepthStencilImage, nullptr);
+    // Destroy render graph render passes, framebuffers and transient images
+    gRenderGraph.Destroy();
 
     // Destroy swapchain image views
     for (auto view : gSwapchainImageViews)
@@ -2386,6 +4090,21 @@ bool Renderer::Shutdown()
         DestroyBuffer(gPerFrameUniformBuffers[i], gPerFrameUniformBuffersMemory[i]);
     }
 
+    // Destroy light grid buffers
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        DestroyBuffer(gLightGridBuffers[i], gLightGridBuffersMemory[i]);
+    }
+
+    // Destroy the material table
+    DestroyBuffer(gMaterialBuffer, gMaterialBufferMemory);
+
+    // Destroy the static per object uniform buffer
+    if (gStaticUniformBuffer != VK_NULL_HANDLE)
+    {
+        DestroyBuffer(gStaticUniformBuffer, gStaticUniformBufferMemory);
+    }
+
     // Destroy per render pass bufers
     for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
     {
@@ -2398,6 +4117,13 @@ bool Renderer::Shutdown()
         DestroyBuffer(gPerObjectUniformBuffers[i], gPerObjectUniformBuffersMemory[i]);
     }
 
+    // Destroy sprite buffers
+    for (uint32_t i = 0; i < gSwapchainImageCount; ++i)
+    {
+        DestroyBuffer(gSpriteVertexBuffers[i], gSpriteVertexBuffersMemory[i]);
+    }
+    DestroyBuffer(gSpriteIndexBuffer, gSpriteIndexBufferMemory);
+
     // Destroy the swapchain
     vkDestroySwapchainKHR(gDevice, gSwapchain, nullptr);
     gSwapchain = VK_NULL_HANDLE;
@@ -2439,88 +4165,259 @@ bool Renderer::Shutdown()
     return true;
 }
 
-void Renderer::SetVulkanDebugReportLevel(const EVulkanDebugReportLevel level)
-{
-    gDebugReportLevel = level;
-}
-
-bool Renderer::BeginFrame(const Renderer::DirectionalLight& directionalLight)
+void Renderer::SetVulkanDebugReportLevel(const EVulkanDebugReportLevel level)
+{
+    gDebugReportLevel = level;
+}
+
+// Copies the frame's point lights to the light grid in world space. They are shared by every view
+static void WritePointLights(const Renderer::PointLight* pointLights, uint32_t pointLightCount)
+{
+    assert(pointLightCount <= MAX_POINT_LIGHTS_PER_FRAME && "Unsupported number of point lights submitted to the renderer this frame.");
+
+    auto* pLightGrid = static_cast<LightGrid*>(gMappedLightGridBuffers[gCurrentFrame]);
+    pLightGrid->LightCount = { pointLightCount, 0, 0, 0 };
+
+    for (uint32_t i = 0; i < pointLightCount; ++i)
+    {
+        const auto& pointLight = pointLights[i];
+        pLightGrid->Lights[i].WorldSpacePositionRadius = glm::vec4(pointLight.Position, pointLight.Radius);
+        pLightGrid->Lights[i].ColorIntensity = glm::vec4(pointLight.Color, pointLight.Intensity);
+    }
+}
+
+// Bins the frame's point lights into the clusters of the current render pass's view
+static void BinPointLights()
+{
+    auto* pLightGrid = static_cast<LightGrid*>(gMappedLightGridBuffers[gCurrentFrame]);
+    auto& clusterGrid = pLightGrid->Views[gRenderPassViewIndex];
+    const auto pointLightCount = pLightGrid->LightCount.x;
+
+    // Describe exponential depth slices. A fragment's slice is log(depth) * scale - bias
+    const auto nearDepth = std::max(gRenderPassNearClipPlane, MIN_CLUSTER_DEPTH);
+    const auto farDepth = std::max(gRenderPassFarClipPlane, nearDepth * 2.0f);
+    const auto logDepthRatio = std::log(farDepth / nearDepth);
+    const auto sliceScale = static_cast<float>(CLUSTER_COUNT_Z) / logDepthRatio;
+    const auto sliceBias = sliceScale * std::log(nearDepth);
+
+    clusterGrid.ClusterCounts = { CLUSTER_COUNT_X, CLUSTER_COUNT_Y, CLUSTER_COUNT_Z, 0 };
+    clusterGrid.ClusterDepth = { nearDepth, farDepth, sliceScale, sliceBias };
+    clusterGrid.ClusterTileSize = {
+        static_cast<float>(gRenderPassViewport.extent.width) / CLUSTER_COUNT_X,
+        static_cast<float>(gRenderPassViewport.extent.height) / CLUSTER_COUNT_Y,
+        static_cast<float>(gRenderPassViewport.offset.x),
+        static_cast<float>(gRenderPassViewport.offset.y)
+    };
+
+    // Transform the point lights to view space for binning. View space is left handed so depth increases along z
+    std::vector<glm::vec4> viewSpaceLights(pointLightCount);
+    for (uint32_t i = 0; i < pointLightCount; ++i)
+    {
+        const auto& light = pLightGrid->Lights[i].WorldSpacePositionRadius;
+        viewSpaceLights[i] = glm::vec4(glm::vec3(gRenderPassViewMatrix * glm::vec4(glm::vec3(light), 1.0f)), light.w);
+    }
+
+    // Unproject the corners of each tile on the near and far clip planes into view space
+    constexpr uint32_t TILE_CORNER_COUNT_X{ CLUSTER_COUNT_X + 1 };
+    constexpr uint32_t TILE_CORNER_COUNT_Y{ CLUSTER_COUNT_Y + 1 };
+    std::array<glm::vec3, TILE_CORNER_COUNT_X * TILE_CORNER_COUNT_Y> nearCorners{};
+    std::array<glm::vec3, TILE_CORNER_COUNT_X * TILE_CORNER_COUNT_Y> farCorners{};
+    const auto inverseProjectionMatrix = glm::inverse(gRenderPassProjectionMatrix);
+
+    for (uint32_t y = 0; y < TILE_CORNER_COUNT_Y; ++y)
+    {
+        for (uint32_t x = 0; x < TILE_CORNER_COUNT_X; ++x)
+        {
+            const glm::vec2 ndc{ -1.0f + (2.0f * x / CLUSTER_COUNT_X), -1.0f + (2.0f * y / CLUSTER_COUNT_Y) };
+            const auto nearCorner = inverseProjectionMatrix * glm::vec4(ndc, 0.0f, 1.0f);
+            const auto farCorner = inverseProjectionMatrix * glm::vec4(ndc, 1.0f, 1.0f);
+            nearCorners[(y * TILE_CORNER_COUNT_X) + x] = glm::vec3(nearCorner) / nearCorner.w;
+            farCorners[(y * TILE_CORNER_COUNT_X) + x] = glm::vec3(farCorner) / farCorner.w;
+        }
+    }
+
+    // Bin point lights into clusters. Each job bins a depth slice into its own index list
+    JobSystem::ParallelFor(CLUSTER_COUNT_Z, 1, [&](const uint32_t begin, const uint32_t end)
+        {
+            for (uint32_t z = begin; z < end; ++z)
+            {
+                const auto sliceNearDepth = nearDepth * std::pow(farDepth / nearDepth, static_cast<float>(z) / CLUSTER_COUNT_Z);
+                const auto sliceFarDepth = nearDepth * std::pow(farDepth / nearDepth, static_cast<float>(z + 1) / CLUSTER_COUNT_Z);
+
+                // Find lights that overlap the slice's depth range
+                std::vector<uint32_t> sliceLights;
+                for (uint32_t i = 0; i < pointLightCount; ++i)
+                {
+                    const auto& light = viewSpaceLights[i];
+                    if ((light.z + light.w >= sliceNearDepth) && (light.z - light.w <= sliceFarDepth))
+                    {
+                        sliceLights.push_back(i);
+                    }
+                }
+
+                auto& sliceLightIndices = gSliceLightIndices[z];
+                sliceLightIndices.clear();
+
+                for (uint32_t y = 0; y < CLUSTER_COUNT_Y; ++y)
+                {
+                    for (uint32_t x = 0; x < CLUSTER_COUNT_X; ++x)
+                    {
+                        // Calculate the cluster's view space bounds from its tile corners at the slice's near and far depths
+                        glm::vec3 clusterMin{ std::numeric_limits<float>::max() };
+                        glm::vec3 clusterMax{ std::numeric_limits<float>::lowest() };
+                        for (uint32_t corner = 0; corner < 4; ++corner)
+                        {
+                            const auto cornerIndex = ((y + (corner / 2)) * TILE_CORNER_COUNT_X) + x + (corner % 2);
+                            const auto& nearCorner = nearCorners[cornerIndex];
+                            const auto cornerDirection = farCorners[cornerIndex] - nearCorner;
+                            for (const auto depth : { sliceNearDepth, sliceFarDepth })
+                            {
+                                const auto point = nearCorner + (cornerDirection * ((depth - nearCorner.z) / cornerDirection.z));
+                                clusterMin = glm::min(clusterMin, point);
+                                clusterMax = glm::max(clusterMax, point);
+                            }
+                        }
+
+                        // Test the slice's lights against the cluster bounds
+                        uint32_t clusterLightCount{ 0 };
+                        for (const auto lightIndex : sliceLights)
+                        {
+                            const auto& light = viewSpaceLights[lightIndex];
+                            const auto lightPosition = glm::vec3(light);
+                            const auto closestPoint = glm::clamp(lightPosition, clusterMin, clusterMax);
+                            const auto offset = closestPoint - lightPosition;
+                            if (glm::dot(offset, offset) <= light.w * light.w)
+                            {
+                                sliceLightIndices.push_back(lightIndex);
+                                ++clusterLightCount;
+                            }
+                        }
+
+                        gClusterLightCounts[(z * CLUSTER_COUNT_X * CLUSTER_COUNT_Y) + (y * CLUSTER_COUNT_X) + x] = clusterLightCount;
+                    }
+                }
+            }
+        });
+
+    // Pack each slice's light indices into the light grid. Lights past the light index capacity are dropped
+    uint32_t lightIndexCount{ 0 };
+    for (uint32_t z = 0; z < CLUSTER_COUNT_Z; ++z)
+    {
+        const auto& sliceLightIndices = gSliceLightIndices[z];
+        size_t sliceOffset{ 0 };
+
+        for (uint32_t cluster = z * CLUSTER_COUNT_X * CLUSTER_COUNT_Y; cluster < (z + 1) * CLUSTER_COUNT_X * CLUSTER_COUNT_Y; ++cluster)
+        {
+            const auto clusterLightCount = gClusterLightCounts[cluster];
+            const auto packedLightCount = std::min(clusterLightCount, MAX_CLUSTER_LIGHT_INDICES - lightIndexCount);
+
+            std::copy_n(sliceLightIndices.begin() + sliceOffset, packedLightCount, clusterGrid.LightIndices.begin() + lightIndexCount);
+            clusterGrid.Clusters[cluster] = { lightIndexCount, packedLightCount };
+
+            lightIndexCount += packedLightCount;
+            sliceOffset += clusterLightCount;
+        }
+    }
+}
+
+// Records the static draws of each view layout slot into the frame's secondary command buffers. The command buffers are recorded again
+// whenever the frame's static descriptor set is written
+static bool RecordStaticCommandBuffers(const size_t frameIndex)
+{
+    // Describe inheritance info. The secondary command buffers execute inside the static scene render pass
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = gRenderGraph.GetRenderPass(gStaticScenePass);
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    for (size_t slot = 0; slot < VIEW_LAYOUT_SLOT_COUNT; ++slot)
+    {
+        auto commandBuffer = gStaticCommandBuffers[(frameIndex * VIEW_LAYOUT_SLOT_COUNT) + slot];
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        RecordCommandList(commandBuffer, gStaticCommandLists[slot], gStaticDescriptorSets[frameIndex], frameIndex);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Streams texture mips in and out of texture memory for the mips requested last frame. Uploads are recorded into the current frame's
+// command buffer ahead of its render passes
+static bool StreamTextures()
 {
-    // Wait for the previous frame to finish executing on the GPU
-    if (vkWaitForFences(gDevice, 1, &gInFlightFences[gCurrentFrame], VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION) != VK_SUCCESS)
+    // Replace the image of each texture whose resident mips changed with an image holding only the resident mips
+    std::vector<Renderer::TextureResidencyChange> residencyChanges;
+    gTextureStreamer.Update(residencyChanges);
+    for (const auto& residencyChange : residencyChanges)
     {
-        return false;
+        auto& texture = gLoadedTextures[residencyChange.TextureID];
+
+        // The replaced image is destroyed once every frame that could have used it has finished
+        DeferImageDestruction(texture.GetImage(), texture.GetImageMemory(), texture.GetImageView());
+
+        const auto& mips = texture.GetMips();
+        if (!CreateTextureImage(texture, mips.data() + residencyChange.ResidentMip, static_cast<uint32_t>(mips.size()) - residencyChange.ResidentMip, true))
+        {
+            return false;
+        }
+        texture.SetResidentMip(residencyChange.ResidentMip);
     }
 
-    // Get the next available swapchain image
-    if (vkAcquireNextImageKHR(gDevice,
-        gSwapchain,
-        std::chrono::nanoseconds::max().count(),
-        gImageAvailableSemaphores[gCurrentFrame],
-        VK_NULL_HANDLE,
-        &gImageIndex) != VK_SUCCESS)
+    // Every frame's descriptor sets point at the replaced images until they are written
+    if (!residencyChanges.empty())
     {
-        return false;
+        gStaleTextureDescriptorSets.assign(gStaleTextureDescriptorSets.size(), true);
     }
 
-    // Check if a previous frame is using the current image
-    if (gImagesInFlight[gImageIndex] != VK_NULL_HANDLE)
+    // The current frame's descriptor sets are no longer in use by the device so they can be written. Writing the static descriptor set
+    // invalidates the static command buffers that bind it so they are recorded again
+    if (gStaleTextureDescriptorSets[gCurrentFrame])
     {
-        // Wait for the GPU to signal the fence it is finished writing to the image
-        vkWaitForFences(gDevice, 1, &gImagesInFlight[gImageIndex], VK_TRUE, MAX_SYNCHRONIZATION_TIMEOUT_DURATION);
+        WriteTextureDescriptors(gDescriptorSets[gCurrentFrame]);
+        if (gStaticCommandBuffersRecorded)
+        {
+            WriteTextureDescriptors(gStaticDescriptorSets[gCurrentFrame]);
+            if (!RecordStaticCommandBuffers(gCurrentFrame))
+            {
+                return false;
+            }
+        }
+
+        gStaleTextureDescriptorSets[gCurrentFrame] = false;
     }
-    // Set the image as in use by the current frame
-    gImagesInFlight[gImageIndex] = gInFlightFences[gCurrentFrame];
 
-    // Describe command buffer begin info 
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    return true;
+}
 
-    // Begin recording command buffer
-    gCurrentFrameCommandBuffer = gGraphicsCommandBuffers[gCurrentFrame];
-    if (vkBeginCommandBuffer(gCurrentFrameCommandBuffer, &beginInfo) != VK_SUCCESS)
+bool Renderer::BeginFrame(const Renderer::DirectionalLight& directionalLight)
+{
+    // Wait for the frame's resources and begin recording its command buffer. The null backend has no device to wait on
+    if (gBackend == Renderer::EBackend::VULKAN && (!AcquireNextFrame() || !StreamTextures()))
     {
         return false;
     }
 
-    // Describe render area
-    VkRect2D renderArea{};
-    renderArea.offset.x = 0;
-    renderArea.offset.y = 0;
-    renderArea.extent.width = gSurfaceWidth;
-    renderArea.extent.height = gSurfaceHeight;
-
-    // Describe attachment clear values
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color.float32[0] = CLEAR_COLOR.r;
-    clearValues[0].color.float32[1] = CLEAR_COLOR.g;
-    clearValues[0].color.float32[2] = CLEAR_COLOR.b;
-    clearValues[0].color.float32[3] = CLEAR_COLOR.a;
-
-    clearValues[1].depthStencil = { 1.0f, 0 };
-
-    // Describe render pass begin info
-    VkRenderPassBeginInfo renderPassBeginInfo{};
-    renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassBeginInfo.renderPass = gRenderPass;
-    renderPassBeginInfo.framebuffer = gFramebuffers[gImageIndex];
-    renderPassBeginInfo.renderArea = renderArea;
-    renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassBeginInfo.pClearValues = clearValues.data();
-
-    // Begin render pass
-    vkCmdBeginRenderPass(gCurrentFrameCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    // Bind graphics pipeline
-    vkCmdBindPipeline(gCurrentFrameCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, gGraphicsPipeline);
-
     // Update per frame uniforms with this frame's data
     PerFrameUniforms perFrameUniforms{};
 
     auto directionLightColorIntensity = directionalLight.GetColor() * directionalLight.GetIntensity();
     perFrameUniforms.DirectionalLightColor = glm::vec4(directionLightColorIntensity.r, directionLightColorIntensity.g, directionLightColorIntensity.b, 1.0f);
     perFrameUniforms.DirectionalLightWorldSpaceDirection = glm::vec4(directionalLight.GetDirection(), 0.0f);
+    perFrameUniforms.Time = std::chrono::duration<float>(std::chrono::steady_clock::now() - gInitTime).count();
 
     // Copy per frame uniform buffer
     memcpy(gMappedPerFrameUniformBuffers[gCurrentFrame], &perFrameUniforms, sizeof(PerFrameUniforms));
@@ -2528,24 +4425,32 @@ bool Renderer::BeginFrame(const Renderer::DirectionalLight& directionalLight)
     return true;
 }
 
-void Renderer::BeginRenderPass(const glm::vec3& viewPosition,
+// Begins a render pass viewing the scene through a camera into a region of the surface
+static void BeginViewRenderPass(const glm::vec3& viewPosition,
     const glm::vec3& viewRotation,
-    const Renderer::CameraSettings& cameraSettings)
+    const Renderer::CameraSettings& cameraSettings,
+    const VkRect2D& viewport,
+    const uint32_t viewIndex)
 {
     assert(gRenderPassCount < MAX_RENDER_PASS_COUNT && "An unsupported amount of render passes are begun this frame.");
 
     PerRenderPassUniforms perRenderPassUniforms{};
 
     perRenderPassUniforms.ViewMatrix = Maths::CalculateViewMatrix(viewPosition, viewRotation);
+    gRenderPassViewMatrix = perRenderPassUniforms.ViewMatrix;
+    gRenderPassViewport = viewport;
+    gRenderPassViewIndex = viewIndex;
 
     if (cameraSettings.ProjectionMode == Renderer::EProjectionMode::PERSPECTIVE)
     {
         perRenderPassUniforms.ProjectionMatrix = Maths::CalculatePerspectiveProjectionMatrix(
             cameraSettings.PerspectiveFOV,
-            gViewport.width,
-            gViewport.height,
+            static_cast<float>(viewport.extent.width),
+            static_cast<float>(viewport.extent.height),
             cameraSettings.PerspectiveNearClipPlane,
             cameraSettings.PerspectiveFarClipPlane);
+        gRenderPassNearClipPlane = cameraSettings.PerspectiveNearClipPlane;
+        gRenderPassFarClipPlane = cameraSettings.PerspectiveFarClipPlane;
     }
     else
     {
@@ -2554,9 +4459,14 @@ void Renderer::BeginRenderPass(const glm::vec3& viewPosition,
             cameraSettings.AspectHeight * cameraSettings.OrthographicWidth,
             cameraSettings.OrthographicNearClipPlane,
             cameraSettings.OrthographicFarClipPlane);
+        gRenderPassNearClipPlane = cameraSettings.OrthographicNearClipPlane;
+        gRenderPassFarClipPlane = cameraSettings.OrthographicFarClipPlane;
     }
 
+    gRenderPassProjectionMatrix = perRenderPassUniforms.ProjectionMatrix;
+
     perRenderPassUniforms.CameraWorldSpacePosition = glm::vec4(viewPosition.x, viewPosition.y, viewPosition.z, 1.0f);
+    perRenderPassUniforms.ViewIndex = viewIndex;
 
     // Copy per frame uniform buffer
     memcpy(static_cast<uint8_t*>(gMappedPerRenderPassUniformBuffers[gCurrentFrame]) + (static_cast<uint64_t>(gRenderPassCount) * gMinUniformBufferOffsetAlignment), 
@@ -2568,147 +4478,176 @@ void Renderer::BeginRenderPass(const glm::vec3& viewPosition,
     ++gRenderPassCount;
 }
 
-bool Renderer::EndFrame()
+void Renderer::BeginRenderPass(const glm::vec3& viewPosition,
+    const glm::vec3& viewRotation,
+    const Renderer::CameraSettings& cameraSettings)
 {
-    // End render pass
-    vkCmdEndRenderPass(gCurrentFrameCommandBuffer);
-
-    // End recording command buffer
-    if (vkEndCommandBuffer(gCurrentFrameCommandBuffer) != VK_SUCCESS)
-    {
-        return false;
-    }
-
-    // Get the current in flight frame's wait and signal semaphores
-    VkSemaphore waitSemaphores[] = { gImageAvailableSemaphores[gCurrentFrame] };
-    VkSemaphore signalSemaphores[] = { gRenderFinishedSemaphores[gCurrentFrame] };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-
-    // Describe submit info
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = _countof(waitSemaphores);
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &gCurrentFrameCommandBuffer;
-    submitInfo.signalSemaphoreCount = _countof(signalSemaphores);
-    submitInfo.pSignalSemaphores = signalSemaphores;
+    BeginViewRenderPass(viewPosition, viewRotation, cameraSettings, gScissor, 0);
+}
 
-    // Reset the current frame's fence
-    if (vkResetFences(gDevice, 1, &gInFlightFences[gCurrentFrame]) != VK_SUCCESS)
+bool Renderer::EndFrame()
+{
+    // Clear the light grid when no point lights were submitted this frame
+    if (!gLightGridBuilt)
     {
-        return false;
+        SubmitPointLights(nullptr, 0);
     }
 
-    // Submit command buffer signalling the current frame's fence
-    if (vkQueueSubmit(gGraphicsQueue, 1, &submitInfo, gInFlightFences[gCurrentFrame]) != VK_SUCCESS)
+    if (gBackend == Renderer::EBackend::VULKAN)
     {
-        return false;
+        // Record the frame's command lists, submit the frame and present it
+        if (!SubmitAndPresentFrame())
+        {
+            return false;
+        }
     }
-
-    // Describe present info
-    VkResult presentResult = VkResult::VK_RESULT_MAX_ENUM;
-    VkPresentInfoKHR presentInfo{};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    presentInfo.waitSemaphoreCount = _countof(signalSemaphores);
-    presentInfo.pWaitSemaphores = signalSemaphores;
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = &gSwapchain;
-    presentInfo.pImageIndices = &gImageIndex;
-    presentInfo.pResults = &presentResult;
-
-    // Queue the current frame's image for presentation
-    if (vkQueuePresentKHR(gGraphicsQueue, &presentInfo) != VK_SUCCESS)
+    else
     {
-        return false;
-    }
+        // Backends without a device count the recorded commands
+        gCommandStatistics = {};
+        for (uint32_t i = 0; i < gViewCount; ++i)
+        {
+            gStaticCommandLists[GetViewLayoutSlot(i, gViewCount)].CountCommands(gCommandStatistics);
+        }
+        gSceneCommandList.CountCommands(gCommandStatistics);
+        gHUDCommandList.CountCommands(gCommandStatistics);
 
-    // Check the present result for errors
-    if (presentResult != VK_SUCCESS)
-    {
-        return false;
+        if (gBackend == Renderer::EBackend::SOFTWARE)
+        {
+            RasterizeAndPresentSoftwareFrame();
+        }
     }
 
     gCurrentFrame = (gCurrentFrame + 1) % gSwapchainImageCount;
+    ++gFrameNumber;
     gDrawItemSubmitCount = 0;
     gRenderPassCount = 0;
+    gViewCount = 0;
+    gSpriteSubmitCount = 0;
+    gLightGridBuilt = false;
+    gSceneCommandList.Reset();
+    gHUDCommandList.Reset();
 
     return true;
 }
 
-bool Renderer::Submit(
-    const Renderer::DrawItem* drawItems,
-    uint32_t drawItemCount
-)
+// Copies the per object uniforms of draw items submitted this frame. Returns the index of the first draw item's uniforms. Every view
+// drawing the draw items shares their uniforms
+static uint32_t WriteDrawItemUniforms(const Renderer::DrawItem* drawItems, const uint32_t drawItemCount)
 {
-    assert(gDrawItemSubmitCount < MAX_DRAW_ITEMS_PER_FRAME && "Unsupported number of draw items submitted to the renderer this frame.");
-
-    // Update per object uniforms with this frame's submitted draw items
-    PerObjectUniforms perObjectUniforms{};
+    assert(gDrawItemSubmitCount + drawItemCount <= MAX_DRAW_ITEMS_PER_FRAME && "Unsupported number of draw items submitted to the renderer this frame.");
 
     for (uint32_t i = 0; i < drawItemCount; ++i)
     {
-        const auto& drawItem = drawItems[i];
-        perObjectUniforms.WorldMatrix = drawItem.GetWorldMatrix();
+        // Copy per object uniform buffer. An object's world matrix is stored as 64 bytes in 256 byte contiguous chunks
+        // This is due to the GPU's (Nvidia GTX 1080) minUniformBufferOffsetAlignment requiring 256 byte offsets
+        WritePerObjectUniforms(drawItems[i],
+            static_cast<uint8_t*>(gMappedPerObjectUniformBuffers[gCurrentFrame]) + ((static_cast<uint64_t>(i) + gDrawItemSubmitCount) * gMinUniformBufferOffsetAlignment));
+    }
 
-        glm::mat3 worldMatrix3x3 = drawItem.GetWorldMatrix();
-        perObjectUniforms.NormalMatrix = glm::inverse(glm::transpose(worldMatrix3x3));
+    const auto firstUniformIndex = gDrawItemSubmitCount;
+    gDrawItemSubmitCount += drawItemCount;
 
-        perObjectUniforms.SamplerID = drawItem.GetSamplerID();
-        perObjectUniforms.TextureID = drawItem.GetTextureID();
-        const auto& textureScale = drawItem.GetTextureScale();
-        perObjectUniforms.Data1.r = textureScale.r;
-        perObjectUniforms.Data1.g = textureScale.g;
+    return firstUniformIndex;
+}
 
-        // Copy per object uniform buffer. An object's world matrix is stored as 64 bytes in 256 byte contiguous chunks
-        // This is due to the GPU's (Nvidia GTX 1080) minUniformBufferOffsetAlignment requiring 256 byte offsets
-        memcpy(static_cast<uint8_t*>(gMappedPerObjectUniformBuffers[gCurrentFrame]) + ((static_cast<uint64_t>(i) + gDrawItemSubmitCount) * gMinUniformBufferOffsetAlignment), 
-            &perObjectUniforms, sizeof(perObjectUniforms));
+// Returns the world space bounding sphere of geometry drawn with the world matrix. The radius is scaled by the largest axis scale
+static glm::vec4 CalculateWorldBoundingSphere(const uint32_t geometryID, const glm::mat4& worldMatrix)
+{
+    const auto& localSphere = gLoadedGeometry[geometryID].GetBoundingSphere();
+    const auto maxScale = std::max({ glm::length(glm::vec3(worldMatrix[0])), glm::length(glm::vec3(worldMatrix[1])),
+        glm::length(glm::vec3(worldMatrix[2])) });
+    return glm::vec4(glm::vec3(worldMatrix * glm::vec4(glm::vec3(localSphere), 1.0f)), localSphere.w * maxScale);
+}
+
+// Requests the mip of the material's texture needed by the geometry's size on screen in the current render pass from the texture
+// streamer
+static void RequestTextureMip(const uint32_t materialID, const uint32_t geometryID, const glm::vec4& worldBoundingSphere)
+{
+    const auto& material = gMaterials[materialID];
+    if (!gTextureStreamer.IsRegistered(material.TextureID))
+    {
+        return;
     }
 
-    // For each submitted draw item
-    for (uint32_t i = 0; i < drawItemCount; ++i)
+    // Texels spanned by the geometry's texture coordinates
+    const auto& baseMip = gLoadedTextures[material.TextureID].GetMips()[0];
+    const auto texelCount = gLoadedGeometry[geometryID].GetTextureCoordExtent() * std::max(material.TextureScale.x, material.TextureScale.y) *
+        static_cast<float>(std::max(baseMip.Width, baseMip.Height));
+
+    // Pixels spanned by the bounding sphere's diameter. Perspective projections measure it at the sphere's nearest depth to the camera
+    auto pixelCount = worldBoundingSphere.w * gRenderPassProjectionMatrix[1][1] * static_cast<float>(gRenderPassViewport.extent.height);
+    if (gRenderPassProjectionMatrix[3][3] == 0.0f)
     {
-        assert(drawItems[i].GetGeometryID() < MAX_LOADED_GEOMETRY_COUNT && "Draw item geometry ID is invalid.");
+        const auto viewDepth = (gRenderPassViewMatrix * glm::vec4(glm::vec3(worldBoundingSphere), 1.0f)).z - worldBoundingSphere.w;
+        pixelCount /= std::max(viewDepth, gRenderPassNearClipPlane);
+    }
+
+    gTextureStreamer.Request(material.TextureID, Renderer::CalculateRequiredMip(texelCount, pixelCount));
+}
 
-        // Set dynamic offset for the per object uniform buffer
-        gDynamicOffsets[PER_OBJECT_UNIFORMS_DYNAMIC_OFFSET_INDEX] = (i + gDrawItemSubmitCount) * static_cast<uint32_t>(gMinUniformBufferOffsetAlignment);
+// Records the draw of a draw item in the current render pass. Draw items are drawn with the pipeline permutation of their material
+static void RecordDrawItem(const Renderer::DrawItem& drawItem, const uint32_t uniformIndex)
+{
+    const auto geometryID = drawItem.GetGeometryID();
+    assert(geometryID < MAX_LOADED_GEOMETRY_COUNT && "Draw item geometry ID is invalid.");
 
-        // Bind descriptor set for the current frame
-        vkCmdBindDescriptorSets(gCurrentFrameCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, gGraphicsPipelineLayout, 
-            0, 1, &gDescriptorSets[gCurrentFrame],
-            static_cast<uint32_t>(gDynamicOffsets.size()), gDynamicOffsets.data());
+    gSceneCommandList.BindPipeline(GetMaterialPipelineState(Renderer::EPipeline::MESH, gMaterials[drawItem.GetMaterialID()]));
 
-        // Get geometry instance from draw item
-        auto& geometry = gLoadedGeometry[drawItems[i].GetGeometryID()];
+    // Set dynamic offset for the per object uniform buffer
+    gDynamicOffsets[PER_OBJECT_UNIFORMS_DYNAMIC_OFFSET_INDEX] = uniformIndex * static_cast<uint32_t>(gMinUniformBufferOffsetAlignment);
 
-        // Bind vertex buffers
-        const VkBuffer vertexBuffers[] = { geometry.GetVertexBuffer() };
-        const VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(gCurrentFrameCommandBuffer, 0, _countof(vertexBuffers), vertexBuffers, offsets);
+    gSceneCommandList.BindBuffers(Renderer::EBufferSource::GEOMETRY, geometryID);
+    gSceneCommandList.SetDrawData(gDynamicOffsets[PER_OBJECT_UNIFORMS_DYNAMIC_OFFSET_INDEX], gDynamicOffsets[PER_RENDER_PASS_UNIFORMS_DYNAMIC_OFFSET_INDEX]);
+    gSceneCommandList.DrawIndexed(gLoadedGeometry[geometryID].GetIndexCount(), 0);
+}
 
-        // Bind index buffer
-        vkCmdBindIndexBuffer(gCurrentFrameCommandBuffer, geometry.GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+bool Renderer::Submit(
+    const Renderer::DrawItem* drawItems,
+    uint32_t drawItemCount
+)
+{
+    // Update per object uniforms with this frame's submitted draw items
+    const auto firstUniformIndex = WriteDrawItemUniforms(drawItems, drawItemCount);
 
-        // Draw
-        vkCmdDrawIndexed(gCurrentFrameCommandBuffer, geometry.GetIndexCount(), 1, 0, 0, 0);
+    // Record commands for each submitted draw item
+    for (uint32_t i = 0; i < drawItemCount; ++i)
+    {
+        const auto& drawItem = drawItems[i];
+        RequestTextureMip(drawItem.GetMaterialID(), drawItem.GetGeometryID(),
+            CalculateWorldBoundingSphere(drawItem.GetGeometryID(), drawItem.GetWorldMatrix()));
+        RecordDrawItem(drawItem, firstUniformIndex + i);
     }
 
-    gDrawItemSubmitCount += drawItemCount;
-
     return true;
 }
 
-bool Renderer::SubmitLevel(Level& level)
+bool Renderer::SubmitLevel(Level& level, const View* views, uint32_t viewCount, const float interpolation)
 {
+    assert(viewCount > 0 && viewCount <= MAX_VIEW_COUNT && "Unsupported number of views submitted to the renderer this frame.");
+    assert(gRenderPassCount == 0 && "Views must be the first render passes begun in a frame as static draws read their uniforms.");
+
     // Get the level's ecs registry
     auto& ecsRegistry = level.GetECSRegistry();
 
-    // Sort static meshes so that meshes with an alpha blended material are drawn last
+    // Sort static meshes so that meshes with an alpha blended material are drawn last. Meshes are grouped by lighting model and material
+    // within each group
     ecsRegistry.sort<StaticMeshComponent>([](const auto& lhs, const auto& rhs)
         {
-            return lhs.Material.AlphaBlended < rhs.Material.AlphaBlended;
+            const auto& lhsMaterial = gMaterials[lhs.MaterialID];
+            const auto& rhsMaterial = gMaterials[rhs.MaterialID];
+            if (lhsMaterial.AlphaBlended != rhsMaterial.AlphaBlended)
+            {
+                return lhsMaterial.AlphaBlended < rhsMaterial.AlphaBlended;
+            }
+
+            // Group meshes drawn with the same pipeline permutation
+            if (lhsMaterial.LightingModel != rhsMaterial.LightingModel)
+            {
+                return lhsMaterial.LightingModel < rhsMaterial.LightingModel;
+            }
+
+            return lhs.MaterialID < rhs.MaterialID;
         });
 
     // TODO Sort static meshes with an alpha blended material based on distance from the camera
@@ -2716,222 +4655,460 @@ bool Renderer::SubmitLevel(Level& level)
     // Create a view of entities that contain a transform and static mesh component
     auto renderableView = ecsRegistry.view<TransformComponent, StaticMeshComponent>();
     
-    // Build draw items vector
+    // Build draw items vector and the world space bounding sphere of each draw item. The level is extracted once and shared by
+    // every view
     std::vector<Renderer::DrawItem> drawItems;
+    std::vector<glm::vec4> boundingSpheres;
     drawItems.reserve(static_cast<size_t>(renderableView.size_hint()));
+    boundingSpheres.reserve(static_cast<size_t>(renderableView.size_hint()));
 
     // For each entity in the view
     for (auto [renderableEntity, renderableTransform, renderableStaticMesh] : renderableView.each())
     {
-        // Check if the static mesh component is not set to be visible
-        if (!renderableStaticMesh.Visible)
+        // Check if the static mesh component is not set to be visible or was recorded when the level loaded
+        if (!renderableStaticMesh.Visible || renderableStaticMesh.Static)
         {
             // Skip this entity
             continue;
         }
 
         // Construct the draw item
-        drawItems.emplace_back(
+        auto& drawItem = drawItems.emplace_back(
             renderableStaticMesh.GeometryID,
-            static_cast<Renderer::ESampler>(renderableStaticMesh.Material.SamplerID),
-            renderableStaticMesh.Material.TextureID,
-            renderableStaticMesh.Material.TextureScale,
-            Maths::CalculateWorldMatrix(renderableTransform.Transform)
+            renderableStaticMesh.MaterialID,
+            Maths::CalculateWorldMatrix(Interpolation::CalculateRenderTransform(ecsRegistry, renderableEntity, renderableTransform.Transform, interpolation))
         );
+        drawItem.SetFlipbookPhase(renderableStaticMesh.FlipbookPhase);
+
+        boundingSpheres.push_back(CalculateWorldBoundingSphere(renderableStaticMesh.GeometryID, drawItem.GetWorldMatrix()));
     }
 
-    // Submit draw items
-    return Submit(
-        drawItems.data(),
-        static_cast<uint32_t>(drawItems.size())
-    );
+    // Build point lights from entities that contain a transform and point light component
+    std::vector<Renderer::PointLight> pointLights;
+    for (auto [lightEntity, lightTransform, light] : ecsRegistry.view<TransformComponent, PointLightComponent>().each())
+    {
+        if (!light.Enabled)
+        {
+            continue;
+        }
+
+        auto& pointLight = pointLights.emplace_back();
+        pointLight.Position = Interpolation::CalculateRenderTransform(ecsRegistry, lightEntity, lightTransform.Transform, interpolation).Position;
+        pointLight.Color = light.Color;
+        pointLight.Intensity = light.Intensity;
+        pointLight.Radius = light.Radius;
+    }
+
+    // Write the per object uniforms and point lights once for every view
+    assert(!gLightGridBuilt && "Point lights have already been submitted this frame.");
+    const auto firstUniformIndex = WriteDrawItemUniforms(drawItems.data(), static_cast<uint32_t>(drawItems.size()));
+    WritePointLights(pointLights.data(), static_cast<uint32_t>(pointLights.size()));
+
+    // Only culling, light binning and per render pass uniforms are repeated for each view
+    for (uint32_t viewIndex = 0; viewIndex < viewCount; ++viewIndex)
+    {
+        const auto& view = views[viewIndex];
+        const auto viewport = CalculateViewViewport(viewIndex, viewCount);
+        BeginViewRenderPass(view.Position, view.Rotation, view.CameraSettings, viewport, viewIndex);
+        BinPointLights();
+
+        gSceneCommandList.SetViewport(static_cast<uint32_t>(viewport.offset.x), static_cast<uint32_t>(viewport.offset.y),
+            viewport.extent.width, viewport.extent.height);
+
+        // Draw the draw items whose bounding spheres intersect the view's frustum
+        const auto frustumPlanes = Maths::CalculateFrustumPlanes(gRenderPassProjectionMatrix * gRenderPassViewMatrix);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(drawItems.size()); ++i)
+        {
+            const auto& sphere = boundingSpheres[i];
+            if (Maths::SphereIntersectsFrustum(glm::vec3(sphere), sphere.w, frustumPlanes))
+            {
+                RequestTextureMip(drawItems[i].GetMaterialID(), drawItems[i].GetGeometryID(), sphere);
+                RecordDrawItem(drawItems[i], firstUniformIndex + i);
+            }
+        }
+
+        // Request the textures of the static draws. Merged geometry is in world space
+        for (const auto& staticDrawItem : gStaticDrawItems)
+        {
+            const auto& sphere = gLoadedGeometry[staticDrawItem.GetGeometryID()].GetBoundingSphere();
+            if (Maths::SphereIntersectsFrustum(glm::vec3(sphere), sphere.w, frustumPlanes))
+            {
+                RequestTextureMip(staticDrawItem.GetMaterialID(), staticDrawItem.GetGeometryID(), sphere);
+            }
+        }
+    }
+
+    gLightGridBuilt = true;
+    gViewCount = viewCount;
+
+    return true;
 }
 
-bool Renderer::SubmitHUD(HUD& hud)
+bool Renderer::SubmitPointLights(const Renderer::PointLight* pointLights, uint32_t pointLightCount)
 {
-    // Get the HUD's ecs registry
-    auto& ecsRegistry = hud.GetECSRegistry();
+    assert(!gLightGridBuilt && "Point lights have already been submitted this frame.");
 
-    // Sort static meshes so that meshes with an alpha blended material are drawn last
-    ecsRegistry.sort<StaticMeshComponent>([](const auto& lhs, const auto& rhs)
-        {
-            return lhs.Material.AlphaBlended < rhs.Material.AlphaBlended;
-        });
+    WritePointLights(pointLights, pointLightCount);
+    BinPointLights();
+    gLightGridBuilt = true;
 
-    // Create a view of entities that contain a transform and static mesh component
-    auto renderableView = ecsRegistry.view<TransformComponent, StaticMeshComponent>();
+    return true;
+}
 
-    // Build draw items vector
-    std::vector<Renderer::DrawItem> drawItems;
-    drawItems.reserve(static_cast<size_t>(renderableView.size_hint()));
+bool Renderer::RecordStaticGeometry(Level& level)
+{
+    // Destroy the geometry merged for the previous level
+    for (const auto id : gMergedGeometryIDs)
+    {
+        DestroyGeometry(id);
+    }
+    gMergedGeometryIDs.clear();
+    gStaticDrawItems.clear();
 
-    // For each entity in the view
+    // Destroy the lightmap baked for the previous level
+    if (gLightmapLoaded)
+    {
+        DestroyTexture(gLightmapTextureID);
+        gLightmapLoaded = false;
+    }
+
+    // Static meshes merged into a single geometry for each material
+    struct MergedGeometry
+    {
+        uint32_t MaterialID{ 0 };
+        std::vector<Vertex1Pos1UV1Norm> Vertices;
+        std::vector<uint32_t> Indices;
+    };
+    std::vector<MergedGeometry> mergedGeometry;
+
+    // Create a view of entities that contain a transform and static mesh component
+    auto renderableView = level.GetECSRegistry().view<TransformComponent, StaticMeshComponent>();
+
+    // Merge the level's static meshes. Transforms are baked into vertex positions and normals and texture scale is baked into
+    // texture coordinates, so meshes whose materials only differ by texture scale are merged together
     for (auto [renderableEntity, renderableTransform, renderableStaticMesh] : renderableView.each())
     {
-        // Check if the static mesh component is not set to be visible
-        if (!renderableStaticMesh.Visible)
+        if (!renderableStaticMesh.Visible || !renderableStaticMesh.Static)
         {
-            // Skip this entity
             continue;
         }
 
-        // Construct the draw item
-        drawItems.emplace_back(
-            renderableStaticMesh.GeometryID,
-            static_cast<Renderer::ESampler>(renderableStaticMesh.Material.SamplerID),
-            renderableStaticMesh.Material.TextureID,
-            renderableStaticMesh.Material.TextureScale,
-            Maths::CalculateWorldMatrix(renderableTransform.Transform)
-        );
+        const auto material = GetMaterial(renderableStaticMesh.MaterialID);
+        assert(!material.AlphaBlended && "Static meshes must be opaque as they are drawn before dynamic meshes.");
+
+        // Find the merged geometry for the material without texture scale
+        auto mergedMaterial = material;
+        mergedMaterial.TextureScale = { 1.0f, 1.0f };
+        const auto mergedMaterialID = RegisterMaterial(mergedMaterial);
+
+        auto merged = std::find_if(mergedGeometry.begin(), mergedGeometry.end(),
+            [mergedMaterialID](const auto& geometry) { return geometry.MaterialID == mergedMaterialID; });
+        if (merged == mergedGeometry.end())
+        {
+            merged = mergedGeometry.insert(mergedGeometry.end(), MergedGeometry{ mergedMaterialID });
+        }
+
+        // Append the mesh's vertices transformed to world space
+        const auto worldMatrix = Maths::CalculateWorldMatrix(renderableTransform.Transform);
+        const auto normalMatrix = glm::inverse(glm::transpose(glm::mat3(worldMatrix)));
+        const auto& geometry = gLoadedGeometry[renderableStaticMesh.GeometryID];
+        const auto baseVertex = static_cast<uint32_t>(merged->Vertices.size());
+
+        for (const auto& vertex : geometry.GetVertices())
+        {
+            merged->Vertices.emplace_back(
+                glm::vec3(worldMatrix * glm::vec4(vertex.Pos, 1.0f)),
+                vertex.UV * material.TextureScale,
+                glm::normalize(normalMatrix * vertex.Norm));
+        }
+
+        for (const auto index : geometry.GetIndices())
+        {
+            merged->Indices.push_back(baseVertex + index);
+        }
+    }
+
+    // Expand the merged geometry into one unindexed triangle list so each triangle can be given its own lightmap chart
+    std::vector<Vertex1Pos2UV1Norm> lightmappedVertices;
+    std::vector<size_t> mergedGeometryFirstVertices;
+    for (const auto& merged : mergedGeometry)
+    {
+        mergedGeometryFirstVertices.push_back(lightmappedVertices.size());
+        for (const auto index : merged.Indices)
+        {
+            const auto& vertex = merged.Vertices[index];
+            lightmappedVertices.emplace_back(vertex.Pos, vertex.UV, glm::vec2(0.0f, 0.0f), vertex.Norm);
+        }
+    }
+    mergedGeometryFirstVertices.push_back(lightmappedVertices.size());
+
+    // Bake the lightmap unless a lightmap baked from the same geometry and lighting is cached with the level's assets
+    if (!lightmappedVertices.empty())
+    {
+        Lightmap lightmap{};
+        GenerateLightmapUVs(lightmappedVertices, level.GetDirectionalLight(), lightmap);
+
+        const auto& lightmapFilepath = level.GetLightmapAssetFilepath();
+        if (lightmapFilepath.empty() || !ReadLightmap(lightmapFilepath, lightmap.Key, lightmap))
+        {
+            BakeLightmap(lightmappedVertices, level.GetDirectionalLight(), lightmap);
+
+            if (!lightmapFilepath.empty() && !WriteLightmap(lightmapFilepath, lightmap))
+            {
+                LOG("Failed to write lightmap " + lightmapFilepath + ".");
+            }
+        }
+
+        if (!CreateTexture(lightmap.Pixels.data(), static_cast<int32_t>(lightmap.Width), static_cast<int32_t>(lightmap.Height), false,
+            &gLightmapTextureID))
+        {
+            return false;
+        }
+        gLightmapLoaded = true;
+    }
+
+    // Load the lightmapped geometry and build a draw item for each material
+    std::vector<Renderer::DrawItem> drawItems;
+    for (size_t i = 0; i < mergedGeometry.size(); ++i)
+    {
+        const auto firstVertex = mergedGeometryFirstVertices[i];
+        const auto vertexCount = static_cast<uint32_t>(mergedGeometryFirstVertices[i + 1] - firstVertex);
+
+        // Get an available geometry instance
+        assert(!gAvailableGeometryIDs.empty() && "Max loaded geometry count reached.");
+        const auto mergedGeometryID = gAvailableGeometryIDs.front();
+        gAvailableGeometryIDs.pop();
+        gUsedGeometryIDs.push_back(mergedGeometryID);
+        gMergedGeometryIDs.push_back(mergedGeometryID);
+
+        // Lightmapped geometry is unindexed so its indices are sequential
+        std::vector<uint32_t> indices(vertexCount);
+        for (uint32_t index = 0; index < vertexCount; ++index)
+        {
+            indices[index] = index;
+        }
+
+        auto& geometry = gLoadedGeometry[mergedGeometryID];
+        geometry.SetIndexCount(vertexCount);
+        geometry.SetBoundingSphere(CalculateBoundingSphere(mergedGeometry[i].Vertices.data(), static_cast<uint32_t>(mergedGeometry[i].Vertices.size())));
+        geometry.SetTextureCoordExtent(CalculateTextureCoordExtent(mergedGeometry[i].Vertices.data(),
+            static_cast<uint32_t>(mergedGeometry[i].Vertices.size())));
+        if (gBackend == Renderer::EBackend::SOFTWARE)
+        {
+            geometry.GetLightmappedVertices().assign(lightmappedVertices.begin() + firstVertex,
+                lightmappedVertices.begin() + firstVertex + vertexCount);
+        }
+        if (gBackend == Renderer::EBackend::VULKAN && !CreateGeometryBuffers(geometry, &lightmappedVertices[firstVertex],
+            sizeof(Vertex1Pos2UV1Norm) * vertexCount, indices.data(), vertexCount))
+        {
+            return false;
+        }
+
+        drawItems.emplace_back(mergedGeometryID, mergedGeometry[i].MaterialID, glm::identity<glm::mat4>());
     }
 
-    // Submit draw items
-    return Submit(
-        drawItems.data(),
-        static_cast<uint32_t>(drawItems.size())
-    );
-
-    return true;
-}
+    gStaticDrawItems = drawItems;
 
-bool Renderer::LoadGeometry(const Vertex1Pos1UV1Norm* vertices, const uint32_t vertexCount, const uint32_t* indices, const uint32_t indexCount, uint32_t* pID)
-{
-    // Get the queue family indices that will share access to buffer resources
-    const uint32_t sharedAccessQueueFamilyIndices[] = { gQueueFamilyIndices.GetGraphicsFamilyIndex(), gQueueFamilyIndices.GetTransferFamilyIndex() };
+    // Record the static draws for each view of each layout. A view's static draws read the per render pass uniforms of the view's
+    // render pass, which is begun in the order of the views before any other render pass each frame
+    for (uint32_t viewCount = 1; viewCount <= MAX_VIEW_COUNT; ++viewCount)
+    {
+        for (uint32_t viewIndex = 0; viewIndex < viewCount; ++viewIndex)
+        {
+            auto& staticCommandList = gStaticCommandLists[GetViewLayoutSlot(viewIndex, viewCount)];
+            staticCommandList.Reset();
 
-    // Calculate buffer sizes
-    const auto vertexBufferSize = sizeof(Vertex1Pos1UV1Norm) * vertexCount;
-    const auto indexBufferSize = sizeof(uint32_t) * indexCount;
+            const auto viewport = CalculateViewViewport(viewIndex, viewCount);
+            staticCommandList.SetViewport(static_cast<uint32_t>(viewport.offset.x), static_cast<uint32_t>(viewport.offset.y),
+                viewport.extent.width, viewport.extent.height);
 
-    // Assert max loaded geometry count has not been reached
-    assert(!gAvailableGeometryIDs.empty() && "Max loaded geometry count reached.");
+            for (uint32_t i = 0; i < static_cast<uint32_t>(drawItems.size()); ++i)
+            {
+                const auto geometryID = drawItems[i].GetGeometryID();
+                assert(geometryID < MAX_LOADED_GEOMETRY_COUNT && "Draw item geometry ID is invalid.");
 
-    // Get an available geometry instance
-    *pID = gAvailableGeometryIDs.front();
-    gAvailableGeometryIDs.pop();
-    auto& geometry = gLoadedGeometry[*pID];
-    gUsedGeometryIDs.push_back(*pID);
+                staticCommandList.BindPipeline(GetMaterialPipelineState(Renderer::EPipeline::LIGHTMAPPED, GetMaterial(drawItems[i].GetMaterialID())));
 
-    // Create a vertex buffer
-    // Create CPU visible staging buffer for vertex data
-    VkBuffer vertexStagingBuffer;
-    VkDeviceMemory vertexStagingBufferMemory;
-    if (!CreateBuffer(
-        gDevice,
-        gPhysicalDevice,
-        vertexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        VK_SHARING_MODE_EXCLUSIVE,
-        0,
-        nullptr,
-        &vertexStagingBuffer,
-        &vertexStagingBufferMemory))
-    {
-        return false;
+                staticCommandList.BindBuffers(Renderer::EBufferSource::GEOMETRY, geometryID);
+                staticCommandList.SetDrawData(i * static_cast<uint32_t>(gMinUniformBufferOffsetAlignment),
+                    viewIndex * static_cast<uint32_t>(gMinUniformBufferOffsetAlignment));
+                staticCommandList.DrawIndexed(gLoadedGeometry[geometryID].GetIndexCount(), 0);
+            }
+        }
     }
 
-    // Map staging buffer GPU memory
-    void* pData;
-    if (vkMapMemory(gDevice, vertexStagingBufferMemory, 0, vertexBufferSize, 0, &pData) != VK_SUCCESS)
+    // The null and software backends replay the command list without recording it. Static per object uniforms are kept in host memory
+    if (gBackend != Renderer::EBackend::VULKAN)
     {
-        return false;
-    }
-
-    // Upload vertex data to the staging buffer
-    memcpy(pData, vertices, static_cast<size_t>(vertexBufferSize));
+        gHostStaticUniformBuffer.assign(std::max<size_t>(drawItems.size(), 1) * gMinUniformBufferOffsetAlignment, 0);
+        for (size_t i = 0; i < drawItems.size(); ++i)
+        {
+            WritePerObjectUniforms(drawItems[i], gHostStaticUniformBuffer.data() + (i * gMinUniformBufferOffsetAlignment), gLightmapTextureID);
+        }
 
-    // Unmap GPU memory
-    vkUnmapMemory(gDevice, vertexStagingBufferMemory);
+        return true;
+    }
 
-    // Create GPU only vertex buffer
-    if (!CreateBuffer(
-        gDevice,
-        gPhysicalDevice,
-        vertexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        VK_SHARING_MODE_CONCURRENT,
-        _countof(sharedAccessQueueFamilyIndices),
-        sharedAccessQueueFamilyIndices,
-        &geometry.GetVertexBuffer(),
-        &geometry.GetVertexBufferMemory()))
+    // Replace the static per object uniform buffer. The device is idle while a level loads so the previous buffer is not in use
+    gStaticCommandBuffersRecorded = false;
+    if (gStaticUniformBuffer != VK_NULL_HANDLE)
     {
-        return false;
+        DestroyBuffer(gStaticUniformBuffer, gStaticUniformBufferMemory);
+        gStaticUniformBuffer = VK_NULL_HANDLE;
+        gStaticUniformBufferMemory = VK_NULL_HANDLE;
     }
 
-    // Create index buffer
-    // Create CPU visible staging buffer
-    VkBuffer indexStagingBuffer;
-    VkDeviceMemory indexStagingBufferMemory;
+    const auto staticUniformBufferSize = std::max<VkDeviceSize>(drawItems.size(), 1) * gMinUniformBufferOffsetAlignment;
     if (!CreateBuffer(gDevice,
         gPhysicalDevice,
-        indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        staticUniformBufferSize,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         VK_SHARING_MODE_EXCLUSIVE,
         0,
         nullptr,
-        &indexStagingBuffer,
-        &indexStagingBufferMemory))
+        &gStaticUniformBuffer,
+        &gStaticUniformBufferMemory))
     {
         return false;
     }
 
-    // Map staging buffer GPU memory
-    if (vkMapMemory(gDevice, indexStagingBufferMemory, 0, indexBufferSize, 0, &pData) != VK_SUCCESS)
+    // Copy the static per object uniforms. They are not written again until the next level loads
+    void* pMappedStaticUniformBuffer{ nullptr };
+    if (vkMapMemory(gDevice, gStaticUniformBufferMemory, 0, staticUniformBufferSize, 0, &pMappedStaticUniformBuffer) != VK_SUCCESS)
     {
         return false;
     }
 
-    // Upload vertex data to the staging buffer
-    memcpy(pData, indices, static_cast<size_t>(indexBufferSize));
+    for (size_t i = 0; i < drawItems.size(); ++i)
+    {
+        WritePerObjectUniforms(drawItems[i], static_cast<uint8_t*>(pMappedStaticUniformBuffer) + (i * gMinUniformBufferOffsetAlignment),
+            gLightmapTextureID);
+    }
 
-    // Create GPU only index buffer
-    if (!CreateBuffer(
-        gDevice,
-        gPhysicalDevice,
-        indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        VK_SHARING_MODE_CONCURRENT,
-        _countof(sharedAccessQueueFamilyIndices),
-        sharedAccessQueueFamilyIndices,
-        &geometry.GetIndexBuffer(),
-        &geometry.GetIndexBufferMemory()))
+    vkUnmapMemory(gDevice, gStaticUniformBufferMemory);
+
+    // Point the static descriptor sets at the static per object uniforms
+    WriteDescriptorSets(gStaticDescriptorSets, std::vector<VkBuffer>(gSwapchainImageCount, gStaticUniformBuffer));
+
+    // Record a secondary command buffer for each view layout slot of each frame in flight as each frame binds its own descriptor set
+    for (size_t i = 0; i < gStaticCommandBuffers.size() / VIEW_LAYOUT_SLOT_COUNT; ++i)
     {
-        return false;
+        if (!RecordStaticCommandBuffers(i))
+        {
+            return false;
+        }
     }
 
-    // Set index count
-    geometry.SetIndexCount(indexCount);
+    gStaticCommandBuffersRecorded = true;
 
-    // Begin single submit command buffer
-    VkCommandBuffer commandBuffer;
-    if (!BeginSingleSubmitCommandBuffer(gDevice, gTransferTemporaryCommandPool, &commandBuffer))
+    return true;
+}
+
+bool Renderer::SubmitHUD(HUD& hud)
+{
+    const auto& sprites = hud.GetSprites();
+
+    // Submit the HUD's sprites as a single batch
+    return SubmitSprites(sprites.data(), static_cast<uint32_t>(sprites.size()));
+}
+
+bool Renderer::SubmitSprites(const Renderer::Sprite* sprites, uint32_t spriteCount)
+{
+    // Gather visible sprites
+    std::vector<const Renderer::Sprite*> visibleSprites;
+    visibleSprites.reserve(static_cast<size_t>(spriteCount));
+
+    for (uint32_t i = 0; i < spriteCount; ++i)
     {
-        return false;
+        if (sprites[i].Visible)
+        {
+            visibleSprites.push_back(&sprites[i]);
+        }
     }
 
-    // Copy vertex staging buffer to the vertex buffer
-    CopyBuffer(commandBuffer, vertexStagingBuffer, geometry.GetVertexBuffer(), vertexBufferSize);
+    // Early exit if there is nothing to draw
+    if (visibleSprites.empty())
+    {
+        return true;
+    }
+
+    assert(gSpriteSubmitCount + visibleSprites.size() <= MAX_SPRITES_PER_FRAME && "Unsupported number of sprites submitted to the renderer this frame.");
 
-    // Copy index staging buffer to the index buffer
-    CopyBuffer(commandBuffer, indexStagingBuffer, geometry.GetIndexBuffer(), indexBufferSize);
+    // Sort sprites back to front as they are blended without depth testing. Sprites at equal depth keep their submission order
+    std::stable_sort(visibleSprites.begin(), visibleSprites.end(), [](const auto* lhs, const auto* rhs)
+        {
+            return lhs->Position.z > rhs->Position.z;
+        });
 
-    // End single submit command buffer
-    if (!EndAndSubmitSingleSubmitCommandBuffer(gDevice, gTransferTemporaryCommandPool, gTransferQueue, commandBuffer))
+    // Write a quad for each sprite into the current frame's sprite vertex buffer
+    auto* pVertices = static_cast<SpriteVertex*>(gMappedSpriteVertexBuffers[gCurrentFrame]) + (static_cast<size_t>(gSpriteSubmitCount) * SPRITE_VERTEX_COUNT);
+
+    for (const auto* pSprite : visibleSprites)
     {
-        return false;
+        // Sprites are drawn close to their texture's size so their textures are requested at full detail
+        gTextureStreamer.Request(pSprite->TextureID, 0);
+
+        const glm::vec2 halfSize = pSprite->Size * 0.5f;
+        const glm::vec2 min = glm::vec2(pSprite->Position.x, pSprite->Position.y) - halfSize;
+        const glm::vec2 max = glm::vec2(pSprite->Position.x, pSprite->Position.y) + halfSize;
+        const float z = pSprite->Position.z;
+
+        pVertices[0] = { glm::vec3(min.x, min.y, z), glm::vec2(pSprite->UVRect.x, pSprite->UVRect.y), pSprite->Color, pSprite->SamplerID, pSprite->TextureID };
+        pVertices[1] = { glm::vec3(max.x, min.y, z), glm::vec2(pSprite->UVRect.z, pSprite->UVRect.y), pSprite->Color, pSprite->SamplerID, pSprite->TextureID };
+        pVertices[2] = { glm::vec3(max.x, max.y, z), glm::vec2(pSprite->UVRect.z, pSprite->UVRect.w), pSprite->Color, pSprite->SamplerID, pSprite->TextureID };
+        pVertices[3] = { glm::vec3(min.x, max.y, z), glm::vec2(pSprite->UVRect.x, pSprite->UVRect.w), pSprite->Color, pSprite->SamplerID, pSprite->TextureID };
+
+        pVertices += SPRITE_VERTEX_COUNT;
     }
 
-    // Delete staging buffer and memory
-    DestroyBuffer(vertexStagingBuffer, vertexStagingBufferMemory);
-    DestroyBuffer(indexStagingBuffer, indexStagingBufferMemory);
+    // Record a single draw for every sprite in this submission
+    const auto batchSpriteCount = static_cast<uint32_t>(visibleSprites.size());
+    gHUDCommandList.BindPipeline(GetSpritePipelineState());
+    gHUDCommandList.BindBuffers(Renderer::EBufferSource::SPRITE_BATCH);
+    gHUDCommandList.SetDrawData(gDynamicOffsets[PER_OBJECT_UNIFORMS_DYNAMIC_OFFSET_INDEX], gDynamicOffsets[PER_RENDER_PASS_UNIFORMS_DYNAMIC_OFFSET_INDEX]);
+    gHUDCommandList.DrawIndexed(batchSpriteCount * SPRITE_INDEX_COUNT, gSpriteSubmitCount * SPRITE_INDEX_COUNT);
+
+    gSpriteSubmitCount += batchSpriteCount;
 
     return true;
 }
 
+bool Renderer::LoadGeometry(const Vertex1Pos1UV1Norm* vertices, const uint32_t vertexCount, const uint32_t* indices, const uint32_t indexCount, uint32_t* pID)
+{
+    // The null and software backends only track the geometry's ID, index count and host copies
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        assert(!gAvailableGeometryIDs.empty() && "Max loaded geometry count reached.");
+        *pID = gAvailableGeometryIDs.front();
+        gAvailableGeometryIDs.pop();
+        gLoadedGeometry[*pID].SetIndexCount(indexCount);
+        gLoadedGeometry[*pID].SetBoundingSphere(CalculateBoundingSphere(vertices, vertexCount));
+        gLoadedGeometry[*pID].SetTextureCoordExtent(CalculateTextureCoordExtent(vertices, vertexCount));
+        gLoadedGeometry[*pID].GetVertices().assign(vertices, vertices + vertexCount);
+        gLoadedGeometry[*pID].GetIndices().assign(indices, indices + indexCount);
+        gUsedGeometryIDs.push_back(*pID);
+        return true;
+    }
+
+    // Assert max loaded geometry count has not been reached
+    assert(!gAvailableGeometryIDs.empty() && "Max loaded geometry count reached.");
+
+    // Get an available geometry instance
+    *pID = gAvailableGeometryIDs.front();
+    gAvailableGeometryIDs.pop();
+    auto& geometry = gLoadedGeometry[*pID];
+    gUsedGeometryIDs.push_back(*pID);
+
+    // Keep host copies of the vertices and indices
+    geometry.GetVertices().assign(vertices, vertices + vertexCount);
+    geometry.GetIndices().assign(indices, indices + indexCount);
+    geometry.SetBoundingSphere(CalculateBoundingSphere(vertices, vertexCount));
+    geometry.SetTextureCoordExtent(CalculateTextureCoordExtent(vertices, vertexCount));
+
+    return CreateGeometryBuffers(geometry, vertices, sizeof(Vertex1Pos1UV1Norm) * vertexCount, indices, indexCount);
+}
+
 bool Renderer::LoadPlaneGeometryPrimitive(const float width, uint32_t* pID)
 {
     const float halfWidth = width / 2.0f;
@@ -3337,6 +5514,12 @@ bool Renderer::LoadConeGeometryPrimitive(const float baseRadius, const float hei
 
 bool Renderer::LoadTexture(const std::string& textureAssetFilepath, const bool generateMipmaps, uint32_t* pID)
 {
+    // The null backend does not read the texture's pixels
+    if (gBackend == Renderer::EBackend::NULL_BACKEND)
+    {
+        return CreateTexture(nullptr, 0, 0, generateMipmaps, pID);
+    }
+
     // Load the pixels from the texture
     int32_t textureWidth;
     int32_t textureHeight;
@@ -3349,153 +5532,179 @@ bool Renderer::LoadTexture(const std::string& textureAssetFilepath, const bool g
         return false;
     }
 
-    uint32_t mipLevels{ 1 };
-    if (generateMipmaps)
-    {
-        // Calculate the number of mip levels to generate from the texture
-        mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(textureWidth, textureHeight)))) + 1;
-    }
+    // Create the texture from the pixels
+    const auto result = CreateTexture(texturePixels, textureWidth, textureHeight, generateMipmaps, pID);
 
-    // Calculate the size of the image
-    const int32_t channelCount{ 4 };
-    auto imageSize{ static_cast<VkDeviceSize>(textureWidth) * 
-        static_cast<VkDeviceSize>(textureHeight) * 
-        static_cast<VkDeviceSize>(channelCount) };
+    // Free pixel data
+    stbi_image_free(texturePixels);
 
-    // Create staging buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
+    return result;
+}
 
-    if (!CreateBuffer(
-        gDevice,
-        gPhysicalDevice,
-        imageSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        VK_SHARING_MODE_EXCLUSIVE,
-        0,
-        nullptr,
-        &stagingBuffer,
-        &stagingBufferMemory
-    ))
+uint32_t Renderer::RegisterMaterial(const Material& material)
+{
+    // Return the ID of an identical registered material
+    const auto registeredMaterial = std::find(gMaterials.begin(), gMaterials.end(), material);
+    if (registeredMaterial != gMaterials.end())
     {
-        return false;
+        return static_cast<uint32_t>(std::distance(gMaterials.begin(), registeredMaterial));
     }
 
-    // Copy pixels into staging buffer
-    void* pData;
-    if (vkMapMemory(gDevice, stagingBufferMemory, 0, imageSize, 0, &pData) != VK_SUCCESS)
-    {
-        return false;
-    }
-    memcpy(pData, texturePixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(gDevice, stagingBufferMemory);
+    assert(gMaterials.size() < MAX_MATERIAL_COUNT && "Unsupported number of materials registered.");
 
-    // Free pixel data
-    stbi_image_free(texturePixels);
+    const auto id = static_cast<uint32_t>(gMaterials.size());
+    gMaterials.push_back(material);
 
-    // Assert max loaded texture count has not been reached
-    assert(!gAvailableTextureIDs.empty() && "Max loaded texture count reached.");
+    // Upload the material's parameters to the material table
+    MaterialData materialData{};
+    materialData.SamplerID = material.SamplerID;
+    materialData.TextureID = material.TextureID;
+    materialData.TextureScale = material.TextureScale;
+    materialData.FlipbookFrameCount = material.FlipbookFrameCount;
+    materialData.FlipbookColumnCount = material.FlipbookColumnCount;
+    materialData.FlipbookFrameRate = material.FlipbookFrameRate;
+    memcpy(static_cast<MaterialData*>(gMappedMaterialBuffer) + id, &materialData, sizeof(materialData));
 
-    // Get an available texture instance
-    *pID = gAvailableTextureIDs.front();
-    gAvailableTextureIDs.pop();
-    auto& texture = gLoadedTextures[*pID];
-    gUsedTextureIDs.push_back(*pID);
+    return id;
+}
 
-    // Create image and memory for the texture
-    if (!CreateImage(static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight), mipLevels, &texture.GetImage(), &texture.GetImageMemory()))
-    {
-        return false;
-    }
- 
-    // Begin single submit command buffer
-    VkCommandBuffer commandBuffer;
-    if (!BeginSingleSubmitCommandBuffer(gDevice, gGraphicsCommandPool, &commandBuffer))
-    {
-        return false;
-    }
+const Renderer::Material& Renderer::GetMaterial(const uint32_t id)
+{
+    assert(id < gMaterials.size() && "Material ID is invalid.");
+    return gMaterials[id];
+}
 
-    // Transition the image to transfer destination layout
-    TransitionImageLayout(commandBuffer, texture.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+void Renderer::ClearMaterials()
+{
+    gMaterials.clear();
+}
 
-    // Copy staging buffer data into the image
-    CopyBufferToImage(commandBuffer, stagingBuffer, texture.GetImage(), static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+void Renderer::DestroyGeometry(const uint32_t id)
+{
+    auto& destroyedGeometry = gLoadedGeometry[id];
 
-    // Check if mipmaps should be generated for the texture
-    if (generateMipmaps)
+    if (gBackend == Renderer::EBackend::VULKAN)
     {
-        // Generate mipmaps
-        GenerateMipmaps(commandBuffer, texture.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, mipLevels);
+        // Frames in flight may still draw the geometry
+        DeferBufferDestruction(destroyedGeometry.GetVertexBuffer(), destroyedGeometry.GetVertexBufferMemory());
+        DeferBufferDestruction(destroyedGeometry.GetIndexBuffer(), destroyedGeometry.GetIndexBufferMemory());
     }
-    else
+
+    destroyedGeometry.Reset();
+    gUsedGeometryIDs.erase(std::find(gUsedGeometryIDs.begin(), gUsedGeometryIDs.end(), id));
+    gAvailableGeometryIDs.push(id);
+}
+
+void Renderer::DestroyTexture(const uint32_t id)
+{
+    auto& destroyedTexture = gLoadedTextures[id];
+
+    if (gBackend == Renderer::EBackend::VULKAN)
     {
-        // Transition the image to shader read only
-        TransitionImageLayout(commandBuffer, texture.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, mipLevels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        // Frames in flight may still sample the texture
+        DeferImageDestruction(destroyedTexture.GetImage(), destroyedTexture.GetImageMemory(), destroyedTexture.GetImageView());
     }
 
-    // End single submit command buffer
-    if (!EndAndSubmitSingleSubmitCommandBuffer(gDevice, gGraphicsCommandPool, gGraphicsQueue, commandBuffer))
+    if (gTextureStreamer.IsRegistered(id))
     {
-        return false;
+        gTextureStreamer.Unregister(id);
     }
 
-    // Cleanup staging buffer
-    DestroyBuffer(stagingBuffer, stagingBufferMemory);
+    destroyedTexture.Reset();
+    gUsedTextureIDs.erase(std::find(gUsedTextureIDs.begin(), gUsedTextureIDs.end(), id));
+    gAvailableTextureIDs.push(id);
+}
 
-    // Create texture image view
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = texture.GetImage();
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = mipLevels;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
-    viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-    viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+bool Renderer::WaitForIdle()
+{
+    // The null and software backends have no queues
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        return true;
+    }
 
-    if (vkCreateImageView(gDevice, &viewInfo, nullptr, &texture.GetImageView()) != VK_SUCCESS)
+    // Wait for all queues to finish work
+    if ((vkQueueWaitIdle(gGraphicsQueue) != VK_SUCCESS) || (vkQueueWaitIdle(gTransferQueue) != VK_SUCCESS))
     {
         return false;
     }
 
+    // Every submitted frame has finished
+    gFinishedFrameCount = gFrameNumber;
+    ReleaseDeferredDestructions();
+
     return true;
 }
 
-void Renderer::DestroyGeometry(const uint32_t id)
+void Renderer::SetTextureMemoryBudget(const uint64_t bytes)
 {
-    // Wait for all queues to finish work
-    vkQueueWaitIdle(gGraphicsQueue);
-    vkQueueWaitIdle(gTransferQueue);
+    gTextureStreamer.SetBudget(bytes);
+}
 
-    auto& destroyedGeometry = gLoadedGeometry[id];
-    DestroyBuffer(destroyedGeometry.GetVertexBuffer(), destroyedGeometry.GetVertexBufferMemory());
-    DestroyBuffer(destroyedGeometry.GetIndexBuffer(), destroyedGeometry.GetIndexBufferMemory());
-    destroyedGeometry.Reset();
-    gUsedGeometryIDs.erase(std::find(gUsedGeometryIDs.begin(), gUsedGeometryIDs.end(), id));
-    gAvailableGeometryIDs.push(id);
+uint64_t Renderer::GetTextureMemoryUsage()
+{
+    return gTextureStreamer.GetResidentSize();
 }
 
-void Renderer::DestroyTexture(const uint32_t id)
+void Renderer::BeginUploadBatch()
 {
-    // Wait for all queues to finish work
-    vkQueueWaitIdle(gGraphicsQueue) != VK_SUCCESS && vkQueueWaitIdle(gTransferQueue);
+    assert(!gUploadBatchOpen && "An upload batch is already open.");
+    gUploadBatchOpen = true;
+}
 
-    auto& destroyedTexture = gLoadedTextures[id];
-    DestroyImage(destroyedTexture.GetImage(), destroyedTexture.GetImageMemory());
-    vkDestroyImageView(gDevice, destroyedTexture.GetImageView(), nullptr);
-    destroyedTexture.Reset();
-    gUsedTextureIDs.erase(std::find(gUsedTextureIDs.begin(), gUsedTextureIDs.end(), id));
-    gAvailableTextureIDs.push(id);
+bool Renderer::EndUploadBatch()
+{
+    assert(gUploadBatchOpen && "No upload batch is open.");
+
+    // The null and software backends upload nothing to a device
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        gUploadBatchOpen = false;
+        return true;
+    }
+
+    const auto flushed = FlushUploadBatch();
+    gUploadBatchOpen = false;
+
+    return flushed;
 }
 
-bool Renderer::WaitForIdle()
+void Renderer::AbortUploadBatch()
 {
-    // Wait for all queues to finish work
-    return (vkQueueWaitIdle(gGraphicsQueue) == VK_SUCCESS) && (vkQueueWaitIdle(gTransferQueue) == VK_SUCCESS);
+    assert(gUploadBatchOpen && "No upload batch is open.");
+    gUploadBatchOpen = false;
+
+    if (gBackend != Renderer::EBackend::VULKAN)
+    {
+        return;
+    }
+
+    // The recorded command buffers were never submitted so can be freed straight away along with the staging memory they read
+    for (auto& batch : gUploadBatches)
+    {
+        if (batch.CommandBuffer != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(gDevice, batch.CommandPool, 1, &batch.CommandBuffer);
+            batch.CommandBuffer = VK_NULL_HANDLE;
+        }
+    }
+
+    ReleaseUploadStagingMemory();
+}
+
+const Renderer::CommandStatistics& Renderer::GetCommandStatistics()
+{
+    // Only counted by backends without a device
+    return gCommandStatistics;
+}
+
+bool Renderer::WriteFramebuffer(const std::string& filepath)
+{
+    // Only the software backend renders into a CPU framebuffer
+    if (gBackend != Renderer::EBackend::SOFTWARE)
+    {
+        return false;
+    }
+
+    return gSoftwareRasterizer.WriteBitmap(filepath);
 }
@@ -2,8 +2,13 @@
 
 #include "Vertex1Pos1UV1Norm.h"
 #include "DrawItem.h"
+#include "Material.h"
+#include "Sprite.h"
+#include "CommandList.h"
 #include "CameraSettings.h"
+#include "View.h"
 #include "DirectionalLight.h"
+#include "PointLight.h"
 
 class Level;
 class HUD;
@@ -21,13 +26,23 @@ namespace Renderer
 		NONE
 	};
 
+	// Backend that recorded command lists are translated by. The null backend creates no device and only counts commands,
+	// allowing the CPU cost of rendering to be measured on machines without a GPU. The software backend rasterizes command lists on
+	// the CPU into a framebuffer that is presented to the window
+	enum class EBackend : uint8_t
+	{
+		VULKAN = 0,
+		NULL_BACKEND,
+		SOFTWARE
+	};
+
 	enum class ESampler : uint8_t
 	{
 		LINEAR_FILTER = 0,
 		NEAREST_NEIGHBOUR_FILTER = 1,
 	};
 
-	bool Init(const glm::vec2& windowClientAreaResolution, HWND windowHandle);
+	bool Init(const glm::vec2& windowClientAreaResolution, HWND windowHandle, const EBackend backend = EBackend::VULKAN);
 	void UpdateDescriptorSets();
 	bool Shutdown();
 	void SetVulkanDebugReportLevel(const EVulkanDebugReportLevel level);
@@ -39,8 +54,23 @@ namespace Renderer
 	bool Submit(
 		const Renderer::DrawItem* drawItems, 
 		uint32_t drawItemCount);
-	bool SubmitLevel(Level& level);
+	// Renders the level from each view into its own viewport. The level is extracted once and each view only culls the level's
+	// meshes and bins its point lights. Views must be submitted before any other render pass is begun in the frame. Transforms are
+	// interpolated the fraction of a fixed step the frame is past the latest step
+	bool SubmitLevel(Level& level, const View* views, uint32_t viewCount, const float interpolation);
+	// Merges the level's static meshes by material and records them once so they are replayed every frame without being submitted.
+	// Static meshes are lit by a lightmap that is baked, or read from the level's cached lightmap, when the level loads. Must be
+	// called after the level loads and before descriptor sets are updated
+	bool RecordStaticGeometry(Level& level);
+	// Bins point lights into clusters of the current render pass's view frustum for the scene's fragment shader. Called at most once
+	// per frame after the scene render pass begins. Levels submit their point lights for every view when they are submitted
+	bool SubmitPointLights(
+		const Renderer::PointLight* pointLights,
+		uint32_t pointLightCount);
 	bool SubmitHUD(HUD& hud);
+	bool SubmitSprites(
+		const Renderer::Sprite* sprites,
+		uint32_t spriteCount);
 	bool LoadGeometry(
 		const Vertex1Pos1UV1Norm* vertices,
 		const uint32_t vertexCount, 
@@ -52,8 +82,32 @@ namespace Renderer
 	bool LoadSphereGeometryPrimitive(const float radius, const int32_t sectors, const int32_t stacks, uint32_t* pID);
 	bool LoadCylinderGeometryPrimitive(const float baseRadius, const float topRadius, const float height, const int32_t sectors, const int32_t stacks, uint32_t* pID);
 	bool LoadConeGeometryPrimitive(const float baseRadius, const float height, const int32_t sectors, const int32_t stacks, uint32_t* pID);
+	// Mipmapped textures are streamed. They are usable once their smallest mips are uploaded and higher mips are streamed in as their
+	// size on screen needs them, within the texture memory budget
 	bool LoadTexture(const std::string& textureAssetFilepath, const bool generateMipmaps, uint32_t* pID);
+	// Returns the ID of the material, registering it if an identical material has not been registered. Materials are uploaded to the
+	// material table read by shaders so they must be registered while a level loads
+	uint32_t RegisterMaterial(const Material& material);
+	const Material& GetMaterial(const uint32_t id);
+	void ClearMaterials();
+	// Geometry and textures are released immediately. Their device resources are destroyed once every frame that could use them has
+	// finished, so destroying them does not wait for the device
 	void DestroyGeometry(const uint32_t id);
 	void DestroyTexture(const uint32_t id);
+	// Deferred destructions of frames that have finished are carried out while waiting. Shutdown destroys any that remain
 	bool WaitForIdle();
+	// Mips of the least recently needed streamed textures are evicted to keep streamed texture memory within the budget. The smallest
+	// mips of loaded textures are always resident
+	void SetTextureMemoryBudget(const uint64_t bytes);
+	// Bytes of texture memory used by resident mips of streamed textures
+	uint64_t GetTextureMemoryUsage();
+	// Geometry and textures loaded while an upload batch is open are uploaded together when the batch ends, with a single wait for the
+	// device. Loaded resources must not be drawn until the batch ends
+	void BeginUploadBatch();
+	bool EndUploadBatch();
+	// Closes the open upload batch without submitting the uploads recorded since it was last flushed. Used when loading fails part way
+	void AbortUploadBatch();
+	const CommandStatistics& GetCommandStatistics();
+	// Writes the last frame rasterized by the software backend to a bitmap file. Fails with other backends
+	bool WriteFramebuffer(const std::string& filepath);
 }
\ No newline at end of file
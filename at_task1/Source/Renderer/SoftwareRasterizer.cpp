@@ -0,0 +1,530 @@
+#include "Pch.h"
+#include "SoftwareRasterizer.h"
+#include "JobSystem/JobSystem.h"
+
+#include <emmintrin.h>
+
+// Tiles are a whole number of SIMD lanes wide so no two tiles write the same group of pixels
+constexpr uint32_t TILE_SIZE{ 64 };
+constexpr uint32_t SIMD_WIDTH{ 4 };
+constexpr float CLEAR_DEPTH{ 1.0f };
+
+// Attributes interpolated over a triangle
+constexpr size_t ATTRIBUTE_U{ 0 };
+constexpr size_t ATTRIBUTE_V{ 1 };
+constexpr size_t ATTRIBUTE_LIGHTMAP_U{ 2 };
+constexpr size_t ATTRIBUTE_LIGHTMAP_V{ 3 };
+constexpr size_t ATTRIBUTE_RED{ 4 };
+constexpr size_t ATTRIBUTE_GREEN{ 5 };
+constexpr size_t ATTRIBUTE_BLUE{ 6 };
+constexpr size_t ATTRIBUTE_ALPHA{ 7 };
+constexpr size_t ATTRIBUTE_COUNT{ 8 };
+
+// Matches the gamma applied by the fragment shaders
+constexpr float OUTPUT_GAMMA{ 2.2f };
+constexpr uint32_t GAMMA_TABLE_SIZE{ 4096 };
+
+// Converts sRGB texels to linear space
+static const std::array<float, 256>& GetSRGBToLinearTable()
+{
+	static const auto table = []()
+		{
+			std::array<float, 256> values{};
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				const auto srgb = static_cast<float>(i) / 255.0f;
+				values[i] = (srgb <= 0.04045f) ? (srgb / 12.92f) : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+			}
+			return values;
+		}();
+
+	return table;
+}
+
+// Converts linear colors quantised to the table size to gamma space
+static const std::array<uint8_t, GAMMA_TABLE_SIZE>& GetLinearToGammaTable()
+{
+	static const auto table = []()
+		{
+			std::array<uint8_t, GAMMA_TABLE_SIZE> values{};
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				const auto linear = static_cast<float>(i) / static_cast<float>(GAMMA_TABLE_SIZE - 1);
+				values[i] = static_cast<uint8_t>((std::pow(linear, 1.0f / OUTPUT_GAMMA) * 255.0f) + 0.5f);
+			}
+			return values;
+		}();
+
+	return table;
+}
+
+static uint8_t EncodeGamma(const float linear)
+{
+	const auto index = static_cast<int32_t>((linear * static_cast<float>(GAMMA_TABLE_SIZE - 1)) + 0.5f);
+	return GetLinearToGammaTable()[std::clamp(index, 0, static_cast<int32_t>(GAMMA_TABLE_SIZE - 1))];
+}
+
+static uint32_t PackBGRA(const uint8_t r, const uint8_t g, const uint8_t b, const uint8_t a)
+{
+	return (static_cast<uint32_t>(a) << 24) | (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | static_cast<uint32_t>(b);
+}
+
+// Samples the texel nearest to the texture coordinate. Texture coordinates repeat
+static uint32_t SampleNearest(const Renderer::SoftwareTexture& texture, const float u, const float v)
+{
+	const auto width = static_cast<int32_t>(texture.Width);
+	const auto height = static_cast<int32_t>(texture.Height);
+	auto x = static_cast<int32_t>(std::floor(u * static_cast<float>(width))) % width;
+	auto y = static_cast<int32_t>(std::floor(v * static_cast<float>(height))) % height;
+	x += (x < 0) ? width : 0;
+	y += (y < 0) ? height : 0;
+
+	return texture.Texels[(static_cast<size_t>(y) * texture.Width) + x];
+}
+
+static Renderer::SoftwareVertex LerpVertex(const Renderer::SoftwareVertex& a, const Renderer::SoftwareVertex& b, const float t)
+{
+	Renderer::SoftwareVertex vertex{};
+	vertex.ClipPosition = a.ClipPosition + ((b.ClipPosition - a.ClipPosition) * t);
+	vertex.TextureCoord = a.TextureCoord + ((b.TextureCoord - a.TextureCoord) * t);
+	vertex.LightmapCoord = a.LightmapCoord + ((b.LightmapCoord - a.LightmapCoord) * t);
+	vertex.Color = a.Color + ((b.Color - a.Color) * t);
+	return vertex;
+}
+
+static __m128 EvaluatePlane(const float dx, const float dy, const float c, const __m128 x, const float y)
+{
+	return _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dx), x), _mm_set1_ps((dy * y) + c));
+}
+
+void Renderer::SoftwareRasterizer::Resize(const uint32_t width, const uint32_t height)
+{
+	Width = width;
+	Height = height;
+	Stride = ((width + SIMD_WIDTH - 1) / SIMD_WIDTH) * SIMD_WIDTH;
+	TileCountX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	TileCountY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	SetViewport(0, 0, width, height);
+
+	ColorBuffer.assign(static_cast<size_t>(Stride) * Height, 0);
+	DepthBuffer.assign(static_cast<size_t>(Stride) * Height, CLEAR_DEPTH);
+	Triangles.clear();
+	TileBins.assign(static_cast<size_t>(TileCountX) * TileCountY, {});
+}
+
+void Renderer::SoftwareRasterizer::SetViewport(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height)
+{
+	assert(x + width <= Width && y + height <= Height && "Viewport is outside the framebuffer.");
+
+	ViewportX = x;
+	ViewportY = y;
+	ViewportWidth = width;
+	ViewportHeight = height;
+}
+
+void Renderer::SoftwareRasterizer::Clear(const glm::vec4& color)
+{
+	assert(Triangles.empty() && "Framebuffer cleared before drawn triangles were flushed.");
+
+	const auto toByte = [](const float value) { return static_cast<uint8_t>((std::clamp(value, 0.0f, 1.0f) * 255.0f) + 0.5f); };
+	std::fill(ColorBuffer.begin(), ColorBuffer.end(), PackBGRA(toByte(color.r), toByte(color.g), toByte(color.b), toByte(color.a)));
+	std::fill(DepthBuffer.begin(), DepthBuffer.end(), CLEAR_DEPTH);
+}
+
+void Renderer::SoftwareRasterizer::DrawTriangles(const SoftwareVertex* vertices, const uint32_t vertexCount, const SoftwareDrawState& state)
+{
+	for (uint32_t i = 0; i + 2 < vertexCount; i += 3)
+	{
+		ClipTriangle(&vertices[i], state);
+	}
+}
+
+void Renderer::SoftwareRasterizer::ClipTriangle(const SoftwareVertex* vertices, const SoftwareDrawState& state)
+{
+	// Triangles are clipped to the near and far planes. They are not clipped to the sides of the view volume as their bounds are
+	// clamped to the framebuffer when binned. Clipping a triangle to a plane adds at most one vertex
+	std::array<SoftwareVertex, 5> polygon{ vertices[0], vertices[1], vertices[2] };
+	size_t polygonVertexCount{ 3 };
+
+	for (size_t plane = 0; plane < 2; ++plane)
+	{
+		// Distance to the near plane (z = 0) or the far plane (z = w) in clip space
+		const auto distance = [plane](const SoftwareVertex& vertex)
+			{
+				return (plane == 0) ? vertex.ClipPosition.z : (vertex.ClipPosition.w - vertex.ClipPosition.z);
+			};
+
+		std::array<SoftwareVertex, 5> clipped{};
+		size_t clippedVertexCount{ 0 };
+		for (size_t i = 0; i < polygonVertexCount; ++i)
+		{
+			const auto& current = polygon[i];
+			const auto& next = polygon[(i + 1) % polygonVertexCount];
+			const auto currentDistance = distance(current);
+			const auto nextDistance = distance(next);
+
+			if (currentDistance >= 0.0f)
+			{
+				clipped[clippedVertexCount++] = current;
+			}
+
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+			{
+				clipped[clippedVertexCount++] = LerpVertex(current, next, currentDistance / (currentDistance - nextDistance));
+			}
+		}
+
+		if (clippedVertexCount < 3)
+		{
+			return;
+		}
+
+		polygon = clipped;
+		polygonVertexCount = clippedVertexCount;
+	}
+
+	// Set up the clipped polygon as a triangle fan
+	for (size_t i = 1; i + 1 < polygonVertexCount; ++i)
+	{
+		SetupTriangle(polygon[0], polygon[i], polygon[i + 1], state);
+	}
+}
+
+void Renderer::SoftwareRasterizer::SetupTriangle(const SoftwareVertex& v0, const SoftwareVertex& v1, const SoftwareVertex& v2,
+	const SoftwareDrawState& state)
+{
+	struct ScreenVertex
+	{
+		float X{ 0.0f };
+		float Y{ 0.0f };
+		float Z{ 0.0f };
+		float InverseW{ 0.0f };
+		std::array<float, ATTRIBUTE_COUNT> Attributes{};
+	};
+
+	// Project to screen space. The viewport maps y = -1 to its top edge
+	const auto project = [this](const SoftwareVertex& vertex)
+		{
+			ScreenVertex screenVertex{};
+			screenVertex.InverseW = 1.0f / vertex.ClipPosition.w;
+			screenVertex.X = static_cast<float>(ViewportX) +
+				(((vertex.ClipPosition.x * screenVertex.InverseW * 0.5f) + 0.5f) * static_cast<float>(ViewportWidth));
+			screenVertex.Y = static_cast<float>(ViewportY) +
+				(((vertex.ClipPosition.y * screenVertex.InverseW * 0.5f) + 0.5f) * static_cast<float>(ViewportHeight));
+			screenVertex.Z = vertex.ClipPosition.z * screenVertex.InverseW;
+			screenVertex.Attributes = {
+				vertex.TextureCoord.x, vertex.TextureCoord.y, vertex.LightmapCoord.x, vertex.LightmapCoord.y,
+				vertex.Color.r, vertex.Color.g, vertex.Color.b, vertex.Color.a
+			};
+			for (auto& attribute : screenVertex.Attributes)
+			{
+				attribute *= screenVertex.InverseW;
+			}
+			return screenVertex;
+		};
+
+	std::array<ScreenVertex, 3> screenVertices{ project(v0), project(v1), project(v2) };
+
+	// Triangles that are clockwise on screen are front facing. Back facing triangles that are not culled are flipped so edge
+	// functions are positive inside every triangle
+	const auto doubleArea = ((screenVertices[1].X - screenVertices[0].X) * (screenVertices[2].Y - screenVertices[0].Y)) -
+		((screenVertices[2].X - screenVertices[0].X) * (screenVertices[1].Y - screenVertices[0].Y));
+	if (doubleArea == 0.0f || !std::isfinite(doubleArea) || (doubleArea < 0.0f && state.CullBackFaces))
+	{
+		return;
+	}
+
+	if (doubleArea < 0.0f)
+	{
+		std::swap(screenVertices[1], screenVertices[2]);
+	}
+
+	// Find the pixels the triangle may cover within the viewport
+	const auto minX = std::max(static_cast<int32_t>(std::floor(std::min({ screenVertices[0].X, screenVertices[1].X, screenVertices[2].X }))),
+		static_cast<int32_t>(ViewportX));
+	const auto minY = std::max(static_cast<int32_t>(std::floor(std::min({ screenVertices[0].Y, screenVertices[1].Y, screenVertices[2].Y }))),
+		static_cast<int32_t>(ViewportY));
+	const auto maxX = std::min(static_cast<int32_t>(std::ceil(std::max({ screenVertices[0].X, screenVertices[1].X, screenVertices[2].X }))),
+		static_cast<int32_t>(ViewportX + ViewportWidth) - 1);
+	const auto maxY = std::min(static_cast<int32_t>(std::ceil(std::max({ screenVertices[0].Y, screenVertices[1].Y, screenVertices[2].Y }))),
+		static_cast<int32_t>(ViewportY + ViewportHeight) - 1);
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	auto& triangle = Triangles.emplace_back();
+	triangle.OriginX = screenVertices[0].X;
+	triangle.OriginY = screenVertices[0].Y;
+	triangle.MinX = minX;
+	triangle.MinY = minY;
+	triangle.MaxX = maxX;
+	triangle.MaxY = maxY;
+	triangle.pTexture = state.pTexture;
+	triangle.pLightmap = state.pLightmap;
+	triangle.DepthTest = state.DepthTest;
+	triangle.DepthWrite = state.DepthWrite;
+	triangle.AlphaBlend = state.AlphaBlend;
+
+	// Each edge function is zero on its edge and equals twice the triangle's area at the opposite vertex
+	for (size_t i = 0; i < 3; ++i)
+	{
+		const auto& a = screenVertices[(i + 1) % 3];
+		const auto& b = screenVertices[(i + 2) % 3];
+		auto& edge = triangle.Edges[i];
+		edge.DX = a.Y - b.Y;
+		edge.DY = b.X - a.X;
+
+		// Evaluate from the end point that is first in y then x whichever direction the edge is wound
+		const auto aFirst = (a.Y < b.Y) || (a.Y == b.Y && a.X < b.X);
+		edge.X = aFirst ? a.X : b.X;
+		edge.Y = aFirst ? a.Y : b.Y;
+
+		// Top edges are horizontal with the triangle below them. Left edges have the triangle to their right
+		triangle.TopLeftEdges[i] = (edge.DX > 0.0f) || (edge.DX == 0.0f && edge.DY > 0.0f);
+	}
+
+	// Values are interpolated with barycentric weights given by the edge functions divided by twice the area
+	const auto inverseDoubleArea = 1.0f / std::abs(doubleArea);
+	std::array<float, 3> originEdgeDistances{};
+	for (size_t i = 0; i < 3; ++i)
+	{
+		const auto& edge = triangle.Edges[i];
+		originEdgeDistances[i] = (edge.DX * (triangle.OriginX - edge.X)) + (edge.DY * (triangle.OriginY - edge.Y));
+	}
+
+	const auto buildPlane = [&triangle, &originEdgeDistances, inverseDoubleArea](const float value0, const float value1, const float value2)
+		{
+			Plane plane{};
+			plane.DX = ((value0 * triangle.Edges[0].DX) + (value1 * triangle.Edges[1].DX) + (value2 * triangle.Edges[2].DX)) * inverseDoubleArea;
+			plane.DY = ((value0 * triangle.Edges[0].DY) + (value1 * triangle.Edges[1].DY) + (value2 * triangle.Edges[2].DY)) * inverseDoubleArea;
+			plane.C = ((value0 * originEdgeDistances[0]) + (value1 * originEdgeDistances[1]) + (value2 * originEdgeDistances[2])) * inverseDoubleArea;
+			return plane;
+		};
+
+	triangle.Depth = buildPlane(screenVertices[0].Z, screenVertices[1].Z, screenVertices[2].Z);
+	triangle.InverseW = buildPlane(screenVertices[0].InverseW, screenVertices[1].InverseW, screenVertices[2].InverseW);
+	for (size_t i = 0; i < ATTRIBUTE_COUNT; ++i)
+	{
+		triangle.Attributes[i] = buildPlane(screenVertices[0].Attributes[i], screenVertices[1].Attributes[i], screenVertices[2].Attributes[i]);
+	}
+
+	// Bin the triangle into the tiles its bounds overlap
+	const auto triangleIndex = static_cast<uint32_t>(Triangles.size() - 1);
+	for (auto tileY = static_cast<uint32_t>(minY) / TILE_SIZE; tileY <= static_cast<uint32_t>(maxY) / TILE_SIZE; ++tileY)
+	{
+		for (auto tileX = static_cast<uint32_t>(minX) / TILE_SIZE; tileX <= static_cast<uint32_t>(maxX) / TILE_SIZE; ++tileX)
+		{
+			TileBins[(static_cast<size_t>(tileY) * TileCountX) + tileX].push_back(triangleIndex);
+		}
+	}
+}
+
+void Renderer::SoftwareRasterizer::Flush()
+{
+	if (Triangles.empty())
+	{
+		return;
+	}
+
+	// Tiles write disjoint pixels so they are rasterized without synchronisation
+	JobSystem::ParallelFor(TileCountX * TileCountY, 1, [this](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t tile = begin; tile < end; ++tile)
+			{
+				RasterizeTile(tile);
+			}
+		});
+
+	Triangles.clear();
+	for (auto& bin : TileBins)
+	{
+		bin.clear();
+	}
+}
+
+void Renderer::SoftwareRasterizer::RasterizeTile(const uint32_t tile)
+{
+	const auto& srgbToLinear = GetSRGBToLinearTable();
+
+	const auto tileMinX = static_cast<int32_t>((tile % TileCountX) * TILE_SIZE);
+	const auto tileMinY = static_cast<int32_t>((tile / TileCountX) * TILE_SIZE);
+	const auto tileMaxX = std::min(tileMinX + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(Width)) - 1;
+	const auto tileMaxY = std::min(tileMinY + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(Height)) - 1;
+
+	const auto laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const auto zero = _mm_setzero_ps();
+	const auto one = _mm_set1_ps(1.0f);
+
+	alignas(16) std::array<std::array<float, SIMD_WIDTH>, ATTRIBUTE_COUNT> attributes{};
+
+	for (const auto triangleIndex : TileBins[tile])
+	{
+		const auto& triangle = Triangles[triangleIndex];
+
+		// Pixels are processed in groups of SIMD lanes aligned to the group size
+		const auto minX = std::max(triangle.MinX, tileMinX) & ~static_cast<int32_t>(SIMD_WIDTH - 1);
+		const auto maxX = std::min(triangle.MaxX, tileMaxX);
+		const auto minY = std::max(triangle.MinY, tileMinY);
+		const auto maxY = std::min(triangle.MaxY, tileMaxY);
+
+		// Lanes of aligned pixel groups outside the triangle's bounds are masked so triangles do not draw outside their viewport
+		const auto scissorMinX = _mm_set1_ps(static_cast<float>(triangle.MinX));
+		const auto scissorMaxX = _mm_set1_ps(static_cast<float>(triangle.MaxX + 1));
+
+		std::array<__m128, 3> topLeftMasks{};
+		for (size_t i = 0; i < 3; ++i)
+		{
+			topLeftMasks[i] = triangle.TopLeftEdges[i] ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+		}
+
+		for (auto y = minY; y <= maxY; ++y)
+		{
+			const auto pixelCenterY = static_cast<float>(y) + 0.5f;
+			const auto pixelY = pixelCenterY - triangle.OriginY;
+
+			for (auto x = minX; x <= maxX; x += SIMD_WIDTH)
+			{
+				const auto pixelCenterX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+				const auto pixelX = _mm_sub_ps(pixelCenterX, _mm_set1_ps(triangle.OriginX));
+
+				// Test the pixel centers against each edge. Pixel centers on an edge are owned by top and left edges
+				auto coverage = _mm_and_ps(_mm_cmpgt_ps(pixelCenterX, scissorMinX), _mm_cmplt_ps(pixelCenterX, scissorMaxX));
+				for (size_t i = 0; i < 3; ++i)
+				{
+					const auto& edge = triangle.Edges[i];
+					const auto distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edge.DX), _mm_sub_ps(pixelCenterX, _mm_set1_ps(edge.X))),
+						_mm_set1_ps(edge.DY * (pixelCenterY - edge.Y)));
+					const auto inside = _mm_or_ps(_mm_cmpgt_ps(distance, zero), _mm_and_ps(_mm_cmpeq_ps(distance, zero), topLeftMasks[i]));
+					coverage = _mm_and_ps(coverage, inside);
+				}
+
+				if (_mm_movemask_ps(coverage) == 0)
+				{
+					continue;
+				}
+
+				// Depth test against the depth buffer
+				const auto pixelIndex = (static_cast<size_t>(y) * Stride) + static_cast<size_t>(x);
+				float* pDepth = &DepthBuffer[pixelIndex];
+				const auto depth = EvaluatePlane(triangle.Depth.DX, triangle.Depth.DY, triangle.Depth.C, pixelX, pixelY);
+				const auto storedDepth = _mm_loadu_ps(pDepth);
+				if (triangle.DepthTest)
+				{
+					coverage = _mm_and_ps(coverage, _mm_cmplt_ps(depth, storedDepth));
+				}
+
+				const auto coveredLanes = _mm_movemask_ps(coverage);
+				if (coveredLanes == 0)
+				{
+					continue;
+				}
+
+				if (triangle.DepthWrite)
+				{
+					_mm_storeu_ps(pDepth, _mm_or_ps(_mm_and_ps(coverage, depth), _mm_andnot_ps(coverage, storedDepth)));
+				}
+
+				// Interpolate perspective correct attributes
+				const auto inverseW = EvaluatePlane(triangle.InverseW.DX, triangle.InverseW.DY, triangle.InverseW.C, pixelX, pixelY);
+				const auto w = _mm_div_ps(one, inverseW);
+				for (size_t i = 0; i < ATTRIBUTE_COUNT; ++i)
+				{
+					const auto& plane = triangle.Attributes[i];
+					_mm_store_ps(attributes[i].data(), _mm_mul_ps(EvaluatePlane(plane.DX, plane.DY, plane.C, pixelX, pixelY), w));
+				}
+
+				// Shade covered pixels
+				for (uint32_t lane = 0; lane < SIMD_WIDTH; ++lane)
+				{
+					if ((coveredLanes & (1 << lane)) == 0)
+					{
+						continue;
+					}
+
+					// Sample the texture. Untextured triangles are white
+					float red{ 1.0f };
+					float green{ 1.0f };
+					float blue{ 1.0f };
+					float alpha{ 1.0f };
+					if (triangle.pTexture != nullptr)
+					{
+						const auto texel = SampleNearest(*triangle.pTexture, attributes[ATTRIBUTE_U][lane], attributes[ATTRIBUTE_V][lane]);
+						red = srgbToLinear[texel & 0xFF];
+						green = srgbToLinear[(texel >> 8) & 0xFF];
+						blue = srgbToLinear[(texel >> 16) & 0xFF];
+						alpha = static_cast<float>(texel >> 24) / 255.0f;
+					}
+
+					// Add baked light to the vertex light
+					auto lightRed = attributes[ATTRIBUTE_RED][lane];
+					auto lightGreen = attributes[ATTRIBUTE_GREEN][lane];
+					auto lightBlue = attributes[ATTRIBUTE_BLUE][lane];
+					if (triangle.pLightmap != nullptr)
+					{
+						const auto lightmapTexel = SampleNearest(*triangle.pLightmap, attributes[ATTRIBUTE_LIGHTMAP_U][lane],
+							attributes[ATTRIBUTE_LIGHTMAP_V][lane]);
+						lightRed += srgbToLinear[lightmapTexel & 0xFF];
+						lightGreen += srgbToLinear[(lightmapTexel >> 8) & 0xFF];
+						lightBlue += srgbToLinear[(lightmapTexel >> 16) & 0xFF];
+					}
+
+					alpha = std::clamp(alpha * attributes[ATTRIBUTE_ALPHA][lane], 0.0f, 1.0f);
+					auto outRed = static_cast<float>(EncodeGamma(red * lightRed));
+					auto outGreen = static_cast<float>(EncodeGamma(green * lightGreen));
+					auto outBlue = static_cast<float>(EncodeGamma(blue * lightBlue));
+					auto outAlpha = alpha * 255.0f;
+
+					// Blend over the framebuffer in gamma space, matching a swapchain without an sRGB format
+					auto& pixel = ColorBuffer[pixelIndex + lane];
+					if (triangle.AlphaBlend)
+					{
+						const auto inverseAlpha = 1.0f - alpha;
+						outRed = (outRed * alpha) + (static_cast<float>((pixel >> 16) & 0xFF) * inverseAlpha);
+						outGreen = (outGreen * alpha) + (static_cast<float>((pixel >> 8) & 0xFF) * inverseAlpha);
+						outBlue = (outBlue * alpha) + (static_cast<float>(pixel & 0xFF) * inverseAlpha);
+						outAlpha = outAlpha + (static_cast<float>(pixel >> 24) * inverseAlpha);
+					}
+
+					pixel = PackBGRA(static_cast<uint8_t>(outRed + 0.5f), static_cast<uint8_t>(outGreen + 0.5f), static_cast<uint8_t>(outBlue + 0.5f),
+						static_cast<uint8_t>(std::min(outAlpha + 0.5f, 255.0f)));
+				}
+			}
+		}
+	}
+}
+
+bool Renderer::SoftwareRasterizer::WriteBitmap(const std::string& filepath) const
+{
+	std::ofstream file(filepath, std::ios::out | std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	const auto rowSize = static_cast<size_t>(Width) * sizeof(uint32_t);
+
+	// Rows are stored top down
+	BITMAPINFOHEADER infoHeader{};
+	infoHeader.biSize = sizeof(BITMAPINFOHEADER);
+	infoHeader.biWidth = static_cast<LONG>(Width);
+	infoHeader.biHeight = -static_cast<LONG>(Height);
+	infoHeader.biPlanes = 1;
+	infoHeader.biBitCount = 32;
+	infoHeader.biCompression = BI_RGB;
+	infoHeader.biSizeImage = static_cast<DWORD>(rowSize * Height);
+
+	BITMAPFILEHEADER fileHeader{};
+	fileHeader.bfType = 0x4D42; // "BM"
+	fileHeader.bfOffBits = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER);
+	fileHeader.bfSize = fileHeader.bfOffBits + infoHeader.biSizeImage;
+
+	file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+	file.write(reinterpret_cast<const char*>(&infoHeader), sizeof(infoHeader));
+	for (uint32_t y = 0; y < Height; ++y)
+	{
+		file.write(reinterpret_cast<const char*>(&ColorBuffer[static_cast<size_t>(y) * Stride]), rowSize);
+	}
+
+	return file.good();
+}
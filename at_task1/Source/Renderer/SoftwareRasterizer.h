@@ -0,0 +1,123 @@
+#pragma once
+
+namespace Renderer
+{
+	// Texture sampled by the software rasterizer. Texels are RGBA8 in sRGB and are sampled with nearest neighbour filtering
+	struct SoftwareTexture
+	{
+		uint32_t Width{ 0 };
+		uint32_t Height{ 0 };
+		std::vector<uint32_t> Texels;
+	};
+
+	// A vertex transformed to clip space by the software backend. Color is the vertex's lighting, or a sprite's tint, and alpha
+	struct SoftwareVertex
+	{
+		glm::vec4 ClipPosition{ 0.0f, 0.0f, 0.0f, 1.0f };
+		glm::vec2 TextureCoord{ 0.0f, 0.0f };
+		glm::vec2 LightmapCoord{ 0.0f, 0.0f };
+		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+	};
+
+	// State a triangle list is rasterized with. The lightmap's light is added to the vertex color when one is given
+	struct SoftwareDrawState
+	{
+		const SoftwareTexture* pTexture{ nullptr };
+		const SoftwareTexture* pLightmap{ nullptr };
+		bool CullBackFaces{ true };
+		bool DepthTest{ true };
+		bool DepthWrite{ true };
+		bool AlphaBlend{ false };
+	};
+
+	// Rasterizes textured, depth tested triangles into a CPU framebuffer. Triangles are clipped and binned into screen tiles as they
+	// are drawn and the tiles are rasterized on the job system when flushed. Each tile keeps the triangles' submission order so
+	// blending matches a GPU
+	class SoftwareRasterizer
+	{
+	public:
+		// Resizing resets the viewport to the whole framebuffer
+		void Resize(const uint32_t width, const uint32_t height);
+		// Sets the region of the framebuffer clip space is mapped to. Triangles drawn afterwards are scissored to the region
+		void SetViewport(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height);
+		// Colors are given in gamma space
+		void Clear(const glm::vec4& color);
+		void DrawTriangles(const SoftwareVertex* vertices, const uint32_t vertexCount, const SoftwareDrawState& state);
+		// Rasterizes the triangles drawn since the last flush. Must only be called from the main thread
+		void Flush();
+
+		// Writes the framebuffer to a 32 bit bitmap file
+		bool WriteBitmap(const std::string& filepath) const;
+
+		uint32_t GetWidth() const { return Width; }
+		uint32_t GetHeight() const { return Height; }
+		// Row stride of the framebuffer in pixels. Rows are padded to a whole number of SIMD lanes
+		uint32_t GetStride() const { return Stride; }
+		// Pixels are BGRA8 in gamma space, matching 32 bit Windows device independent bitmaps
+		const std::vector<uint32_t>& GetColorBuffer() const { return ColorBuffer; }
+
+	private:
+		// Screen space plane equation of a value interpolated over a triangle
+		struct Plane
+		{
+			float DX{ 0.0f };
+			float DY{ 0.0f };
+			float C{ 0.0f };
+		};
+
+		// Edge function of a triangle edge evaluated relative to one of the edge's end points. Edges shared by two triangles are evaluated
+		// from the same end point so the edge functions are exact negatives of each other and no pixel is drawn twice
+		struct Edge
+		{
+			float DX{ 0.0f };
+			float DY{ 0.0f };
+			float X{ 0.0f };
+			float Y{ 0.0f };
+		};
+
+		struct Triangle
+		{
+			// Planes are evaluated relative to the triangle's first vertex to keep precision far from the framebuffer origin
+			float OriginX{ 0.0f };
+			float OriginY{ 0.0f };
+			// Edge functions are positive inside the triangle
+			std::array<Edge, 3> Edges{};
+			// Edges that own pixel centers lying exactly on them
+			std::array<bool, 3> TopLeftEdges{};
+			Plane Depth{};
+			Plane InverseW{};
+			// Attributes divided by w for perspective correct interpolation
+			std::array<Plane, 8> Attributes{};
+			// Pixel bounds of the triangle scissored to the viewport it was drawn with
+			int32_t MinX{ 0 };
+			int32_t MinY{ 0 };
+			int32_t MaxX{ 0 };
+			int32_t MaxY{ 0 };
+			const SoftwareTexture* pTexture{ nullptr };
+			const SoftwareTexture* pLightmap{ nullptr };
+			bool DepthTest{ true };
+			bool DepthWrite{ true };
+			bool AlphaBlend{ false };
+		};
+
+		void ClipTriangle(const SoftwareVertex* vertices, const SoftwareDrawState& state);
+		void SetupTriangle(const SoftwareVertex& v0, const SoftwareVertex& v1, const SoftwareVertex& v2, const SoftwareDrawState& state);
+		void RasterizeTile(const uint32_t tile);
+
+		uint32_t Width{ 0 };
+		uint32_t Height{ 0 };
+		uint32_t Stride{ 0 };
+		uint32_t ViewportX{ 0 };
+		uint32_t ViewportY{ 0 };
+		uint32_t ViewportWidth{ 0 };
+		uint32_t ViewportHeight{ 0 };
+		uint32_t TileCountX{ 0 };
+		uint32_t TileCountY{ 0 };
+		std::vector<uint32_t> ColorBuffer;
+		std::vector<float> DepthBuffer;
+
+		// Triangles drawn since the last flush and the indices of the triangles overlapping each tile
+		std::vector<Triangle> Triangles;
+		std::vector<std::vector<uint32_t>> TileBins;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace Renderer
+{
+	enum class ESampler : uint8_t;
+
+	struct Sprite
+	{
+		void SetSamplerID(const Renderer::ESampler id) { SamplerID = static_cast<uint32_t>(id); }
+
+		bool Visible{ true };
+		// Center of the sprite in camera space. Sprites are drawn back to front along z
+		glm::vec3 Position{ 0.0f, 0.0f, 0.0f };
+		glm::vec2 Size{ 1.0f, 1.0f };
+		// Min (xy) and max (zw) texture coordinates of the sprite within its texture, allowing sprites to share an atlas
+		glm::vec4 UVRect{ 0.0f, 0.0f, 1.0f, 1.0f };
+		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+		uint32_t SamplerID{ 0 };
+		uint32_t TextureID{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include "Pch.h"
+#include "TextureStreamer.h"
+
+constexpr uint32_t BYTES_PER_TEXEL{ 4 };
+// Mips no larger than the tail size are resident while the texture is loaded
+constexpr uint32_t TAIL_MIP_SIZE{ 64 };
+// Limits the texture data uploaded by an update so streaming does not stall a frame
+constexpr uint64_t MAX_UPLOAD_SIZE_PER_UPDATE{ 8ull * 1024 * 1024 };
+constexpr uint32_t NO_REQUEST{ std::numeric_limits<uint32_t>::max() };
+
+static float LinearToSRGB(const float value)
+{
+	return (value <= 0.0031308f) ? (value * 12.92f) : ((1.055f * std::pow(value, 1.0f / 2.4f)) - 0.055f);
+}
+
+std::vector<Renderer::TextureMip> Renderer::GenerateMipChain(const uint8_t* pixels, const uint32_t width, const uint32_t height)
+{
+	// Decodes sRGB channels to linear
+	static const auto sSRGBToLinear = []()
+	{
+		std::array<float, 256> table{};
+		for (size_t i = 0; i < table.size(); ++i)
+		{
+			const auto value = static_cast<float>(i) / 255.0f;
+			table[i] = (value <= 0.04045f) ? (value / 12.92f) : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+		return table;
+	}();
+
+	std::vector<TextureMip> mips;
+
+	TextureMip baseMip{ width, height };
+	baseMip.Pixels.assign(pixels, pixels + (static_cast<size_t>(width) * height * BYTES_PER_TEXEL));
+	mips.push_back(std::move(baseMip));
+
+	// Halve each mip until it is a single texel. Odd sized mips clamp their last row and column
+	while ((mips.back().Width > 1) || (mips.back().Height > 1))
+	{
+		const auto& source = mips.back();
+		TextureMip mip{ std::max(source.Width / 2, 1u), std::max(source.Height / 2, 1u) };
+		mip.Pixels.resize(static_cast<size_t>(mip.Width) * mip.Height * BYTES_PER_TEXEL);
+
+		for (uint32_t y = 0; y < mip.Height; ++y)
+		{
+			const std::array<uint32_t, 2> sourceRows{ std::min(y * 2, source.Height - 1), std::min((y * 2) + 1, source.Height - 1) };
+			for (uint32_t x = 0; x < mip.Width; ++x)
+			{
+				const std::array<uint32_t, 2> sourceColumns{ std::min(x * 2, source.Width - 1), std::min((x * 2) + 1, source.Width - 1) };
+				for (uint32_t channel = 0; channel < BYTES_PER_TEXEL; ++channel)
+				{
+					float sum{ 0.0f };
+					for (const auto row : sourceRows)
+					{
+						for (const auto column : sourceColumns)
+						{
+							const auto value = source.Pixels[(((static_cast<size_t>(row) * source.Width) + column) * BYTES_PER_TEXEL) + channel];
+							// Alpha is stored linearly
+							sum += (channel < 3) ? sSRGBToLinear[value] : (static_cast<float>(value) / 255.0f);
+						}
+					}
+
+					const auto average = sum * 0.25f;
+					const auto encoded = (channel < 3) ? LinearToSRGB(average) : average;
+					mip.Pixels[(((static_cast<size_t>(y) * mip.Width) + x) * BYTES_PER_TEXEL) + channel] =
+						static_cast<uint8_t>((glm::clamp(encoded, 0.0f, 1.0f) * 255.0f) + 0.5f);
+				}
+			}
+		}
+
+		mips.push_back(std::move(mip));
+	}
+
+	return mips;
+}
+
+uint32_t Renderer::CalculateRequiredMip(const float texelCount, const float pixelCount)
+{
+	// Draws smaller than a pixel need no more detail than a draw covering one
+	const auto texelsPerPixel = texelCount / std::max(pixelCount, 1.0f);
+	if (texelsPerPixel <= 1.0f)
+	{
+		return 0;
+	}
+
+	return static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+}
+
+uint32_t Renderer::TextureStreamer::Register(const uint32_t id, const uint32_t width, const uint32_t height, const uint32_t mipCount)
+{
+	if (id >= Textures.size())
+	{
+		Textures.resize(static_cast<size_t>(id) + 1);
+	}
+
+	auto& texture = Textures[id];
+	assert(!texture.Registered && "Texture is already registered with the texture streamer.");
+
+	texture = {};
+	texture.Registered = true;
+	texture.MipSizes.resize(mipCount);
+	texture.TailMip = mipCount - 1;
+
+	for (uint32_t mip = 0; mip < mipCount; ++mip)
+	{
+		const auto mipWidth = std::max(width >> mip, 1u);
+		const auto mipHeight = std::max(height >> mip, 1u);
+		texture.MipSizes[mip] = static_cast<uint64_t>(mipWidth) * mipHeight * BYTES_PER_TEXEL;
+
+		// The tail starts at the first mip no larger than the tail size
+		if ((std::max(mipWidth, mipHeight) <= TAIL_MIP_SIZE) && (mip < texture.TailMip))
+		{
+			texture.TailMip = mip;
+		}
+	}
+
+	// Tail mips are resident regardless of the budget so every loaded texture can be sampled
+	texture.ResidentMip = texture.TailMip;
+	texture.RequestedMip = NO_REQUEST;
+	texture.DesiredMip = texture.TailMip;
+	texture.LastRequestedUpdate = UpdateCount;
+	ResidentSize += CalculateResidentSize(texture, texture.ResidentMip);
+
+	return texture.ResidentMip;
+}
+
+void Renderer::TextureStreamer::Unregister(const uint32_t id)
+{
+	assert(IsRegistered(id) && "Texture is not registered with the texture streamer.");
+
+	auto& texture = Textures[id];
+	ResidentSize -= CalculateResidentSize(texture, texture.ResidentMip);
+	texture = {};
+}
+
+void Renderer::TextureStreamer::Request(const uint32_t id, const uint32_t mip)
+{
+	if (!IsRegistered(id))
+	{
+		return;
+	}
+
+	auto& texture = Textures[id];
+	texture.RequestedMip = std::min(texture.RequestedMip, mip);
+}
+
+void Renderer::TextureStreamer::Update(std::vector<TextureResidencyChange>& changes)
+{
+	++UpdateCount;
+
+	// Apply the requests made since the last update and find the textures needing more detail
+	std::vector<uint32_t> previousResidentMips(Textures.size(), 0);
+	std::vector<uint32_t> streamedIDs;
+	for (uint32_t id = 0; id < static_cast<uint32_t>(Textures.size()); ++id)
+	{
+		auto& texture = Textures[id];
+		previousResidentMips[id] = texture.ResidentMip;
+		if (!texture.Registered)
+		{
+			continue;
+		}
+
+		if (texture.RequestedMip != NO_REQUEST)
+		{
+			texture.DesiredMip = std::min(texture.RequestedMip, texture.TailMip);
+			texture.LastRequestedUpdate = UpdateCount;
+			texture.RequestedMip = NO_REQUEST;
+		}
+
+		if (texture.DesiredMip < texture.ResidentMip)
+		{
+			streamedIDs.push_back(id);
+		}
+	}
+
+	// Stream the most recently requested textures first, then the textures furthest from the mip they need
+	std::sort(streamedIDs.begin(), streamedIDs.end(), [this](const uint32_t lhs, const uint32_t rhs)
+		{
+			const auto& lhsTexture = Textures[lhs];
+			const auto& rhsTexture = Textures[rhs];
+			if (lhsTexture.LastRequestedUpdate != rhsTexture.LastRequestedUpdate)
+			{
+				return lhsTexture.LastRequestedUpdate > rhsTexture.LastRequestedUpdate;
+			}
+
+			const auto lhsMissingMipCount = lhsTexture.ResidentMip - lhsTexture.DesiredMip;
+			const auto rhsMissingMipCount = rhsTexture.ResidentMip - rhsTexture.DesiredMip;
+			if (lhsMissingMipCount != rhsMissingMipCount)
+			{
+				return lhsMissingMipCount > rhsMissingMipCount;
+			}
+
+			return lhs < rhs;
+		});
+
+	// Make one more mip of each texture resident until the upload limit is reached. A texture's resident mips are uploaded again when
+	// a mip is streamed in, so the whole texture counts towards the limit. The first texture is always streamed
+	uint64_t uploadSize{ 0 };
+	for (const auto id : streamedIDs)
+	{
+		auto& texture = Textures[id];
+		const auto mip = texture.ResidentMip - 1;
+		const auto textureSize = CalculateResidentSize(texture, mip);
+		if ((uploadSize > 0) && ((uploadSize + textureSize) > MAX_UPLOAD_SIZE_PER_UPDATE))
+		{
+			break;
+		}
+
+		if (!Evict(texture.MipSizes[mip], texture.LastRequestedUpdate))
+		{
+			continue;
+		}
+
+		texture.ResidentMip = mip;
+		ResidentSize += texture.MipSizes[mip];
+		uploadSize += textureSize;
+	}
+
+	// Evict mips of textures that were not requested when the budget is lowered below the resident size
+	Evict(0, UpdateCount);
+
+	for (uint32_t id = 0; id < static_cast<uint32_t>(Textures.size()); ++id)
+	{
+		const auto& texture = Textures[id];
+		if (texture.Registered && (texture.ResidentMip != previousResidentMips[id]))
+		{
+			changes.push_back({ id, texture.ResidentMip });
+		}
+	}
+}
+
+uint64_t Renderer::TextureStreamer::CalculateResidentSize(const StreamedTexture& texture, const uint32_t residentMip) const
+{
+	uint64_t size{ 0 };
+	for (size_t mip = residentMip; mip < texture.MipSizes.size(); ++mip)
+	{
+		size += texture.MipSizes[mip];
+	}
+
+	return size;
+}
+
+bool Renderer::TextureStreamer::Evict(const uint64_t size, const uint64_t priority)
+{
+	if ((ResidentSize + size) <= Budget)
+	{
+		return true;
+	}
+
+	// A texture with evictable mips and the mip it can be evicted down to
+	struct EvictionCandidate
+	{
+		uint32_t ID{ 0 };
+		uint32_t EvictedMip{ 0 };
+	};
+
+	// Find the evictable mips of each texture
+	std::vector<EvictionCandidate> candidates;
+	uint64_t evictableSize{ 0 };
+	for (uint32_t id = 0; id < static_cast<uint32_t>(Textures.size()); ++id)
+	{
+		const auto& texture = Textures[id];
+		if (!texture.Registered)
+		{
+			continue;
+		}
+
+		const auto evictedMip = (texture.LastRequestedUpdate < priority) ? texture.TailMip : texture.DesiredMip;
+		if (evictedMip <= texture.ResidentMip)
+		{
+			continue;
+		}
+
+		candidates.push_back({ id, evictedMip });
+		evictableSize += CalculateResidentSize(texture, texture.ResidentMip) - CalculateResidentSize(texture, evictedMip);
+	}
+
+	// Mips are only evicted to make room for a size that fits. Textures over the budget evict what they can
+	const auto excessSize = (ResidentSize + size) - Budget;
+	if ((size > 0) && (evictableSize < excessSize))
+	{
+		return false;
+	}
+
+	// Evict the most detailed mips of the least recently requested textures first
+	std::sort(candidates.begin(), candidates.end(), [this](const EvictionCandidate& lhs, const EvictionCandidate& rhs)
+		{
+			const auto lhsLastRequestedUpdate = Textures[lhs.ID].LastRequestedUpdate;
+			const auto rhsLastRequestedUpdate = Textures[rhs.ID].LastRequestedUpdate;
+			if (lhsLastRequestedUpdate != rhsLastRequestedUpdate)
+			{
+				return lhsLastRequestedUpdate < rhsLastRequestedUpdate;
+			}
+
+			return lhs.ID < rhs.ID;
+		});
+
+	uint64_t evictedSize{ 0 };
+	for (const auto& candidate : candidates)
+	{
+		auto& texture = Textures[candidate.ID];
+		while ((texture.ResidentMip < candidate.EvictedMip) && (evictedSize < excessSize))
+		{
+			evictedSize += texture.MipSizes[texture.ResidentMip];
+			++texture.ResidentMip;
+		}
+
+		if (evictedSize >= excessSize)
+		{
+			break;
+		}
+	}
+
+	ResidentSize -= evictedSize;
+
+	return true;
+}
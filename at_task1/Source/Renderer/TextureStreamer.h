@@ -0,0 +1,71 @@
+#pragma once
+
+namespace Renderer
+{
+	// A level of a texture's mip chain. Texels are RGBA8 in sRGB
+	struct TextureMip
+	{
+		uint32_t Width{ 0 };
+		uint32_t Height{ 0 };
+		std::vector<uint8_t> Pixels;
+	};
+
+	// A texture whose resident mips changed. Mips from the resident mip to the texture's smallest mip are resident
+	struct TextureResidencyChange
+	{
+		uint32_t TextureID{ 0 };
+		uint32_t ResidentMip{ 0 };
+	};
+
+	// Generates a full mip chain from a texture's base level. Texels are averaged in linear space
+	std::vector<TextureMip> GenerateMipChain(const uint8_t* pixels, const uint32_t width, const uint32_t height);
+	// Returns the most detailed mip needed to draw a number of texels across a number of pixels without minifying by more than a
+	// texel per pixel
+	uint32_t CalculateRequiredMip(const float texelCount, const float pixelCount);
+
+	// Decides which mips of streamed textures are resident in texture memory. Textures are registered with only their tail mips
+	// resident and are requested each frame at the mip their size on screen needs. Each update makes one more mip of each texture
+	// needing more detail resident, evicting mips of the least recently requested textures to stay within the memory budget
+	class TextureStreamer
+	{
+	public:
+		void SetBudget(const uint64_t bytes) { Budget = bytes; }
+		uint64_t GetBudget() const { return Budget; }
+		uint64_t GetResidentSize() const { return ResidentSize; }
+
+		// Returns the mip the texture is resident from when registered
+		uint32_t Register(const uint32_t id, const uint32_t width, const uint32_t height, const uint32_t mipCount);
+		void Unregister(const uint32_t id);
+		bool IsRegistered(const uint32_t id) const { return (id < Textures.size()) && Textures[id].Registered; }
+		uint32_t GetResidentMip(const uint32_t id) const { return Textures[id].ResidentMip; }
+		// The most detailed mip requested for a texture in a frame is streamed in
+		void Request(const uint32_t id, const uint32_t mip);
+		// Applies the requests made since the last update and writes the textures whose resident mips changed
+		void Update(std::vector<TextureResidencyChange>& changes);
+
+	private:
+		struct StreamedTexture
+		{
+			bool Registered{ false };
+			// Size in bytes of each mip
+			std::vector<uint64_t> MipSizes;
+			// Smallest mips that are always resident
+			uint32_t TailMip{ 0 };
+			uint32_t ResidentMip{ 0 };
+			uint32_t RequestedMip{ 0 };
+			// Mip last requested for the texture. Kept until the texture's mips are evicted
+			uint32_t DesiredMip{ 0 };
+			uint64_t LastRequestedUpdate{ 0 };
+		};
+
+		uint64_t CalculateResidentSize(const StreamedTexture& texture, const uint32_t residentMip) const;
+		// Evicts mips until the size fits within the budget. Only mips of textures requested before the priority, or mips more detailed
+		// than a texture was last requested at, are evicted. Evicts nothing and fails when a non-zero size cannot fit
+		bool Evict(const uint64_t size, const uint64_t priority);
+
+		std::vector<StreamedTexture> Textures;
+		uint64_t Budget{ 64ull * 1024 * 1024 };
+		uint64_t ResidentSize{ 0 };
+		uint64_t UpdateCount{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace Renderer
+{
+	// Vertex with a second set of texture coordinates addressing a lightmap
+	struct Vertex1Pos2UV1Norm
+	{
+		Vertex1Pos2UV1Norm() : Pos({ 0.0f, 0.0f, 0.0f }), UV({ 0.0f, 0.0f }), LightmapUV({ 0.0f, 0.0f }), Norm({ 0.0f, 0.0f, 0.0f }) {}
+		Vertex1Pos2UV1Norm(const glm::vec3& pos, const glm::vec2& uv, const glm::vec2& lightmapUV, const glm::vec3& norm) : 
+			Pos(pos), UV(uv), LightmapUV(lightmapUV), Norm(norm) {}
+
+		glm::vec3 Pos;
+		glm::vec2 UV;
+		glm::vec2 LightmapUV;
+		glm::vec3 Norm;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CameraSettings.h"
+
+namespace Renderer
+{
+	// Split screen frames render up to four views of the level, one for each local player
+	constexpr uint32_t MAX_VIEW_COUNT{ 4 };
+
+	// A camera the level is rendered from into its own region of the surface
+	struct View
+	{
+		glm::vec3 Position{ 0.0f, 0.0f, 0.0f };
+		glm::vec3 Rotation{ 0.0f, 0.0f, 0.0f };
+		Renderer::CameraSettings CameraSettings{};
+	};
+}
\ No newline at end of file